@@ -74,6 +74,20 @@ if(ARGOS_BUILD_FOR_SIMULATOR)
   endif(FREEIMAGE_FOUND)
 endif(ARGOS_BUILD_FOR_SIMULATOR)
 
+#
+# Check for zlib
+# It is used to compress the data written by the recorder
+#
+if(ARGOS_BUILD_FOR_SIMULATOR)
+  find_package(ZLIB)
+  if(ZLIB_FOUND)
+    set(ARGOS_WITH_ZLIB ON)
+    include_directories(AFTER ${ZLIB_INCLUDE_DIRS})
+  else(ZLIB_FOUND)
+    message(STATUS "zlib not found, the recorder won't compress its data")
+  endif(ZLIB_FOUND)
+endif(ARGOS_BUILD_FOR_SIMULATOR)
+
 #
 # Check for Google Perftools
 #
@@ -109,17 +123,30 @@ if(ARGOS_BUILD_FOR_SIMULATOR)
 endif(ARGOS_BUILD_FOR_SIMULATOR)
 
 #
-# Check for Lua 5.3
+# Check for Lua 5.3, or for LuaJIT if requested
 #
-find_package(Lua)
-if(LUA_FOUND)
-  if(${LUA_VERSION_STRING} VERSION_GREATER_EQUAL "5.3")
+if(ARGOS_USE_LUAJIT)
+  find_package(LuaJIT)
+  if(LUAJIT_FOUND)
     set(ARGOS_WITH_LUA ON)
+    set(ARGOS_WITH_LUAJIT ON)
+    set(LUA_INCLUDE_DIR ${LUAJIT_INCLUDE_DIR})
+    set(LUA_LIBRARIES ${LUAJIT_LIBRARIES})
     include_directories(AFTER ${LUA_INCLUDE_DIR})
-  else()
+  else(LUAJIT_FOUND)
+    message(STATUS "LuaJIT not found")
+  endif(LUAJIT_FOUND)
+else(ARGOS_USE_LUAJIT)
+  find_package(Lua)
+  if(LUA_FOUND)
+    if(${LUA_VERSION_STRING} VERSION_GREATER_EQUAL "5.3")
+      set(ARGOS_WITH_LUA ON)
+      include_directories(AFTER ${LUA_INCLUDE_DIR})
+    else()
+      message(STATUS "Lua >=5.3 not found")
+    endif()
+  else(LUA_FOUND)
     message(STATUS "Lua >=5.3 not found")
-  endif()
-else(LUA_FOUND)
-  message(STATUS "Lua >=5.3 not found")
-endif(LUA_FOUND)
+  endif(LUA_FOUND)
+endif(ARGOS_USE_LUAJIT)
 
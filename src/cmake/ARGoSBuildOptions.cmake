@@ -49,6 +49,30 @@ if(NOT DEFINED ARGOS_USE_DOUBLE)
   option(ARGOS_USE_DOUBLE "ON -> use double for Real, OFF -> use float for Real" ON)
 endif(NOT DEFINED ARGOS_USE_DOUBLE)
 
+#
+# Whether to run the Lua controllers with LuaJIT instead of Lua 5.3
+#
+if(NOT DEFINED ARGOS_USE_LUAJIT)
+  option(ARGOS_USE_LUAJIT "ON -> use LuaJIT for the Lua controllers, OFF -> use Lua 5.3" OFF)
+endif(NOT DEFINED ARGOS_USE_LUAJIT)
+
+#
+# Whether CEntity takes its memory from the entity pools
+# By default, entities are allocated on the heap
+#
+if(NOT DEFINED ARGOS_ENTITY_POOL)
+  option(ARGOS_ENTITY_POOL "ON -> allocate the entities in the entity pools, OFF -> allocate the entities on the heap" OFF)
+  mark_as_advanced(ARGOS_ENTITY_POOL)
+endif(NOT DEFINED ARGOS_ENTITY_POOL)
+
+#
+# Run the benchmarks with ctest
+# By default, the benchmarks are compiled but ctest runs only the tests
+#
+if(NOT DEFINED ARGOS_BENCHMARKS)
+  option(ARGOS_BENCHMARKS "ON -> run the benchmarks with ctest, OFF -> only compile them" OFF)
+endif(NOT DEFINED ARGOS_BENCHMARKS)
+
 #
 # Compile documentation
 #
@@ -133,7 +133,11 @@ if(ARGOS_BUILD_FOR_SIMULATOR)
   list(APPEND ARGOS_LDFLAGS "${ARGOS_QTOPENGL_LIBRARIES}")
 endif(ARGOS_BUILD_FOR_SIMULATOR)
 
-if(ARGOS_WITH_LUA)
+if(ARGOS_WITH_LUAJIT)
+  find_package(LuaJIT REQUIRED)
+  list(APPEND ARGOS_INCLUDE_DIRS "${LUAJIT_INCLUDE_DIR}")
+  list(APPEND ARGOS_LDFLAGS "${LUAJIT_LIBRARIES}")
+elseif(ARGOS_WITH_LUA)
   find_package(Lua REQUIRED)
   if(${LUA_VERSION_STRING} VERSION_GREATER_EQUAL "5.3")
     list(APPEND ARGOS_INCLUDE_DIRS "${LUA_INCLUDE_DIR}")
@@ -141,7 +145,7 @@ if(ARGOS_WITH_LUA)
   else(${LUA_VERSION_STRING} VERSION_GREATER_EQUAL "5.3")
     message(FATAL_ERROR "Lua >=5.3 not found")
   endif(${LUA_VERSION_STRING} VERSION_GREATER_EQUAL "5.3")
-endif(ARGOS_WITH_LUA)
+endif(ARGOS_WITH_LUAJIT)
 
 list(REMOVE_DUPLICATES ARGOS_INCLUDE_DIRS)
 set(ARGOS_INCLUDE_DIRS "${ARGOS_INCLUDE_DIRS}" CACHE STRING "Path of the headers needed for ARGoS" FORCE)
@@ -0,0 +1,51 @@
+# Find LuaJIT
+#
+# This module defines these variables:
+#
+#  LUAJIT_FOUND       - True if the LuaJIT library was found
+#  LUAJIT_LIBRARY     - The location of the LuaJIT library
+#  LUAJIT_INCLUDE_DIR - The include directory of the LuaJIT library
+#
+# AUTHOR: agent <agent@local>
+
+#
+# Find the header file
+#
+FIND_PATH(LUAJIT_INCLUDE_DIR
+  NAMES
+  luajit.h
+  PATHS
+  /usr/include/
+  /usr/local/include/
+  PATH_SUFFIXES
+  luajit-2.1
+  luajit-2.0
+  DOC "LuaJIT header location"
+)
+
+#
+# Find the library
+#
+FIND_LIBRARY(LUAJIT_LIBRARY
+  NAMES
+  luajit-5.1
+  luajit
+  PATHS
+  /usr/lib
+  /usr/lib64
+  /usr/local/lib
+  /usr/local/lib64
+  DOC "LuaJIT library location"
+)
+
+INCLUDE(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(LuaJIT DEFAULT_MSG
+	LUAJIT_LIBRARY LUAJIT_INCLUDE_DIR)
+
+IF(LUAJIT_INCLUDE_DIR AND LUAJIT_LIBRARY)
+	SET(LUAJIT_INCLUDE_DIRS ${LUAJIT_INCLUDE_DIR})
+	SET(LUAJIT_LIBRARIES	  ${LUAJIT_LIBRARY})
+ENDIF(LUAJIT_INCLUDE_DIR AND LUAJIT_LIBRARY)
+
+MARK_AS_ADVANCED(LUAJIT_INCLUDE_DIR)
+MARK_AS_ADVANCED(LUAJIT_LIBRARY)
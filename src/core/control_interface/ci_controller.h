@@ -207,6 +207,27 @@ namespace argos {
          m_mapSensors[str_sensor_type] = pc_sensor;
       }
 
+      /**
+       * Returns the scalars exported by this controller.
+       * @return The scalars exported by this controller, indexed by name.
+       * @see ExportScalar()
+       */
+      inline const std::map<std::string, Real>& GetExportedScalars() const {
+         return m_mapExportedScalars;
+      }
+
+      /**
+       * Sets the value of a scalar exported by this controller.
+       * Exported scalars are meant to be read by external tools, such as the recorder.
+       * @param str_name The name of the scalar.
+       * @param f_value The value of the scalar.
+       * @see GetExportedScalars()
+       */
+      inline void ExportScalar(const std::string& str_name,
+                               Real f_value) {
+         m_mapExportedScalars[str_name] = f_value;
+      }
+
    protected:
 
       /** A map containing all the actuators associated to this controller */
@@ -218,6 +239,9 @@ namespace argos {
       /** The id of the robot associated to this controller  */
       std::string m_strId;
 
+      /** The scalars exported by this controller */
+      std::map<std::string, Real> m_mapExportedScalars;
+
    };
 
 }
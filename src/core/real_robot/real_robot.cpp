@@ -16,7 +16,9 @@ CRealRobot* CRealRobot::m_pcInstance = NULL;
 /****************************************/
 
 CRealRobot::CRealRobot() :
-  m_pcController(NULL) {
+  m_pcController(NULL),
+  m_unMaxLag(0),
+  m_pcRate(NULL) {
   /* Set instance */
   m_pcInstance = this;
 }
@@ -42,6 +44,8 @@ void CRealRobot::Init(const std::string& str_conf_fname,
   TConfigurationNode& tFramework = GetNode(m_tConfRoot, "framework");
   TConfigurationNode& tExperiment = GetNode(tFramework, "experiment");
   GetNodeAttribute(tExperiment, "ticks_per_second", m_fRate);
+  /* Number of late ticks the control loop can catch up with */
+  GetNodeAttributeOrDefault(tExperiment, "real_time_max_lag", m_unMaxLag, m_unMaxLag);
   /*
    * Parse XML to identify the controller to run
    */
@@ -122,6 +126,16 @@ void CRealRobot::Init(const std::string& str_conf_fname,
 CRealRobot::~CRealRobot() {
   if(m_pcController)
     delete m_pcController;
+  if(m_pcRate) {
+    LOG << "[INFO] Control loop ran "
+        << m_pcRate->GetTicks() << " ticks, "
+        << m_pcRate->GetOverruns() << " overran, "
+        << m_pcRate->GetSkippedPeriods() << " skipped; wake-up jitter "
+        << m_pcRate->GetMeanJitterUS() << " us on average, "
+        << m_pcRate->GetMaxJitterUS() << " us at most"
+        << std::endl;
+    delete m_pcRate;
+  }
 }
 
 /****************************************/
@@ -136,7 +150,7 @@ void CRealRobot::Control() {
 
 void CRealRobot::Execute() {
   /* Enforce the control rate */
-  CRate cRate(m_fRate);
+  m_pcRate = new CRate(m_fRate, m_unMaxLag);
   /* Main loop */
   LOG << "[INFO] Control loop running" << std::endl;
   /* Save current time */
@@ -154,7 +168,7 @@ void CRealRobot::Execute() {
     Control();
     Act(fElapsed);
     /* Sleep to enforce control rate */
-    cRate.Sleep();
+    m_pcRate->Sleep();
   }
 }
 
@@ -6,6 +6,8 @@
 
 namespace argos {
 
+   class CRate;
+
    class CRealRobot {
 
    public:
@@ -81,6 +83,8 @@ namespace argos {
       TConfigurationNode m_tConfRoot;
       TConfigurationNode* m_ptControllerConfRoot;
       Real m_fRate;
+      UInt32 m_unMaxLag;
+      CRate* m_pcRate;
       static CRealRobot* m_pcInstance;
       
    };
@@ -15,7 +15,9 @@ namespace argos {
    CARGoSCommandLineArgParser::CARGoSCommandLineArgParser() :
       m_eAction(ACTION_UNKNOWN),
       m_pcInitLogStream(nullptr),
-      m_pcInitLogErrStream(nullptr) {
+      m_pcInitLogErrStream(nullptr),
+      m_unReplicas(1),
+      m_unJobs(0) {
       AddFlag(
          'h',
          "help",
@@ -52,6 +54,24 @@ namespace argos {
          "query the available plugins",
          m_strQuery
          );
+      AddArgument<std::string>(
+         'i',
+         "index-plugins",
+         "write the plugin index of a directory",
+         m_strPluginIndexDir
+         );
+      AddArgument<std::string>(
+         'C',
+         "compile",
+         "compile an experiment XML configuration file",
+         m_strCompileConfigFile
+         );
+      AddArgument<std::string>(
+         'o',
+         "output",
+         "the file where the compiled configuration is written [OPTIONAL]",
+         m_strCompileOutputFile
+         );
       AddArgument<std::string>(
          'l',
          "log-file",
@@ -64,6 +84,18 @@ namespace argos {
          "output logerr to file [OPTIONAL]",
          m_strLogErrFileName
          );
+      AddArgument<UInt32>(
+         'r',
+         "replicas",
+         "run N replicas of the experiment [OPTIONAL]",
+         m_unReplicas
+         );
+      AddArgument<UInt32>(
+         'j',
+         "jobs",
+         "run at most N replicas at the same time [OPTIONAL]",
+         m_unJobs
+         );
    }
 
    /****************************************/
@@ -120,27 +152,53 @@ namespace argos {
       }
 
 
-      /* Check that either -h, -v, -c or -q was passed (strictly one of them) */
+      /* Check that either -h, -v, -c, -q, -i or -C was passed (strictly one of them) */
       UInt32 nOptionsOn = 0;
       if(m_strExperimentConfigFile != "") ++nOptionsOn;
       if(m_strQuery != "") ++nOptionsOn;
+      if(m_strPluginIndexDir != "") ++nOptionsOn;
+      if(m_strCompileConfigFile != "") ++nOptionsOn;
       if(m_bHelpWanted) ++nOptionsOn;
       if(m_bVersionWanted) ++nOptionsOn;
       if(nOptionsOn == 0) {
-         THROW_ARGOSEXCEPTION("No --help, --version, --config-file or --query options specified.");
+         THROW_ARGOSEXCEPTION("No --help, --version, --config-file, --query, --index-plugins or --compile options specified.");
       }
       if(nOptionsOn > 1) {
-         THROW_ARGOSEXCEPTION("Options --help, --version, --config-file and --query are mutually exclusive.");
+         THROW_ARGOSEXCEPTION("Options --help, --version, --config-file, --query, --index-plugins and --compile are mutually exclusive.");
       }
 
       if(m_strExperimentConfigFile != "") {
          m_eAction = ACTION_RUN_EXPERIMENT;
       }
+      if(m_unReplicas == 0) {
+         THROW_ARGOSEXCEPTION("The number of replicas passed to --replicas must be positive.");
+      }
 
       if(m_strQuery != "") {
          m_eAction = ACTION_QUERY;
       }
 
+      if(m_strPluginIndexDir != "") {
+         m_eAction = ACTION_INDEX_PLUGINS;
+      }
+
+      if(m_strCompileConfigFile != "") {
+         m_eAction = ACTION_COMPILE_EXPERIMENT;
+         if(m_strCompileOutputFile == "") {
+            /* Replace the extension of the input file, if any */
+            size_t unSlash = m_strCompileConfigFile.rfind('/');
+            size_t unDot = m_strCompileConfigFile.rfind('.');
+            if(unDot != std::string::npos &&
+               (unSlash == std::string::npos || unDot > unSlash)) {
+               m_strCompileOutputFile = m_strCompileConfigFile.substr(0, unDot);
+            }
+            else {
+               m_strCompileOutputFile = m_strCompileConfigFile;
+            }
+            m_strCompileOutputFile += ".argosb";
+         }
+      }
+
       if(m_bHelpWanted) {
          m_eAction = ACTION_SHOW_HELP;
       }
@@ -164,13 +222,34 @@ namespace argos {
       c_log << "   -v       | --version               display ARGoS version and release" << std::endl;
       c_log << "   -c FILE  | --config-file FILE      the experiment XML configuration file" << std::endl;
       c_log << "   -q QUERY | --query QUERY           query the available plugins." << std::endl;
+      c_log << "   -i DIR   | --index-plugins DIR     write the plugin index of DIR" << std::endl;
+      c_log << "   -C FILE  | --compile FILE          compile the experiment XML configuration file" << std::endl;
+      c_log << "   -o FILE  | --output FILE           write the compiled configuration to FILE [OPTIONAL]" << std::endl;
       c_log << "   -n       | --no-color              do not use colored output [OPTIONAL]" << std::endl;
       c_log << "   -l       | --log-file FILE         redirect LOG to FILE [OPTIONAL]" << std::endl;
       c_log << "   -e       | --logerr-file FILE      redirect LOGERR to FILE [OPTIONAL]" << std::endl;
-      c_log << "   -z       | --no-visualization      ignore the <visualization> tag [OPTIONAL]" << std::endl << std::endl;
+      c_log << "   -z       | --no-visualization      ignore the <visualization> tag [OPTIONAL]" << std::endl;
+      c_log << "   -r N     | --replicas N            run N replicas of the experiment [OPTIONAL]" << std::endl;
+      c_log << "   -j N     | --jobs N                run at most N replicas at the same time [OPTIONAL]" << std::endl << std::endl;
       c_log << "The options --config-file and --query are mutually exclusive. Either you use" << std::endl;
       c_log << "the first, and thus you run an experiment, or you use the second to query the" << std::endl;
       c_log << "plugins." << std::endl << std::endl;
+      c_log << "When a plugin directory contains an index, written with --index-plugins,"  << std::endl;
+      c_log << "its libraries are loaded only when the experiment refers to one of the" << std::endl;
+      c_log << "plugins they contain. The plugins installed with ARGoS are indexed at" << std::endl;
+      c_log << "installation time." << std::endl << std::endl;
+      c_log << "With --compile, the experiment file is stored in a binary form that loads" << std::endl;
+      c_log << "faster than XML, by default in a file with extension .argosb. The compiled" << std::endl;
+      c_log << "file can be passed to --config-file like any experiment file. Comments are" << std::endl;
+      c_log << "not kept, and the compiled file must be created again whenever the XML file" << std::endl;
+      c_log << "changes." << std::endl << std::endl;
+      c_log << "With --replicas, the experiment is loaded once and run N times, each time" << std::endl;
+      c_log << "in a separate process with random seed equal to the experiment seed plus the" << std::endl;
+      c_log << "index of the replica. The visualization is disabled, and the output of replica" << std::endl;
+      c_log << "I goes to the file CONFIG_I.log, where CONFIG is the name of the experiment" << std::endl;
+      c_log << "file without extension. The environment variable ARGOS_REPLICA contains the" << std::endl;
+      c_log << "index of the replica. By default, as many replicas as the available cores run" << std::endl;
+      c_log << "at the same time." << std::endl << std::endl;
       c_log << "EXAMPLES" << std::endl << std::endl;
       c_log << "To run an experiment, type:" << std::endl << std::endl;
       c_log << "   argos3 -c /path/to/myconfig.argos" << std::endl << std::endl;
@@ -183,7 +262,8 @@ namespace argos {
       c_log << "   physics_engines      print a list of all the available physics engines" << std::endl;
       c_log << "   media                print a list of all the available media" << std::endl;
       c_log << "   visualizations       print a list of all the available visualizations" << std::endl;
-      c_log << "   entities             print a list of all the available entities" << std::endl << std::endl;
+      c_log << "   entities             print a list of all the available entities" << std::endl;
+      c_log << "   recorder_fields      print a list of all the available recorder fields" << std::endl << std::endl;
       c_log << "Alternatively, QUERY can be the name of a specific plugin as returned by the" << std::endl;
       c_log << "above commands. In this case, you get a complete description of the matching" << std::endl;
       c_log << "plugins." << std::endl << std::endl;
@@ -34,7 +34,9 @@ namespace argos {
          ACTION_SHOW_HELP,
          ACTION_SHOW_VERSION,
          ACTION_RUN_EXPERIMENT,
-         ACTION_QUERY
+         ACTION_QUERY,
+         ACTION_INDEX_PLUGINS,
+         ACTION_COMPILE_EXPERIMENT
       };
 
    public:
@@ -108,6 +110,37 @@ namespace argos {
          return m_strQuery;
       }
 
+      /**
+       * Returns the plugin directory to index as parsed by Parse().
+       * The returned value is meaningful only if GetAction() returns ACTION_INDEX_PLUGINS.
+       * @return The plugin directory to index as parsed by Parse().
+       * @see Parse()
+       */
+      inline const std::string& GetPluginIndexDir() {
+         return m_strPluginIndexDir;
+      }
+
+      /**
+       * Returns the experiment configuration file to compile as parsed by Parse().
+       * The returned value is meaningful only if GetAction() returns ACTION_COMPILE_EXPERIMENT.
+       * @return The experiment configuration file to compile as parsed by Parse().
+       * @see Parse()
+       */
+      inline const std::string& GetCompileConfigFile() {
+         return m_strCompileConfigFile;
+      }
+
+      /**
+       * Returns the file where the compiled experiment configuration is written.
+       * The returned value is meaningful only if GetAction() returns ACTION_COMPILE_EXPERIMENT.
+       * When no output file was given, it is the input file with the extension <tt>.argosb</tt>.
+       * @return The file where the compiled experiment configuration is written.
+       * @see Parse()
+       */
+      inline const std::string& GetCompileOutputFile() {
+         return m_strCompileOutputFile;
+      }
+
       /**
        * Returns <tt>true</tt> if color is enabled for LOG and LOGERR.
        * @see Parse()
@@ -136,11 +169,32 @@ namespace argos {
          return m_bForceNoViz;
       }
 
+      /**
+       * Returns the number of replicas of the experiment to run.
+       * The returned value is meaningful only if GetAction() returns ACTION_RUN_EXPERIMENT.
+       * @see Parse()
+       */
+      inline UInt32 GetReplicas() {
+         return m_unReplicas;
+      }
+
+      /**
+       * Returns the maximum number of replicas to run at the same time.
+       * Zero means as many as the available cores.
+       * @see Parse()
+       */
+      inline UInt32 GetJobs() {
+         return m_unJobs;
+      }
+
    private:
 
       EAction m_eAction;
       std::string m_strExperimentConfigFile;
       std::string m_strQuery;
+      std::string m_strPluginIndexDir;
+      std::string m_strCompileConfigFile;
+      std::string m_strCompileOutputFile;
       std::string m_strLogFileName;
       std::ofstream m_cLogFile;
       std::streambuf* m_pcInitLogStream;
@@ -151,6 +205,8 @@ namespace argos {
       bool m_bHelpWanted;
       bool m_bVersionWanted;
       bool m_bForceNoViz;
+      UInt32 m_unReplicas;
+      UInt32 m_unJobs;
 
    };
 
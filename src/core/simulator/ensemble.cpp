@@ -0,0 +1,221 @@
+/**
+ * @file <argos3/core/simulator/ensemble.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "ensemble.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/entity/floor_entity.h>
+#include <argos3/core/utility/configuration/compiled_configuration.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/core/utility/string_utilities.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <map>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CEnsemble::CEnsemble(const std::string& str_config_file,
+                        UInt32 un_replicas,
+                        UInt32 un_jobs) :
+      m_strConfigFile(str_config_file),
+      m_unReplicas(un_replicas),
+      m_unJobs(un_jobs) {
+      /* The log files are named after the experiment file */
+      size_t unSlash = m_strConfigFile.rfind('/');
+      size_t unDot = m_strConfigFile.rfind('.');
+      if(unDot != std::string::npos &&
+         (unSlash == std::string::npos || unDot > unSlash)) {
+         m_strLogPrefix = m_strConfigFile.substr(0, unDot);
+      }
+      else {
+         m_strLogPrefix = m_strConfigFile;
+      }
+      /* By default, run as many replicas as the available cores */
+      if(m_unJobs == 0) {
+         long nCores = ::sysconf(_SC_NPROCESSORS_ONLN);
+         m_unJobs = (nCores > 0) ? static_cast<UInt32>(nCores) : 1;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CEnsemble::Run() {
+      /* Parse the experiment file once for all the replicas */
+      try {
+         LoadConfiguration(m_tConfiguration, m_strConfigFile);
+      }
+      catch(ticpp::Exception& ex) {
+         THROW_ARGOSEXCEPTION("Error parsing experiment file \"" << m_strConfigFile << "\": " << ex.what());
+      }
+      /* Get the base random seed */
+      UInt32 unBaseSeed = 0;
+      try {
+         TConfigurationNode& tExperiment =
+            GetNode(GetNode(*m_tConfiguration.FirstChildElement(), "framework"), "experiment");
+         GetNodeAttributeOrDefault(tExperiment, "random_seed", unBaseSeed, unBaseSeed);
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error parsing experiment file \"" << m_strConfigFile << "\"", ex);
+      }
+      if(unBaseSeed == 0) {
+         struct timeval sTimeValue;
+         ::gettimeofday(&sTimeValue, nullptr);
+         unBaseSeed = static_cast<UInt32>(sTimeValue.tv_usec);
+      }
+      /* Load what the replicas share */
+      PreloadAssets();
+      /* Anything still buffered would be written by every replica too */
+      LOG.Flush();
+      LOGERR.Flush();
+      std::cout.flush();
+      std::cerr.flush();
+      /* Run the replicas, at most m_unJobs at a time */
+      std::map<pid_t, UInt32> mapRunning;
+      UInt32 unNext = 0;
+      UInt32 unFailed = 0;
+      while(unNext < m_unReplicas || !mapRunning.empty()) {
+         /* Start replicas until all the job slots are taken */
+         while(unNext < m_unReplicas && mapRunning.size() < m_unJobs) {
+            pid_t tPid = ::fork();
+            if(tPid < 0) {
+               THROW_ARGOSEXCEPTION("Error starting replica " << unNext << ": " << ::strerror(errno));
+            }
+            if(tPid == 0) {
+               /* Child process, never returns */
+               RunReplica(unNext, unBaseSeed + unNext);
+            }
+            LOG << "[INFO] Started replica " << unNext
+                << " with random seed " << (unBaseSeed + unNext)
+                << ", output in \"" << m_strLogPrefix << "_" << unNext << ".log\""
+                << std::endl;
+            LOG.Flush();
+            mapRunning[tPid] = unNext;
+            ++unNext;
+         }
+         /* Wait for a replica to finish */
+         int nStatus;
+         pid_t tPid = ::waitpid(-1, &nStatus, 0);
+         if(tPid < 0) {
+            if(errno == EINTR) continue;
+            THROW_ARGOSEXCEPTION("Error waiting for the replicas: " << ::strerror(errno));
+         }
+         auto it = mapRunning.find(tPid);
+         if(it == mapRunning.end()) continue;
+         if(WIFEXITED(nStatus) && WEXITSTATUS(nStatus) == 0) {
+            LOG << "[INFO] Replica " << it->second << " done" << std::endl;
+         }
+         else {
+            ++unFailed;
+            if(WIFSIGNALED(nStatus)) {
+               LOGERR << "[ERROR] Replica " << it->second
+                      << " killed by signal " << WTERMSIG(nStatus)
+                      << std::endl;
+            }
+            else {
+               LOGERR << "[ERROR] Replica " << it->second
+                      << " failed, see \"" << m_strLogPrefix << "_" << it->second << ".log\""
+                      << std::endl;
+            }
+         }
+         LOG.Flush();
+         LOGERR.Flush();
+         mapRunning.erase(it);
+      }
+      return unFailed;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CEnsemble::PreloadAssets() {
+      TConfigurationNode& tRoot = *m_tConfiguration.FirstChildElement();
+      std::string strLibrary;
+      TConfigurationNodeIterator it;
+      /* Libraries of the controllers */
+      if(NodeExists(tRoot, "controllers")) {
+         for(it = it.begin(&GetNode(tRoot, "controllers"));
+             it != it.end();
+             ++it) {
+            if(NodeAttributeExists(*it, "library")) {
+               GetNodeAttribute(*it, "library", strLibrary);
+               CDynamicLoading::LoadLibrary(strLibrary);
+            }
+         }
+      }
+      /* Library of the loop functions */
+      if(NodeExists(tRoot, "loop_functions") &&
+         NodeAttributeExists(GetNode(tRoot, "loop_functions"), "library")) {
+         GetNodeAttribute(GetNode(tRoot, "loop_functions"), "library", strLibrary);
+         CDynamicLoading::LoadLibrary(strLibrary);
+      }
+#ifdef ARGOS_WITH_FREEIMAGE
+      /* Floor images */
+      if(NodeExists(tRoot, "arena")) {
+         std::string strSource, strPath;
+         TConfigurationNodeIterator itFloor("floor");
+         for(itFloor = itFloor.begin(&GetNode(tRoot, "arena"));
+             itFloor != itFloor.end();
+             ++itFloor) {
+            GetNodeAttributeOrDefault(*itFloor, "source", strSource, std::string());
+            if(strSource == "image") {
+               GetNodeAttribute(*itFloor, "path", strPath);
+               CFloorEntity::PreloadImage(strPath);
+            }
+         }
+      }
+#endif
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CEnsemble::RunReplica(UInt32 un_replica,
+                              UInt32 un_random_seed) {
+      int nResult = 0;
+      try {
+         /* Send the output of the replica to its own file */
+         std::string strLogFile = m_strLogPrefix + "_" + ToString(un_replica) + ".log";
+         int nFD = ::open(strLogFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+         if(nFD < 0) {
+            THROW_ARGOSEXCEPTION("Error opening file \"" << strLogFile << "\": " << ::strerror(errno));
+         }
+         ::dup2(nFD, STDOUT_FILENO);
+         ::dup2(nFD, STDERR_FILENO);
+         ::close(nFD);
+         LOG.DisableColoredOutput();
+         LOGERR.DisableColoredOutput();
+         /* Let the user code know which replica this is */
+         ::setenv("ARGOS_REPLICA", ToString(un_replica).c_str(), 1);
+         /* Run the experiment */
+         CSimulator& cSimulator = CSimulator::GetInstance();
+         cSimulator.SetExperimentFileName(m_strConfigFile);
+         cSimulator.SetRandomSeed(un_random_seed);
+         cSimulator.Load(m_tConfiguration, true);
+         cSimulator.Execute();
+         cSimulator.Destroy();
+      }
+      catch(std::exception& ex) {
+         LOGERR << ex.what() << std::endl;
+         nResult = 1;
+      }
+      LOG.Flush();
+      LOGERR.Flush();
+      ::exit(nResult);
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,87 @@
+/**
+ * @file <argos3/core/simulator/ensemble.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+namespace argos {
+   class CEnsemble;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <string>
+
+namespace argos {
+
+   /**
+    * Runs several replicas of an experiment, each with its own random seed.
+    * <p>
+    * The experiment file is parsed once, and the libraries of the controllers
+    * and of the loop functions, as well as the floor images, are loaded
+    * once. Then, each replica runs in a process forked from this one. The
+    * replicas thus share these read-only assets through copy-on-write memory,
+    * while each has its own simulator, space and random number generators.
+    * </p>
+    * <p>
+    * Replica <i>i</i> uses the random seed of the experiment plus <i>i</i>.
+    * When the experiment sets no random seed, the base seed is taken from the
+    * clock. The visualization is always disabled. The output of replica
+    * <i>i</i> goes to the file <tt>PREFIX_i.log</tt>, where <tt>PREFIX</tt>
+    * is the path of the experiment file without extension. The index of the
+    * replica is stored in the environment variable <tt>ARGOS_REPLICA</tt>, so
+    * the controllers and the loop functions can tell the replicas apart.
+    * </p>
+    */
+   class CEnsemble {
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param str_config_file The experiment XML configuration file.
+       * @param un_replicas The number of replicas to run.
+       * @param un_jobs The maximum number of replicas running at the same time, zero for the number of available cores.
+       */
+      CEnsemble(const std::string& str_config_file,
+                UInt32 un_replicas,
+                UInt32 un_jobs);
+
+      /**
+       * Runs all the replicas and waits for them to finish.
+       * @return The number of replicas that failed.
+       * @throws CARGoSException if the experiment cannot be parsed or a replica cannot be started.
+       */
+      UInt32 Run();
+
+   private:
+
+      /**
+       * Loads the assets shared by the replicas.
+       */
+      void PreloadAssets();
+
+      /**
+       * Runs a replica in the current process, and exits.
+       * @param un_replica The index of the replica.
+       * @param un_random_seed The random seed of the replica.
+       */
+      void RunReplica(UInt32 un_replica,
+                      UInt32 un_random_seed);
+
+   private:
+
+      std::string m_strConfigFile;
+      std::string m_strLogPrefix;
+      UInt32 m_unReplicas;
+      UInt32 m_unJobs;
+      ticpp::Document m_tConfiguration;
+
+   };
+
+}
+
+#endif
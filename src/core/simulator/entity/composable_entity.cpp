@@ -8,11 +8,38 @@
 
 #include <argos3/core/utility/string_utilities.h>
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+
 namespace argos {
 
    /****************************************/
    /****************************************/
 
+   const CComposableEntity::TLabelId CComposableEntity::NO_LABEL = std::numeric_limits<TLabelId>::max();
+
+   /*
+    * The interned component labels, shared by all the composable
+    * entities. New labels are added while the entities are created, and
+    * looked up by the string API at any time, possibly from several
+    * threads.
+    */
+   struct SLabelRegistry {
+      std::shared_mutex Mutex;
+      std::unordered_map<std::string, CComposableEntity::TLabelId> Ids;
+   };
+
+   static SLabelRegistry& GetLabelRegistry() {
+      static SLabelRegistry sRegistry;
+      return sRegistry;
+   }
+
+   /****************************************/
+   /****************************************/
+
    CComposableEntity::CComposableEntity(CComposableEntity* pc_parent) :
       CEntity(pc_parent) {}
 
@@ -27,10 +54,8 @@ namespace argos {
    /****************************************/
 
    void CComposableEntity::Reset() {
-      for(auto it = m_mapComponents.begin();
-          it != m_mapComponents.end();
-          ++it) {
-         it->second->Reset();
+      for(CEntity* pcComponent : m_vecUpdateList) {
+         pcComponent->Reset();
       }
    }
 
@@ -46,10 +71,8 @@ namespace argos {
 
    void CComposableEntity::SetEnabled(bool b_enabled) {
       CEntity::SetEnabled(b_enabled);
-      for(auto it = m_mapComponents.begin();
-          it != m_mapComponents.end();
-          ++it) {
-         it->second->SetEnabled(b_enabled);
+      for(CEntity* pcComponent : m_vecUpdateList) {
+         pcComponent->SetEnabled(b_enabled);
       }
    }
 
@@ -57,11 +80,9 @@ namespace argos {
    /****************************************/
 
    void CComposableEntity::UpdateComponents() {
-      for(auto it = m_mapComponents.begin();
-          it != m_mapComponents.end();
-          ++it) {
-         if(it->second->IsEnabled()) {
-            it->second->Update();
+      for(CEntity* pcComponent : m_vecUpdateList) {
+         if(pcComponent->IsEnabled()) {
+            pcComponent->Update();
          }
       }
    }
@@ -70,11 +91,17 @@ namespace argos {
    /****************************************/
 
    void CComposableEntity::AddComponent(CEntity& c_component) {
-      m_mapComponents.insert(
+      std::string strLabel = c_component.GetTypeDescription();
+      auto itComponent = m_mapComponents.insert(
          std::pair<std::string, CEntity*>(
-            c_component.GetTypeDescription(),
+            strLabel,
             &c_component));
       m_vecComponents.push_back(&c_component);
+      /* Keep the update list in the order of the map */
+      m_vecUpdateList.insert(
+         m_vecUpdateList.begin() + std::distance(m_mapComponents.begin(), itComponent),
+         &c_component);
+      m_mapComponentsPerLabel[GetLabelId(strLabel)].push_back(&c_component);
    }
 
    /****************************************/
@@ -87,6 +114,9 @@ namespace argos {
             THROW_ARGOSEXCEPTION("Element \"" << str_component << "\" not found in the component map.");
          }
          CEntity& cRetVal = *(it->second);
+         m_vecUpdateList.erase(m_vecUpdateList.begin() + std::distance(m_mapComponents.begin(), it));
+         CEntity::TVector& vecPerLabel = m_mapComponentsPerLabel[GetLabelId(it->first)];
+         vecPerLabel.erase(std::find(vecPerLabel.begin(), vecPerLabel.end(), &cRetVal));
          m_mapComponents.erase(it);
          size_t i;
          for(i = 0; i < m_vecComponents.size() && m_vecComponents[i] != &cRetVal; ++i);
@@ -114,15 +144,15 @@ namespace argos {
          if(unFirstSeparatorIdx == std::string::npos) strFrontIdentifier = str_path;
          else strFrontIdentifier = str_path.substr(0, unFirstSeparatorIdx);
          /* Try to find the relevant component in this context */
-         auto itComponent = FindComponent(strFrontIdentifier);
-         if(itComponent != m_mapComponents.end()) {
+         CEntity* pcComponent = LookupComponent(strFrontIdentifier);
+         if(pcComponent != nullptr) {
             if(unFirstSeparatorIdx == std::string::npos) {
                /* Path separator not found, found component in the current context is the one we want */
-               return *(itComponent->second);
+               return *pcComponent;
             }
             /* Path separator found, try to cast the found component to a composable entity */
             else {
-               auto* pcComposableEntity = dynamic_cast<CComposableEntity*>(itComponent->second);
+               auto* pcComposableEntity = dynamic_cast<CComposableEntity*>(pcComponent);
                if(pcComposableEntity != nullptr) {
                   /* Dynamic cast of component to composable entity was successful, re-execute this function in the new context */
                   return pcComposableEntity->GetComponent(str_path.substr(unFirstSeparatorIdx + 1, std::string::npos));
@@ -154,15 +184,15 @@ namespace argos {
       if(unFirstSeparatorIdx == std::string::npos) strFrontIdentifier = str_path;
       else strFrontIdentifier = str_path.substr(0, unFirstSeparatorIdx);
       /* Try to find the relevant component in this context */
-      auto itComponent = FindComponent(strFrontIdentifier);
-      if(itComponent != m_mapComponents.end()) {
+      CEntity* pcComponent = LookupComponent(strFrontIdentifier);
+      if(pcComponent != nullptr) {
          if(unFirstSeparatorIdx == std::string::npos) {
             /* Path separator not found, found component in the current context is the one we want */
             return true;
          }
          else {
             /* Path separator found, try to cast the found component to a composable entity */
-            auto* pcComposableEntity = dynamic_cast<CComposableEntity*>(itComponent->second);
+            auto* pcComposableEntity = dynamic_cast<CComposableEntity*>(pcComponent);
             if(pcComposableEntity != nullptr) {
                /* Dynamic cast of component to composable entity was sucessful, re-execute this function in the new context */
                return pcComposableEntity->HasComponent(str_path.substr(unFirstSeparatorIdx + 1, std::string::npos));
@@ -234,6 +264,99 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CComposableEntity::TLabelId CComposableEntity::GetLabelId(const std::string& str_label) {
+      TLabelId tId = FindLabelId(str_label);
+      if(tId != NO_LABEL) {
+         return tId;
+      }
+      SLabelRegistry& sRegistry = GetLabelRegistry();
+      std::unique_lock<std::shared_mutex> cLock(sRegistry.Mutex);
+      /* Another thread might have added the label in the meantime */
+      return sRegistry.Ids.emplace(str_label, sRegistry.Ids.size()).first->second;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CComposableEntity::TLabelId CComposableEntity::FindLabelId(const std::string& str_label) {
+      /* The ids never change, so each thread keeps the ones it has seen
+       * and takes the lock only for the others */
+      static thread_local std::unordered_map<std::string, TLabelId> mapSeen;
+      auto itSeen = mapSeen.find(str_label);
+      if(itSeen != mapSeen.end()) {
+         return itSeen->second;
+      }
+      SLabelRegistry& sRegistry = GetLabelRegistry();
+      std::shared_lock<std::shared_mutex> cLock(sRegistry.Mutex);
+      auto itId = sRegistry.Ids.find(str_label);
+      if(itId == sRegistry.Ids.end()) {
+         return NO_LABEL;
+      }
+      mapSeen.emplace(str_label, itId->second);
+      return itId->second;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const CEntity::TVector& CComposableEntity::GetComponents(TLabelId t_label) const {
+      static const CEntity::TVector vecNone;
+      auto itComponents = m_mapComponentsPerLabel.find(t_label);
+      return (itComponents != m_mapComponentsPerLabel.end()) ? itComponents->second : vecNone;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CEntity& CComposableEntity::GetComponent(TLabelId t_label,
+                                            size_t un_index) {
+      const CEntity::TVector& vecComponents = GetComponents(t_label);
+      if(un_index >= vecComponents.size()) {
+         THROW_ARGOSEXCEPTION("Component " << un_index << " with label id " << t_label << " does not exist in \""
+                              << GetContext() + GetId() << "\"");
+      }
+      return *vecComponents[un_index];
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CEntity* CComposableEntity::LookupComponent(const std::string& str_component) const {
+      /* Split label[id] into label and id */
+      std::string::size_type unIdentifierStart = str_component.find('[');
+      std::string::size_type unIdentifierEnd = std::string::npos;
+      if(unIdentifierStart != std::string::npos) {
+         unIdentifierEnd = str_component.rfind(']');
+         if(unIdentifierEnd == std::string::npos ||
+            unIdentifierEnd < unIdentifierStart) {
+            THROW_ARGOSEXCEPTION("Syntax error in entity id \"" << str_component << "\"");
+         }
+      }
+      const CEntity::TVector& vecComponents =
+         GetComponents(FindLabelId((unIdentifierStart == std::string::npos) ?
+                                   str_component :
+                                   str_component.substr(0, unIdentifierStart)));
+      if(vecComponents.empty()) {
+         return nullptr;
+      }
+      if(unIdentifierStart == std::string::npos) {
+         /* No id, take the first component with this label */
+         return vecComponents.front();
+      }
+      /* Search for the component with the given id */
+      size_t unIdLength = unIdentifierEnd - unIdentifierStart - 1;
+      for(CEntity* pcComponent : vecComponents) {
+         if(pcComponent->GetId().compare(0, std::string::npos,
+                                          str_component, unIdentifierStart + 1, unIdLength) == 0) {
+            return pcComponent;
+         }
+      }
+      return nullptr;
+   }
+
+   /****************************************/
+   /****************************************/
+
    REGISTER_STANDARD_SPACE_OPERATIONS_ON_COMPOSABLE(CComposableEntity);
 
    /****************************************/
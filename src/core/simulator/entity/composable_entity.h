@@ -20,6 +20,8 @@ namespace argos {
 #include <argos3/core/simulator/entity/entity.h>
 #include <argos3/core/simulator/space/space.h>
 
+#include <unordered_map>
+
 namespace argos {
 
    /**
@@ -35,6 +37,20 @@ namespace argos {
 
       ENABLE_VTABLE();
 
+      /**
+       * The interned id of a component label.
+       * Every string label returned by GetTypeDescription() gets a small
+       * integer id, shared by all the composable entities. Looking up
+       * components by id avoids parsing and comparing strings.
+       * @see GetLabelId()
+       */
+      typedef UInt32 TLabelId;
+
+      /**
+       * The id returned by FindLabelId() when a label is unknown.
+       */
+      static const TLabelId NO_LABEL;
+
    public:
 
       /**
@@ -155,6 +171,77 @@ namespace argos {
        */
       bool HasComponent(const std::string& str_component);
 
+      /**
+       * Returns the id of the given component label, creating it if needed.
+       * Call this once, for instance in Init(), and keep the result.
+       * @param str_label The string label of the component.
+       * @return The id of the label.
+       * @see GetTypeDescription()
+       */
+      static TLabelId GetLabelId(const std::string& str_label);
+
+      /**
+       * Returns the id of the given component label.
+       * Unlike GetLabelId(), this method does not create an id for an unknown label.
+       * @param str_label The string label of the component.
+       * @return The id of the label, or NO_LABEL if no component has ever had this label.
+       */
+      static TLabelId FindLabelId(const std::string& str_label);
+
+      /**
+       * Returns the components with the given label id.
+       * The components are stored in the same order as they were inserted.
+       * @param t_label The id of the label.
+       * @return The components with the given label id; the vector is empty if there are none.
+       * @see GetLabelId()
+       */
+      const CEntity::TVector& GetComponents(TLabelId t_label) const;
+
+      /**
+       * Returns the component with the given label id.
+       * @param t_label The id of the label.
+       * @param un_index The index of the component among those with the same label, in insertion order.
+       * @return The component.
+       * @see GetLabelId()
+       * @throws CARGoSException if the component was not found.
+       */
+      CEntity& GetComponent(TLabelId t_label,
+                            size_t un_index = 0);
+
+      /**
+       * Returns the component with the given label id.
+       * This method internally performs a <tt>dynamic_cast</tt> and returns
+       * directly the desired type instead of CEntity.
+       * @param t_label The id of the label.
+       * @param un_index The index of the component among those with the same label, in insertion order.
+       * @return The component.
+       * @see GetLabelId()
+       * @throws CARGoSException if the component was not found or can't be cast to the target type.
+       */
+      template <class E>
+      E& GetComponent(TLabelId t_label,
+                      size_t un_index = 0) {
+         E* pcComponent = dynamic_cast<E*>(&GetComponent(t_label, un_index));
+         if(pcComponent != nullptr) {
+            return *pcComponent;
+         }
+         else {
+            THROW_ARGOSEXCEPTION("Type conversion failed for component " << un_index << " with label id " << t_label << " of entity \"" << GetId());
+         }
+      }
+
+      /**
+       * Returns <tt>true</tt> if this composable entity has a component with the given label id.
+       * @param t_label The id of the label.
+       * @param un_index The index of the component among those with the same label, in insertion order.
+       * @return <tt>true</tt> if this composable entity has a component with the given label id.
+       * @see GetLabelId()
+       */
+      inline bool HasComponent(TLabelId t_label,
+                               size_t un_index = 0) const {
+         return un_index < GetComponents(t_label).size();
+      }
+
       /**
        * Searches for a component with the given string label.
        * The format of the label can be either <tt>label</tt> or <tt>label[label_N]</tt> to get the
@@ -184,9 +271,27 @@ namespace argos {
 
    private:
 
+      /**
+       * Returns the component with the given string label, or <tt>nullptr</tt> if it does not exist.
+       * The format of the label can be either <tt>label</tt> or <tt>label[label_N]</tt>.
+       * @throws CARGoSException in case of syntax error.
+       */
+      CEntity* LookupComponent(const std::string& str_component) const;
+
+   private:
+
+      /** The components, indexed by string label */
       CEntity::TMultiMap m_mapComponents;
+
+      /** The components, in insertion order */
       CEntity::TVector m_vecComponents;
 
+      /** The components, in the order of m_mapComponents, for the updates */
+      CEntity::TVector m_vecUpdateList;
+
+      /** The components, indexed by label id, in insertion order */
+      std::unordered_map<TLabelId, CEntity::TVector> m_mapComponentsPerLabel;
+
    };
 
 /**
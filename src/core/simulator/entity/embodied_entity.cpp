@@ -99,6 +99,7 @@ namespace argos {
       /* Reset origin anchor first */
       m_psOriginAnchor->Position = m_cInitOriginPosition;
       m_psOriginAnchor->Orientation = m_cInitOriginOrientation;
+      ++m_psOriginAnchor->Version;
       /* Reset other anchors */
       SAnchor* psAnchor;
       for(auto it = m_mapAnchors.begin();
@@ -111,6 +112,7 @@ namespace argos {
             psAnchor->Position.Rotate(m_cInitOriginOrientation);
             psAnchor->Position += m_cInitOriginPosition;
             psAnchor->Orientation = m_cInitOriginOrientation * psAnchor->OffsetOrientation;
+            ++psAnchor->Version;
          }
       }
    }
@@ -160,6 +162,8 @@ namespace argos {
       /* Add to vector of enabled anchors if necessary */
       if(it->second->InUseCount == 1) {
          m_vecEnabledAnchors.push_back(it->second);
+         /* The pose was not updated while disabled */
+         ++(it->second->Version);
       }
    }
 
@@ -503,6 +507,33 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CEmbodiedEntitySpatialHashUpdater::CEmbodiedEntitySpatialHashUpdater(CSpatialHash<CEmbodiedEntity>& c_hash) :
+      m_cHash(c_hash) {}
+
+   bool CEmbodiedEntitySpatialHashUpdater::operator()(CEmbodiedEntity& c_entity) {
+      try {
+         /* Get the cells of the bounding box corners */
+         m_cHash.PositionToCell(m_nMinI, m_nMinJ, m_nMinK, c_entity.GetBoundingBox().MinCorner);
+         m_cHash.PositionToCell(m_nMaxI, m_nMaxJ, m_nMaxK, c_entity.GetBoundingBox().MaxCorner);
+         /* Go through cells */
+         for(SInt32 nK = m_nMinK; nK <= m_nMaxK; ++nK) {
+            for(SInt32 nJ = m_nMinJ; nJ <= m_nMaxJ; ++nJ) {
+               for(SInt32 nI = m_nMinI; nI <= m_nMaxI; ++nI) {
+                  m_cHash.UpdateCell(nI, nJ, nK, c_entity);
+               }
+            }
+         }
+         /* Continue with the other entities */
+         return true;
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("While updating the embodied entity spatial hash for embodied entity \"" << c_entity.GetContext() << c_entity.GetId() << "\"", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    /**
     * @cond HIDDEN_SYMBOLS
     */
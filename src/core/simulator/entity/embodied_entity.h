@@ -14,6 +14,7 @@ namespace argos {
 #include <argos3/core/simulator/entity/entity.h>
 #include <argos3/core/simulator/space/positional_indices/grid.h>
 #include <argos3/core/simulator/space/positional_indices/space_hash.h>
+#include <argos3/core/simulator/space/positional_indices/spatial_hash.h>
 #include <argos3/core/utility/datatypes/set.h>
 #include <argos3/core/utility/math/ray3.h>
 #include <argos3/core/utility/math/quaternion.h>
@@ -390,6 +391,26 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /**
+    * Adds an embodied entity to all the cells of a spatial hash its bounding box overlaps.
+    */
+   class CEmbodiedEntitySpatialHashUpdater : public CSpatialHash<CEmbodiedEntity>::COperation {
+
+   public:
+
+      CEmbodiedEntitySpatialHashUpdater(CSpatialHash<CEmbodiedEntity>& c_hash);
+      virtual bool operator()(CEmbodiedEntity& c_entity);
+
+   private:
+
+      CSpatialHash<CEmbodiedEntity>& m_cHash;
+      SInt32 m_nMinI, m_nMinJ, m_nMinK;
+      SInt32 m_nMaxI, m_nMaxJ, m_nMaxK;
+   };
+
+   /****************************************/
+   /****************************************/
+
 }
 
 #endif
@@ -7,6 +7,7 @@
 
 #include "entity.h"
 #include "composable_entity.h"
+#include "entity_pool.h"
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/simulator/space/space.h>
 
@@ -37,6 +38,30 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+#ifdef ARGOS_ENTITY_POOL
+   void* CEntity::operator new(size_t un_size) {
+      CEntityPool* pcPool = CEntityPool::GetCurrent();
+      return (pcPool != nullptr) ? pcPool->Allocate(un_size) : ::operator new(un_size);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CEntity::operator delete(void* pv_ptr) {
+      if(pv_ptr == nullptr) return;
+      CEntityPool* pcPool = CEntityPool::Find(pv_ptr);
+      if(pcPool != nullptr) {
+         pcPool->Release();
+      }
+      else {
+         ::operator delete(pv_ptr);
+      }
+   }
+#endif
+
+   /****************************************/
+   /****************************************/
+
    void CEntity::Init(TConfigurationNode& t_tree) {
       try {
          /*
@@ -19,6 +19,7 @@ namespace argos {
    class CSpace;
 }
 
+#include <argos3/core/config.h>
 #include <argos3/core/utility/datatypes/datatypes.h>
 #include <argos3/core/utility/configuration/argos_configuration.h>
 #include <argos3/core/utility/configuration/base_configurable_resource.h>
@@ -127,6 +128,38 @@ namespace argos {
        */
       virtual ~CEntity() {}
 
+#ifdef ARGOS_ENTITY_POOL
+      /**
+       * Allocates the memory for an entity.
+       * If a CEntityPool::CScope is open in this thread, the memory is taken
+       * from its pool; otherwise, it is taken from the heap.
+       * Available only when ARGoS is compiled with ARGOS_ENTITY_POOL.
+       * @param un_size The size in bytes of the entity.
+       * @return The memory for the entity.
+       * @see CEntityPool
+       */
+      static void* operator new(size_t un_size);
+
+      /**
+       * Releases the memory of an entity.
+       * @param pv_ptr The memory of the entity.
+       * @see CEntityPool
+       */
+      static void operator delete(void* pv_ptr);
+
+      /**
+       * Placement new, which constructs an entity in the given memory.
+       */
+      static void* operator new(size_t, void* pv_place) {
+         return pv_place;
+      }
+
+      /**
+       * Placement delete, matching the placement new.
+       */
+      static void operator delete(void*, void*) {}
+#endif
+
       /**
        * Initializes the state of the entity from the XML configuration tree.
        * If the id of the entity has not been set yet, this method sets an id for
@@ -0,0 +1,152 @@
+/**
+ * @file <argos3/core/simulator/entity/entity_pool.cpp>
+ *
+ * @author agent <agent@local>
+ */
+
+#include "entity_pool.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const size_t CEntityPool::DEFAULT_CHUNK_SIZE = 16384;
+
+   /* The current pool of each thread */
+   static thread_local CEntityPool* pcCurrentPool = nullptr;
+
+   /*
+    * The chunks of all the pools, indexed by their first byte, with their
+    * end and their pool. They let CEntity::operator delete tell the pooled
+    * entities from those on the heap.
+    */
+   typedef std::map<const char*, std::pair<const char*, CEntityPool*> > TChunkMap;
+
+   static TChunkMap& GetChunkMap() {
+      static TChunkMap mapChunks;
+      return mapChunks;
+   }
+
+   static std::mutex& GetChunkMapMutex() {
+      static std::mutex cMutex;
+      return cMutex;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CEntityPool::CScope::CScope(size_t un_chunk_size) :
+      m_pcPool(new CEntityPool(un_chunk_size)),
+      m_pcPrevious(pcCurrentPool) {
+      pcCurrentPool = m_pcPool;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CEntityPool::CScope::~CScope() {
+      pcCurrentPool = m_pcPrevious;
+      m_pcPool->Unreference();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CEntityPool* CEntityPool::GetCurrent() {
+      return pcCurrentPool;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CEntityPool* CEntityPool::Find(const void* pv_block) {
+      const char* pchBlock = static_cast<const char*>(pv_block);
+      std::lock_guard<std::mutex> cLock(GetChunkMapMutex());
+      TChunkMap& mapChunks = GetChunkMap();
+      /* The last chunk starting at or before the block */
+      TChunkMap::const_iterator it = mapChunks.upper_bound(pchBlock);
+      if(it == mapChunks.begin()) return nullptr;
+      --it;
+      return (pchBlock < it->second.first) ? it->second.second : nullptr;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void* CEntityPool::Allocate(size_t un_size) {
+      /* Keep every block aligned like the memory returned by new */
+      const size_t unAlign = alignof(std::max_align_t);
+      un_size = (un_size + unAlign - 1) & ~(unAlign - 1);
+      if(un_size > m_unFreeBytes) {
+         /* Start a new chunk, larger than usual if the block does not fit */
+         size_t unChunkSize = std::max(m_unChunkSize, un_size);
+         m_vecChunks.push_back(static_cast<char*>(::operator new(unChunkSize)));
+         m_pchNext = m_vecChunks.back();
+         m_unFreeBytes = unChunkSize;
+         std::lock_guard<std::mutex> cLock(GetChunkMapMutex());
+         GetChunkMap()[m_pchNext] = std::make_pair(m_pchNext + unChunkSize, this);
+      }
+      void* pvBlock = m_pchNext;
+      m_pchNext += un_size;
+      m_unFreeBytes -= un_size;
+      m_unUsedBytes += un_size;
+      ++m_unEntities;
+      ++m_unReferences;
+      return pvBlock;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CEntityPool::Release() {
+      --m_unEntities;
+      Unreference();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CEntityPool::Unreference() {
+      /* The thread that drops the last reference deletes the pool */
+      if(m_unReferences.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+         delete this;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CEntityPool::CEntityPool(size_t un_chunk_size) :
+      m_unChunkSize(un_chunk_size),
+      m_pchNext(nullptr),
+      m_unFreeBytes(0),
+      m_unUsedBytes(0),
+      m_unEntities(0),
+      m_unReferences(1) {}
+
+   /****************************************/
+   /****************************************/
+
+   CEntityPool::~CEntityPool() {
+      {
+         std::lock_guard<std::mutex> cLock(GetChunkMapMutex());
+         for(char* pch_chunk : m_vecChunks) {
+            GetChunkMap().erase(pch_chunk);
+         }
+      }
+      for(char* pch_chunk : m_vecChunks) {
+         ::operator delete(pch_chunk);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
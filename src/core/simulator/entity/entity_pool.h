@@ -0,0 +1,220 @@
+/**
+ * @file <argos3/core/simulator/entity/entity_pool.h>
+ *
+ * @brief This file contains the definition of the entity pool.
+ *
+ * The entity pool stores an entity and its components in a few contiguous
+ * chunks of memory, which are released at once when the last entity in the
+ * pool is deleted.
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef ENTITY_POOL_H
+#define ENTITY_POOL_H
+
+namespace argos {
+   class CEntityPool;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * A pool of memory for a tree of entities.
+    * <p>
+    * A composable entity such as a robot creates its components one by one
+    * with <tt>new</tt> in its Init() method. On the plain heap, the components
+    * of a robot end up scattered among those of the other robots, and the
+    * per-step updates of the components jump around in memory.
+    * </p>
+    * <p>
+    * The pool is used only when ARGoS is compiled with ARGOS_ENTITY_POOL.
+    * Otherwise, CEntity does not override <tt>new</tt> and the entities always
+    * come from the heap.
+    * </p>
+    * <p>
+    * While a CEntityPool::CScope is alive, CEntity::operator new takes the
+    * memory of the new entities from the pool of the scope, one after the
+    * other. The entity and its components then lie next to each other in
+    * memory. The pool counts the entities it holds, and releases all of its
+    * memory when the scope is closed and the last entity is deleted. The
+    * memory of an entity deleted before the others is reused only when the
+    * whole pool is released.
+    * </p>
+    * <p>
+    * CSpace opens a scope for each root entity it creates from the XML
+    * configuration. Loop functions that create entities with <tt>new</tt> can
+    * do the same:
+    * </p>
+    * <pre>
+    * CFootBotEntity* pcFB;
+    * {
+    *    CEntityPool::CScope cScope;
+    *    pcFB = new CFootBotEntity("fb", "ctrl", CVector3(1, 1, 0));
+    * }
+    * AddEntity(*pcFB);
+    * </pre>
+    * Entities created outside of any scope come from the heap as usual.
+    * Scopes are per thread and can be nested; the innermost one is used.
+    * <p>
+    * A pool hands out memory only in the thread that opened its scope, so
+    * Allocate() needs no lock. The entities of a pool can be deleted in any
+    * thread: the scope and each entity hold a reference to the pool, counted
+    * atomically, and the pool is deleted with the last reference.
+    * </p>
+    * @see CEntity
+    */
+   class CEntityPool {
+
+   public:
+
+      /**
+       * Opens a new pool, and makes it the current pool of this thread until
+       * the scope is destroyed.
+       */
+      class CScope {
+
+      public:
+
+         /**
+          * Class constructor.
+          * @param un_chunk_size The size in bytes of the chunks of the pool.
+          */
+         CScope(size_t un_chunk_size = DEFAULT_CHUNK_SIZE);
+
+         /**
+          * Class destructor.
+          * Restores the previous pool as the current one.
+          */
+         ~CScope();
+
+         /**
+          * Returns the pool of this scope.
+          * @return The pool of this scope.
+          */
+         inline CEntityPool& GetPool() {
+            return *m_pcPool;
+         }
+
+      private:
+
+         CScope(const CScope&) = delete;
+         CScope& operator=(const CScope&) = delete;
+
+      private:
+
+         CEntityPool* m_pcPool;
+         CEntityPool* m_pcPrevious;
+
+      };
+
+   public:
+
+      /** The default size in bytes of the chunks of a pool */
+      static const size_t DEFAULT_CHUNK_SIZE;
+
+   public:
+
+      /**
+       * Returns the current pool of this thread.
+       * @return The current pool of this thread, or <tt>nullptr</tt> if no scope is open.
+       */
+      static CEntityPool* GetCurrent();
+
+      /**
+       * Returns the pool that holds the given memory block.
+       * This method is used internally by CEntity::operator delete, don't use it in your code.
+       * @param pv_block The memory block.
+       * @return The pool that holds the block, or <tt>nullptr</tt> if the block comes from the heap.
+       */
+      static CEntityPool* Find(const void* pv_block);
+
+      /**
+       * Returns the number of entities in the pool.
+       * @return The number of entities in the pool.
+       */
+      inline size_t GetNumEntities() const {
+         return m_unEntities;
+      }
+
+      /**
+       * Returns the number of bytes taken from the chunks of the pool.
+       * @return The number of bytes taken from the chunks of the pool.
+       */
+      inline size_t GetUsedBytes() const {
+         return m_unUsedBytes;
+      }
+
+      /**
+       * Returns the number of chunks of the pool.
+       * @return The number of chunks of the pool.
+       */
+      inline size_t GetNumChunks() const {
+         return m_vecChunks.size();
+      }
+
+      /**
+       * Returns memory for a new entity.
+       * This method must be called in the thread that opened the scope of the pool.
+       * This method is used internally by CEntity::operator new, don't use it in your code.
+       * @param un_size The size in bytes of the memory block.
+       * @return The memory block, aligned like the memory returned by <tt>new</tt>.
+       */
+      void* Allocate(size_t un_size);
+
+      /**
+       * Notifies the pool that one of its entities was deleted.
+       * The pool destroys itself when its scope is closed and it has no entities left.
+       * This method can be called in any thread.
+       * This method is used internally by CEntity::operator delete, don't use it in your code.
+       */
+      void Release();
+
+   private:
+
+      CEntityPool(size_t un_chunk_size);
+
+      ~CEntityPool();
+
+      CEntityPool(const CEntityPool&) = delete;
+      CEntityPool& operator=(const CEntityPool&) = delete;
+
+   private:
+
+      /** The size of a new chunk */
+      size_t m_unChunkSize;
+
+      /** The chunks of memory */
+      std::vector<char*> m_vecChunks;
+
+      /** The first free byte in the last chunk */
+      char* m_pchNext;
+
+      /** The number of free bytes in the last chunk */
+      size_t m_unFreeBytes;
+
+      /** The number of bytes given to entities */
+      size_t m_unUsedBytes;
+
+      /** The number of entities in the pool */
+      std::atomic<size_t> m_unEntities;
+
+      /** The number of references to the pool: one for the scope, one per entity */
+      std::atomic<size_t> m_unReferences;
+
+      /**
+       * Drops a reference to the pool, and deletes the pool if it was the last one.
+       */
+      void Unreference();
+
+   };
+
+}
+
+#endif
@@ -8,9 +8,13 @@
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/loop_functions.h>
+#include <map>
 
 #ifdef ARGOS_WITH_FREEIMAGE
 #include <FreeImagePlus.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
 #endif
 
 namespace argos {
@@ -19,11 +23,52 @@ namespace argos {
    /****************************************/
 
 #ifdef ARGOS_WITH_FREEIMAGE
+   /*
+    * The images loaded by the floor entities, indexed by path and time of
+    * last modification, so that an image changed on disk is loaded again on
+    * Reset(). The images are never modified, so all the floors of the process
+    * share them, including the replicas of an ensemble forked after the
+    * images were loaded.
+    */
+   typedef std::map<std::pair<std::string, time_t>, fipImage> TImageCache;
+
+   static TImageCache& GetImageCache() {
+      static TImageCache mapImages;
+      return mapImages;
+   }
+
+   static const fipImage& GetCachedImage(const std::string& str_path) {
+      struct stat sStat;
+      if(::stat(str_path.c_str(), &sStat) != 0) {
+         THROW_ARGOSEXCEPTION("Could not load image \"" <<
+                              str_path <<
+                              "\": " <<
+                              ::strerror(errno));
+      }
+      TImageCache& mapImages = GetImageCache();
+      std::pair<std::string, time_t> cKey(str_path, sStat.st_mtime);
+      TImageCache::iterator it = mapImages.find(cKey);
+      if(it == mapImages.end()) {
+         it = mapImages.insert(std::make_pair(cKey, fipImage())).first;
+         if(!it->second.load(str_path.c_str())) {
+            mapImages.erase(it);
+            THROW_ARGOSEXCEPTION("Could not load image \"" <<
+                                 str_path <<
+                                 "\"");
+         }
+      }
+      return it->second;
+   }
+
+   /****************************************/
+   /****************************************/
+
    class CFloorColorFromImageFile : public CFloorEntity::CFloorColorSource {
 
    public:
 
-      CFloorColorFromImageFile(const std::string& str_path) {
+      CFloorColorFromImageFile(const std::string& str_path) :
+         m_pcImage(nullptr) {
          const CVector3& cArenaSize = CSimulator::GetInstance().GetSpace().GetArenaSize();
          m_cHalfArenaSize.Set(
             cArenaSize.GetX() * 0.5f,
@@ -44,16 +89,16 @@ namespace argos {
          UInt32 x = static_cast<UInt32>((f_x + m_cHalfArenaSize.GetX()) * m_fArenaToImageCoordinateXFactor);
          UInt32 y = static_cast<UInt32>((f_y + m_cHalfArenaSize.GetY()) * m_fArenaToImageCoordinateYFactor);
          /* Check the bit depth */
-         if(m_cImage.getBitsPerPixel() <= 8) {
+         if(m_pcImage->getBitsPerPixel() <= 8) {
             RGBQUAD* ptColorPalette;
             BYTE tPixelIndex;
             /* 1, 4 or 8 bits per pixel */
-            if(! m_cImage.getPixelIndex(x, y, &tPixelIndex)) {
+            if(! m_pcImage->getPixelIndex(x, y, &tPixelIndex)) {
                THROW_ARGOSEXCEPTION("Unable to access image pixel at (" << x << "," << y <<
-                                    "). Image size (" << m_cImage.getWidth() << "," <<
-                                    m_cImage.getHeight() << ")");
+                                    "). Image size (" << m_pcImage->getWidth() << "," <<
+                                    m_pcImage->getHeight() << ")");
             }
-            ptColorPalette = m_cImage.getPalette();
+            ptColorPalette = m_pcImage->getPalette();
             return CColor(ptColorPalette[tPixelIndex].rgbRed,
                           ptColorPalette[tPixelIndex].rgbGreen,
                           ptColorPalette[tPixelIndex].rgbBlue);
@@ -61,10 +106,10 @@ namespace argos {
          else {
             /* 16, 24 or 32 bits per pixel */
             RGBQUAD tColorPixel;
-            if(! m_cImage.getPixelColor(x, y, &tColorPixel)) {
+            if(! m_pcImage->getPixelColor(x, y, &tColorPixel)) {
                THROW_ARGOSEXCEPTION("Unable to access image pixel at (" << x << "," << y <<
-                                    "). Image size (" << m_cImage.getWidth() << "," <<
-                                    m_cImage.getHeight() << ")");
+                                    "). Image size (" << m_pcImage->getWidth() << "," <<
+                                    m_pcImage->getHeight() << ")");
             }
             return CColor(tColorPixel.rgbRed,
                           tColorPixel.rgbGreen,
@@ -74,7 +119,9 @@ namespace argos {
 
       virtual void SaveAsImage(const std::string& str_path) {
          m_strImageFileName = str_path;
-         m_cImage.save(str_path.c_str());
+         /* Save a copy, the cached image is shared with the other floors */
+         fipImage cImage(*m_pcImage);
+         cImage.save(str_path.c_str());
       }
 
       virtual const std::string& GetImageFileName() const {
@@ -85,19 +132,15 @@ namespace argos {
 
       void LoadImage(const std::string& str_path) {
          m_strImageFileName = str_path;
-         if(!m_cImage.load(m_strImageFileName.c_str())) {
-            THROW_ARGOSEXCEPTION("Could not load image \"" <<
-                                 m_strImageFileName <<
-                                 "\"");
-         }
+         m_pcImage = &GetCachedImage(m_strImageFileName);
          const CVector3& cArenaSize = CSimulator::GetInstance().GetSpace().GetArenaSize();
-         m_fArenaToImageCoordinateXFactor = m_cImage.getWidth() / cArenaSize.GetX();
-         m_fArenaToImageCoordinateYFactor = m_cImage.getHeight() / cArenaSize.GetY();
+         m_fArenaToImageCoordinateXFactor = m_pcImage->getWidth() / cArenaSize.GetX();
+         m_fArenaToImageCoordinateYFactor = m_pcImage->getHeight() / cArenaSize.GetY();
       }
 
    private:
 
-      fipImage m_cImage;
+      const fipImage* m_pcImage;
       Real m_fArenaToImageCoordinateXFactor;
       Real m_fArenaToImageCoordinateYFactor;
       CVector2 m_cHalfArenaSize;
@@ -173,7 +216,16 @@ namespace argos {
       CEntity(nullptr),
       m_eColorSource(UNSET),
       m_pcColorSource(nullptr),
-      m_bHasChanged(true) {}
+      m_bHasChanged(true),
+      m_unRasterPixelsPerMeter(0),
+      m_bRasterBilinear(false),
+      m_bRasterParallel(false),
+      m_nRasterWidth(0),
+      m_nRasterHeight(0),
+      m_nDirtyMinX(0),
+      m_nDirtyMinY(0),
+      m_nDirtyMaxX(0),
+      m_nDirtyMaxY(0) {}
 
    /****************************************/
    /****************************************/
@@ -184,7 +236,16 @@ namespace argos {
       CEntity(nullptr, str_id),
       m_eColorSource(FROM_IMAGE),
       m_pcColorSource(nullptr),
-      m_bHasChanged(true) {
+      m_bHasChanged(true),
+      m_unRasterPixelsPerMeter(0),
+      m_bRasterBilinear(false),
+      m_bRasterParallel(false),
+      m_nRasterWidth(0),
+      m_nRasterHeight(0),
+      m_nDirtyMinX(0),
+      m_nDirtyMinY(0),
+      m_nDirtyMaxX(0),
+      m_nDirtyMaxY(0) {
       std::string strFileName = str_file_name;
       ExpandEnvVariables(strFileName);
       m_pcColorSource = new CFloorColorFromImageFile(strFileName);
@@ -199,7 +260,16 @@ namespace argos {
       CEntity(nullptr, str_id),
       m_eColorSource(FROM_LOOP_FUNCTIONS),
       m_pcColorSource(new CFloorColorFromLoopFunctions(un_pixels_per_meter)),
-      m_bHasChanged(true) {}
+      m_bHasChanged(true),
+      m_unRasterPixelsPerMeter(0),
+      m_bRasterBilinear(false),
+      m_bRasterParallel(false),
+      m_nRasterWidth(0),
+      m_nRasterHeight(0),
+      m_nDirtyMinX(0),
+      m_nDirtyMinY(0),
+      m_nDirtyMaxX(0),
+      m_nDirtyMaxY(0) {}
 
    /****************************************/
    /****************************************/
@@ -245,13 +315,194 @@ namespace argos {
                               GetId() <<
                               "\"");
       }
+      /* Parse the raster configuration */
+      UInt32 unRasterPixelsPerMeter = 0;
+      GetNodeAttributeOrDefault(t_tree, "raster_pixels_per_meter", unRasterPixelsPerMeter, unRasterPixelsPerMeter);
+      std::string strRasterSampling = "nearest";
+      GetNodeAttributeOrDefault(t_tree, "raster_sampling", strRasterSampling, strRasterSampling);
+      if(strRasterSampling != "nearest" && strRasterSampling != "bilinear") {
+         THROW_ARGOSEXCEPTION("Unknown raster sampling \"" <<
+                              strRasterSampling <<
+                              "\" for the floor entity \"" <<
+                              GetId() <<
+                              "\", use \"nearest\" or \"bilinear\"");
+      }
+      bool bRasterParallel = false;
+      GetNodeAttributeOrDefault(t_tree, "raster_parallel", bRasterParallel, bRasterParallel);
+      SetRaster(unRasterPixelsPerMeter, strRasterSampling == "bilinear", bRasterParallel);
    }
 
    /****************************************/
    /****************************************/
 
+#ifdef ARGOS_WITH_FREEIMAGE
+   void CFloorEntity::PreloadImage(const std::string& str_path) {
+      std::string strPath = str_path;
+      ExpandEnvVariables(strPath);
+      GetCachedImage(strPath);
+   }
+#endif
+
+   /****************************************/
+   /****************************************/
+
    void CFloorEntity::Reset() {
       m_pcColorSource->Reset();
+      SetChanged();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CFloorEntity::Update() {
+      if(m_nDirtyMinX >= m_nDirtyMaxX || m_nDirtyMinY >= m_nDirtyMaxY) return;
+      if(m_bRasterParallel) {
+         /* Each thread takes whole rows */
+         CSimulator::GetInstance().GetSpace().ParallelFor(
+            m_nDirtyMaxY - m_nDirtyMinY,
+            1,
+            [this](size_t, size_t un_begin, size_t un_end) {
+               for(size_t i = un_begin; i < un_end; ++i) {
+                  UpdateRasterRow(m_nDirtyMinY + static_cast<SInt32>(i));
+               }
+            });
+      }
+      else {
+         for(SInt32 nY = m_nDirtyMinY; nY < m_nDirtyMaxY; ++nY) {
+            UpdateRasterRow(nY);
+         }
+      }
+      m_nDirtyMinX = m_nDirtyMaxX = 0;
+      m_nDirtyMinY = m_nDirtyMaxY = 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CFloorEntity::UpdateRasterRow(SInt32 n_y) {
+      /* Sample the color source at the center of the changed pixels */
+      Real fPixelSize = 1.0 / m_unRasterPixelsPerMeter;
+      Real fY = m_cRasterOrigin.GetY() + (n_y + 0.5) * fPixelSize;
+      CColor* pcRow = &m_vecRaster[static_cast<size_t>(n_y) * m_nRasterWidth];
+      for(SInt32 nX = m_nDirtyMinX; nX < m_nDirtyMaxX; ++nX) {
+         pcRow[nX] = m_pcColorSource->GetColorAtPoint(
+            m_cRasterOrigin.GetX() + (nX + 0.5) * fPixelSize,
+            fY);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CFloorEntity::SetRaster(UInt32 un_pixels_per_meter,
+                                bool b_bilinear,
+                                bool b_parallel) {
+      m_unRasterPixelsPerMeter = un_pixels_per_meter;
+      m_bRasterBilinear = b_bilinear;
+      m_bRasterParallel = b_parallel;
+      m_vecRaster.clear();
+      m_nRasterWidth = m_nRasterHeight = 0;
+      m_nDirtyMinX = m_nDirtyMaxX = 0;
+      m_nDirtyMinY = m_nDirtyMaxY = 0;
+      if(m_unRasterPixelsPerMeter == 0) return;
+      /* The raster covers the arena */
+      const CVector3& cArenaSize = CSimulator::GetInstance().GetSpace().GetArenaSize();
+      const CVector3& cArenaCenter = CSimulator::GetInstance().GetSpace().GetArenaCenter();
+      m_cRasterOrigin.Set(cArenaCenter.GetX() - cArenaSize.GetX() * 0.5,
+                          cArenaCenter.GetY() - cArenaSize.GetY() * 0.5);
+      m_nRasterWidth  = Max<SInt32>(1, static_cast<SInt32>(Ceil(cArenaSize.GetX() * m_unRasterPixelsPerMeter)));
+      m_nRasterHeight = Max<SInt32>(1, static_cast<SInt32>(Ceil(cArenaSize.GetY() * m_unRasterPixelsPerMeter)));
+      m_vecRaster.resize(static_cast<size_t>(m_nRasterWidth) * m_nRasterHeight);
+      /* Calculate the whole raster at the next update */
+      SetChanged();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CFloorEntity::SetChanged() {
+      m_bHasChanged = true;
+      m_nDirtyMinX = 0;
+      m_nDirtyMinY = 0;
+      m_nDirtyMaxX = m_nRasterWidth;
+      m_nDirtyMaxY = m_nRasterHeight;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CFloorEntity::SetChanged(const CVector2& c_min_corner,
+                                 const CVector2& c_max_corner) {
+      m_bHasChanged = true;
+      if(m_unRasterPixelsPerMeter == 0) return;
+      /* Get the pixels in the rectangle, with the ones that interpolate them */
+      SInt32 nMinX = static_cast<SInt32>(Floor((c_min_corner.GetX() - m_cRasterOrigin.GetX()) * m_unRasterPixelsPerMeter)) - 1;
+      SInt32 nMinY = static_cast<SInt32>(Floor((c_min_corner.GetY() - m_cRasterOrigin.GetY()) * m_unRasterPixelsPerMeter)) - 1;
+      SInt32 nMaxX = static_cast<SInt32>(Floor((c_max_corner.GetX() - m_cRasterOrigin.GetX()) * m_unRasterPixelsPerMeter)) + 2;
+      SInt32 nMaxY = static_cast<SInt32>(Floor((c_max_corner.GetY() - m_cRasterOrigin.GetY()) * m_unRasterPixelsPerMeter)) + 2;
+      nMinX = Max<SInt32>(nMinX, 0);
+      nMinY = Max<SInt32>(nMinY, 0);
+      nMaxX = Min<SInt32>(nMaxX, m_nRasterWidth);
+      nMaxY = Min<SInt32>(nMaxY, m_nRasterHeight);
+      if(nMinX >= nMaxX || nMinY >= nMaxY) return;
+      /* Merge with the pixels already marked */
+      if(m_nDirtyMinX >= m_nDirtyMaxX || m_nDirtyMinY >= m_nDirtyMaxY) {
+         m_nDirtyMinX = nMinX;
+         m_nDirtyMinY = nMinY;
+         m_nDirtyMaxX = nMaxX;
+         m_nDirtyMaxY = nMaxY;
+      }
+      else {
+         m_nDirtyMinX = Min(m_nDirtyMinX, nMinX);
+         m_nDirtyMinY = Min(m_nDirtyMinY, nMinY);
+         m_nDirtyMaxX = Max(m_nDirtyMaxX, nMaxX);
+         m_nDirtyMaxY = Max(m_nDirtyMaxY, nMaxY);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CColor CFloorEntity::GetRasterColorAtPoint(Real f_x,
+                                              Real f_y) {
+      /* Position in pixels, with the pixel centers on integer coordinates */
+      Real fU = (f_x - m_cRasterOrigin.GetX()) * m_unRasterPixelsPerMeter - 0.5;
+      Real fV = (f_y - m_cRasterOrigin.GetY()) * m_unRasterPixelsPerMeter - 0.5;
+      SInt32 nX = static_cast<SInt32>(Floor(fU));
+      SInt32 nY = static_cast<SInt32>(Floor(fV));
+      /* Outside the arena or in a changed part, ask the color source */
+      if(nX < -1 || nX >= m_nRasterWidth ||
+         nY < -1 || nY >= m_nRasterHeight ||
+         (nX + 1 >= m_nDirtyMinX && nX < m_nDirtyMaxX &&
+          nY + 1 >= m_nDirtyMinY && nY < m_nDirtyMaxY)) {
+         return m_pcColorSource->GetColorAtPoint(f_x, f_y);
+      }
+      /* The pixels around the point, clamped to the raster */
+      SInt32 nX0 = Max<SInt32>(nX, 0);
+      SInt32 nY0 = Max<SInt32>(nY, 0);
+      SInt32 nX1 = Min<SInt32>(nX + 1, m_nRasterWidth - 1);
+      SInt32 nY1 = Min<SInt32>(nY + 1, m_nRasterHeight - 1);
+      if(! m_bRasterBilinear) {
+         /* Take the closest pixel */
+         return m_vecRaster[static_cast<size_t>(fV - nY < 0.5 ? nY0 : nY1) * m_nRasterWidth +
+                            (fU - nX < 0.5 ? nX0 : nX1)];
+      }
+      /* Interpolate the four pixels around the point */
+      const CColor& cC00 = m_vecRaster[static_cast<size_t>(nY0) * m_nRasterWidth + nX0];
+      const CColor& cC10 = m_vecRaster[static_cast<size_t>(nY0) * m_nRasterWidth + nX1];
+      const CColor& cC01 = m_vecRaster[static_cast<size_t>(nY1) * m_nRasterWidth + nX0];
+      const CColor& cC11 = m_vecRaster[static_cast<size_t>(nY1) * m_nRasterWidth + nX1];
+      Real fTX = fU - nX;
+      Real fTY = fV - nY;
+      Real fW00 = (1.0 - fTX) * (1.0 - fTY);
+      Real fW10 = fTX * (1.0 - fTY);
+      Real fW01 = (1.0 - fTX) * fTY;
+      Real fW11 = fTX * fTY;
+      return CColor(
+         static_cast<UInt8>(fW00 * cC00.GetRed()   + fW10 * cC10.GetRed()   + fW01 * cC01.GetRed()   + fW11 * cC11.GetRed()   + 0.5),
+         static_cast<UInt8>(fW00 * cC00.GetGreen() + fW10 * cC10.GetGreen() + fW01 * cC01.GetGreen() + fW11 * cC11.GetGreen() + 0.5),
+         static_cast<UInt8>(fW00 * cC00.GetBlue()  + fW10 * cC10.GetBlue()  + fW01 * cC01.GetBlue()  + fW11 * cC11.GetBlue()  + 0.5),
+         static_cast<UInt8>(fW00 * cC00.GetAlpha() + fW10 * cC10.GetAlpha() + fW01 * cC01.GetAlpha() + fW11 * cC11.GetAlpha() + 0.5));
    }
 
    /****************************************/
@@ -317,7 +568,29 @@ namespace argos {
                    "    ...\n"
                    "  </arena>\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
-                   "None for the time being.\n",
+                   "The robots' ground sensors ask the color source for the floor color at each\n"
+                   "step. When the color comes from the loop functions, this can be slow, and the\n"
+                   "loop functions are called from several threads at once. With the attribute\n"
+                   "'raster_pixels_per_meter', the floor color is instead sampled once into a\n"
+                   "raster with the given resolution, and the ground sensors read the raster.\n"
+                   "The loop functions must then call SetChanged() on the floor entity when the\n"
+                   "floor color changes, optionally passing the rectangle that changed, and the\n"
+                   "changed pixels are sampled again at the beginning of the next step. The\n"
+                   "attribute 'raster_sampling' chooses how the raster is read: 'nearest' (the\n"
+                   "default) takes the closest pixel, 'bilinear' interpolates the four closest\n"
+                   "pixels. When the attribute 'raster_parallel' is 'true', the changed rows of the\n"
+                   "raster are sampled by the ARGoS threads, so the loop functions are called from\n"
+                   "several threads at once and GetFloorColor() must not modify shared state:\n\n"
+                   "  <arena ...>\n"
+                   "    ...\n"
+                   "    <floor id=\"floor\"\n"
+                   "           source=\"loop_functions\"\n"
+                   "           pixels_per_meter=\"100\"\n"
+                   "           raster_pixels_per_meter=\"100\"\n"
+                   "           raster_sampling=\"nearest\"\n"
+                   "           raster_parallel=\"false\" />\n"
+                   "    ...\n"
+                   "  </arena>\n",
                    "Usable"
       );
 
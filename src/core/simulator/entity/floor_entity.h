@@ -15,6 +15,7 @@ namespace argos {
 #include <argos3/core/utility/math/vector2.h>
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/core/utility/datatypes/color.h>
+#include <vector>
 
 namespace argos {
 
@@ -90,11 +91,22 @@ namespace argos {
        */
       virtual void Reset();
 
+      /**
+       * Calculates again the parts of the raster marked as changed.
+       * The space calls this method once per step, before the robots sense.
+       * @see SetRaster
+       */
+      virtual void Update();
+
       /**
        * Returns the color at the given point.
+       * If the floor is rasterized, the color is sampled from the raster,
+       * unless the point lies outside the arena or in a part of the raster
+       * that has changed since the last update.
        * @param f_x The x coordinate on the floor
        * @param f_y The y coordinate on the floor
        * @returns the color at the given point
+       * @see SetRaster
        */
       inline CColor GetColorAtPoint(Real f_x,
                                     Real f_y) {
@@ -102,9 +114,51 @@ namespace argos {
                       "The floor entity \"" <<
                       GetId() <<
                       "\" has no associated color source.");
+         if(m_unRasterPixelsPerMeter > 0) {
+            return GetRasterColorAtPoint(f_x, f_y);
+         }
          return m_pcColorSource->GetColorAtPoint(f_x, f_y);
       }
 
+      /**
+       * Rasterizes the floor color.
+       * The color source is sampled at the center of each pixel of the raster,
+       * and the raster then answers GetColorAtPoint() with no call to the
+       * color source. When the floor color changes, call SetChanged() to
+       * have the changed part of the raster calculated again at the next step.
+       * The raster is only read while the robots sense, so several threads can
+       * use it at the same time.
+       * The changed rows of the raster can be calculated by the ARGoS threads,
+       * through CSpace::ParallelFor(). In this case, the color source is
+       * called by several threads at once, and it must be thread-safe; for
+       * the loop functions, this means that CLoopFunctions::GetFloorColor()
+       * must not modify shared state.
+       * @param un_pixels_per_meter The resolution of the raster, or 0 to disable it.
+       * @param b_bilinear <tt>true</tt> to interpolate among the closest pixels, <tt>false</tt> to take the closest pixel.
+       * @param b_parallel <tt>true</tt> to calculate the raster with the ARGoS threads.
+       */
+      void SetRaster(UInt32 un_pixels_per_meter,
+                     bool b_bilinear = false,
+                     bool b_parallel = false);
+
+      /**
+       * Returns the resolution of the raster, in pixels per meter.
+       * @return the resolution of the raster, or 0 if the floor is not rasterized.
+       * @see SetRaster
+       */
+      inline UInt32 GetRasterPixelsPerMeter() const {
+         return m_unRasterPixelsPerMeter;
+      }
+
+      /**
+       * Returns <tt>true</tt> if the raster is calculated by the ARGoS threads.
+       * @return <tt>true</tt> if the raster is calculated by the ARGoS threads.
+       * @see SetRaster
+       */
+      inline bool IsRasterParallel() const {
+         return m_bRasterParallel;
+      }
+
       /**
        * Returns <tt>true</tt> if the floor color has changed.
        * It is mainly used by the OpenGL visualization to know when to create a new texture.
@@ -116,11 +170,21 @@ namespace argos {
 
       /**
        * Marks the floor color as changed.
+       * If the floor is rasterized, the whole raster is calculated again.
        * @see HasChanged
        */
-      inline void SetChanged() {
-         m_bHasChanged = true;
-      }
+      void SetChanged();
+
+      /**
+       * Marks the floor color as changed in the given rectangle.
+       * If the floor is rasterized, only the pixels in the rectangle are
+       * calculated again.
+       * @param c_min_corner The corner of the rectangle with the smallest coordinates.
+       * @param c_max_corner The corner of the rectangle with the largest coordinates.
+       * @see HasChanged
+       */
+      void SetChanged(const CVector2& c_min_corner,
+                      const CVector2& c_max_corner);
 
       /**
        * Marks the floor color as not changed.
@@ -144,6 +208,25 @@ namespace argos {
          return "floor";
       }
 
+#ifdef ARGOS_WITH_FREEIMAGE
+      /**
+       * Loads an image into the cache shared by all the floor entities.
+       * The floor entities that use this image will not load it again,
+       * unless the file is modified afterwards.
+       * The given path can include environment variables, which are expanded
+       * internally.
+       * @param str_path The path of the image.
+       */
+      static void PreloadImage(const std::string& str_path);
+#endif
+
+   private:
+
+      CColor GetRasterColorAtPoint(Real f_x,
+                                   Real f_y);
+
+      void UpdateRasterRow(SInt32 n_y);
+
    private:
 
       /**
@@ -160,6 +243,46 @@ namespace argos {
        * Set to <tt>true</tt> when the floor color has changed.
        */
       bool               m_bHasChanged;
+
+      /**
+       * The resolution of the raster, or 0 if the floor is not rasterized.
+       */
+      UInt32             m_unRasterPixelsPerMeter;
+
+      /**
+       * Set to <tt>true</tt> to interpolate among the raster pixels.
+       */
+      bool               m_bRasterBilinear;
+
+      /**
+       * Set to <tt>true</tt> to calculate the raster with the ARGoS threads.
+       */
+      bool               m_bRasterParallel;
+
+      /**
+       * The position of the corner of the raster with the smallest coordinates.
+       */
+      CVector2           m_cRasterOrigin;
+
+      /**
+       * The size of the raster in pixels.
+       */
+      SInt32             m_nRasterWidth;
+      SInt32             m_nRasterHeight;
+
+      /**
+       * The raster pixels, row by row.
+       */
+      std::vector<CColor> m_vecRaster;
+
+      /**
+       * The pixels to calculate again, as [min,max) ranges.
+       * The range is empty when min >= max.
+       */
+      SInt32             m_nDirtyMinX;
+      SInt32             m_nDirtyMinY;
+      SInt32             m_nDirtyMaxX;
+      SInt32             m_nDirtyMaxY;
    };
 }
 
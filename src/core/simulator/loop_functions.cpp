@@ -11,6 +11,11 @@
 
 namespace argos {
 
+   /****************************************/
+   /****************************************/
+
+   const size_t CLoopFunctions::MAP_REDUCE_MAX_CHUNKS = 256;
+
    /****************************************/
    /****************************************/
    
@@ -17,6 +17,8 @@ namespace argos {
 }
 
 #include <functional>
+#include <string>
+#include <vector>
 
 #include <argos3/core/utility/configuration/base_configurable_resource.h>
 #include <argos3/core/simulator/simulator.h>
@@ -218,6 +220,8 @@ namespace argos {
        * Important: the entity must be created with a <tt>new</tt> statement or a CFactory::New() statement.
        * In other words, the entity must be stored in the heap.
        * If this is not the case, memory corruption will occur.
+       * When ARGoS is compiled with ARGOS_ENTITY_POOL, create the entity while
+       * a CEntityPool::CScope is open to keep its components together in memory.
        * @param c_entity A reference to the entity to add.
        * @throws CARGoSException if an error occurs.
        */
@@ -253,18 +257,185 @@ namespace argos {
       * - Entity removal
       * - Creating a new entity based on the current one
       *
-      * Furthermore, iteration over controllable entities can be performed AT
-      * MOST twice in one timestep: one time in PreStep(), and one time in
-      * PostStep(). Mutiple iteration attempts in either function will cause a
-      * deadlock due to how iteration is implemented.
+      * The iteration can be performed any number of times in PreStep() and
+      * PostStep(). Elsewhere, it runs in the calling thread.
       *
       * @see PostStep()
       * @see PreStep()
+      * @see CSpace::ParallelFor()
       */
       void IterateOverControllableEntities(const CSpace::TControllableEntityIterCBType& c_cb) const {
         m_cSpace.IterateOverControllableEntities(c_cb);
       }
 
+     /**
+      * \brief Iterate over all the entities of the given type, executing the
+      * specified callback on each.
+      *
+      * The entities are those returned by CSpace::GetEntitiesByType(), and
+      * the callback receives them as <tt>ENTITY&</tt>. Like
+      * IterateOverControllableEntities(), the callback is executed by the
+      * ARGoS threads in PreStep() and PostStep(), with the same restrictions.
+      * If there is no entity of the given type, the callback is not called.
+      * <pre>
+      * IterateOverEntities<CBoxEntity>("box", [](CBoxEntity& c_box) {
+      *    // do stuff with the box ...
+      * });
+      * </pre>
+      *
+      * @param str_type The type of the entities, as returned by CEntity::GetTypeDescription().
+      * @param c_cb The callback.
+      * @throws CARGoSException if the entities of the given type are not of class <tt>ENTITY</tt>.
+      */
+      template <typename ENTITY, typename CALLBACK>
+      void IterateOverEntities(const std::string& str_type,
+                               CALLBACK c_cb) const {
+         std::vector<ENTITY*> vecEntities = GetEntityVector<ENTITY>(str_type);
+         m_cSpace.ParallelFor(
+            vecEntities.size(),
+            Max<size_t>(1, vecEntities.size() / (Max<UInt32>(1, m_cSimulator.GetNumThreads()) * 4)),
+            [&vecEntities, &c_cb](size_t, size_t un_begin, size_t un_end) {
+               for(size_t i = un_begin; i < un_end; ++i) {
+                  c_cb(*vecEntities[i]);
+               }
+            });
+      }
+
+     /**
+      * \brief Computes a value over the items in <tt>[0, un_items)</tt> using
+      * the ARGoS threads.
+      *
+      * The items are split into at most MAP_REDUCE_MAX_CHUNKS chunks of
+      * consecutive items. Each chunk has its own accumulator, which starts as
+      * a copy of <tt>t_init</tt>; <tt>c_map(tAccumulator, i)</tt> adds item
+      * <tt>i</tt> to the accumulator of its chunk. Once all the chunks are
+      * done, the calling thread combines the accumulators in chunk order with
+      * <tt>c_reduce(tResult, tChunkAccumulator)</tt>. The chunks depend only
+      * on the number of items, so the result does not depend on the number of
+      * threads, not even for the rounding of floating point sums. Note that
+      * <tt>c_map</tt> can be called by several threads at once, each on the
+      * accumulator of a different chunk.
+      *
+      * As for IterateOverControllableEntities(), the ARGoS threads are used in
+      * PreStep() and PostStep(); elsewhere, the computation runs in the
+      * calling thread. Computing the number of robots in an area:
+      * <pre>
+      * size_t unInNest = MapReduce(
+      *    vecRobots.size(), size_t(0),
+      *    [&](size_t& un_count, size_t i) { if(InNest(*vecRobots[i])) ++un_count; },
+      *    [](size_t& un_total, size_t un_count) { un_total += un_count; });
+      * </pre>
+      *
+      * @param un_items The number of items.
+      * @param t_init The initial value of the accumulators. It must be neutral for <tt>c_reduce</tt>, like 0 for a sum.
+      * @param c_map The function that adds an item to an accumulator.
+      * @param c_reduce The function that adds an accumulator to another.
+      * @return The combined accumulators, or <tt>t_init</tt> if there are no items.
+      * @see MapReduceOverEntities()
+      * @see CSpace::ParallelFor()
+      */
+      template <typename ACCUMULATOR, typename MAP, typename REDUCE>
+      ACCUMULATOR MapReduce(size_t un_items,
+                            const ACCUMULATOR& t_init,
+                            MAP c_map,
+                            REDUCE c_reduce) const {
+         if(un_items == 0) {
+            return t_init;
+         }
+         size_t unChunkSize = (un_items + MAP_REDUCE_MAX_CHUNKS - 1) / MAP_REDUCE_MAX_CHUNKS;
+         size_t unChunks = (un_items + unChunkSize - 1) / unChunkSize;
+         std::vector<SMapReduceSlot<ACCUMULATOR> > vecSlots(unChunks, SMapReduceSlot<ACCUMULATOR>(t_init));
+         m_cSpace.ParallelFor(
+            un_items,
+            unChunkSize,
+            [&vecSlots, &c_map](size_t un_chunk, size_t un_begin, size_t un_end) {
+               ACCUMULATOR& tAccumulator = vecSlots[un_chunk].Value;
+               for(size_t i = un_begin; i < un_end; ++i) {
+                  c_map(tAccumulator, i);
+               }
+            });
+         ACCUMULATOR tResult(vecSlots[0].Value);
+         for(size_t i = 1; i < unChunks; ++i) {
+            c_reduce(tResult, vecSlots[i].Value);
+         }
+         return tResult;
+      }
+
+     /**
+      * \brief Computes a value over all the entities of the given type using
+      * the ARGoS threads.
+      *
+      * Works like MapReduce() on the entities returned by
+      * CSpace::GetEntitiesByType(), in order of id; <tt>c_map</tt> is called
+      * as <tt>c_map(tAccumulator, cEntity)</tt> with <tt>cEntity</tt> of class
+      * <tt>ENTITY</tt>. Computing the center of mass of the foot-bots:
+      * <pre>
+      * CVector3 cSum = MapReduceOverEntities<CFootBotEntity>(
+      *    "foot-bot", CVector3(),
+      *    [](CVector3& c_sum, CFootBotEntity& c_fb) {
+      *       c_sum += c_fb.GetEmbodiedEntity().GetOriginAnchor().Position;
+      *    },
+      *    [](CVector3& c_total, const CVector3& c_sum) { c_total += c_sum; });
+      * </pre>
+      *
+      * @param str_type The type of the entities, as returned by CEntity::GetTypeDescription().
+      * @param t_init The initial value of the accumulators. It must be neutral for <tt>c_reduce</tt>, like 0 for a sum.
+      * @param c_map The function that adds an entity to an accumulator.
+      * @param c_reduce The function that adds an accumulator to another.
+      * @return The combined accumulators, or <tt>t_init</tt> if there are no entities of the given type.
+      * @throws CARGoSException if the entities of the given type are not of class <tt>ENTITY</tt>.
+      * @see MapReduce()
+      */
+      template <typename ENTITY, typename ACCUMULATOR, typename MAP, typename REDUCE>
+      ACCUMULATOR MapReduceOverEntities(const std::string& str_type,
+                                        const ACCUMULATOR& t_init,
+                                        MAP c_map,
+                                        REDUCE c_reduce) const {
+         std::vector<ENTITY*> vecEntities = GetEntityVector<ENTITY>(str_type);
+         return MapReduce(
+            vecEntities.size(),
+            t_init,
+            [&vecEntities, &c_map](ACCUMULATOR& t_accumulator, size_t i) {
+               c_map(t_accumulator, *vecEntities[i]);
+            },
+            c_reduce);
+      }
+
+   public:
+
+      /** The maximum number of chunks, and thus of accumulators, of MapReduce() */
+      static const size_t MAP_REDUCE_MAX_CHUNKS;
+
+   private:
+
+      /**
+       * The accumulator of a MapReduce() chunk, on its own cache line to
+       * keep the threads from invalidating each other's accumulators.
+       */
+      template <typename ACCUMULATOR>
+      struct alignas(64) SMapReduceSlot {
+         ACCUMULATOR Value;
+
+         explicit SMapReduceSlot(const ACCUMULATOR& t_value) :
+            Value(t_value) {}
+      };
+
+      /**
+       * Returns the entities of the given type, in order of id.
+       */
+      template <typename ENTITY>
+      std::vector<ENTITY*> GetEntityVector(const std::string& str_type) const {
+         std::vector<ENTITY*> vecEntities;
+         auto itEntities = m_cSpace.GetEntityMapPerTypePerId().find(str_type);
+         if(itEntities != m_cSpace.GetEntityMapPerTypePerId().end()) {
+            vecEntities.reserve(itEntities->second.size());
+            for(const auto& c_item : itEntities->second) {
+               vecEntities.push_back(any_cast<ENTITY*>(c_item.second));
+            }
+         }
+         return vecEntities;
+      }
+
    private:
 
       /** A reference to the CSimulator instance */
@@ -5,7 +5,9 @@
  */
 
 #include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/ensemble.h>
 #include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/core/utility/configuration/compiled_configuration.h>
 #include <argos3/core/simulator/query_plugins.h>
 #include <argos3/core/simulator/argos_command_line_arg_parser.h>
 
@@ -32,7 +34,17 @@ int main(int n_argc, char** ppch_argv) {
       cACLAP.Parse(n_argc, ppch_argv);
       switch(cACLAP.GetAction()) {
          case CARGoSCommandLineArgParser::ACTION_RUN_EXPERIMENT:
-            CDynamicLoading::LoadAllLibraries();
+            CDynamicLoading::LoadLibrariesOnDemand();
+            if(cACLAP.GetReplicas() > 1) {
+               /* Run the replicas in child processes */
+               CEnsemble cEnsemble(cACLAP.GetExperimentConfigFile(),
+                                   cACLAP.GetReplicas(),
+                                   cACLAP.GetJobs());
+               if(cEnsemble.Run() > 0) {
+                  THROW_ARGOSEXCEPTION("Some replicas failed");
+               }
+               break;
+            }
             cSimulator.SetExperimentFileName(cACLAP.GetExperimentConfigFile());
             cSimulator.LoadExperiment(cACLAP.IsForceNoViz());
             cSimulator.Execute();
@@ -41,6 +53,17 @@ int main(int n_argc, char** ppch_argv) {
             CDynamicLoading::LoadAllLibraries();
             QueryPlugins(cACLAP.GetQuery());
             break;
+         case CARGoSCommandLineArgParser::ACTION_COMPILE_EXPERIMENT: {
+            ticpp::Document tConfiguration;
+            LoadConfiguration(tConfiguration, cACLAP.GetCompileConfigFile());
+            SaveCompiledConfiguration(tConfiguration, cACLAP.GetCompileOutputFile());
+            LOG << "[INFO] Compiled \"" << cACLAP.GetCompileConfigFile()
+                << "\" into \"" << cACLAP.GetCompileOutputFile() << "\"" << std::endl;
+            break;
+         }
+         case CARGoSCommandLineArgParser::ACTION_INDEX_PLUGINS:
+            CDynamicLoading::WritePluginIndex(cACLAP.GetPluginIndexDir());
+            break;
          case CARGoSCommandLineArgParser::ACTION_SHOW_HELP:
             cACLAP.PrintUsage(LOG);
             break;
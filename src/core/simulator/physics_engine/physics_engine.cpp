@@ -81,6 +81,27 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CheckOcclusionsAlongRays(std::vector<UInt8>& vec_occluded,
+                                 const std::vector<CRay3>& vec_rays,
+                                 CEmbodiedEntity& c_entity) {
+      vec_occluded.assign(vec_rays.size(), 0);
+      TEmbodiedEntityIntersectionData tData;
+      for(size_t i = 0; i < vec_rays.size(); ++i) {
+         GetEmbodiedEntitiesIntersectedByRay(tData, vec_rays[i]);
+         /* Same criterion as GetClosestEmbodiedEntityIntersectedByRay() */
+         for(size_t j = 0; j < tData.size(); ++j) {
+            if(tData[j].TOnRay < 1.0f &&
+               &c_entity != tData[j].IntersectedEntity) {
+               vec_occluded[i] = 1;
+               break;
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    /* The default value of the simulation clock tick */
    Real CPhysicsEngine::m_fSimulationClockTick = 0.1f;
    Real CPhysicsEngine::m_fInverseSimulationClockTick = 1.0f / CPhysicsEngine::m_fSimulationClockTick;
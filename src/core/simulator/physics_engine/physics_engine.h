@@ -88,6 +88,19 @@ namespace argos {
                                                         const CRay3& c_ray,
                                                         CEmbodiedEntity& c_entity);
 
+   /**
+    * Checks a batch of rays for occlusions.
+    * A ray is occluded if GetClosestEmbodiedEntityIntersectedByRay() would
+    * find an intersection for it. The intersection buffer is shared by all the
+    * rays of the batch, which avoids an allocation per ray.
+    * @param vec_occluded Set to 1 for each occluded ray, and to 0 otherwise.
+    * @param vec_rays The rays to test for intersections.
+    * @param c_entity The entity to exclude from the intersection check.
+    */
+   extern void CheckOcclusionsAlongRays(std::vector<UInt8>& vec_occluded,
+                                        const std::vector<CRay3>& vec_rays,
+                                        CEmbodiedEntity& c_entity);
+
    /****************************************/
    /****************************************/
 
@@ -21,7 +21,8 @@ namespace argos {
       OffsetOrientation(c_offset_orientation),
       Position(c_position),
       Orientation(c_orientation),
-      InUseCount(0) {
+      InUseCount(0),
+      Version(1) {
    }
 
    /****************************************/
@@ -46,6 +47,8 @@ namespace argos {
       m_cEngine(c_engine),
       m_cEmbodiedEntity(c_entity),
       m_sBoundingBox(),
+      m_bWasAsleep(false),
+      m_vecAnchorPoses(c_entity.GetAnchors().size()),
       m_vecAnchorMethodHolders(c_entity.GetAnchors().size(), nullptr),
       m_vecThunks(c_entity.GetAnchors().size(), nullptr) {}
 
@@ -53,8 +56,26 @@ namespace argos {
    /****************************************/
 
    void CPhysicsModel::UpdateEntityStatus() {
-      CalculateAnchors();
-      CalculateBoundingBox();
+      /*
+       * Update anchors and bounding box, unless they can't have changed.
+       * A model that just fell asleep might have moved in the last step,
+       * so it is skipped only from the next call.
+       */
+      bool bAsleep = IsAsleep();
+      if(bAsleep && m_bWasAsleep) {
+         ++m_sPoseUpdateCounters.Skipped;
+      }
+      else {
+         CalculateAnchors();
+         if(UpdateAnchorVersions() || !HasRigidBoundingBox()) {
+            CalculateBoundingBox();
+            ++m_sPoseUpdateCounters.Recomputed;
+         }
+         else {
+            ++m_sPoseUpdateCounters.Skipped;
+         }
+      }
+      m_bWasAsleep = bAsleep;
       /*
        * Update entity components
        */
@@ -87,4 +108,26 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   bool CPhysicsModel::UpdateAnchorVersions() {
+      bool bOriginChanged = false;
+      std::vector<SAnchor*>& vecAnchors = m_cEmbodiedEntity.GetEnabledAnchors();
+      for(size_t i = 0; i < vecAnchors.size(); ++i) {
+         SAnchor& sAnchor = *vecAnchors[i];
+         SAnchorPose& sPose = m_vecAnchorPoses[sAnchor.Index];
+         if(!sPose.Valid ||
+            sPose.Position != sAnchor.Position ||
+            !(sPose.Orientation == sAnchor.Orientation)) {
+            sPose.Position = sAnchor.Position;
+            sPose.Orientation = sAnchor.Orientation;
+            sPose.Valid = true;
+            ++sAnchor.Version;
+            if(sAnchor.Index == 0) bOriginChanged = true;
+         }
+      }
+      return bOriginChanged;
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
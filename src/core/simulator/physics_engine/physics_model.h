@@ -53,10 +53,19 @@ namespace argos {
       CQuaternion Orientation;
       /** A counter for the devices using this anchor */
       UInt32 InUseCount;
+      /**
+       * The pose version of this anchor.
+       * This value is incremented every time Position or Orientation change.
+       * Components can store the last version they processed and skip their
+       * calculations while it stays the same. Versions start from 1, so 0 can
+       * be used to mean 'never processed'.
+       */
+      UInt64 Version;
       /**
        * Struct constructor.
        * Initializes the anchor using the provided information.
        * InUseCount is initialized to 0, i.e., the anchor is initially disabled.
+       * Version is initialized to 1.
        * @param str_id The id of the anchor.
        * @param c_offset_position The position of the anchor wrt the body coordinate system.
        * @param c_offset_orientation The orientation of the anchor wrt the body coordinate system.
@@ -106,6 +115,22 @@ namespace argos {
       typedef std::map<std::string, CPhysicsModel*> TMap;
       typedef std::vector<CPhysicsModel*> TVector;
 
+      /**
+       * Counts how many times the bounding box of a model was recomputed
+       * or skipped in UpdateEntityStatus().
+       * @see HasRigidBoundingBox()
+       */
+      struct SPoseUpdateCounters {
+         /** The number of times the bounding box was recomputed */
+         UInt64 Recomputed;
+         /** The number of times the bounding box was left untouched */
+         UInt64 Skipped;
+
+         SPoseUpdateCounters() :
+            Recomputed(0),
+            Skipped(0) {}
+      };
+
    public:
 
       CPhysicsModel(CPhysicsEngine& c_engine,
@@ -149,13 +174,19 @@ namespace argos {
        * that anchors get updated and transfer to other engines is scheduled.
        * This method internally calls:
        * <ul>
-       * <li>CalculateBoundingBox()
        * <li>CalculateAnchors()
+       * <li>CalculateBoundingBox()
        * <li>CComposableEntity::UpdateComponents()
        * </ul>
+       * After the anchors are calculated, the version of every enabled anchor
+       * whose pose changed is incremented. If HasRigidBoundingBox() returns
+       * <tt>true</tt> and the origin anchor did not move, the bounding box is
+       * not recalculated. If the model was asleep since the last call, the
+       * anchors and the bounding box are not recalculated at all.
        * @see CalculateBoundingBox()
        * @see CalculateAnchors()
        * @see CComposableEntity::UpdateComponents()
+       * @see SAnchor::Version
        */
       virtual void UpdateEntityStatus();
 
@@ -228,6 +259,35 @@ namespace argos {
        */
       virtual void CalculateAnchors();
 
+      /**
+       * Returns <tt>true</tt> if the bounding box depends only on the pose of the origin anchor.
+       * When this method returns <tt>true</tt>, UpdateEntityStatus() skips
+       * CalculateBoundingBox() if the origin anchor did not move. Models made of
+       * a single rigid body should return <tt>true</tt>. The default implementation
+       * returns <tt>false</tt>.
+       */
+      virtual bool HasRigidBoundingBox() const {
+         return false;
+      }
+
+      /**
+       * Returns <tt>true</tt> if the physics engine put this model to sleep.
+       * A sleeping model does not move until something wakes it up, so its
+       * anchors and its bounding box stay the same. The default implementation
+       * returns <tt>false</tt>.
+       */
+      virtual bool IsAsleep() const {
+         return false;
+      }
+
+      /**
+       * Returns the counters of recomputed and skipped bounding box updates.
+       * @return The counters of recomputed and skipped bounding box updates.
+       */
+      inline const SPoseUpdateCounters& GetPoseUpdateCounters() const {
+         return m_sPoseUpdateCounters;
+      }
+
       /**
        * Returns <tt>true</tt> if this model is colliding with another model.
        * @return <tt>true</tt> if this model is colliding with another model.
@@ -248,6 +308,33 @@ namespace argos {
       CPhysicsEngine& m_cEngine;
       CEmbodiedEntity& m_cEmbodiedEntity;
       SBoundingBox m_sBoundingBox;
+      SPoseUpdateCounters m_sPoseUpdateCounters;
+      bool m_bWasAsleep;
+
+   private:
+
+      /**
+       * Updates the version of the enabled anchors whose pose changed.
+       * @return <tt>true</tt> if the origin anchor changed.
+       */
+      bool UpdateAnchorVersions();
+
+      /**
+       * The pose of an anchor the last time this model looked at it.
+       */
+      struct SAnchorPose {
+         CVector3 Position;
+         CQuaternion Orientation;
+         bool Valid;
+
+         SAnchorPose() :
+            Valid(false) {}
+      };
+
+      /**
+       * The last known pose of each anchor, indexed by anchor index.
+       */
+      std::vector<SAnchorPose> m_vecAnchorPoses;
 
    private:
 
@@ -10,6 +10,7 @@
 #include <argos3/core/simulator/entity/entity.h>
 #include <argos3/core/simulator/actuator.h>
 #include <argos3/core/simulator/sensor.h>
+#include <argos3/core/simulator/recorder/recorder_field.h>
 
 namespace argos {
 
@@ -27,6 +28,7 @@ namespace argos {
       QuerySearchPlugins<CMedium>           (str_query, tResult);
       QuerySearchPlugins<CVisualization>    (str_query, tResult);
       QuerySearchPlugins<CEntity>           (str_query, tResult);
+      QuerySearchPlugins<CRecorderField>    (str_query, tResult);
       /* Print the result */
       if(tResult.empty()) {
          LOG << "   None found." << std::endl << std::endl;
@@ -65,6 +67,8 @@ namespace argos {
          QueryShowList<CVisualization>("AVAILABLE VISUALIZATIONS");
       } else if(str_query == "entities") {
          QueryShowList<CEntity>("AVAILABLE ENTITIES");
+      } else if(str_query == "recorder_fields") {
+         QueryShowList<CRecorderField>("AVAILABLE RECORDER FIELDS");
       } else if(str_query == "all") {
          QueryShowList<CSimulatedActuator>("AVAILABLE ACTUATORS");
          QueryShowList<CSimulatedSensor>  ("AVAILABLE SENSORS");
@@ -72,6 +76,7 @@ namespace argos {
          QueryShowList<CMedium>           ("AVAILABLE MEDIA");
          QueryShowList<CVisualization>    ("AVAILABLE VISUALIZATIONS");
          QueryShowList<CEntity>           ("AVAILABLE ENTITIES");
+         QueryShowList<CRecorderField>    ("AVAILABLE RECORDER FIELDS");
       } else {
          QueryShowPluginDescription(str_query);
       }
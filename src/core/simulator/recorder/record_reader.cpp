@@ -0,0 +1,206 @@
+/**
+ * @file <argos3/core/simulator/recorder/record_reader.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "record_reader.h"
+#include <argos3/core/config.h>
+#include <argos3/core/simulator/recorder/recorder.h>
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+#include <arpa/inet.h>
+#include <cstring>
+#ifdef ARGOS_WITH_ZLIB
+#  include <zlib.h>
+#endif
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CRecordReader::CRecordReader(const std::string& str_file_name) :
+      m_strFileName(str_file_name),
+      m_unCompression(CRecorder::COMPRESSION_NONE),
+      m_unPeriod(1),
+      m_unNextSample(0) {
+      m_cFile.open(m_strFileName.c_str(), std::ios::in | std::ios::binary);
+      if(m_cFile.fail()) {
+         THROW_ARGOSEXCEPTION("Can't open record file \"" << m_strFileName << "\"");
+      }
+      /* Check the magic string */
+      std::string strMagic(CRecorder::MAGIC.size(), '\0');
+      m_cFile.read(&strMagic[0], strMagic.size());
+      if(m_cFile.fail() || strMagic != CRecorder::MAGIC) {
+         THROW_ARGOSEXCEPTION("\"" << m_strFileName << "\" is not a record file");
+      }
+      UInt32 unVersion = ReadUInt32();
+      if(unVersion != CRecorder::VERSION) {
+         THROW_ARGOSEXCEPTION("Record file \"" << m_strFileName << "\" has version " << unVersion <<
+                              ", but only version " << CRecorder::VERSION << " is supported");
+      }
+      /* Read the rest of the header */
+      m_unCompression = m_cFile.get();
+      if(m_unCompression != CRecorder::COMPRESSION_NONE) {
+#ifdef ARGOS_WITH_ZLIB
+         if(m_unCompression != CRecorder::COMPRESSION_ZLIB) {
+            THROW_ARGOSEXCEPTION("Record file \"" << m_strFileName << "\" uses unknown compression method " << static_cast<UInt32>(m_unCompression));
+         }
+#else
+         THROW_ARGOSEXCEPTION("Record file \"" << m_strFileName << "\" is compressed, but ARGoS was compiled without zlib");
+#endif
+      }
+      m_unPeriod = ReadUInt32();
+      UInt32 unFields = ReadUInt32();
+      for(UInt32 i = 0; i < unFields; ++i) {
+         m_vecFields.push_back(ReadString());
+      }
+      m_tFirstChunk = m_cFile.tellg();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   SInt32 CRecordReader::GetFieldIndex(const std::string& str_field) const {
+      for(size_t i = 0; i < m_vecFields.size(); ++i) {
+         if(m_vecFields[i] == str_field) {
+            return i;
+         }
+      }
+      return -1;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CRecordReader::Next(SSample& s_sample) {
+      /* Load the next chunk when the current one is over */
+      if(m_unNextSample >= m_vecSteps.size()) {
+         if(!ReadChunk()) {
+            return false;
+         }
+      }
+      /* Fill the sample */
+      s_sample.Step = m_vecSteps[m_unNextSample];
+      s_sample.EntityIds = m_vecEntityIds;
+      s_sample.Values.resize(m_vecColumns.size());
+      for(size_t f = 0; f < m_vecColumns.size(); ++f) {
+         const std::vector<UInt8>& vecColumn = m_vecColumns[f];
+         size_t& unOffset = m_vecColumnOffsets[f];
+         s_sample.Values[f].resize(m_vecEntityIds.size());
+         for(size_t e = 0; e < m_vecEntityIds.size(); ++e) {
+            if(unOffset + sizeof(UInt32) > vecColumn.size()) {
+               THROW_ARGOSEXCEPTION("Record file \"" << m_strFileName << "\" is corrupted: column \"" << m_vecFields[f] << "\" is too short");
+            }
+            UInt32 unSize;
+            ::memcpy(&unSize, &vecColumn[unOffset], sizeof(UInt32));
+            unSize = ntohl(unSize);
+            unOffset += sizeof(UInt32);
+            if(unOffset + unSize > vecColumn.size()) {
+               THROW_ARGOSEXCEPTION("Record file \"" << m_strFileName << "\" is corrupted: column \"" << m_vecFields[f] << "\" is too short");
+            }
+            s_sample.Values[f][e].Clear();
+            if(unSize > 0) {
+               s_sample.Values[f][e].AddBuffer(&vecColumn[unOffset], unSize);
+               unOffset += unSize;
+            }
+         }
+      }
+      ++m_unNextSample;
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRecordReader::Rewind() {
+      m_cFile.clear();
+      m_cFile.seekg(m_tFirstChunk);
+      m_vecSteps.clear();
+      m_unNextSample = 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CRecordReader::ReadChunk() {
+      /* Check for the end of the file */
+      if(m_cFile.peek() == std::char_traits<char>::eof()) {
+         return false;
+      }
+      /* Entities and steps */
+      UInt32 unSamples = ReadUInt32();
+      UInt32 unEntities = ReadUInt32();
+      m_vecEntityIds.resize(unEntities);
+      for(UInt32 i = 0; i < unEntities; ++i) {
+         m_vecEntityIds[i] = ReadString();
+      }
+      m_vecSteps.resize(unSamples);
+      for(UInt32 i = 0; i < unSamples; ++i) {
+         m_vecSteps[i] = ReadUInt32();
+      }
+      /* Columns */
+      m_vecColumns.resize(m_vecFields.size());
+      m_vecColumnOffsets.assign(m_vecFields.size(), 0);
+      std::vector<UInt8> vecStored;
+      for(size_t f = 0; f < m_vecFields.size(); ++f) {
+         UInt32 unRawSize = ReadUInt32();
+         UInt32 unStoredSize = ReadUInt32();
+         m_vecColumns[f].resize(unRawSize);
+         if(m_unCompression == CRecorder::COMPRESSION_NONE ||
+            unStoredSize == unRawSize) {
+            if(unStoredSize != unRawSize) {
+               THROW_ARGOSEXCEPTION("Record file \"" << m_strFileName << "\" is corrupted: bad size for column \"" << m_vecFields[f] << "\"");
+            }
+            m_cFile.read(reinterpret_cast<char*>(m_vecColumns[f].data()), unRawSize);
+         }
+         else {
+            vecStored.resize(unStoredSize);
+            m_cFile.read(reinterpret_cast<char*>(vecStored.data()), unStoredSize);
+#ifdef ARGOS_WITH_ZLIB
+            uLongf unDecompressedSize = unRawSize;
+            if(!m_cFile.fail() &&
+               (::uncompress(m_vecColumns[f].data(), &unDecompressedSize,
+                             vecStored.data(), unStoredSize) != Z_OK ||
+                unDecompressedSize != unRawSize)) {
+               THROW_ARGOSEXCEPTION("Record file \"" << m_strFileName << "\" is corrupted: can't decompress column \"" << m_vecFields[f] << "\"");
+            }
+#endif
+         }
+         if(m_cFile.fail()) {
+            THROW_ARGOSEXCEPTION("Record file \"" << m_strFileName << "\" is truncated");
+         }
+      }
+      m_unNextSample = 0;
+      return unSamples > 0 || ReadChunk();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CRecordReader::ReadUInt32() {
+      UInt32 unValue;
+      m_cFile.read(reinterpret_cast<char*>(&unValue), sizeof(UInt32));
+      if(m_cFile.fail()) {
+         THROW_ARGOSEXCEPTION("Record file \"" << m_strFileName << "\" is truncated");
+      }
+      return ntohl(unValue);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   std::string CRecordReader::ReadString() {
+      std::string strValue;
+      std::getline(m_cFile, strValue, '\0');
+      if(m_cFile.fail()) {
+         THROW_ARGOSEXCEPTION("Record file \"" << m_strFileName << "\" is truncated");
+      }
+      return strValue;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,140 @@
+/**
+ * @file <argos3/core/simulator/recorder/record_reader.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef RECORD_READER_H
+#define RECORD_READER_H
+
+namespace argos {
+   class CRecordReader;
+}
+
+#include <argos3/core/utility/datatypes/byte_array.h>
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * Reads the files written by CRecorder.
+    * <p>
+    * The reader loads one chunk at a time, and returns its samples in order.
+    * It does not depend on the simulator, so it can be used in standalone
+    * analysis tools. The format is described in CRecorder.
+    * </p>
+    * <p>
+    * Example:
+    * <pre>
+    * CRecordReader cReader("trajectories.argosrec");
+    * SInt32 nPose = cReader.GetFieldIndex("pose");
+    * CRecordReader::SSample sSample;
+    * while(cReader.Next(sSample)) {
+    *    for(size_t i = 0; i < sSample.EntityIds.size(); ++i) {
+    *       CByteArray& cValue = sSample.Values[nPose][i];
+    *       if(!cValue.Empty()) {
+    *          Real fX, fY, fZ;
+    *          cValue >> fX >> fY >> fZ;
+    *       }
+    *    }
+    * }
+    * </pre>
+    * </p>
+    * @see CRecorder
+    */
+   class CRecordReader {
+
+   public:
+
+      /**
+       * The values of all the fields of all the entities at a step.
+       */
+      struct SSample {
+         /** The simulation step */
+         UInt32 Step;
+         /** The ids of the entities */
+         std::vector<std::string> EntityIds;
+         /**
+          * The values, indexed first by field and then by entity.
+          * An empty value means that the field does not apply to the entity.
+          */
+         std::vector<std::vector<CByteArray> > Values;
+      };
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param str_file_name The file to read.
+       * @throws CARGoSException if the file can't be opened or its header is invalid.
+       */
+      CRecordReader(const std::string& str_file_name);
+
+      ~CRecordReader() {}
+
+      /**
+       * Returns the labels of the recorded fields.
+       */
+      inline const std::vector<std::string>& GetFields() const {
+         return m_vecFields;
+      }
+
+      /**
+       * Returns the index of the given field in SSample::Values.
+       * @param str_field The field label.
+       * @return The index of the field, or -1 if it was not recorded.
+       */
+      SInt32 GetFieldIndex(const std::string& str_field) const;
+
+      /**
+       * Returns the sampling period, in steps.
+       */
+      inline UInt32 GetPeriod() const {
+         return m_unPeriod;
+      }
+
+      /**
+       * Reads the next sample.
+       * @param s_sample The sample to fill.
+       * @return <tt>false</tt> if the end of the file was reached.
+       * @throws CARGoSException if the file is corrupted.
+       */
+      bool Next(SSample& s_sample);
+
+      /**
+       * Goes back to the first sample.
+       */
+      void Rewind();
+
+   private:
+
+      bool ReadChunk();
+
+      UInt32 ReadUInt32();
+
+      std::string ReadString();
+
+   private:
+
+      std::string m_strFileName;
+      std::ifstream m_cFile;
+      std::streampos m_tFirstChunk;
+      UInt8 m_unCompression;
+      UInt32 m_unPeriod;
+      std::vector<std::string> m_vecFields;
+
+      /* The chunk being read */
+      std::vector<std::string> m_vecEntityIds;
+      std::vector<UInt32> m_vecSteps;
+      std::vector<std::vector<UInt8> > m_vecColumns;
+      std::vector<size_t> m_vecColumnOffsets;
+      size_t m_unNextSample;
+   };
+
+}
+
+#endif
@@ -0,0 +1,382 @@
+/**
+ * @file <argos3/core/simulator/recorder/recorder.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "recorder.h"
+#include <argos3/core/config.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/string_utilities.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/entity/composable_entity.h>
+
+#include <algorithm>
+#ifdef ARGOS_WITH_ZLIB
+#  include <zlib.h>
+#endif
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const std::string CRecorder::MAGIC = "ARGOSREC";
+   const UInt32 CRecorder::VERSION = 1;
+
+   /****************************************/
+   /****************************************/
+
+   CRecorder::CRecorder() :
+      m_pcSpace(nullptr),
+      m_eMode(MODE_RECORD),
+      m_eCompression(COMPRESSION_NONE),
+      m_nCompressionLevel(1),
+      m_unPeriod(1),
+      m_unChunkSize(100),
+      m_unMaxQueuedChunks(4),
+      m_bStopWriter(false),
+      m_pcReader(nullptr),
+      m_bSampleValid(false) {
+#ifdef ARGOS_WITH_ZLIB
+      m_eCompression = COMPRESSION_ZLIB;
+#endif
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CRecorder::~CRecorder() {
+      Destroy();
+      for(size_t i = 0; i < m_vecFields.size(); ++i) {
+         delete m_vecFields[i];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRecorder::Init(TConfigurationNode& t_tree,
+                        CSpace& c_space) {
+      try {
+         m_pcSpace = &c_space;
+         /* Parse the configuration */
+         GetNodeAttribute(t_tree, "file", m_strFileName);
+         std::string strMode = "record";
+         GetNodeAttributeOrDefault(t_tree, "mode", strMode, strMode);
+         if(strMode == "record") {
+            m_eMode = MODE_RECORD;
+         }
+         else if(strMode == "replay") {
+            m_eMode = MODE_REPLAY;
+         }
+         else {
+            THROW_ARGOSEXCEPTION("Unknown recorder mode \"" << strMode << "\". Accepted values are \"record\" and \"replay\".");
+         }
+         GetNodeAttributeOrDefault(t_tree, "period", m_unPeriod, m_unPeriod);
+         if(m_unPeriod == 0) {
+            THROW_ARGOSEXCEPTION("The recorder period must be greater than zero");
+         }
+         GetNodeAttributeOrDefault(t_tree, "chunk_size", m_unChunkSize, m_unChunkSize);
+         if(m_unChunkSize == 0) {
+            THROW_ARGOSEXCEPTION("The recorder chunk size must be greater than zero");
+         }
+         std::string strCompression =
+            (m_eCompression == COMPRESSION_ZLIB) ? "zlib" : "none";
+         GetNodeAttributeOrDefault(t_tree, "compression", strCompression, strCompression);
+         if(strCompression == "none") {
+            m_eCompression = COMPRESSION_NONE;
+         }
+         else if(strCompression == "zlib") {
+#ifdef ARGOS_WITH_ZLIB
+            m_eCompression = COMPRESSION_ZLIB;
+#else
+            THROW_ARGOSEXCEPTION("Recorder compression \"zlib\" requested, but ARGoS was compiled without zlib");
+#endif
+         }
+         else {
+            THROW_ARGOSEXCEPTION("Unknown recorder compression \"" << strCompression << "\". Accepted values are \"none\" and \"zlib\".");
+         }
+         GetNodeAttributeOrDefault(t_tree, "compression_level", m_nCompressionLevel, m_nCompressionLevel);
+         std::string strEntities;
+         GetNodeAttributeOrDefault(t_tree, "entities", strEntities, strEntities);
+         if(!strEntities.empty()) {
+            Tokenize(strEntities, m_vecEntityTypes, ", ");
+         }
+         std::string strFields = "pose";
+         GetNodeAttributeOrDefault(t_tree, "fields", strFields, strFields);
+         Tokenize(strFields, m_vecFieldLabels, ", ");
+         if(m_vecFieldLabels.empty()) {
+            THROW_ARGOSEXCEPTION("The recorder needs at least one field");
+         }
+         /* Create the fields */
+         for(size_t i = 0; i < m_vecFieldLabels.size(); ++i) {
+            m_vecFields.push_back(CFactory<CRecorderField>::New(m_vecFieldLabels[i]));
+         }
+         Open();
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error initializing the recorder", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRecorder::Reset() {
+      Destroy();
+      Open();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRecorder::Destroy() {
+      if(m_eMode == MODE_RECORD) {
+         if(!m_cFile.is_open()) return;
+         /* Send the last chunk */
+         FlushChunk();
+         /* Stop the writer */
+         {
+            std::unique_lock<std::mutex> cLock(m_cQueueMutex);
+            m_bStopWriter = true;
+         }
+         m_cQueueCondition.notify_all();
+         if(m_cWriter.joinable()) {
+            m_cWriter.join();
+         }
+         m_cFile.close();
+      }
+      else {
+         delete m_pcReader;
+         m_pcReader = nullptr;
+         m_bSampleValid = false;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRecorder::Update(UInt32 un_step) {
+      if(un_step % m_unPeriod != 0) return;
+      if(m_eMode == MODE_RECORD) {
+         RecordSample(un_step);
+      }
+      else {
+         ReplaySample(un_step);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRecorder::Open() {
+      if(m_eMode == MODE_RECORD) {
+         /* Open the file and write the header */
+         m_cFile.open(m_strFileName.c_str(),
+                      std::ios::out | std::ios::trunc | std::ios::binary);
+         if(m_cFile.fail()) {
+            THROW_ARGOSEXCEPTION("Can't open record file \"" << m_strFileName << "\" for writing");
+         }
+         CByteArray cHeader;
+         cHeader.AddBuffer(reinterpret_cast<const UInt8*>(MAGIC.data()), MAGIC.size());
+         cHeader << VERSION
+                 << static_cast<UInt8>(m_eCompression)
+                 << m_unPeriod
+                 << static_cast<UInt32>(m_vecFieldLabels.size());
+         for(size_t i = 0; i < m_vecFieldLabels.size(); ++i) {
+            cHeader << m_vecFieldLabels[i];
+         }
+         m_cFile.write(reinterpret_cast<const char*>(cHeader.ToCArray()), cHeader.Size());
+         /* Prepare the first chunk */
+         m_sChunk.EntityIds.clear();
+         m_sChunk.Steps.clear();
+         m_sChunk.Columns.assign(m_vecFields.size(), CByteArray());
+         /* Start the writer */
+         m_bStopWriter = false;
+         m_cWriter = std::thread(&CRecorder::WriteLoop, this);
+      }
+      else {
+         m_pcReader = new CRecordReader(m_strFileName);
+         /* Match the recorded fields with the configured ones */
+         for(size_t i = 0; i < m_vecFieldLabels.size(); ++i) {
+            if(m_pcReader->GetFieldIndex(m_vecFieldLabels[i]) < 0) {
+               THROW_ARGOSEXCEPTION("Field \"" << m_vecFieldLabels[i] << "\" was not recorded in \"" << m_strFileName << "\"");
+            }
+         }
+         m_bSampleValid = false;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRecorder::RecordSample(UInt32 un_step) {
+      /* Collect the entities to record */
+      std::vector<CComposableEntity*> vecEntities;
+      m_vecSampleIds.clear();
+      CEntity::TVector& vecRoots = m_pcSpace->GetRootEntityVector();
+      for(size_t i = 0; i < vecRoots.size(); ++i) {
+         if(!m_vecEntityTypes.empty() &&
+            std::find(m_vecEntityTypes.begin(),
+                      m_vecEntityTypes.end(),
+                      vecRoots[i]->GetTypeDescription()) == m_vecEntityTypes.end()) {
+            continue;
+         }
+         auto* pcEntity = dynamic_cast<CComposableEntity*>(vecRoots[i]);
+         if(pcEntity != nullptr) {
+            vecEntities.push_back(pcEntity);
+            m_vecSampleIds.push_back(pcEntity->GetId());
+         }
+      }
+      /* A chunk has a fixed set of entities */
+      if(!m_sChunk.Steps.empty() && m_vecSampleIds != m_sChunk.EntityIds) {
+         FlushChunk();
+      }
+      if(m_sChunk.Steps.empty()) {
+         m_sChunk.EntityIds = m_vecSampleIds;
+      }
+      /* Serialize the fields by column */
+      m_sChunk.Steps.push_back(un_step);
+      for(size_t f = 0; f < m_vecFields.size(); ++f) {
+         CByteArray& cColumn = m_sChunk.Columns[f];
+         for(size_t e = 0; e < vecEntities.size(); ++e) {
+            m_cValue.Clear();
+            if(m_vecFields[f]->Record(*vecEntities[e], m_cValue)) {
+               cColumn << static_cast<UInt32>(m_cValue.Size());
+               cColumn.AddBuffer(m_cValue.ToCArray(), m_cValue.Size());
+            }
+            else {
+               cColumn << static_cast<UInt32>(0);
+            }
+         }
+      }
+      if(m_sChunk.Steps.size() >= m_unChunkSize) {
+         FlushChunk();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRecorder::ReplaySample(UInt32 un_step) {
+      /* Skip the samples of the past */
+      while(!m_bSampleValid || m_sSample.Step < un_step) {
+         m_bSampleValid = m_pcReader->Next(m_sSample);
+         if(!m_bSampleValid) return;
+      }
+      if(m_sSample.Step != un_step) return;
+      /* Apply the values to the entities that still exist */
+      CEntity::TMap& mapEntities = m_pcSpace->GetEntityMapPerId();
+      for(size_t e = 0; e < m_sSample.EntityIds.size(); ++e) {
+         auto itEntity = mapEntities.find(m_sSample.EntityIds[e]);
+         if(itEntity == mapEntities.end()) continue;
+         auto* pcEntity = dynamic_cast<CComposableEntity*>(itEntity->second);
+         if(pcEntity == nullptr) continue;
+         for(size_t f = 0; f < m_vecFields.size(); ++f) {
+            CByteArray& cValue =
+               m_sSample.Values[m_pcReader->GetFieldIndex(m_vecFieldLabels[f])][e];
+            if(!cValue.Empty()) {
+               m_vecFields[f]->Replay(*pcEntity, cValue);
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRecorder::FlushChunk() {
+      if(m_sChunk.Steps.empty()) return;
+      /* Hand the chunk over to the writer */
+      auto* psChunk = new SChunk;
+      psChunk->EntityIds.swap(m_sChunk.EntityIds);
+      psChunk->Steps.swap(m_sChunk.Steps);
+      psChunk->Columns.swap(m_sChunk.Columns);
+      m_sChunk.Columns.assign(m_vecFields.size(), CByteArray());
+      {
+         std::unique_lock<std::mutex> cLock(m_cQueueMutex);
+         /* Wait if the writer lags behind, to bound memory usage */
+         m_cQueueCondition.wait(cLock, [this] {
+               return m_deqQueue.size() < m_unMaxQueuedChunks;
+            });
+         m_deqQueue.push_back(psChunk);
+      }
+      m_cQueueCondition.notify_all();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRecorder::WriteLoop() {
+      /* The writer thread logs, so it needs its own log buffers */
+      LOG.AddThreadSafeBuffer();
+      LOGERR.AddThreadSafeBuffer();
+      while(true) {
+         SChunk* psChunk;
+         {
+            std::unique_lock<std::mutex> cLock(m_cQueueMutex);
+            m_cQueueCondition.wait(cLock, [this] {
+                  return m_bStopWriter || !m_deqQueue.empty();
+               });
+            if(m_deqQueue.empty()) return;
+            psChunk = m_deqQueue.front();
+            m_deqQueue.pop_front();
+         }
+         m_cQueueCondition.notify_all();
+         WriteChunk(*psChunk);
+         delete psChunk;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRecorder::WriteChunk(SChunk& s_chunk) {
+      CByteArray cBuffer;
+      cBuffer << static_cast<UInt32>(s_chunk.Steps.size())
+              << static_cast<UInt32>(s_chunk.EntityIds.size());
+      for(size_t i = 0; i < s_chunk.EntityIds.size(); ++i) {
+         cBuffer << s_chunk.EntityIds[i];
+      }
+      for(size_t i = 0; i < s_chunk.Steps.size(); ++i) {
+         cBuffer << s_chunk.Steps[i];
+      }
+      m_cFile.write(reinterpret_cast<const char*>(cBuffer.ToCArray()), cBuffer.Size());
+      for(size_t f = 0; f < s_chunk.Columns.size(); ++f) {
+         CByteArray& cColumn = s_chunk.Columns[f];
+         cBuffer.Clear();
+         cBuffer << static_cast<UInt32>(cColumn.Size());
+#ifdef ARGOS_WITH_ZLIB
+         if(m_eCompression == COMPRESSION_ZLIB) {
+            uLongf unStoredSize = ::compressBound(cColumn.Size());
+            CByteArray cStored(unStoredSize);
+            if(::compress2(cStored.ToCArray(), &unStoredSize,
+                           cColumn.ToCArray(), cColumn.Size(),
+                           m_nCompressionLevel) != Z_OK) {
+               LOGERR << "[WARNING] The recorder failed to compress a chunk of \""
+                      << m_strFileName << "\", storing it uncompressed" << std::endl;
+            }
+            else if(unStoredSize < cColumn.Size()) {
+               cBuffer << static_cast<UInt32>(unStoredSize);
+               m_cFile.write(reinterpret_cast<const char*>(cBuffer.ToCArray()), cBuffer.Size());
+               m_cFile.write(reinterpret_cast<const char*>(cStored.ToCArray()), unStoredSize);
+               continue;
+            }
+            /* A stored size equal to the raw size marks an uncompressed column */
+         }
+#endif
+         cBuffer << static_cast<UInt32>(cColumn.Size());
+         m_cFile.write(reinterpret_cast<const char*>(cBuffer.ToCArray()), cBuffer.Size());
+         m_cFile.write(reinterpret_cast<const char*>(cColumn.ToCArray()), cColumn.Size());
+      }
+      if(m_cFile.fail()) {
+         LOGERR << "[WARNING] The recorder failed to write to \""
+                << m_strFileName << "\"" << std::endl;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,197 @@
+/**
+ * @file <argos3/core/simulator/recorder/recorder.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+namespace argos {
+   class CRecorder;
+   class CSpace;
+}
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/simulator/recorder/recorder_field.h>
+#include <argos3/core/simulator/recorder/record_reader.h>
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace argos {
+
+   /**
+    * Records selected per-entity fields into a binary file, or replays them.
+    * <p>
+    * The recorder is configured with the <tt>&lt;recorder&gt;</tt> tag inside
+    * <tt>&lt;framework&gt;</tt>. Every <tt>period</tt> steps, it takes a sample:
+    * for each selected root entity, each field serializes its value. Samples
+    * are grouped into chunks. Within a chunk, the data is stored by column,
+    * that is, all the values of a field are contiguous, which makes them
+    * compress well. Chunks are compressed and written by a background thread,
+    * so the simulation only pays for serialization.
+    * </p>
+    * <p>
+    * Example configuration (all attributes but <tt>file</tt> are optional):
+    * <pre>
+    * &lt;framework&gt;
+    *   ...
+    *   &lt;recorder file="trajectories.argosrec"
+    *             mode="record"
+    *             fields="pose,leds,rab,scalars"
+    *             entities="foot-bot,box"
+    *             period="10"
+    *             chunk_size="100"
+    *             compression="zlib"
+    *             compression_level="1" /&gt;
+    * &lt;/framework&gt;
+    * </pre>
+    * By default, only the <tt>pose</tt> field is recorded, every step, for all
+    * the root entities. The available fields are listed by
+    * <tt>argos3 -q recorder_fields</tt>. The <tt>mode</tt> is either
+    * <tt>record</tt> or <tt>replay</tt>. Compression defaults to <tt>zlib</tt>
+    * when ARGoS is compiled with zlib, and to <tt>none</tt> otherwise.
+    * </p>
+    * <p>
+    * The file starts with a header:
+    * <ul>
+    * <li>the magic string <tt>ARGOSREC</tt> (8 bytes);
+    * <li>the format version (UInt32);
+    * <li>the compression method (UInt8, 0 = none, 1 = zlib);
+    * <li>the sampling period in steps (UInt32);
+    * <li>the number of fields (UInt32) and their labels (null-terminated strings).
+    * </ul>
+    * A sequence of chunks follows. Each chunk is made of:
+    * <ul>
+    * <li>the number of samples S (UInt32);
+    * <li>the number of entities E (UInt32) and their ids (null-terminated strings);
+    * <li>the step of each sample (S times UInt32);
+    * <li>for each field, the uncompressed size of the column (UInt32), its stored
+    *     size (UInt32) and the stored data. With zlib compression, a column
+    *     whose stored size equals its uncompressed size is stored uncompressed.
+    * </ul>
+    * An uncompressed column contains, for each sample and for each entity, the
+    * size of the value (UInt32) followed by the value. A size of zero means that
+    * the field does not apply to the entity. Integers are stored in network byte
+    * order and real numbers as in CByteArray. A chunk is closed early when the set
+    * of recorded entities changes.
+    * </p>
+    * <p>
+    * In replay mode, the recorder reads the file with CRecordReader and applies
+    * the recorded values to the entities with the same ids. This works with any
+    * visualization, including the Qt-OpenGL one.
+    * </p>
+    * @see CRecorderField
+    * @see CRecordReader
+    */
+   class CRecorder {
+
+   public:
+
+      enum EMode {
+         MODE_RECORD = 0,
+         MODE_REPLAY
+      };
+
+      enum ECompression {
+         COMPRESSION_NONE = 0,
+         COMPRESSION_ZLIB = 1
+      };
+
+      /** The magic string at the beginning of a record file */
+      static const std::string MAGIC;
+
+      /** The version of the record file format */
+      static const UInt32 VERSION;
+
+   public:
+
+      CRecorder();
+
+      ~CRecorder();
+
+      /**
+       * Initializes the recorder.
+       * @param t_tree The <tt>&lt;recorder&gt;</tt> configuration node.
+       * @param c_space The space.
+       */
+      void Init(TConfigurationNode& t_tree,
+                CSpace& c_space);
+
+      /**
+       * Restarts the recording or the replay from the beginning.
+       */
+      void Reset();
+
+      /**
+       * Flushes the pending data and closes the file.
+       */
+      void Destroy();
+
+      /**
+       * Records or replays the current step.
+       * This method is called by the simulator after each step.
+       * @param un_step The current simulation step.
+       */
+      void Update(UInt32 un_step);
+
+   private:
+
+      struct SChunk {
+         std::vector<std::string> EntityIds;
+         std::vector<UInt32> Steps;
+         std::vector<CByteArray> Columns;
+      };
+
+   private:
+
+      void Open();
+
+      void RecordSample(UInt32 un_step);
+
+      void ReplaySample(UInt32 un_step);
+
+      void FlushChunk();
+
+      void WriteLoop();
+
+      void WriteChunk(SChunk& s_chunk);
+
+   private:
+
+      CSpace* m_pcSpace;
+      std::string m_strFileName;
+      EMode m_eMode;
+      ECompression m_eCompression;
+      SInt32 m_nCompressionLevel;
+      UInt32 m_unPeriod;
+      UInt32 m_unChunkSize;
+      std::vector<std::string> m_vecEntityTypes;
+      std::vector<std::string> m_vecFieldLabels;
+      CRecorderField::TVector m_vecFields;
+
+      /* Recording */
+      SChunk m_sChunk;
+      std::vector<std::string> m_vecSampleIds;
+      CByteArray m_cValue;
+      std::ofstream m_cFile;
+      std::thread m_cWriter;
+      std::mutex m_cQueueMutex;
+      std::condition_variable m_cQueueCondition;
+      std::deque<SChunk*> m_deqQueue;
+      size_t m_unMaxQueuedChunks;
+      bool m_bStopWriter;
+
+      /* Replay */
+      CRecordReader* m_pcReader;
+      CRecordReader::SSample m_sSample;
+      bool m_bSampleValid;
+   };
+
+}
+
+#endif
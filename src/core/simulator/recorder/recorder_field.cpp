@@ -0,0 +1,109 @@
+/**
+ * @file <argos3/core/simulator/recorder/recorder_field.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "recorder_field.h"
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Records the position and the orientation of the origin anchor of the body.
+    * The value is the position (x,y,z) followed by the orientation (w,x,y,z).
+    */
+   class CPoseRecorderField : public CRecorderField {
+
+   public:
+
+      virtual bool Record(CComposableEntity& c_entity,
+                          CByteArray& c_buffer) {
+         if(!c_entity.HasComponent("body")) {
+            return false;
+         }
+         const SAnchor& sOrigin =
+            c_entity.GetComponent<CEmbodiedEntity>("body").GetOriginAnchor();
+         c_buffer << sOrigin.Position.GetX()
+                  << sOrigin.Position.GetY()
+                  << sOrigin.Position.GetZ()
+                  << sOrigin.Orientation.GetW()
+                  << sOrigin.Orientation.GetX()
+                  << sOrigin.Orientation.GetY()
+                  << sOrigin.Orientation.GetZ();
+         return true;
+      }
+
+      virtual void Replay(CComposableEntity& c_entity,
+                          CByteArray& c_value) {
+         if(!c_entity.HasComponent("body")) {
+            return;
+         }
+         Real fPX, fPY, fPZ, fQW, fQX, fQY, fQZ;
+         c_value >> fPX >> fPY >> fPZ >> fQW >> fQX >> fQY >> fQZ;
+         c_entity.GetComponent<CEmbodiedEntity>("body").MoveTo(
+            CVector3(fPX, fPY, fPZ),
+            CQuaternion(fQW, fQX, fQY, fQZ),
+            false,
+            true);
+      }
+
+   };
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Records the scalars exported by the controller.
+    * The value is the number of scalars followed by name/value pairs.
+    * @see CCI_Controller::ExportScalar()
+    */
+   class CScalarsRecorderField : public CRecorderField {
+
+   public:
+
+      virtual bool Record(CComposableEntity& c_entity,
+                          CByteArray& c_buffer) {
+         if(!c_entity.HasComponent("controller")) {
+            return false;
+         }
+         const std::map<std::string, Real>& mapScalars =
+            c_entity.GetComponent<CControllableEntity>("controller").
+            GetController().GetExportedScalars();
+         c_buffer << static_cast<UInt32>(mapScalars.size());
+         for(auto it = mapScalars.begin(); it != mapScalars.end(); ++it) {
+            c_buffer << it->first << it->second;
+         }
+         return true;
+      }
+
+   };
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_RECORDER_FIELD(CPoseRecorderField,
+                           "pose",
+                           "agent [agent@local]",
+                           "1.0",
+                           "The pose of the body of an entity.",
+                           "This field records the position and the orientation of the origin anchor\n"
+                           "of the embodied component of an entity. During a replay, the entity is moved\n"
+                           "to the recorded pose, ignoring collisions.",
+                           "Usable");
+
+   REGISTER_RECORDER_FIELD(CScalarsRecorderField,
+                           "scalars",
+                           "agent [agent@local]",
+                           "1.0",
+                           "The scalars exported by the controller of an entity.",
+                           "This field records the name and the value of the scalars a controller\n"
+                           "exported with CCI_Controller::ExportScalar().",
+                           "Usable");
+
+}
@@ -0,0 +1,84 @@
+/**
+ * @file <argos3/core/simulator/recorder/recorder_field.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef RECORDER_FIELD_H
+#define RECORDER_FIELD_H
+
+namespace argos {
+   class CRecorderField;
+   class CComposableEntity;
+}
+
+#include <argos3/core/utility/datatypes/byte_array.h>
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/plugins/factory.h>
+
+namespace argos {
+
+   /**
+    * A per-entity quantity captured by the recorder.
+    * <p>
+    * A field serializes one quantity of a root entity, such as the pose of its
+    * body or the colors of its LEDs, into a byte array. The recorder stores the
+    * values of each field in a separate column of its chunks. During a replay,
+    * the recorder passes the stored values back to the field, which applies them
+    * to the entity.
+    * </p>
+    * <p>
+    * Fields are plugins. Register new fields with REGISTER_RECORDER_FIELD().
+    * </p>
+    * @see CRecorder
+    */
+   class CRecorderField {
+
+   public:
+
+      typedef std::vector<CRecorderField*> TVector;
+
+   public:
+
+      CRecorderField() {}
+      virtual ~CRecorderField() {}
+
+      /**
+       * Appends the value of this field for the given entity to the buffer.
+       * @param c_entity The root entity to record.
+       * @param c_buffer The buffer to append the value to.
+       * @return <tt>false</tt> if the field does not apply to the entity.
+       */
+      virtual bool Record(CComposableEntity& c_entity,
+                          CByteArray& c_buffer) = 0;
+
+      /**
+       * Applies a recorded value to the given entity.
+       * By default, this method does nothing.
+       * @param c_entity The root entity to modify.
+       * @param c_value The value, as written by Record().
+       */
+      virtual void Replay(CComposableEntity& c_entity,
+                          CByteArray& c_value) {}
+
+   };
+
+}
+
+#define REGISTER_RECORDER_FIELD(CLASSNAME,                 \
+                                LABEL,                     \
+                                AUTHOR,                    \
+                                VERSION,                   \
+                                BRIEF_DESCRIPTION,         \
+                                LONG_DESCRIPTION,          \
+                                STATUS)                    \
+   REGISTER_SYMBOL(CRecorderField,                         \
+                   CLASSNAME,                              \
+                   LABEL,                                  \
+                   AUTHOR,                                 \
+                   VERSION,                                \
+                   BRIEF_DESCRIPTION,                      \
+                   LONG_DESCRIPTION,                       \
+                   STATUS)
+
+#endif
@@ -12,12 +12,15 @@
 #include <sys/time.h>
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/profiler/profiler.h>
+#include <argos3/core/simulator/recorder/recorder.h>
 #include <argos3/core/utility/string_utilities.h>
+#include <argos3/core/utility/configuration/compiled_configuration.h>
 #include <argos3/core/utility/plugins/dynamic_loading.h>
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/simulator/space/space_no_threads.h>
 #include <argos3/core/simulator/space/space_multi_thread_balance_quantity.h>
 #include <argos3/core/simulator/space/space_multi_thread_balance_length.h>
+#include <argos3/core/simulator/space/space_multi_thread_balance_cost.h>
 #include <argos3/core/simulator/visualization/default_visualization.h>
 #include <argos3/core/simulator/physics_engine/physics_engine.h>
 #include <argos3/core/simulator/loop_functions.h>
@@ -37,7 +40,10 @@ namespace argos {
       m_bWasRandomSeedSet(false),
       m_pcProfiler(nullptr),
       m_bHumanReadableProfile(true),
+      m_pcRecorder(nullptr),
       m_bRealTimeClock(false),
+      m_fRealTimeFactor(1.0),
+      m_unRealTimeMaxLag(0),
       m_bTerminated(false) {}
 
    /****************************************/
@@ -47,6 +53,8 @@ namespace argos {
       if(IsProfiling()) {
          delete m_pcProfiler;
       }
+      /* Delete the recorder */
+      delete m_pcRecorder;
       /* Delete the visualization */
       if(m_pcVisualization != nullptr) delete m_pcVisualization;
       /* Delete all the media */
@@ -102,11 +110,13 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   void CSimulator::Load(ticpp::Document& t_tree) {
+   void CSimulator::Load(ticpp::Document& t_tree,
+                         bool b_force_no_viz) {
       /* Build configuration tree */
       m_tConfiguration = t_tree;
       m_tConfigurationRoot = *m_tConfiguration.FirstChildElement();
       /* Init the experiment */
+      m_bForceNoViz = b_force_no_viz;
       Init();
       LOG.Flush();
       LOGERR.Flush();
@@ -117,7 +127,7 @@ namespace argos {
 
    void CSimulator::LoadExperiment(bool b_force_no_viz) {
       /* Build configuration tree */
-      m_tConfiguration.LoadFile(m_strExperimentConfigFileName);
+      LoadConfiguration(m_tConfiguration, m_strExperimentConfigFileName);
       m_tConfigurationRoot = *m_tConfiguration.FirstChildElement();
       /* Init the experiment */
       m_bForceNoViz = b_force_no_viz;
@@ -167,6 +177,13 @@ namespace argos {
          LOG << "[INFO] No visualization selected." << std::endl;
          m_pcVisualization = new CDefaultVisualization();
       }
+      /* Initialize the recorder and take the first sample */
+      if(NodeExists(GetNode(m_tConfigurationRoot, "framework"), "recorder")) {
+         m_pcRecorder = new CRecorder;
+         m_pcRecorder->Init(GetNode(GetNode(m_tConfigurationRoot, "framework"), "recorder"),
+                            *m_pcSpace);
+         m_pcRecorder->Update(m_pcSpace->GetSimulationClock());
+      }
       /* Start profiling, if needed */
       if(IsProfiling()) {
          m_pcProfiler->Start();
@@ -207,6 +224,11 @@ namespace argos {
       }
       /* Reset the loop functions */
       m_pcLoopFunctions->Reset();
+      /* Restart the recorder */
+      if(IsRecording()) {
+         m_pcRecorder->Reset();
+         m_pcRecorder->Update(m_pcSpace->GetSimulationClock());
+      }
       LOG.Flush();
       LOGERR.Flush();
    }
@@ -215,6 +237,12 @@ namespace argos {
    /****************************************/
 
    void CSimulator::Destroy() {
+      /* Flush the recorder */
+      if(IsRecording()) {
+         m_pcRecorder->Destroy();
+         delete m_pcRecorder;
+         m_pcRecorder = nullptr;
+      }
       /* Call user destroy function */
       if (m_pcLoopFunctions != nullptr) {
          m_pcLoopFunctions->Destroy();
@@ -258,6 +286,7 @@ namespace argos {
       CFactory<CCI_Controller>::Destroy();
       CFactory<CEntity>::Destroy();
       CFactory<CLoopFunctions>::Destroy();
+      CFactory<CRecorderField>::Destroy();
       /* Stop profiling and flush the data */
       if(IsProfiling()) {
          m_pcProfiler->Stop();
@@ -280,6 +309,10 @@ namespace argos {
    void CSimulator::UpdateSpace() {
       /* Update the space */
       m_pcSpace->Update();
+      /* Record or replay the new state */
+      if(IsRecording()) {
+         m_pcRecorder->Update(m_pcSpace->GetSimulationClock());
+      }
    }
 
    /****************************************/
@@ -351,8 +384,17 @@ namespace argos {
              << std::endl;
          /* Check for the 'real_time' attribute */
          GetNodeAttributeOrDefault(tExperiment, "real_time", m_bRealTimeClock, m_bRealTimeClock);
+         GetNodeAttributeOrDefault(tExperiment, "real_time_factor", m_fRealTimeFactor, m_fRealTimeFactor);
+         if(m_fRealTimeFactor <= 0.0) {
+            THROW_ARGOSEXCEPTION("The real-time factor must be positive, but " << m_fRealTimeFactor << " was given.");
+         }
+         GetNodeAttributeOrDefault(tExperiment, "real_time_max_lag", m_unRealTimeMaxLag, m_unRealTimeMaxLag);
          if(m_bRealTimeClock) {
-            LOG << "[INFO] Using the real-time clock." << std::endl;
+            LOG << "[INFO] Using the real-time clock";
+            if(m_fRealTimeFactor != 1.0) {
+               LOG << " at " << m_fRealTimeFactor << "x";
+            }
+            LOG << "." << std::endl;
          }
          /* Get the profiling tag, if present */
          if(NodeExists(t_tree, "profiling")) {
@@ -403,8 +445,11 @@ namespace argos {
          else if(strThreadingMethod == "balance_length") {
            m_pcSpace = new CSpaceMultiThreadBalanceLength(m_unThreads, bPinThreadsToCores);
          }
+         else if(strThreadingMethod == "balance_cost") {
+           m_pcSpace = new CSpaceMultiThreadBalanceCost(m_unThreads, bPinThreadsToCores);
+         }
          else {
-           THROW_ARGOSEXCEPTION("Error parsing the <system> tag. Unknown threading method \"" << strThreadingMethod << "\". Available methods: \"balance_quantity\" and \"balance_length\".");
+           THROW_ARGOSEXCEPTION("Error parsing the <system> tag. Unknown threading method \"" << strThreadingMethod << "\". Available methods: \"balance_quantity\", \"balance_length\" and \"balance_cost\".");
          }
        }
      }
@@ -31,6 +31,7 @@ namespace argos {
    class CMedium;
    class CSpace;
    class CProfiler;
+   class CRecorder;
 }
 
 #include <argos3/core/config.h>
@@ -183,6 +184,22 @@ namespace argos {
          return m_pcProfiler != NULL;
       }
 
+      /**
+       * Returns a reference to the recorder.
+       * @return A reference to the recorder.
+       */
+      inline CRecorder& GetRecorder() {
+         return *m_pcRecorder;
+      }
+
+      /**
+       * Returns <tt>true</tt> if the recorder is active.
+       * @return <tt>true</tt> if the recorder is active.
+       */
+      inline bool IsRecording() const {
+         return m_pcRecorder != NULL;
+      }
+
       /**
        * Returns the random seed of the "argos" category of the random seed.
        * @return the random seed of the "argos" category of the random seed.
@@ -277,6 +294,43 @@ namespace argos {
          m_bRealTimeClock = b_real_time;
       }
 
+      /**
+       * Returns how many times faster than the real time the simulation runs with the real-time clock.
+       * For instance, 2 runs the simulation twice as fast as the real time, and 0.5 half as fast.
+       * By default, this factor is 1.
+       * @see IsRealTimeClock()
+       */
+      inline Real GetRealTimeFactor() const {
+         return m_fRealTimeFactor;
+      }
+
+      /**
+       * Sets how many times faster than the real time the simulation runs with the real-time clock.
+       * @param f_factor The real-time factor.
+       * @see IsRealTimeClock()
+       */
+      inline void SetRealTimeFactor(Real f_factor) {
+         m_fRealTimeFactor = f_factor;
+      }
+
+      /**
+       * Returns the number of clock ticks the simulation can fall behind the real time and still catch up.
+       * Beyond that, the late ticks are not made up for. By default, this number is 0.
+       * @see IsRealTimeClock()
+       */
+      inline UInt32 GetRealTimeMaxLag() const {
+         return m_unRealTimeMaxLag;
+      }
+
+      /**
+       * Sets the number of clock ticks the simulation can fall behind the real time and still catch up.
+       * @param un_max_lag The maximum lag, in clock ticks.
+       * @see IsRealTimeClock()
+       */
+      inline void SetRealTimeMaxLag(UInt32 un_max_lag) {
+         m_unRealTimeMaxLag = un_max_lag;
+      }
+
       /**
        * Puts an end to the simulation.
        */
@@ -302,8 +356,10 @@ namespace argos {
        * Loads an already-parsed XML configuration tree.
        * The tree should have the same structure as an ARGoS file.
        * The variable m_tConfigurationRoot is set here.
+       * @param b_force_no_viz Whether to ignore the <tt>&lt;visualization&gt;</tt> tag.
        */
-      void Load(ticpp::Document& t_tree);
+      void Load(ticpp::Document& t_tree,
+                bool b_force_no_viz = false);
 
 
       /**
@@ -482,11 +538,26 @@ namespace argos {
        */
       bool m_bHumanReadableProfile;
 
+      /**
+       * Pointer to the recorder (NULL when recording is off).
+       */
+      CRecorder* m_pcRecorder;
+
       /**
        * <tt>true</tt> when ARGoS must run in real-time; <tt>false</tt> otherwise.
        */
       bool m_bRealTimeClock;
 
+      /**
+       * How many times faster than the real time the simulation runs with the real-time clock.
+       */
+      Real m_fRealTimeFactor;
+
+      /**
+       * The number of clock ticks the simulation can fall behind the real time and still catch up.
+       */
+      UInt32 m_unRealTimeMaxLag;
+
       /**
        * <tt>true</tt> if the simulation must be terminated now.
        */
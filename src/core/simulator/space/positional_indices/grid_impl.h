@@ -304,7 +304,7 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
       }
       /* Check rest of the circle */
       for(SInt32 i = nID; i > 0; --i) {
-         nJD = Floor(Sqrt(f_radius * f_radius - i * m_cCellSize.GetX() * i * m_cCellSize.GetX()) * m_cInvCellSize.GetY() + 0.5f);
+         nJD = Floor(Sqrt(Max<Real>(0.0f, f_radius * f_radius - i * m_cCellSize.GetX() * i * m_cCellSize.GetX())) * m_cInvCellSize.GetY() + 0.5f);
          for(SInt32 j = nJD; j > 0; --j) {
             if((nI + i >= 0 && nI + i < m_nSizeI) && (nJ + j >= 0 && nJ + j < m_nSizeJ)) APPLY_ENTITY_OPERATION_TO_CELL(nI + i, nJ + j, nK);
             if((nI + i >= 0 && nI + i < m_nSizeI) && (nJ - j >= 0 && nJ - j < m_nSizeJ)) APPLY_ENTITY_OPERATION_TO_CELL(nI + i, nJ - j, nK);
@@ -668,7 +668,7 @@ CGrid<ENTITY>::CGrid(const CVector3& c_area_min_corner,
       }
       /* Check rest of the circle */
       for(SInt32 i = nID; i > 0; --i) {
-         nJD = Floor(Sqrt(f_radius * f_radius - i * m_cCellSize.GetX() * i * m_cCellSize.GetX()) * m_cInvCellSize.GetY() + 0.5f);
+         nJD = Floor(Sqrt(Max<Real>(0.0f, f_radius * f_radius - i * m_cCellSize.GetX() * i * m_cCellSize.GetX())) * m_cInvCellSize.GetY() + 0.5f);
          for(SInt32 j = nJD; j > 0; --j) {
             if((nI + i >= 0 && nI + i < m_nSizeI) && (nJ + j >= 0 && nJ + j < m_nSizeJ)) APPLY_CELL_OPERATION_TO_CELL(nI + i, nJ + j, nK);
             if((nI + i >= 0 && nI + i < m_nSizeI) && (nJ - j >= 0 && nJ - j < m_nSizeJ)) APPLY_CELL_OPERATION_TO_CELL(nI + i, nJ - j, nK);
@@ -0,0 +1,221 @@
+/**
+ * @file <argos3/core/simulator/space/positional_indices/spatial_hash.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <argos3/core/utility/datatypes/set.h>
+#include <argos3/core/utility/math/ray3.h>
+#include <argos3/core/simulator/space/positional_indices/positional_index.h>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * A sparse positional index that stores only the occupied cells.
+    * <p>
+    * Like CGrid, this index divides the space into cells of equal size. Unlike
+    * CGrid, it does not need the arena bounds, and its memory depends on the
+    * number of occupied cells instead of the size of the arena. This makes it
+    * suitable for large, mostly empty arenas.
+    * </p>
+    * <p>
+    * The occupied cells are stored in an open-addressing hash table with linear
+    * probing. Each cell is marked with the timestamp of the last update, so the
+    * table is emptied in constant time at each update. The entities of a cell are
+    * kept in a singly-linked list stored in a flat vector, in the same order as
+    * they are added.
+    * </p>
+    * <p>
+    * The cell coordinates are limited to +/- 2^20 on each axis. Positions beyond
+    * that are clamped to the outermost cells.
+    * </p>
+    * <p>
+    * The index does not know where an entity is. As with CGrid, an update
+    * operation must be set with SetUpdateEntityOperation(). This operation is
+    * called on each entity at every update, and it must call UpdateCell() for
+    * each cell the entity occupies.
+    * </p>
+    * @see CGrid
+    */
+   template<class ENTITY>
+   class CSpatialHash : public CPositionalIndex<ENTITY> {
+
+   public:
+
+      typedef typename CPositionalIndex<ENTITY>::COperation CEntityOperation;
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param c_cell_size The size of a cell.
+       */
+      CSpatialHash(const CVector3& c_cell_size);
+
+      virtual ~CSpatialHash() {}
+
+      virtual void Init(TConfigurationNode& t_tree);
+      virtual void Reset();
+      virtual void Destroy();
+
+      virtual void AddEntity(ENTITY& c_entity);
+
+      virtual void RemoveEntity(ENTITY& c_entity);
+
+      virtual void Update();
+
+      virtual void GetEntitiesAt(CSet<ENTITY*,SEntityComparator>& c_entities,
+                                 const CVector3& c_position) const;
+
+      virtual void ForAllEntities(CEntityOperation& c_operation);
+
+      virtual void ForEntitiesInSphereRange(const CVector3& c_center,
+                                            Real f_radius,
+                                            CEntityOperation& c_operation);
+
+      virtual void ForEntitiesInBoxRange(const CVector3& c_center,
+                                         const CVector3& c_half_size,
+                                         CEntityOperation& c_operation);
+
+      virtual void ForEntitiesInCircleRange(const CVector3& c_center,
+                                            Real f_radius,
+                                            CEntityOperation& c_operation);
+
+      virtual void ForEntitiesInRectangleRange(const CVector3& c_center,
+                                               const CVector2& c_half_size,
+                                               CEntityOperation& c_operation);
+
+      virtual void ForEntitiesAlongRay(const CRay3& c_ray,
+                                       CEntityOperation& c_operation,
+                                       bool b_stop_at_closest_match = false);
+
+      inline void SetUpdateEntityOperation(CEntityOperation* pc_operation) {
+         m_pcUpdateEntityOperation = pc_operation;
+      }
+
+      /**
+       * Adds an entity to the given cell.
+       * This method is meant to be called by the update operation.
+       */
+      void UpdateCell(SInt32 n_i,
+                      SInt32 n_j,
+                      SInt32 n_k,
+                      ENTITY& c_entity);
+
+      /**
+       * Calculates the cell that contains the given position.
+       * The cell coordinates are clamped to the supported range.
+       */
+      inline void PositionToCell(SInt32& n_i,
+                                 SInt32& n_j,
+                                 SInt32& n_k,
+                                 const CVector3& c_position) const;
+
+      inline const CVector3& GetCellSize() const {
+         return m_cCellSize;
+      }
+
+      /**
+       * Returns the number of cells occupied since the last update.
+       */
+      inline size_t GetNumOccupiedCells() const {
+         return m_vecOccupied.size();
+      }
+
+      /**
+       * Returns the memory allocated by the index, in bytes.
+       */
+      size_t GetMemoryUsage() const;
+
+   private:
+
+      struct SCell {
+         SInt32 I, J, K;
+         UInt32 First;
+         UInt32 Last;
+         size_t Timestamp;
+
+         SCell() : I(0), J(0), K(0), First(0), Last(0), Timestamp(0) {}
+      };
+
+      struct SEntry {
+         ENTITY* Entity;
+         UInt32 Next;
+
+         SEntry(ENTITY* pc_entity) : Entity(pc_entity), Next(NO_ENTRY) {}
+      };
+
+      static const UInt32 NO_ENTRY;
+      static const SInt32 MAX_COORDINATE;
+
+   private:
+
+      inline size_t HashCell(SInt32 n_i,
+                             SInt32 n_j,
+                             SInt32 n_k) const;
+
+      /**
+       * Returns the slot of the given cell, or the empty slot where it should go.
+       */
+      inline size_t FindSlot(SInt32 n_i,
+                             SInt32 n_j,
+                             SInt32 n_k) const;
+
+      inline bool IsOccupied(size_t un_slot) const {
+         return m_vecCells[un_slot].Timestamp == m_unCurTimestamp;
+      }
+
+      void Grow();
+
+      inline SInt32 ClampCoordinate(Real f_value) const;
+
+      /**
+       * Applies the operation to the entities of an occupied cell.
+       * Returns <tt>false</tt> if the operation asked to stop.
+       */
+      inline bool ApplyToCell(const SCell& s_cell,
+                              CEntityOperation& c_operation);
+
+      /**
+       * Applies the operation to the entities of the cells in the given range
+       * that pass the filter. When the range has more cells than the occupied
+       * ones, the occupied cells are scanned instead.
+       */
+      template<typename FILTER>
+      void ForEntitiesInCellRange(SInt32 n_i1, SInt32 n_i2,
+                                  SInt32 n_j1, SInt32 n_j2,
+                                  SInt32 n_k1, SInt32 n_k2,
+                                  const FILTER& c_filter,
+                                  CEntityOperation& c_operation);
+
+      /**
+       * Returns the squared distance between a point and a cell.
+       */
+      inline Real SquareDistanceToCell(const CVector3& c_point,
+                                       SInt32 n_i,
+                                       SInt32 n_j,
+                                       SInt32 n_k) const;
+
+   private:
+
+      CVector3 m_cCellSize;
+      CVector3 m_cInvCellSize;
+      std::vector<SCell> m_vecCells;
+      size_t m_unMask;
+      std::vector<UInt32> m_vecOccupied;
+      std::vector<SEntry> m_vecEntries;
+      size_t m_unCurTimestamp;
+      CSet<ENTITY*,SEntityComparator> m_cEntities;
+      CEntityOperation* m_pcUpdateEntityOperation;
+
+   };
+
+}
+
+#include <argos3/core/simulator/space/positional_indices/spatial_hash_impl.h>
+
+#endif
@@ -0,0 +1,438 @@
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   const UInt32 CSpatialHash<ENTITY>::NO_ENTRY = 0xFFFFFFFF;
+
+   template<class ENTITY>
+   const SInt32 CSpatialHash<ENTITY>::MAX_COORDINATE = (1 << 20) - 1;
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   CSpatialHash<ENTITY>::CSpatialHash(const CVector3& c_cell_size) :
+      m_cCellSize(c_cell_size),
+      m_vecCells(64),
+      m_unMask(63),
+      m_unCurTimestamp(0),
+      m_pcUpdateEntityOperation(NULL) {
+      if(m_cCellSize.GetX() <= 0.0 ||
+         m_cCellSize.GetY() <= 0.0 ||
+         m_cCellSize.GetZ() <= 0.0) {
+         THROW_ARGOSEXCEPTION("The cell size of a spatial hash must be positive, but <" << m_cCellSize << "> was given");
+      }
+      m_cInvCellSize.Set(1.0 / m_cCellSize.GetX(),
+                         1.0 / m_cCellSize.GetY(),
+                         1.0 / m_cCellSize.GetZ());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::Init(TConfigurationNode& t_tree) {
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::Reset() {
+      m_unCurTimestamp = 0;
+      std::fill(m_vecCells.begin(), m_vecCells.end(), SCell());
+      m_vecOccupied.clear();
+      m_vecEntries.clear();
+      Update();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::Destroy() {
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::AddEntity(ENTITY& c_entity) {
+      m_cEntities.insert(&c_entity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::RemoveEntity(ENTITY& c_entity) {
+      m_cEntities.erase(&c_entity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::Update() {
+      /* Cells with an older timestamp count as empty */
+      ++m_unCurTimestamp;
+      m_vecOccupied.clear();
+      m_vecEntries.clear();
+      ForAllEntities(*m_pcUpdateEntityOperation);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::GetEntitiesAt(CSet<ENTITY*,SEntityComparator>& c_entities,
+                                            const CVector3& c_position) const {
+      c_entities.clear();
+      SInt32 i, j, k;
+      PositionToCell(i, j, k, c_position);
+      size_t unSlot = FindSlot(i, j, k);
+      if(IsOccupied(unSlot)) {
+         for(UInt32 e = m_vecCells[unSlot].First; e != NO_ENTRY; e = m_vecEntries[e].Next) {
+            c_entities.insert(m_vecEntries[e].Entity);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::ForAllEntities(CEntityOperation& c_operation) {
+      for(typename CSet<ENTITY*,SEntityComparator>::iterator it = m_cEntities.begin();
+          it != m_cEntities.end() && c_operation(**it);
+          ++it);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::ForEntitiesInSphereRange(const CVector3& c_center,
+                                                       Real f_radius,
+                                                       CEntityOperation& c_operation) {
+      SInt32 nI1, nJ1, nK1, nI2, nJ2, nK2;
+      CVector3 cHalfSize(f_radius, f_radius, f_radius);
+      PositionToCell(nI1, nJ1, nK1, c_center - cHalfSize);
+      PositionToCell(nI2, nJ2, nK2, c_center + cHalfSize);
+      Real fRadius2 = f_radius * f_radius;
+      ForEntitiesInCellRange(
+         nI1, nI2, nJ1, nJ2, nK1, nK2,
+         [this, &c_center, fRadius2](SInt32 n_i, SInt32 n_j, SInt32 n_k) {
+            return SquareDistanceToCell(c_center, n_i, n_j, n_k) <= fRadius2;
+         },
+         c_operation);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::ForEntitiesInBoxRange(const CVector3& c_center,
+                                                    const CVector3& c_half_size,
+                                                    CEntityOperation& c_operation) {
+      SInt32 nI1, nJ1, nK1, nI2, nJ2, nK2;
+      PositionToCell(nI1, nJ1, nK1, c_center - c_half_size);
+      PositionToCell(nI2, nJ2, nK2, c_center + c_half_size);
+      ForEntitiesInCellRange(
+         nI1, nI2, nJ1, nJ2, nK1, nK2,
+         [](SInt32, SInt32, SInt32) { return true; },
+         c_operation);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::ForEntitiesInCircleRange(const CVector3& c_center,
+                                                       Real f_radius,
+                                                       CEntityOperation& c_operation) {
+      /* Only the layer of cells that contains the center is considered */
+      SInt32 nI1, nJ1, nK, nI2, nJ2;
+      CVector3 cHalfSize(f_radius, f_radius, 0.0);
+      PositionToCell(nI1, nJ1, nK, c_center - cHalfSize);
+      PositionToCell(nI2, nJ2, nK, c_center + cHalfSize);
+      Real fRadius2 = f_radius * f_radius;
+      ForEntitiesInCellRange(
+         nI1, nI2, nJ1, nJ2, nK, nK,
+         [this, &c_center, fRadius2](SInt32 n_i, SInt32 n_j, SInt32) {
+            Real fDX = Max<Real>(0.0, Max(n_i * m_cCellSize.GetX() - c_center.GetX(),
+                                          c_center.GetX() - (n_i + 1) * m_cCellSize.GetX()));
+            Real fDY = Max<Real>(0.0, Max(n_j * m_cCellSize.GetY() - c_center.GetY(),
+                                          c_center.GetY() - (n_j + 1) * m_cCellSize.GetY()));
+            return fDX * fDX + fDY * fDY <= fRadius2;
+         },
+         c_operation);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::ForEntitiesInRectangleRange(const CVector3& c_center,
+                                                          const CVector2& c_half_size,
+                                                          CEntityOperation& c_operation) {
+      /* Only the layer of cells that contains the center is considered */
+      SInt32 nI1, nJ1, nK, nI2, nJ2;
+      CVector3 cHalfSize(c_half_size.GetX(), c_half_size.GetY(), 0.0);
+      PositionToCell(nI1, nJ1, nK, c_center - cHalfSize);
+      PositionToCell(nI2, nJ2, nK, c_center + cHalfSize);
+      ForEntitiesInCellRange(
+         nI1, nI2, nJ1, nJ2, nK, nK,
+         [](SInt32, SInt32, SInt32) { return true; },
+         c_operation);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::ForEntitiesAlongRay(const CRay3& c_ray,
+                                                  CEntityOperation& c_operation,
+                                                  bool b_stop_at_closest_match) {
+      /* Visit the cells crossed by the ray in order (Amanatides & Woo, 1987) */
+      SInt32 pnCell[3], pnEndCell[3], pnStep[3];
+      Real pfMax[3], pfDelta[3];
+      PositionToCell(pnCell[0], pnCell[1], pnCell[2], c_ray.GetStart());
+      PositionToCell(pnEndCell[0], pnEndCell[1], pnEndCell[2], c_ray.GetEnd());
+      CVector3 cDirection;
+      c_ray.GetDirection(cDirection);
+      Real fLength = c_ray.GetLength();
+      for(UInt32 a = 0; a < 3; ++a) {
+         if(cDirection[a] > 0.0) {
+            pnStep[a] = 1;
+            pfDelta[a] = m_cCellSize[a] / cDirection[a];
+            pfMax[a] = ((pnCell[a] + 1) * m_cCellSize[a] - c_ray.GetStart()[a]) / cDirection[a];
+         }
+         else if(cDirection[a] < 0.0) {
+            pnStep[a] = -1;
+            pfDelta[a] = -m_cCellSize[a] / cDirection[a];
+            pfMax[a] = (pnCell[a] * m_cCellSize[a] - c_ray.GetStart()[a]) / cDirection[a];
+         }
+         else {
+            pnStep[a] = 0;
+            pfDelta[a] = fLength;
+            pfMax[a] = fLength + 1.0;
+         }
+      }
+      /* The number of crossed cells is bounded, which guards against rounding errors */
+      UInt32 unSteps =
+         Abs(pnEndCell[0] - pnCell[0]) +
+         Abs(pnEndCell[1] - pnCell[1]) +
+         Abs(pnEndCell[2] - pnCell[2]);
+      for(UInt32 s = 0; s <= unSteps; ++s) {
+         size_t unSlot = FindSlot(pnCell[0], pnCell[1], pnCell[2]);
+         if(IsOccupied(unSlot)) {
+            if(!ApplyToCell(m_vecCells[unSlot], c_operation)) return;
+            if(b_stop_at_closest_match) return;
+         }
+         /* Move to the next cell along the axis with the closest boundary */
+         UInt32 unAxis = (pfMax[0] < pfMax[1]) ?
+            ((pfMax[0] < pfMax[2]) ? 0 : 2) :
+            ((pfMax[1] < pfMax[2]) ? 1 : 2);
+         if(pfMax[unAxis] > fLength) return;
+         pnCell[unAxis] += pnStep[unAxis];
+         pfMax[unAxis] += pfDelta[unAxis];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::UpdateCell(SInt32 n_i,
+                                         SInt32 n_j,
+                                         SInt32 n_k,
+                                         ENTITY& c_entity) {
+      /* Keep the load factor below 1/2 */
+      if(2 * (m_vecOccupied.size() + 1) > m_vecCells.size()) {
+         Grow();
+      }
+      size_t unSlot = FindSlot(n_i, n_j, n_k);
+      SCell& sCell = m_vecCells[unSlot];
+      UInt32 unEntry = m_vecEntries.size();
+      if(!IsOccupied(unSlot)) {
+         /* New cell */
+         sCell.I = n_i;
+         sCell.J = n_j;
+         sCell.K = n_k;
+         sCell.First = unEntry;
+         sCell.Timestamp = m_unCurTimestamp;
+         m_vecOccupied.push_back(unSlot);
+      }
+      else if(m_vecEntries[sCell.Last].Entity == &c_entity) {
+         /* The entity is already in this cell */
+         return;
+      }
+      else {
+         m_vecEntries[sCell.Last].Next = unEntry;
+      }
+      sCell.Last = unEntry;
+      m_vecEntries.push_back(SEntry(&c_entity));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::PositionToCell(SInt32& n_i,
+                                             SInt32& n_j,
+                                             SInt32& n_k,
+                                             const CVector3& c_position) const {
+      n_i = ClampCoordinate(c_position.GetX() * m_cInvCellSize.GetX());
+      n_j = ClampCoordinate(c_position.GetY() * m_cInvCellSize.GetY());
+      n_k = ClampCoordinate(c_position.GetZ() * m_cInvCellSize.GetZ());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   size_t CSpatialHash<ENTITY>::GetMemoryUsage() const {
+      return
+         m_vecCells.capacity()    * sizeof(SCell) +
+         m_vecOccupied.capacity() * sizeof(UInt32) +
+         m_vecEntries.capacity()  * sizeof(SEntry);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   size_t CSpatialHash<ENTITY>::HashCell(SInt32 n_i,
+                                         SInt32 n_j,
+                                         SInt32 n_k) const {
+      /* Pack 21 bits per coordinate and mix them with a Fibonacci hash */
+      UInt64 unKey =
+         (static_cast<UInt64>(n_i + MAX_COORDINATE + 1) << 42) |
+         (static_cast<UInt64>(n_j + MAX_COORDINATE + 1) << 21) |
+          static_cast<UInt64>(n_k + MAX_COORDINATE + 1);
+      unKey *= 0x9E3779B97F4A7C15ULL;
+      return static_cast<size_t>(unKey >> 32) & m_unMask;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   size_t CSpatialHash<ENTITY>::FindSlot(SInt32 n_i,
+                                         SInt32 n_j,
+                                         SInt32 n_k) const {
+      size_t unSlot = HashCell(n_i, n_j, n_k);
+      while(IsOccupied(unSlot)) {
+         const SCell& sCell = m_vecCells[unSlot];
+         if(sCell.I == n_i && sCell.J == n_j && sCell.K == n_k) break;
+         unSlot = (unSlot + 1) & m_unMask;
+      }
+      return unSlot;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   void CSpatialHash<ENTITY>::Grow() {
+      std::vector<SCell> vecOld(2 * m_vecCells.size());
+      vecOld.swap(m_vecCells);
+      m_unMask = m_vecCells.size() - 1;
+      /* Reinsert the occupied cells, the entries stay where they are */
+      for(size_t i = 0; i < m_vecOccupied.size(); ++i) {
+         const SCell& sCell = vecOld[m_vecOccupied[i]];
+         size_t unSlot = FindSlot(sCell.I, sCell.J, sCell.K);
+         m_vecCells[unSlot] = sCell;
+         m_vecOccupied[i] = unSlot;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   SInt32 CSpatialHash<ENTITY>::ClampCoordinate(Real f_value) const {
+      Real fCell = Floor(f_value);
+      if(fCell > MAX_COORDINATE) return MAX_COORDINATE;
+      if(fCell < -MAX_COORDINATE) return -MAX_COORDINATE;
+      return static_cast<SInt32>(fCell);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   bool CSpatialHash<ENTITY>::ApplyToCell(const SCell& s_cell,
+                                          CEntityOperation& c_operation) {
+      for(UInt32 e = s_cell.First; e != NO_ENTRY; e = m_vecEntries[e].Next) {
+         if(!c_operation(*m_vecEntries[e].Entity)) return false;
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   template<typename FILTER>
+   void CSpatialHash<ENTITY>::ForEntitiesInCellRange(SInt32 n_i1, SInt32 n_i2,
+                                                     SInt32 n_j1, SInt32 n_j2,
+                                                     SInt32 n_k1, SInt32 n_k2,
+                                                     const FILTER& c_filter,
+                                                     CEntityOperation& c_operation) {
+      UInt64 unRangeCells =
+         static_cast<UInt64>(n_i2 - n_i1 + 1) *
+         static_cast<UInt64>(n_j2 - n_j1 + 1) *
+         static_cast<UInt64>(n_k2 - n_k1 + 1);
+      if(unRangeCells > m_vecOccupied.size()) {
+         /* Large range: scanning the occupied cells is cheaper */
+         for(size_t c = 0; c < m_vecOccupied.size(); ++c) {
+            const SCell& sCell = m_vecCells[m_vecOccupied[c]];
+            if(sCell.I >= n_i1 && sCell.I <= n_i2 &&
+               sCell.J >= n_j1 && sCell.J <= n_j2 &&
+               sCell.K >= n_k1 && sCell.K <= n_k2 &&
+               c_filter(sCell.I, sCell.J, sCell.K)) {
+               if(!ApplyToCell(sCell, c_operation)) return;
+            }
+         }
+      }
+      else {
+         /* Small range: look up each cell */
+         for(SInt32 k = n_k1; k <= n_k2; ++k) {
+            for(SInt32 j = n_j1; j <= n_j2; ++j) {
+               for(SInt32 i = n_i1; i <= n_i2; ++i) {
+                  size_t unSlot = FindSlot(i, j, k);
+                  if(IsOccupied(unSlot) && c_filter(i, j, k)) {
+                     if(!ApplyToCell(m_vecCells[unSlot], c_operation)) return;
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class ENTITY>
+   Real CSpatialHash<ENTITY>::SquareDistanceToCell(const CVector3& c_point,
+                                                   SInt32 n_i,
+                                                   SInt32 n_j,
+                                                   SInt32 n_k) const {
+      Real fDX = Max<Real>(0.0, Max(n_i * m_cCellSize.GetX() - c_point.GetX(),
+                                    c_point.GetX() - (n_i + 1) * m_cCellSize.GetX()));
+      Real fDY = Max<Real>(0.0, Max(n_j * m_cCellSize.GetY() - c_point.GetY(),
+                                    c_point.GetY() - (n_j + 1) * m_cCellSize.GetY()));
+      Real fDZ = Max<Real>(0.0, Max(n_k * m_cCellSize.GetZ() - c_point.GetZ(),
+                                    c_point.GetZ() - (n_k + 1) * m_cCellSize.GetZ()));
+      Real fDist2 = fDX * fDX + fDY * fDY + fDZ * fDZ;
+      return fDist2;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
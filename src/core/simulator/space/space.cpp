@@ -14,6 +14,8 @@
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/entity/entity_pool.h>
+#include <argos3/core/simulator/entity/floor_entity.h>
 #include <argos3/core/simulator/entity/positional_entity.h>
 #include <argos3/core/simulator/loop_functions.h>
 #include <cstring>
@@ -24,12 +26,31 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /* The cell size of the embodied entity index, close to the size of the robots */
+   static const CVector3 EMBODIED_ENTITY_INDEX_CELL_SIZE(0.5, 0.5, 0.5);
+
+   /****************************************/
+   /****************************************/
+
    CSpace::CSpace() :
       m_cSimulator(CSimulator::GetInstance()),
       m_unSimulationClock(0),
       m_pcFloorEntity(nullptr),
       m_ptPhysicsEngines(nullptr),
-      m_ptMedia(nullptr) {}
+      m_ptMedia(nullptr),
+      m_pcEmbodiedEntityIndex(nullptr),
+      m_pcEmbodiedEntityIndexUpdater(nullptr),
+      m_unEmbodiedEntityIndexClock(0),
+      m_bEmbodiedEntityIndexStale(true) {
+      pthread_mutex_init(&m_tEmbodiedEntityIndexMutex, nullptr);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CSpace::~CSpace() {
+      pthread_mutex_destroy(&m_tEmbodiedEntityIndexMutex);
+   }
 
    /****************************************/
    /****************************************/
@@ -48,10 +69,23 @@ namespace argos {
        */
       /* Start from the entities placed manually */
       TConfigurationNodeIterator itArenaItem;
+      /* Make room for them at once, large arenas list many thousands */
+      size_t unManual = 0;
+      for(itArenaItem = itArenaItem.begin(&t_tree);
+          itArenaItem != itArenaItem.end();
+          ++itArenaItem) {
+         if(itArenaItem->Value() != "distribute") ++unManual;
+      }
+      m_vecRootEntities.reserve(unManual);
+      m_vecEntities.reserve(unManual);
       for(itArenaItem = itArenaItem.begin(&t_tree);
           itArenaItem != itArenaItem.end();
           ++itArenaItem) {
          if(itArenaItem->Value() != "distribute") {
+#ifdef ARGOS_ENTITY_POOL
+            /* Keep the entity and its components together in memory */
+            CEntityPool::CScope cPoolScope;
+#endif
             CEntity* pcEntity = CFactory<CEntity>::New(itArenaItem->Value());
             pcEntity->Init(*itArenaItem);
             CallEntityOperation<CSpaceOperationAddEntity, CSpace, void>(*this, *pcEntity);
@@ -73,6 +107,8 @@ namespace argos {
    void CSpace::Reset() {
       /* Reset the simulation clock */
       m_unSimulationClock = 0;
+      /* The entities go back to their initial positions */
+      m_bEmbodiedEntityIndexStale = true;
       /* Reset the entities */
       for(UInt32 i = 0; i < m_vecEntities.size(); ++i) {
          m_vecEntities[i]->Reset();
@@ -87,6 +123,42 @@ namespace argos {
       while(!m_vecRootEntities.empty()) {
          CallEntityOperation<CSpaceOperationRemoveEntity, CSpace, void>(*this, *m_vecRootEntities.back());
       }
+      /* Delete the embodied entity index */
+      delete m_pcEmbodiedEntityIndex;
+      delete m_pcEmbodiedEntityIndexUpdater;
+      m_pcEmbodiedEntityIndex = nullptr;
+      m_pcEmbodiedEntityIndexUpdater = nullptr;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CPositionalIndex<CEmbodiedEntity>& CSpace::GetEmbodiedEntityIndex() {
+      pthread_mutex_lock(&m_tEmbodiedEntityIndexMutex);
+      if(m_bEmbodiedEntityIndexStale) {
+         /* Make a new index with the current entities */
+         delete m_pcEmbodiedEntityIndex;
+         delete m_pcEmbodiedEntityIndexUpdater;
+         m_pcEmbodiedEntityIndex = new CSpatialHash<CEmbodiedEntity>(EMBODIED_ENTITY_INDEX_CELL_SIZE);
+         m_pcEmbodiedEntityIndexUpdater = new CEmbodiedEntitySpatialHashUpdater(*m_pcEmbodiedEntityIndex);
+         m_pcEmbodiedEntityIndex->SetUpdateEntityOperation(m_pcEmbodiedEntityIndexUpdater);
+         TMapPerTypePerId::iterator itBodies = m_mapEntitiesPerTypePerId.find("body");
+         if(itBodies != m_mapEntitiesPerTypePerId.end()) {
+            for(auto& c_item : itBodies->second) {
+               m_pcEmbodiedEntityIndex->AddEntity(*any_cast<CEmbodiedEntity*>(c_item.second));
+            }
+         }
+         m_pcEmbodiedEntityIndex->Update();
+         m_unEmbodiedEntityIndexClock = m_unSimulationClock;
+         m_bEmbodiedEntityIndexStale = false;
+      }
+      else if(m_unEmbodiedEntityIndexClock != m_unSimulationClock) {
+         /* The entities moved */
+         m_pcEmbodiedEntityIndex->Update();
+         m_unEmbodiedEntityIndexClock = m_unSimulationClock;
+      }
+      pthread_mutex_unlock(&m_tEmbodiedEntityIndexMutex);
+      return *m_pcEmbodiedEntityIndex;
    }
 
    /****************************************/
@@ -125,37 +197,20 @@ namespace argos {
       UpdatePhysics();
       /* Update media */
       UpdateMedia();
-      /* Call loop functions */
+      /* Call loop functions, which can use the ARGoS threads */
+      StartLoopFunctionTasks();
       m_cSimulator.GetLoopFunctions().PreStep();
-      /*
-       * If the loop functions did not use ARGoS threads during PreStep(), tell
-       * the waiting thread pool to continue.
-       */
-      if (!ControllableEntityIterationEnabled()) {
-        ControllableEntityIterationWaitAbort();
+      /* Bring the floor raster up to date before the robots sense */
+      if(m_pcFloorEntity != nullptr) {
+         m_pcFloorEntity->Update();
       }
-      /*
-       * Reset callback to NULL to disable entity iteration for PostStep()
-       * unless enabled again by the loop functions.
-       */
-      m_cbControllableEntityIter = nullptr;
+      EndLoopFunctionTasks();
       /* Perform the 'sense+step' phase for controllable entities */
       UpdateControllableEntitiesSenseStep();
-      /* Call loop functions */
+      /* Call loop functions, which can use the ARGoS threads */
+      StartLoopFunctionTasks();
       m_cSimulator.GetLoopFunctions().PostStep();
-
-      /*
-       * If the loop functions did not use ARGoS threads during PostStep(), tell
-       * the waiting thread pool to continue.
-       */
-      if (!ControllableEntityIterationEnabled()) {
-        ControllableEntityIterationWaitAbort();
-      }
-      /*
-       * Reset callback to NULL to disable entity iteration for next PreStep()
-       * unless enabled again by the loop functions.
-       */
-      m_cbControllableEntityIter = nullptr;
+      EndLoopFunctionTasks();
       /* Flush logs */
       LOG.Flush();
       LOGERR.Flush();
@@ -164,6 +219,37 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CSpace::IterateOverControllableEntities(
+       const TControllableEntityIterCBType& c_cb) {
+      /* Small chunks, so that robots with slow callbacks are spread among the threads */
+      size_t unChunkSize = Max<size_t>(
+         1, m_vecControllableEntities.size() / (Max<UInt32>(1, m_cSimulator.GetNumThreads()) * 4));
+      ParallelFor(m_vecControllableEntities.size(),
+                  unChunkSize,
+                  [this, &c_cb](size_t, size_t un_begin, size_t un_end) {
+                     for(size_t i = un_begin; i < un_end; ++i) {
+                        c_cb(m_vecControllableEntities[i]);
+                     }
+                  });
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::ParallelFor(size_t un_items,
+                            size_t un_chunk_size,
+                            const TParallelForCBType& c_cb) {
+      un_chunk_size = Max<size_t>(1, un_chunk_size);
+      for(size_t unBegin = 0, unChunk = 0;
+          unBegin < un_items;
+          unBegin += un_chunk_size, ++unChunk) {
+         c_cb(unChunk, unBegin, Min(unBegin + un_chunk_size, un_items));
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CSpace::AddControllableEntity(CControllableEntity& c_entity) {
       m_vecControllableEntities.push_back(&c_entity);
    }
@@ -473,6 +559,10 @@ namespace argos {
             bool bRetry = false;
             CEntity* pcEntity;
             do {
+#ifdef ARGOS_ENTITY_POOL
+               /* Keep the entity and its components together in memory */
+               CEntityPool::CScope cPoolScope;
+#endif
                /* Create entity */
                pcEntity = CFactory<CEntity>::New(tEntityTree.Value());
                /*
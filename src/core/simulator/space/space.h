@@ -17,7 +17,9 @@ namespace argos {
 }
 
 #include <functional>
+#include <iterator>
 #include <string>
+#include <pthread.h>
 
 #include <argos3/core/utility/datatypes/any.h>
 #include <argos3/core/simulator/medium/medium.h>
@@ -89,6 +91,15 @@ namespace argos {
       */
       typedef std::function<void(CControllableEntity*)> TControllableEntityIterCBType;
 
+     /**
+      * The callback type for ParallelFor(). The callback processes the items
+      * in <tt>[un_begin, un_end)</tt>, which form the chunk with index
+      * <tt>un_chunk</tt>.
+      *
+      * @see ParallelFor()
+      */
+      typedef std::function<void(size_t un_chunk, size_t un_begin, size_t un_end)> TParallelForCBType;
+
       /****************************************/
       /****************************************/
 
@@ -102,7 +113,7 @@ namespace argos {
       /**
        * Class destructor.
        */
-      virtual ~CSpace() {}
+      virtual ~CSpace();
 
       /**
        * Initializes the space using the <tt>&lt;arena&gt;</tt> section of the XML configuration file.
@@ -249,6 +260,16 @@ namespace argos {
          m_pcFloorEntity = &c_floor_entity;
       }
 
+      /**
+       * Returns a positional index of the embodied entities, by bounding box.
+       * The index is brought up to date on demand, at most once per step, by
+       * the first call after the entities moved, so it costs nothing when it
+       * is not used. It can be queried by sensors running in parallel.
+       * Entities spanning more than one cell are visited once per cell.
+       * @return a positional index of the embodied entities.
+       */
+      CPositionalIndex<CEmbodiedEntity>& GetEmbodiedEntityIndex();
+
       /**
        * Updates the space.
        * The operations are performed in the following order:
@@ -296,6 +317,7 @@ namespace argos {
          c_entity.SetIndex(unIdx);
          m_mapEntitiesPerId[strEntityQualifiedName] = &c_entity;
          m_mapEntitiesPerTypePerId[c_entity.GetTypeDescription()][strEntityQualifiedName] = &c_entity;
+         m_bEmbodiedEntityIndexStale = true;
       }
 
       /**
@@ -312,23 +334,25 @@ namespace argos {
             /* Search for entity in the index per type per id */
             TMapPerType::iterator itMapPerTypePerId = itMapPerType->second.find(strEntityQualifiedName);
             if(itMapPerTypePerId != itMapPerType->second.end()) {
-               /* Remove the entity from the indexes */
-               CEntity::TVector::iterator itVec = find(m_vecEntities.begin(),
-                                                       m_vecEntities.end(),
-                                                       &c_entity);
-               m_vecEntities.erase(itVec);
+               /* Remove the entity from the indexes. Entities are mostly
+                  removed in reverse order of addition, so search from the end */
+               CEntity::TVector::reverse_iterator itVec = find(m_vecEntities.rbegin(),
+                                                               m_vecEntities.rend(),
+                                                               &c_entity);
+               m_vecEntities.erase(std::next(itVec).base());
                CEntity::TMap::iterator itMap = m_mapEntitiesPerId.find(strEntityQualifiedName);
                itMapPerType->second.erase(itMapPerTypePerId);
                m_mapEntitiesPerId.erase(itMap);
                if(!c_entity.HasParent()) {
-                  CEntity::TVector::iterator itRootVec = find(m_vecRootEntities.begin(),
-                                                              m_vecRootEntities.end(),
-                                                              &c_entity);
-                  m_vecRootEntities.erase(itRootVec);
+                  CEntity::TVector::reverse_iterator itRootVec = find(m_vecRootEntities.rbegin(),
+                                                                      m_vecRootEntities.rend(),
+                                                                      &c_entity);
+                  m_vecRootEntities.erase(std::next(itRootVec).base());
                }
                /* Remove entity object */
                c_entity.Destroy();
                delete &c_entity;
+               m_bEmbodiedEntityIndexStale = true;
                return;
             }
          }
@@ -420,7 +444,27 @@ namespace argos {
       * those that are currently disabled).
       */
       virtual void IterateOverControllableEntities(
-          const TControllableEntityIterCBType& c_cb) = 0;
+          const TControllableEntityIterCBType& c_cb);
+
+     /**
+      * \brief Splits the items in <tt>[0, un_items)</tt> into consecutive
+      * chunks of <tt>un_chunk_size</tt> items, and calls the given callback on
+      * each chunk. Returns when all the chunks are done.
+      *
+      * During CLoopFunctions::PreStep() and CLoopFunctions::PostStep(), the
+      * chunks are processed by the ARGoS threads, if any, in no particular
+      * order. Otherwise, and when called from within a callback, the chunks
+      * are processed in order by the calling thread. If a callback throws, the
+      * exception is rethrown by this method once all the chunks are done.
+      *
+      * @param un_items The number of items.
+      * @param un_chunk_size The number of items in a chunk; the last chunk can be shorter.
+      * @param c_cb The callback.
+      * @see CLoopFunctions::MapReduce()
+      */
+      virtual void ParallelFor(size_t un_items,
+                               size_t un_chunk_size,
+                               const TParallelForCBType& c_cb);
 
    protected:
 
@@ -430,26 +474,31 @@ namespace argos {
       virtual void UpdateControllableEntitiesSenseStep() = 0;
 
       /**
-       * \brief If the loop functions do not perform entity iteration in either
-       * of the PreStep() or PostStep() functions, then the threads which are
-       * currently waiting for the "go" signal from the loop functions need to
-       * be told in CSpace::Update() that they should stop waiting and start the
-       * next phase of the per-timestep updates.
+       * \brief Called by Update() before CLoopFunctions::PreStep() and
+       * CLoopFunctions::PostStep(). From here to the matching
+       * EndLoopFunctionTasks(), ParallelFor() can use the ARGoS threads.
        *
-       * Unused if ARGoS was not configured to use threads in the input file.
+       * The default implementation does nothing.
        *
        * @see Update()
        */
-      virtual void ControllableEntityIterationWaitAbort() {}
+      virtual void StartLoopFunctionTasks() {}
+
+      /**
+       * \brief Called by Update() after CLoopFunctions::PreStep() and
+       * CLoopFunctions::PostStep(). The ARGoS threads, which were waiting for
+       * ParallelFor() tasks, go on with the next phase of the time step.
+       *
+       * The default implementation does nothing.
+       *
+       * @see Update()
+       */
+      virtual void EndLoopFunctionTasks() {}
 
       void Distribute(TConfigurationNode& t_tree);
 
       void AddBoxStrip(TConfigurationNode& t_tree);
 
-      bool ControllableEntityIterationEnabled() const {
-        return nullptr != m_cbControllableEntityIter;
-      }
-
    protected:
 
       friend class CSpaceOperationAddControllableEntity;
@@ -499,8 +548,20 @@ namespace argos {
       /** A pointer to the list of media */
       CMedium::TVector* m_ptMedia;
 
-      /** Callback for iterating over entities from within the loop functions */
-      TControllableEntityIterCBType m_cbControllableEntityIter{nullptr};
+      /** The positional index of the embodied entities, built on demand */
+      CSpatialHash<CEmbodiedEntity>* m_pcEmbodiedEntityIndex;
+
+      /** The operation that inserts the embodied entities in their index */
+      CEmbodiedEntitySpatialHashUpdater* m_pcEmbodiedEntityIndexUpdater;
+
+      /** The simulation clock at the last update of the embodied entity index */
+      UInt32 m_unEmbodiedEntityIndexClock;
+
+      /** True when entities were added or removed since the index was built */
+      bool m_bEmbodiedEntityIndexStale;
+
+      /** Serializes the updates of the embodied entity index */
+      pthread_mutex_t m_tEmbodiedEntityIndexMutex;
 
   private:
       TMapPerType& GetEntitiesByTypeImpl(const std::string& str_type) const;
@@ -5,20 +5,158 @@
  */
 
 #include <argos3/core/simulator/space/space_multi_thread.h>
+#include <cstring>
 
 namespace argos {
 
    /****************************************/
    /****************************************/
 
+   static void UnlockTaskMutex(void* p_mutex) {
+     pthread_mutex_unlock(reinterpret_cast<pthread_mutex_t*>(p_mutex));
+   }
+
+   /****************************************/
+   /****************************************/
+
    CSpaceMultiThread::CSpaceMultiThread(UInt32 un_n_threads,
                                         bool b_pin_threads_to_cores) :
+       m_unTaskRound(0),
+       m_unTaskDoneCounter(0),
+       m_pcTask(nullptr),
+       m_unTaskItems(0),
+       m_unTaskChunkSize(1),
+       m_unNextTaskChunk(0),
+       m_bServingTasks(false),
+       m_bTaskRunning(false),
        m_bPinThreadsToCores(b_pin_threads_to_cores),
        m_vecThreads(un_n_threads) {
      LOG << "[INFO] Using " << GetNumThreads() << " parallel threads" << std::endl;
      if (m_bPinThreadsToCores) {
        LOG << "[INFO]   Pinning threads to cores by thread ID" << std::endl;
      }
+     int nErrors;
+     if((nErrors = pthread_mutex_init(&m_tTaskMutex, nullptr)) ||
+        (nErrors = pthread_cond_init(&m_tTaskCond, nullptr))) {
+       THROW_ARGOSEXCEPTION("Error creating the loop function task mutex " << ::strerror(nErrors));
+     }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CSpaceMultiThread::~CSpaceMultiThread() {
+     pthread_mutex_destroy(&m_tTaskMutex);
+     pthread_cond_destroy(&m_tTaskCond);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThread::ParallelFor(size_t un_items,
+                                       size_t un_chunk_size,
+                                       const TParallelForCBType& c_cb) {
+     /*
+      * Only the main thread can hand out tasks, and only while the threads
+      * are waiting for them. Calls from within a task run in place.
+      */
+     if(!m_bServingTasks || m_bTaskRunning || un_items == 0) {
+       CSpace::ParallelFor(un_items, un_chunk_size, c_cb);
+       return;
+     }
+     RunLoopFunctionTaskRound(&c_cb, un_items, Max<size_t>(1, un_chunk_size));
+     /* Pass on the first exception thrown by the task, if any */
+     if(m_pcTaskException) {
+       std::exception_ptr pcException = m_pcTaskException;
+       m_pcTaskException = nullptr;
+       std::rethrow_exception(pcException);
+     }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThread::StartLoopFunctionTasks() {
+     m_bServingTasks = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThread::EndLoopFunctionTasks() {
+     m_bServingTasks = false;
+     /* Let the threads go on with the time step */
+     RunLoopFunctionTaskRound(nullptr, 0, 1);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThread::RunLoopFunctionTaskRound(const TParallelForCBType* pc_task,
+                                                    size_t un_items,
+                                                    size_t un_chunk_size) {
+     LOG.Flush();
+     LOGERR.Flush();
+     m_bTaskRunning = true;
+     pthread_mutex_lock(&m_tTaskMutex);
+     m_pcTask = pc_task;
+     m_unTaskItems = un_items;
+     m_unTaskChunkSize = un_chunk_size;
+     m_unNextTaskChunk = 0;
+     m_unTaskDoneCounter = 0;
+     ++m_unTaskRound;
+     pthread_cond_broadcast(&m_tTaskCond);
+     while(m_unTaskDoneCounter < GetNumThreads()) {
+       pthread_cond_wait(&m_tTaskCond, &m_tTaskMutex);
+     }
+     pthread_mutex_unlock(&m_tTaskMutex);
+     m_bTaskRunning = false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThread::ServeLoopFunctionTasks(UInt32& un_round) {
+     while(1) {
+       /* Wait for the next round */
+       const TParallelForCBType* pcTask;
+       pthread_mutex_lock(&m_tTaskMutex);
+       pthread_cleanup_push(UnlockTaskMutex, &m_tTaskMutex);
+       while(m_unTaskRound == un_round) {
+         pthread_cond_wait(&m_tTaskCond, &m_tTaskMutex);
+       }
+       un_round = m_unTaskRound;
+       pcTask = m_pcTask;
+       pthread_cleanup_pop(1);
+       pthread_testcancel();
+       /* Run chunks until there are none left */
+       if(pcTask != nullptr) {
+         size_t unChunk;
+         size_t unBegin;
+         while((unBegin = (unChunk = m_unNextTaskChunk.fetch_add(1)) * m_unTaskChunkSize) < m_unTaskItems) {
+           try {
+             (*pcTask)(unChunk, unBegin, Min(unBegin + m_unTaskChunkSize, m_unTaskItems));
+           }
+           catch(...) {
+             pthread_mutex_lock(&m_tTaskMutex);
+             if(!m_pcTaskException) {
+               m_pcTaskException = std::current_exception();
+             }
+             pthread_mutex_unlock(&m_tTaskMutex);
+           }
+         }
+       }
+       /* Signal the end of the round */
+       pthread_mutex_lock(&m_tTaskMutex);
+       ++m_unTaskDoneCounter;
+       pthread_cond_broadcast(&m_tTaskCond);
+       pthread_mutex_unlock(&m_tTaskMutex);
+       pthread_testcancel();
+       /* A round without task ends the loop functions */
+       if(pcTask == nullptr) {
+         return;
+       }
+     }
    }
 
    /****************************************/
@@ -10,7 +10,10 @@
 #ifndef INCLUDE_SPACE_MULTI_THREAD_H_
 #define INCLUDE_SPACE_MULTI_THREAD_H_
 
+#include <atomic>
+#include <exception>
 #include <vector>
+#include <pthread.h>
 
 namespace argos {
   class CSpace;
@@ -22,21 +25,47 @@ namespace argos {
 
    /**
     * @brief Base class for common threading functionality used by @ref
-    * CSpaceMultithreadBalanceLength, @ref CSpaceMultithreadBalanceQuantity.
+    * CSpaceMultithreadBalanceLength, @ref CSpaceMultithreadBalanceQuantity,
+    * @ref CSpaceMultiThreadBalanceCost.
     */
    class CSpaceMultiThread : public CSpace {
     public:
 
      CSpaceMultiThread(UInt32 un_n_threads, bool b_pin_threads);
 
+     virtual ~CSpaceMultiThread();
+
      /**
       * @brief Return the # of configured threads. If threads were not
       * specified, returns 0.
       */
      inline UInt32 GetNumThreads() const { return m_vecThreads.size(); }
 
+     /**
+      * @brief Runs the chunks on the threads, which pick them in turn, when
+      * called by the main thread during the loop functions. Otherwise, runs
+      * them in order in the calling thread.
+      */
+     virtual void ParallelFor(size_t un_items,
+                              size_t un_chunk_size,
+                              const TParallelForCBType& c_cb);
+
     protected:
 
+     virtual void StartLoopFunctionTasks();
+
+     virtual void EndLoopFunctionTasks();
+
+     /**
+      * @brief Called by each thread where it used to wait for the loop
+      * functions. Runs the chunks of each ParallelFor() call, until
+      * EndLoopFunctionTasks() is called.
+      *
+      * @param un_round The last task round seen by the calling thread, 0 at
+      *                 the start. Each thread keeps its own.
+      */
+     void ServeLoopFunctionTasks(UInt32& un_round);
+
      /**
       * @brief After ARGoS finishes running the experiment, dispose of all
       * threads, which are no longer needed.
@@ -59,6 +88,50 @@ namespace argos {
 
     private:
 
+     /**
+      * @brief Has the threads run the given task, or leave the loop
+      * functions if the task is <tt>nullptr</tt>, and waits for all of them
+      * to be done.
+      */
+     void RunLoopFunctionTaskRound(const TParallelForCBType* pc_task,
+                                   size_t un_items,
+                                   size_t un_chunk_size);
+
+    private:
+
+     /** Protects the task round data */
+     pthread_mutex_t m_tTaskMutex;
+
+     /** Signals the start and the end of the task rounds */
+     pthread_cond_t m_tTaskCond;
+
+     /** The current task round; the threads wait for it to change */
+     UInt32 m_unTaskRound;
+
+     /** The number of threads done with the current task round */
+     UInt32 m_unTaskDoneCounter;
+
+     /** The task of the current round, or <tt>nullptr</tt> to leave the loop functions */
+     const TParallelForCBType* m_pcTask;
+
+     /** The number of items of the current task */
+     size_t m_unTaskItems;
+
+     /** The number of items in a chunk of the current task */
+     size_t m_unTaskChunkSize;
+
+     /** The next chunk of the current task to run */
+     std::atomic<size_t> m_unNextTaskChunk;
+
+     /** The first exception thrown by the current task */
+     std::exception_ptr m_pcTaskException;
+
+     /** <tt>true</tt> while the threads wait for loop function tasks */
+     bool m_bServingTasks;
+
+     /** <tt>true</tt> while a task round is running */
+     std::atomic<bool> m_bTaskRunning;
+
      /** Should threads be pinned to cores ? */
      bool m_bPinThreadsToCores;
 
@@ -0,0 +1,445 @@
+/**
+ * @file <argos3/core/simulator/space/space_multi_thread_balance_cost.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/utility/profiler/profiler.h>
+#include "space_multi_thread_balance_cost.h"
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const Real   CSpaceMultiThreadBalanceCost::COST_SMOOTHING     = 0.1;
+   const UInt32 CSpaceMultiThreadBalanceCost::BATCHES_PER_THREAD = 4;
+
+   /****************************************/
+   /****************************************/
+
+   struct SCleanupUpdateThreadData {
+      pthread_mutex_t* SenseControlStepConditionalMutex;
+      pthread_mutex_t* ActConditionalMutex;
+      pthread_mutex_t* PhysicsConditionalMutex;
+      pthread_mutex_t* MediaConditionalMutex;
+   };
+
+   static void CleanupUpdateThread(void* p_data) {
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      if(cSimulator.IsProfiling()) {
+         cSimulator.GetProfiler().CollectThreadResourceUsage();
+      }
+      SCleanupUpdateThreadData& sData =
+         *reinterpret_cast<SCleanupUpdateThreadData*>(p_data);
+      pthread_mutex_unlock(sData.SenseControlStepConditionalMutex);
+      pthread_mutex_unlock(sData.ActConditionalMutex);
+      pthread_mutex_unlock(sData.PhysicsConditionalMutex);
+      pthread_mutex_unlock(sData.MediaConditionalMutex);
+   }
+
+   void* LaunchUpdateThreadBalanceCost(void* p_data) {
+      LOG.AddThreadSafeBuffer();
+      LOGERR.AddThreadSafeBuffer();
+      auto* psData = reinterpret_cast<CSpaceMultiThreadBalanceCost::SUpdateThreadData*>(p_data);
+      psData->Space->UpdateThread(psData->ThreadId);
+      return nullptr;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CSpaceMultiThreadBalanceCost::CSpaceMultiThreadBalanceCost(UInt32 un_n_threads,
+                                                              bool b_pin_threads_to_cores) :
+         CSpaceMultiThread(un_n_threads, b_pin_threads_to_cores),
+         m_psUpdateThreadData(nullptr),
+         m_unNextTask(0),
+         m_unEntityChunkSize(1),
+         m_vecThreadStepBusyTime(un_n_threads, 0.0) {
+     m_sLoadStats.Steps = 0;
+     m_sLoadStats.ThreadBusyTime.assign(un_n_threads, 0.0);
+     m_sLoadStats.MeanImbalance = 0.0;
+     m_sLoadStats.MaxImbalance = 0.0;
+     LOG << "[INFO]   Chosen method \"balance_cost\": threads will be assigned batches of"
+         << std::endl
+         << "[INFO]   controllable entities with similar measured cost."
+         << std::endl;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::Init(TConfigurationNode& t_tree) {
+      /* Initialize the space */
+      CSpace::Init(t_tree);
+      /* Initialize thread related structures */
+      int nErrors;
+      /* First the counters */
+      m_unSenseControlStepPhaseDoneCounter = GetNumThreads();
+      m_unActPhaseDoneCounter = GetNumThreads();
+      m_unPhysicsPhaseDoneCounter = GetNumThreads();
+      m_unMediaPhaseDoneCounter = GetNumThreads();
+      /* Then the mutexes */
+      if((nErrors = pthread_mutex_init(&m_tSenseControlStepConditionalMutex, nullptr)) ||
+         (nErrors = pthread_mutex_init(&m_tActConditionalMutex, nullptr)) ||
+         (nErrors = pthread_mutex_init(&m_tPhysicsConditionalMutex, nullptr)) ||
+         (nErrors = pthread_mutex_init(&m_tMediaConditionalMutex, nullptr))) {
+         THROW_ARGOSEXCEPTION("Error creating thread mutexes " << ::strerror(nErrors));
+      }
+      /* Finally the conditionals */
+      if((nErrors = pthread_cond_init(&m_tSenseControlStepConditional, nullptr)) ||
+         (nErrors = pthread_cond_init(&m_tActConditional, nullptr)) ||
+         (nErrors = pthread_cond_init(&m_tPhysicsConditional, nullptr)) ||
+         (nErrors = pthread_cond_init(&m_tMediaConditional, nullptr))) {
+         THROW_ARGOSEXCEPTION("Error creating thread conditionals " << ::strerror(nErrors));
+      }
+      /* Start threads */
+      StartThreads();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::StartThreads() {
+      m_psUpdateThreadData = new SUpdateThreadData*[GetNumThreads()];
+      /* Create the threads */
+      for(UInt32 i = 0; i < GetNumThreads(); ++i) {
+         /* Create the struct with the info to launch the thread */
+         m_psUpdateThreadData[i] = new SUpdateThreadData(i, this);
+         /* Create the thread */
+         CreateSingleThread(i,
+                            LaunchUpdateThreadBalanceCost,
+                            reinterpret_cast<void*>(m_psUpdateThreadData[i]));
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::Destroy() {
+      /* Report the load statistics */
+      if(m_sLoadStats.Steps > 0) {
+         LOG << "[INFO] Thread load statistics for the sense+control phase over "
+             << m_sLoadStats.Steps << " steps:" << std::endl;
+         for(size_t i = 0; i < m_sLoadStats.ThreadBusyTime.size(); ++i) {
+            LOG << "[INFO]   thread " << i << " busy for "
+                << m_sLoadStats.ThreadBusyTime[i] << " s" << std::endl;
+         }
+         LOG << "[INFO]   imbalance (busiest / mean): average "
+             << m_sLoadStats.MeanImbalance << ", worst "
+             << m_sLoadStats.MaxImbalance << std::endl;
+         LOG.Flush();
+      }
+      /* Destroy the threads to update the controllable entities */
+      UInt32 unThreads = GetNumThreads();
+      DestroyAllThreads();
+      /* Destroy the thread launch info */
+      if(m_psUpdateThreadData != nullptr) {
+         for(UInt32 i = 0; i < unThreads; ++i) {
+            delete m_psUpdateThreadData[i];
+         }
+      }
+      delete[] m_psUpdateThreadData;
+      pthread_mutex_destroy(&m_tSenseControlStepConditionalMutex);
+      pthread_mutex_destroy(&m_tActConditionalMutex);
+      pthread_mutex_destroy(&m_tPhysicsConditionalMutex);
+      pthread_mutex_destroy(&m_tMediaConditionalMutex);
+
+      pthread_cond_destroy(&m_tSenseControlStepConditional);
+      pthread_cond_destroy(&m_tActConditional);
+      pthread_cond_destroy(&m_tPhysicsConditional);
+      pthread_cond_destroy(&m_tMediaConditional);
+
+      /* Destroy the base space */
+      CSpace::Destroy();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::AddControllableEntity(CControllableEntity& c_entity) {
+      CSpace::AddControllableEntity(c_entity);
+      /* New entities are unmeasured, CalculateBatches() gives them the average cost */
+      m_vecEntityCosts.push_back(0.0);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::RemoveControllableEntity(CControllableEntity& c_entity) {
+      auto it = std::find(m_vecControllableEntities.begin(),
+                          m_vecControllableEntities.end(),
+                          &c_entity);
+      if(it != m_vecControllableEntities.end()) {
+         m_vecEntityCosts.erase(m_vecEntityCosts.begin() +
+                                (it - m_vecControllableEntities.begin()));
+      }
+      CSpace::RemoveControllableEntity(c_entity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::CalculateBatches() {
+      m_vecBatches.clear();
+      size_t unEntities = m_vecControllableEntities.size();
+      if(unEntities == 0) return;
+      /* Unmeasured entities get the average cost of the measured ones */
+      Real fMeasuredCost = 0.0;
+      size_t unMeasured = 0;
+      for(size_t i = 0; i < unEntities; ++i) {
+         if(m_vecEntityCosts[i] > 0.0) {
+            fMeasuredCost += m_vecEntityCosts[i];
+            ++unMeasured;
+         }
+      }
+      /* When nothing was measured, all entities count the same */
+      Real fDefaultCost = (unMeasured > 0) ? (fMeasuredCost / unMeasured) : 1.0;
+      Real fTotalCost =
+         fMeasuredCost + (unEntities - unMeasured) * fDefaultCost;
+      /* Cut the entity list into contiguous batches of similar cost */
+      size_t unBatches = std::min<size_t>(unEntities,
+                                          GetNumThreads() * BATCHES_PER_THREAD);
+      Real fTargetCost = fTotalCost / unBatches;
+      size_t unBegin = 0;
+      Real fBatchCost = 0.0;
+      for(size_t i = 0; i < unEntities && m_vecBatches.size() + 1 < unBatches; ++i) {
+         fBatchCost += (m_vecEntityCosts[i] > 0.0) ? m_vecEntityCosts[i] : fDefaultCost;
+         /* Close the batch when it reaches its share, or when the remaining entities
+            are just enough to give one to each remaining batch */
+         if(fBatchCost >= fTargetCost ||
+            unEntities - i - 1 <= unBatches - m_vecBatches.size() - 1) {
+            m_vecBatches.emplace_back(unBegin, i + 1, fBatchCost);
+            unBegin = i + 1;
+            fBatchCost = 0.0;
+         }
+      }
+      /* The last batch takes the remaining entities */
+      if(unBegin < unEntities) {
+         fBatchCost = 0.0;
+         for(size_t i = unBegin; i < unEntities; ++i) {
+            fBatchCost += (m_vecEntityCosts[i] > 0.0) ? m_vecEntityCosts[i] : fDefaultCost;
+         }
+         m_vecBatches.emplace_back(unBegin, unEntities, fBatchCost);
+      }
+      /* Longest processing time first */
+      std::stable_sort(m_vecBatches.begin(), m_vecBatches.end(),
+                       [](const SBatch& s_a, const SBatch& s_b) {
+                          return s_a.Cost > s_b.Cost;
+                       });
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::UpdateLoadStats() {
+      Real fMax = 0.0;
+      Real fSum = 0.0;
+      for(size_t i = 0; i < m_vecThreadStepBusyTime.size(); ++i) {
+         m_sLoadStats.ThreadBusyTime[i] += m_vecThreadStepBusyTime[i];
+         fSum += m_vecThreadStepBusyTime[i];
+         fMax = Max(fMax, m_vecThreadStepBusyTime[i]);
+      }
+      if(fSum > 0.0) {
+         Real fImbalance = fMax * m_vecThreadStepBusyTime.size() / fSum;
+         ++m_sLoadStats.Steps;
+         m_sLoadStats.MeanImbalance +=
+            (fImbalance - m_sLoadStats.MeanImbalance) / m_sLoadStats.Steps;
+         m_sLoadStats.MaxImbalance = Max(m_sLoadStats.MaxImbalance, fImbalance);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+#define MAIN_SEND_GO_FOR_PHASE(PHASE)                       \
+   LOG.Flush();                                             \
+   LOGERR.Flush();                                          \
+   pthread_mutex_lock(&m_t ## PHASE ## ConditionalMutex);   \
+   m_unNextTask = 0;                                        \
+   m_un ## PHASE ## PhaseDoneCounter = 0;                   \
+   pthread_cond_broadcast(&m_t ## PHASE ## Conditional);    \
+   pthread_mutex_unlock(&m_t ## PHASE ## ConditionalMutex);
+
+#define MAIN_WAIT_FOR_PHASE_END(PHASE)                                  \
+   pthread_mutex_lock(&m_t ## PHASE ## ConditionalMutex);               \
+   while(m_un ## PHASE ## PhaseDoneCounter < GetNumThreads()) {         \
+      pthread_cond_wait(&m_t ## PHASE ## Conditional, &m_t ## PHASE ## ConditionalMutex); \
+   }                                                                    \
+   pthread_mutex_unlock(&m_t ## PHASE ## ConditionalMutex);
+
+   void CSpaceMultiThreadBalanceCost::UpdateControllableEntitiesAct() {
+      m_unEntityChunkSize = Max<size_t>(
+         1, m_vecControllableEntities.size() / (GetNumThreads() * BATCHES_PER_THREAD));
+      MAIN_SEND_GO_FOR_PHASE(Act);
+      MAIN_WAIT_FOR_PHASE_END(Act);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::UpdatePhysics() {
+      /* Update the physics engines */
+      MAIN_SEND_GO_FOR_PHASE(Physics);
+      MAIN_WAIT_FOR_PHASE_END(Physics);
+      /* Perform entity transfer from engine to engine, if needed */
+      for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
+         if((*m_ptPhysicsEngines)[i]->IsEntityTransferNeeded()) {
+            (*m_ptPhysicsEngines)[i]->TransferEntities();
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::UpdateMedia() {
+      /* Update the media */
+      MAIN_SEND_GO_FOR_PHASE(Media);
+      MAIN_WAIT_FOR_PHASE_END(Media);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::UpdateControllableEntitiesSenseStep() {
+      /* Assign the entities to batches using the latest costs */
+      CalculateBatches();
+      MAIN_SEND_GO_FOR_PHASE(SenseControlStep);
+      MAIN_WAIT_FOR_PHASE_END(SenseControlStep);
+      UpdateLoadStats();
+   }
+
+   /****************************************/
+   /****************************************/
+
+#define THREAD_WAIT_FOR_GO_SIGNAL(PHASE)                                                   \
+   pthread_mutex_lock(&m_t ## PHASE ## ConditionalMutex);                                  \
+   while(m_un ## PHASE ## PhaseDoneCounter == GetNumThreads()) {                           \
+      pthread_cond_wait(&m_t ## PHASE ## Conditional, &m_t ## PHASE ## ConditionalMutex);  \
+   }                                                                                       \
+   pthread_mutex_unlock(&m_t ## PHASE ## ConditionalMutex);                                \
+   pthread_testcancel();
+
+#define THREAD_SIGNAL_PHASE_DONE(PHASE)                     \
+   pthread_mutex_lock(&m_t ## PHASE ## ConditionalMutex);   \
+   ++m_un ## PHASE ## PhaseDoneCounter;                     \
+   pthread_cond_broadcast(&m_t ## PHASE ## Conditional);    \
+   pthread_mutex_unlock(&m_t ## PHASE ## ConditionalMutex); \
+   pthread_testcancel();
+
+   void CSpaceMultiThreadBalanceCost::UpdateThread(UInt32 un_id) {
+      /* Create cancellation data */
+      SCleanupUpdateThreadData sCancelData;
+      sCancelData.SenseControlStepConditionalMutex = &m_tSenseControlStepConditionalMutex;
+      sCancelData.ActConditionalMutex = &m_tActConditionalMutex;
+      sCancelData.PhysicsConditionalMutex = &m_tPhysicsConditionalMutex;
+      sCancelData.MediaConditionalMutex = &m_tMediaConditionalMutex;
+
+      pthread_cleanup_push(CleanupUpdateThread, &sCancelData);
+
+      /* Last round of loop function tasks served by this thread */
+      UInt32 unTaskRound = 0;
+      while(1) {
+        /* Actuate entities */
+        UpdateThreadEntityAct();
+
+        /* Update physics engines */
+        UpdateThreadPhysics();
+
+        /* Update media */
+        UpdateThreadMedia();
+
+        /* Serve the tasks of the loop functions PreStep() */
+        ServeLoopFunctionTasks(unTaskRound);
+
+        /* Update sensor readings/execute control step for entities */
+        UpdateThreadEntitySenseControl(un_id);
+
+        /* Serve the tasks of the loop functions PostStep() */
+        ServeLoopFunctionTasks(unTaskRound);
+      } /* while(1) */
+
+      pthread_cleanup_pop(1);
+   } /* UpdateThread */
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::UpdateThreadEntityAct() {
+     THREAD_WAIT_FOR_GO_SIGNAL(Act);
+     size_t unEntities = m_vecControllableEntities.size();
+     size_t unBegin;
+     while((unBegin = m_unNextTask.fetch_add(1) * m_unEntityChunkSize) < unEntities) {
+       size_t unEnd = Min(unBegin + m_unEntityChunkSize, unEntities);
+       for(size_t i = unBegin; i < unEnd; ++i) {
+         if(m_vecControllableEntities[i]->IsEnabled())
+           m_vecControllableEntities[i]->Act();
+       }
+     }
+     THREAD_SIGNAL_PHASE_DONE(Act);
+   } /* UpdateThreadEntityAct() */
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::UpdateThreadPhysics() {
+     THREAD_WAIT_FOR_GO_SIGNAL(Physics);
+     size_t i;
+     while((i = m_unNextTask.fetch_add(1)) < m_ptPhysicsEngines->size()) {
+       (*m_ptPhysicsEngines)[i]->Update();
+     }
+     THREAD_SIGNAL_PHASE_DONE(Physics);
+   } /* UpdateThreadPhysics() */
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::UpdateThreadMedia() {
+     THREAD_WAIT_FOR_GO_SIGNAL(Media);
+     size_t i;
+     while((i = m_unNextTask.fetch_add(1)) < m_ptMedia->size()) {
+       (*m_ptMedia)[i]->Update();
+     }
+     THREAD_SIGNAL_PHASE_DONE(Media);
+   } /* UpdateThreadMedia() */
+
+   /****************************************/
+   /****************************************/
+
+   void CSpaceMultiThreadBalanceCost::UpdateThreadEntitySenseControl(UInt32 un_id) {
+     THREAD_WAIT_FOR_GO_SIGNAL(SenseControlStep);
+     /* Claim batches in order of decreasing cost */
+     std::chrono::steady_clock::time_point tStart, tEnd;
+     Real fBusyTime = 0.0;
+     size_t unBatch;
+     while((unBatch = m_unNextTask.fetch_add(1)) < m_vecBatches.size()) {
+       const SBatch& sBatch = m_vecBatches[unBatch];
+       for(size_t i = sBatch.Begin; i < sBatch.End; ++i) {
+         if(m_vecControllableEntities[i]->IsEnabled()) {
+           tStart = std::chrono::steady_clock::now();
+           m_vecControllableEntities[i]->Sense();
+           m_vecControllableEntities[i]->ControlStep();
+           tEnd = std::chrono::steady_clock::now();
+           Real fCost = std::chrono::duration<Real>(tEnd - tStart).count();
+           fBusyTime += fCost;
+           /* Each entity belongs to one batch only, so no lock is needed */
+           Real& fSmoothed = m_vecEntityCosts[i];
+           fSmoothed = (fSmoothed > 0.0) ?
+              (fSmoothed + COST_SMOOTHING * (fCost - fSmoothed)) :
+              fCost;
+         }
+       }
+     }
+     m_vecThreadStepBusyTime[un_id] = fBusyTime;
+     THREAD_SIGNAL_PHASE_DONE(SenseControlStep);
+   } /* UpdateThreadEntitySenseControl() */
+
+   /****************************************/
+   /****************************************/
+}
@@ -0,0 +1,187 @@
+/**
+ * @file <argos3/core/simulator/space/space_multi_thread_balance_cost.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef SPACE_MULTI_THREAD_BALANCE_COST_H
+#define SPACE_MULTI_THREAD_BALANCE_COST_H
+
+#include <argos3/core/simulator/space/space_multi_thread.h>
+#include <atomic>
+#include <pthread.h>
+
+namespace argos {
+
+   /**
+    * A multi-thread space that balances the threads using the measured cost of each entity.
+    * <p>
+    * The time each controllable entity takes in its sense+control step is measured and
+    * smoothed with an exponential moving average. Before each sense+control phase, the
+    * entities are partitioned into contiguous batches of roughly equal cost, and the
+    * batches are sorted by decreasing cost. The threads then claim the batches in order
+    * through an atomic counter. This is the longest-processing-time heuristic: the
+    * expensive batches are started first, and the cheap ones fill the gaps at the end.
+    * </p>
+    * <p>
+    * The act phase, the physics engines and the media are also claimed through atomic
+    * counters, so no mutex is involved in task dispatching. The loop function tasks
+    * are dispatched by CSpaceMultiThread, in the same way.
+    * </p>
+    * <p>
+    * The space keeps track of the time each thread spends in the sense+control phase.
+    * The statistics are available through GetLoadStats() and are logged when the
+    * space is destroyed.
+    * </p>
+    */
+   class CSpaceMultiThreadBalanceCost : public CSpaceMultiThread {
+
+   public:
+
+      /**
+       * Load statistics of the sense+control phase.
+       */
+      struct SLoadStats {
+         /** Number of measured steps */
+         UInt64 Steps;
+         /** Total time spent by each thread in the sense+control phase, in seconds */
+         std::vector<Real> ThreadBusyTime;
+         /** Average over the steps of the ratio between the busiest thread time and the mean thread time */
+         Real MeanImbalance;
+         /** Worst ratio between the busiest thread time and the mean thread time */
+         Real MaxImbalance;
+      };
+
+      /** Smoothing factor of the exponential moving average of the entity costs */
+      static const Real COST_SMOOTHING;
+
+      /** Number of sense+control batches created for each thread */
+      static const UInt32 BATCHES_PER_THREAD;
+
+      /****************************************/
+      /****************************************/
+
+   private:
+
+      struct SUpdateThreadData {
+         UInt32 ThreadId;
+         CSpaceMultiThreadBalanceCost* Space;
+
+         SUpdateThreadData(UInt32 un_thread_id,
+                           CSpaceMultiThreadBalanceCost* pc_space) :
+            ThreadId(un_thread_id),
+            Space(pc_space) {}
+      };
+
+      struct SBatch {
+         size_t Begin;
+         size_t End;
+         Real Cost;
+
+         SBatch(size_t un_begin,
+                size_t un_end,
+                Real f_cost) :
+            Begin(un_begin),
+            End(un_end),
+            Cost(f_cost) {}
+      };
+
+      /****************************************/
+      /****************************************/
+
+   private:
+
+      /** Data structure needed to launch the threads */
+      SUpdateThreadData** m_psUpdateThreadData;
+
+      /** Update thread related variables */
+      UInt32 m_unSenseControlStepPhaseDoneCounter;
+      UInt32 m_unActPhaseDoneCounter;
+      UInt32 m_unPhysicsPhaseDoneCounter;
+      UInt32 m_unMediaPhaseDoneCounter;
+
+      /** Update thread conditional mutexes */
+      pthread_mutex_t m_tSenseControlStepConditionalMutex;
+      pthread_mutex_t m_tActConditionalMutex;
+      pthread_mutex_t m_tPhysicsConditionalMutex;
+      pthread_mutex_t m_tMediaConditionalMutex;
+
+      /** Update thread conditionals */
+      pthread_cond_t m_tSenseControlStepConditional;
+      pthread_cond_t m_tActConditional;
+      pthread_cond_t m_tPhysicsConditional;
+      pthread_cond_t m_tMediaConditional;
+
+      /** Index of the next task to claim in the current phase */
+      std::atomic<size_t> m_unNextTask;
+
+      /** Number of entities per task in the act phase */
+      size_t m_unEntityChunkSize;
+
+      /** Smoothed sense+control cost of each controllable entity, in seconds */
+      std::vector<Real> m_vecEntityCosts;
+
+      /** Sense+control batches, sorted by decreasing cost */
+      std::vector<SBatch> m_vecBatches;
+
+      /** Time spent by each thread in the current sense+control phase, in seconds */
+      std::vector<Real> m_vecThreadStepBusyTime;
+
+      /** Load statistics */
+      SLoadStats m_sLoadStats;
+
+   public:
+
+      CSpaceMultiThreadBalanceCost(UInt32 un_n_threads,
+                                   bool b_pin_threads_to_cores);
+      virtual ~CSpaceMultiThreadBalanceCost() {}
+
+      virtual void Init(TConfigurationNode& t_tree);
+      virtual void Destroy();
+
+      virtual void UpdateControllableEntitiesAct();
+      virtual void UpdatePhysics();
+      virtual void UpdateMedia();
+      virtual void UpdateControllableEntitiesSenseStep();
+
+      /**
+       * Returns the load statistics of the sense+control phase.
+       */
+      inline const SLoadStats& GetLoadStats() const {
+         return m_sLoadStats;
+      }
+
+   protected:
+
+      virtual void AddControllableEntity(CControllableEntity& c_entity);
+      virtual void RemoveControllableEntity(CControllableEntity& c_entity);
+
+   private:
+
+      void StartThreads();
+      void UpdateThread(UInt32 un_id);
+
+      /**
+       * Partitions the controllable entities into contiguous batches of
+       * similar cost and sorts them by decreasing cost.
+       */
+      void CalculateBatches();
+
+      /**
+       * Updates the load statistics with the thread times of the last
+       * sense+control phase.
+       */
+      void UpdateLoadStats();
+
+      void UpdateThreadEntityAct();
+      void UpdateThreadPhysics();
+      void UpdateThreadMedia();
+      void UpdateThreadEntitySenseControl(UInt32 un_id);
+
+      friend void* LaunchUpdateThreadBalanceCost(void* p_data);
+
+   };
+
+}
+
+#endif
@@ -18,7 +18,6 @@ namespace argos {
       pthread_mutex_t* StartActPhaseMutex;
       pthread_mutex_t* StartPhysicsPhaseMutex;
       pthread_mutex_t* StartMediaPhaseMutex;
-      pthread_mutex_t* StartEntityIterPhaseMutex;
       pthread_mutex_t* FetchTaskMutex;
    };
 
@@ -34,7 +33,6 @@ namespace argos {
       pthread_mutex_unlock(sData.StartActPhaseMutex);
       pthread_mutex_unlock(sData.StartPhysicsPhaseMutex);
       pthread_mutex_unlock(sData.StartMediaPhaseMutex);
-      pthread_mutex_unlock(sData.StartEntityIterPhaseMutex);
    }
 
    void* LaunchThreadBalanceLength(void* p_data) {
@@ -52,7 +50,6 @@ namespace argos {
       sCancelData.StartActPhaseMutex = &(psData->Space->m_tStartActPhaseMutex);
       sCancelData.StartPhysicsPhaseMutex = &(psData->Space->m_tStartPhysicsPhaseMutex);
       sCancelData.StartMediaPhaseMutex = &(psData->Space->m_tStartMediaPhaseMutex);
-      sCancelData.StartEntityIterPhaseMutex = &(psData->Space->m_tStartEntityIterPhaseMutex);
       sCancelData.FetchTaskMutex = &(psData->Space->m_tFetchTaskMutex);
       pthread_cleanup_push(CleanupThread, &sCancelData);
       psData->Space->SlaveThread();
@@ -86,7 +83,6 @@ namespace argos {
          (nErrors = pthread_mutex_init(&m_tStartActPhaseMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tStartPhysicsPhaseMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tStartMediaPhaseMutex, nullptr)) ||
-         (nErrors = pthread_mutex_init(&m_tStartEntityIterPhaseMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tFetchTaskMutex, nullptr))) {
          THROW_ARGOSEXCEPTION("Error creating thread mutexes " << ::strerror(nErrors));
       }
@@ -95,7 +91,6 @@ namespace argos {
          (nErrors = pthread_cond_init(&m_tStartActPhaseCond, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tStartPhysicsPhaseCond, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tStartMediaPhaseCond, nullptr)) ||
-         (nErrors = pthread_cond_init(&m_tStartEntityIterPhaseCond, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tFetchTaskCond, nullptr))) {
          THROW_ARGOSEXCEPTION("Error creating thread conditionals " << ::strerror(nErrors));
       }
@@ -104,7 +99,6 @@ namespace argos {
       m_unActPhaseIdleCounter = GetNumThreads();
       m_unPhysicsPhaseIdleCounter = GetNumThreads();
       m_unMediaPhaseIdleCounter = GetNumThreads();
-      m_unEntityIterPhaseIdleCounter = GetNumThreads();
       /* Start threads */
       StartThreads();
    }
@@ -127,14 +121,12 @@ namespace argos {
       pthread_mutex_destroy(&m_tStartActPhaseMutex);
       pthread_mutex_destroy(&m_tStartPhysicsPhaseMutex);
       pthread_mutex_destroy(&m_tStartMediaPhaseMutex);
-      pthread_mutex_destroy(&m_tStartEntityIterPhaseMutex);
       pthread_mutex_destroy(&m_tFetchTaskMutex);
 
       pthread_cond_destroy(&m_tStartSenseControlPhaseCond);
       pthread_cond_destroy(&m_tStartActPhaseCond);
       pthread_cond_destroy(&m_tStartPhysicsPhaseCond);
       pthread_cond_destroy(&m_tStartMediaPhaseCond);
-      pthread_cond_destroy(&m_tStartEntityIterPhaseCond);
       pthread_cond_destroy(&m_tFetchTaskCond);
 
       /* Destroy the base space */
@@ -150,7 +142,6 @@ namespace argos {
       m_unActPhaseIdleCounter = GetNumThreads();
       m_unPhysicsPhaseIdleCounter = GetNumThreads();
       m_unMediaPhaseIdleCounter = GetNumThreads();
-      m_unEntityIterPhaseIdleCounter = GetNumThreads();
       /* Update the space */
       CSpace::Update();
    }
@@ -202,18 +193,6 @@ namespace argos {
       MAIN_WAIT_FOR_END_OF(Media);
    }
 
-   /****************************************/
-   /****************************************/
-
-   void CSpaceMultiThreadBalanceLength::IterateOverControllableEntities(
-       const TControllableEntityIterCBType &c_cb) {
-     m_cbControllableEntityIter = c_cb;
-     /* Iterate over all robots in the swarm */
-     MAIN_START_PHASE(EntityIter);
-     MAIN_WAIT_FOR_END_OF(EntityIter);
-   } /* IterateOverControllableEntities() */
-
-
    /****************************************/
    /****************************************/
 
@@ -279,6 +258,8 @@ namespace argos {
    void CSpaceMultiThreadBalanceLength::SlaveThread() {
       /* Task index */
       size_t unTaskIndex;
+      /* Last round of loop function tasks served by this thread */
+      UInt32 unTaskRound = 0;
       while(1) {
          THREAD_WAIT_FOR_START_OF(Act);
          THREAD_PERFORM_TASK(
@@ -302,12 +283,7 @@ namespace argos {
             (*m_ptMedia)[unTaskIndex]->Update();
             );
          /* loop functions PreStep() */
-         THREAD_WAIT_FOR_START_OF(EntityIter);
-         THREAD_PERFORM_TASK(
-             EntityIter,
-             m_vecControllableEntities,
-             ControllableEntityIterationEnabled(),
-             m_cbControllableEntityIter(m_vecControllableEntities[unTaskIndex]));
+         ServeLoopFunctionTasks(unTaskRound);
          THREAD_WAIT_FOR_START_OF(SenseControl);
          THREAD_PERFORM_TASK(
             SenseControl,
@@ -319,12 +295,7 @@ namespace argos {
             }
             );
          /* loop functions PostStep() */
-         THREAD_WAIT_FOR_START_OF(EntityIter);
-         THREAD_PERFORM_TASK(
-             EntityIter,
-             m_vecControllableEntities,
-             ControllableEntityIterationEnabled(),
-             m_cbControllableEntityIter(m_vecControllableEntities[unTaskIndex]));
+         ServeLoopFunctionTasks(unTaskRound);
       } /* while(1) */
    }
 
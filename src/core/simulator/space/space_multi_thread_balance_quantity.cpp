@@ -20,7 +20,6 @@ namespace argos {
       pthread_mutex_t* ActConditionalMutex;
       pthread_mutex_t* PhysicsConditionalMutex;
       pthread_mutex_t* MediaConditionalMutex;
-      pthread_mutex_t* EntityIterConditionalMutex;
    };
 
    static void CleanupUpdateThread(void* p_data) {
@@ -34,7 +33,6 @@ namespace argos {
       pthread_mutex_unlock(sData.ActConditionalMutex);
       pthread_mutex_unlock(sData.PhysicsConditionalMutex);
       pthread_mutex_unlock(sData.MediaConditionalMutex);
-      pthread_mutex_unlock(sData.EntityIterConditionalMutex);
    }
 
    void* LaunchUpdateThreadBalanceQuantity(void* p_data) {
@@ -72,22 +70,19 @@ namespace argos {
       m_unActPhaseDoneCounter = CSimulator::GetInstance().GetNumThreads();
       m_unPhysicsPhaseDoneCounter = CSimulator::GetInstance().GetNumThreads();
       m_unMediaPhaseDoneCounter = CSimulator::GetInstance().GetNumThreads();
-      m_unEntityIterPhaseDoneCounter = CSimulator::GetInstance().GetNumThreads();
 
       /* Then the mutexes */
       if((nErrors = pthread_mutex_init(&m_tSenseControlStepConditionalMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tActConditionalMutex, nullptr)) ||
          (nErrors = pthread_mutex_init(&m_tPhysicsConditionalMutex, nullptr)) ||
-         (nErrors = pthread_mutex_init(&m_tMediaConditionalMutex, nullptr)) ||
-         (nErrors = pthread_mutex_init(&m_tEntityIterConditionalMutex, nullptr))) {
+         (nErrors = pthread_mutex_init(&m_tMediaConditionalMutex, nullptr))) {
          THROW_ARGOSEXCEPTION("Error creating thread mutexes " << ::strerror(nErrors));
       }
       /* Finally the conditionals */
       if((nErrors = pthread_cond_init(&m_tSenseControlStepConditional, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tActConditional, nullptr)) ||
          (nErrors = pthread_cond_init(&m_tPhysicsConditional, nullptr)) ||
-         (nErrors = pthread_cond_init(&m_tMediaConditional, nullptr)) ||
-         (nErrors = pthread_cond_init(&m_tEntityIterConditional, nullptr))) {
+         (nErrors = pthread_cond_init(&m_tMediaConditional, nullptr))) {
          THROW_ARGOSEXCEPTION("Error creating thread conditionals " << ::strerror(nErrors));
       }
       /* Start threads */
@@ -128,13 +123,11 @@ namespace argos {
       pthread_mutex_destroy(&m_tActConditionalMutex);
       pthread_mutex_destroy(&m_tPhysicsConditionalMutex);
       pthread_mutex_destroy(&m_tMediaConditionalMutex);
-      pthread_mutex_destroy(&m_tEntityIterConditionalMutex);
 
       pthread_cond_destroy(&m_tSenseControlStepConditional);
       pthread_cond_destroy(&m_tActConditional);
       pthread_cond_destroy(&m_tPhysicsConditional);
       pthread_cond_destroy(&m_tMediaConditional);
-      pthread_cond_destroy(&m_tEntityIterConditional);
 
       /* Destroy the base space */
       CSpace::Destroy();
@@ -205,26 +198,6 @@ namespace argos {
       MAIN_WAIT_FOR_PHASE_END(Media);
    }
 
-   /****************************************/
-   /****************************************/
-
-   void CSpaceMultiThreadBalanceQuantity::IterateOverControllableEntities(
-       const TControllableEntityIterCBType &c_cb) {
-     m_cbControllableEntityIter = c_cb;
-
-     /* Iterate over all robots in the swarm */
-     MAIN_SEND_GO_FOR_PHASE(EntityIter);
-     MAIN_WAIT_FOR_PHASE_END(EntityIter);
-   } /* IterateOverControllableEntities() */
-
-   /****************************************/
-   /****************************************/
-
-   void CSpaceMultiThreadBalanceQuantity::ControllableEntityIterationWaitAbort(void) {
-     IterateOverControllableEntities(nullptr);
-   } /* ControllableEntitiesIterationWaitAbort() */
-
-
    /****************************************/
    /****************************************/
 
@@ -295,7 +268,6 @@ namespace argos {
       sCancelData.ActConditionalMutex = &m_tActConditionalMutex;
       sCancelData.PhysicsConditionalMutex = &m_tPhysicsConditionalMutex;
       sCancelData.MediaConditionalMutex = &m_tMediaConditionalMutex;
-      sCancelData.EntityIterConditionalMutex = &m_tEntityIterConditionalMutex;
 
       pthread_cleanup_push(CleanupUpdateThread, &sCancelData);
 
@@ -314,6 +286,8 @@ namespace argos {
        * added/removed entities.
        */
       CRange<size_t> cEntityRange;
+      /* Last round of loop function tasks served by this thread */
+      UInt32 unTaskRound = 0;
       while (1) {
         /* Actuate entities assigned to this thread */
         UpdateThreadEntityAct(un_id, cEntityRange);
@@ -324,14 +298,14 @@ namespace argos {
         /* Update media assigned to this thread */
         UpdateThreadMedia(cMediaRange);
 
-        /* loop functions PreStep() iteration (maybe) */
-        UpdateThreadIterateOverEntities(un_id, cEntityRange);
+        /* Serve the tasks of the loop functions PreStep() */
+        ServeLoopFunctionTasks(unTaskRound);
 
         /* Update sensor readings/execute control step for entities */
         UpdateThreadEntitySenseControl(un_id, cEntityRange);
 
-        /* loop functions PostStep() iteration (maybe) */
-        UpdateThreadIterateOverEntities(un_id, cEntityRange);
+        /* Serve the tasks of the loop functions PostStep() */
+        ServeLoopFunctionTasks(unTaskRound);
       } /* while(1) */
 
       pthread_cleanup_pop(1);
@@ -410,31 +384,6 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   void CSpaceMultiThreadBalanceQuantity::UpdateThreadIterateOverEntities(UInt32 un_id,
-                                                                          CRange<size_t>& c_range) {
-     THREAD_WAIT_FOR_GO_SIGNAL(EntityIter);
-     /* Calculate the portion of entities to update, if needed */
-     if (m_bIsControllableEntityAssignmentRecalculationNeeded) {
-       c_range = CalculatePluginRangeForThread(un_id,
-                                               m_vecControllableEntities.size());
-     }
-     /* Cope with the fact that there may be less entities than threads */
-     if (c_range.GetSpan() > 0 && ControllableEntityIterationEnabled()) {
-       /* This thread has entities */
-       for (size_t i = c_range.GetMin(); i < c_range.GetMax(); ++i) {
-         m_cbControllableEntityIter(m_vecControllableEntities[i]);
-       } /* for(i...) */
-       pthread_testcancel();
-       THREAD_SIGNAL_PHASE_DONE(EntityIter);
-     }
-     else {
-       THREAD_SIGNAL_PHASE_DONE(EntityIter);
-     }
-   } /* UpdateThreadIterateOverEntities() */
-
-   /****************************************/
-   /****************************************/
-
    void CSpaceMultiThreadBalanceQuantity::UpdateThreadEntitySenseControl(UInt32 un_id,
                                                                          CRange<size_t>& c_range) {
      /* Update sensor readings and call controllers */
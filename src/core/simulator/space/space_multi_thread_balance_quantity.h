@@ -42,21 +42,18 @@ namespace argos {
       UInt32 m_unActPhaseDoneCounter;
       UInt32 m_unPhysicsPhaseDoneCounter;
       UInt32 m_unMediaPhaseDoneCounter;
-      UInt32 m_unEntityIterPhaseDoneCounter;
 
       /** Update thread conditional mutexes */
       pthread_mutex_t m_tSenseControlStepConditionalMutex;
       pthread_mutex_t m_tActConditionalMutex;
       pthread_mutex_t m_tPhysicsConditionalMutex;
       pthread_mutex_t m_tMediaConditionalMutex;
-      pthread_mutex_t m_tEntityIterConditionalMutex;
 
       /** Update thread conditionals */
       pthread_cond_t m_tSenseControlStepConditional;
       pthread_cond_t m_tActConditional;
       pthread_cond_t m_tPhysicsConditional;
       pthread_cond_t m_tMediaConditional;
-      pthread_cond_t m_tEntityIterConditional;
 
       /** Flag to know whether the assignment of controllable
           entities to threads must be recalculated */
@@ -75,8 +72,6 @@ namespace argos {
       virtual void UpdatePhysics();
       virtual void UpdateMedia();
       virtual void UpdateControllableEntitiesSenseStep();
-      virtual void IterateOverControllableEntities(
-          const TControllableEntityIterCBType& c_cb);
 
    protected:
 
@@ -106,16 +101,6 @@ namespace argos {
       */
      void UpdateThreadMedia(const CRange<size_t>& c_range);
 
-     /**
-      * \brief (Maybe) iterate over entities as called from
-      * CLoopFunctions::PreStep()/CLoopFunctions::PostStep(), possibly
-      * recalculating entity range assigned to this thread before doing so.
-      *
-      * @see CLoopFunctions::PreStep()
-      * @see CLoopFunctions::PostStep()
-      */
-      void UpdateThreadIterateOverEntities(UInt32 un_id, CRange<size_t>& c_range);
-
      /**
       * \brief Update sensor readings and call controllers assigned to a
       * particular thread, possibly recalculating entity range assigned to this
@@ -123,8 +108,6 @@ namespace argos {
       */
       void UpdateThreadEntitySenseControl(UInt32 un_id, CRange<size_t>& c_range);
 
-      virtual void ControllableEntityIterationWaitAbort();
-
       friend void* LaunchUpdateThreadBalanceQuantity(void* p_data);
 
    };
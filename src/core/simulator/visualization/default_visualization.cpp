@@ -7,31 +7,20 @@
 #include <argos3/core/simulator/visualization/default_visualization.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/loop_functions.h>
-
-#include <unistd.h>
+#include <argos3/core/utility/profiler/profiler.h>
+#include <argos3/core/utility/string_utilities.h>
 
 namespace argos {
 
    /****************************************/
    /****************************************/
 
-   static Real TVTimeToHumanReadable(::timeval& t_time) {
-      return
-         static_cast<Real>(t_time.tv_sec) +
-         static_cast<Real>(t_time.tv_usec * 10e-6);
-   }
-
-   /****************************************/
-   /****************************************/
-
-   CDefaultVisualization::CDefaultVisualization() {
+   CDefaultVisualization::CDefaultVisualization() :
+      m_pcRate(nullptr) {
       /* Set the pointer to the step function */
       if(m_cSimulator.IsRealTimeClock()) {
-         /* Use real-time clock and set time structures */
+         /* Use real-time clock, with one tick every clock tick scaled by the real-time factor */
          m_tStepFunction = &CDefaultVisualization::RealTimeStep;
-         timerclear(&m_tStepClockTime);
-         m_tStepClockTime.tv_usec = 1e6 * CPhysicsEngine::GetSimulationClockTick();
-         ::gettimeofday(&m_tStepStartTime, nullptr);
       }
       else {
          /* Use normal clock */
@@ -42,12 +31,29 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CDefaultVisualization::~CDefaultVisualization() {
+      delete m_pcRate;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDefaultVisualization::Execute() {
+      /* Start pacing now, so the initialization of the experiment is not
+         charged to the first tick */
+      if(m_cSimulator.IsRealTimeClock()) {
+         delete m_pcRate;
+         m_pcRate = new CRate(m_cSimulator.GetRealTimeFactor() / CPhysicsEngine::GetSimulationClockTick(),
+                              m_cSimulator.GetRealTimeMaxLag());
+      }
       /* Main cycle */
       while(!m_cSimulator.IsExperimentFinished()) {
          (this->*m_tStepFunction)();
       }
       /* The experiment is finished */
+      if(m_pcRate != nullptr && m_cSimulator.IsProfiling()) {
+         ReportPacing();
+      }
       m_cSimulator.GetLoopFunctions().PostExperiment();
       LOG.Flush();
       LOGERR.Flush();
@@ -64,32 +70,38 @@ namespace argos {
    /****************************************/
 
    void CDefaultVisualization::RealTimeStep() {
-      /* m_tStepStartTime has already been set */
       m_cSimulator.UpdateSpace();
-      /* Take the time now */
-      ::gettimeofday(&m_tStepEndTime, nullptr);
-      /* Calculate the elapsed time */
-      timersub(&m_tStepEndTime, &m_tStepStartTime, &m_tStepElapsedTime);
-      /* If the elapsed time is lower than the tick length, wait */
-      if(!timercmp(&m_tStepElapsedTime, &m_tStepClockTime, >)) {
-         /* Calculate the waiting time */
-         timersub(&m_tStepClockTime, &m_tStepElapsedTime, &m_tStepWaitTime);
-         /* Wait */
-         ::usleep(static_cast<UInt32>(m_tStepWaitTime.tv_sec * 1e6 + m_tStepWaitTime.tv_usec));
-         /* Get the new step end */
-         ::gettimeofday(&m_tStepEndTime, nullptr);
-      }
-      else {
-         LOGERR << "[WARNING] Clock tick took "
-                << TVTimeToHumanReadable(m_tStepElapsedTime)
-                << " sec, more than the expected "
-                << TVTimeToHumanReadable(m_tStepClockTime)
-                << " sec."
-                << std::endl;
+      /* Wait for the end of the clock tick */
+      m_pcRate->Sleep();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDefaultVisualization::ReportPacing() {
+      CProfiler& cProfiler = m_cSimulator.GetProfiler();
+      cProfiler.SetStatistic("real_time_ticks", m_pcRate->GetTicks());
+      cProfiler.SetStatistic("real_time_overruns", m_pcRate->GetOverruns());
+      cProfiler.SetStatistic("real_time_skipped_ticks", m_pcRate->GetSkippedPeriods());
+      cProfiler.SetStatistic("real_time_jitter_mean_us", m_pcRate->GetMeanJitterUS());
+      cProfiler.SetStatistic("real_time_jitter_max_us", m_pcRate->GetMaxJitterUS());
+      /* Histograms, one statistic per bin named after its upper limit */
+      std::string strLimit;
+      UInt64 unLimit = 1;
+      for(UInt32 i = 0; i < CRate::HISTOGRAM_BINS; ++i) {
+         if(i == CRate::HISTOGRAM_BINS - 1) {
+            strLimit = "inf";
+         }
+         else if(unLimit >= 1000) {
+            strLimit = ToString(unLimit / 1000) + "ms";
+         }
+         else {
+            strLimit = ToString(unLimit) + "us";
+         }
+         cProfiler.SetStatistic("real_time_jitter_lt_" + strLimit, m_pcRate->GetJitterHistogram()[i]);
+         cProfiler.SetStatistic("real_time_overrun_lt_" + strLimit, m_pcRate->GetOverrunHistogram()[i]);
+         unLimit *= 10;
       }
-      /* Set the step start time to whatever the step end time is */
-      m_tStepStartTime.tv_sec = m_tStepEndTime.tv_sec;
-      m_tStepStartTime.tv_usec = m_tStepEndTime.tv_usec;
    }
 
    /****************************************/
@@ -14,7 +14,7 @@ namespace argos {
 }
 
 #include <argos3/core/simulator/visualization/visualization.h>
-#include <sys/time.h>
+#include <argos3/core/utility/rate.h>
 
 namespace argos {
 
@@ -24,7 +24,7 @@ namespace argos {
 
       CDefaultVisualization();
 
-      virtual ~CDefaultVisualization() {}
+      virtual ~CDefaultVisualization();
 
       virtual void Init(TConfigurationNode& t_tree) {}
 
@@ -42,6 +42,9 @@ namespace argos {
       /** Performs a simulation step respecting the real-time constraint */
       void RealTimeStep();
 
+      /** Writes the statistics of the real-time pacing in the profiler */
+      void ReportPacing();
+
    private:
 
       typedef void (CDefaultVisualization::*TStepFunction)();
@@ -51,20 +54,8 @@ namespace argos {
       /** Pointer to step function */
       TStepFunction m_tStepFunction;
 
-      /** The length of a clock tick */
-      ::timeval m_tStepClockTime;
-
-      /** The starting time of a clock tick */
-      ::timeval m_tStepStartTime;
-
-      /** The end time of a clock tick*/
-      ::timeval m_tStepEndTime;
-
-      /** The elapsed time between start and end of a clock tick */
-      ::timeval m_tStepElapsedTime;
-
-      /** The time to wait to complete a clock tick */
-      ::timeval m_tStepWaitTime;
+      /** Paces the clock ticks when the real-time clock is used */
+      CRate* m_pcRate;
 
    };
 
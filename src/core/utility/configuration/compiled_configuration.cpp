@@ -0,0 +1,343 @@
+/**
+ * @file <argos3/core/utility/configuration/compiled_configuration.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "compiled_configuration.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Layout of a compiled configuration file:
+    *
+    * - the magic string "ARGOSB", followed by the format version (UInt16);
+    * - a byte order marker (UInt32);
+    * - the number of strings (UInt32), followed by each string as its
+    *   length (UInt32) and its characters, without terminator;
+    * - the number of root nodes (UInt32);
+    * - padding up to a multiple of four bytes;
+    * - the tree, in depth-first order, made of UInt32 words. Each node is a
+    *   kind and the index of its value in the string table. Elements are
+    *   then followed by the number of attributes, the indices of the name
+    *   and of the value of each attribute, the number of children and the
+    *   children.
+    *
+    * The tree is read in place from the mapped file.
+    */
+
+   static const char   COMPILED_MAGIC[] = { 'A', 'R', 'G', 'O', 'S', 'B' };
+   static const UInt16 COMPILED_VERSION = 1;
+   static const UInt32 COMPILED_BYTE_ORDER = 0x01020304;
+
+   enum ECompiledNodeKind {
+      COMPILED_ELEMENT = 1,
+      COMPILED_TEXT    = 2
+   };
+
+   /****************************************/
+   /****************************************/
+
+   class CCompiledConfigurationWriter {
+
+   public:
+
+      void Write(ticpp::Document& t_document,
+                 const std::string& str_file_name) {
+         /* Build the tree first, so the string table is complete */
+         UInt32 unRoots = 0;
+         ticpp::Iterator<ticpp::Node> it;
+         for(it = it.begin(&t_document); it != it.end(); ++it) {
+            unRoots += WriteNode(*it);
+         }
+         /* Write the file */
+         std::ofstream cOut(str_file_name.c_str(),
+                            std::ios::out | std::ios::trunc | std::ios::binary);
+         if(cOut.fail()) {
+            THROW_ARGOSEXCEPTION("Error opening file \"" << str_file_name << "\": " << ::strerror(errno));
+         }
+         cOut.write(COMPILED_MAGIC, sizeof(COMPILED_MAGIC));
+         WriteRaw(cOut, COMPILED_VERSION);
+         WriteRaw(cOut, COMPILED_BYTE_ORDER);
+         WriteRaw(cOut, static_cast<UInt32>(m_vecStrings.size()));
+         for(size_t i = 0; i < m_vecStrings.size(); ++i) {
+            WriteRaw(cOut, static_cast<UInt32>(m_vecStrings[i]->size()));
+            cOut.write(m_vecStrings[i]->data(), m_vecStrings[i]->size());
+         }
+         WriteRaw(cOut, unRoots);
+         static const char pchPadding[sizeof(UInt32)] = { 0 };
+         cOut.write(pchPadding, (sizeof(UInt32) - cOut.tellp() % sizeof(UInt32)) % sizeof(UInt32));
+         cOut.write(reinterpret_cast<const char*>(m_vecTree.data()),
+                    m_vecTree.size() * sizeof(UInt32));
+         if(cOut.fail()) {
+            THROW_ARGOSEXCEPTION("Error writing file \"" << str_file_name << "\"");
+         }
+      }
+
+   private:
+
+      template <typename T>
+      static void WriteRaw(std::ofstream& c_out, T t_value) {
+         c_out.write(reinterpret_cast<const char*>(&t_value), sizeof(T));
+      }
+
+      UInt32 AddString(const std::string& str_value) {
+         auto it = m_mapStrings.find(str_value);
+         if(it != m_mapStrings.end()) return it->second;
+         UInt32 unIdx = m_vecStrings.size();
+         it = m_mapStrings.insert(std::make_pair(str_value, unIdx)).first;
+         m_vecStrings.push_back(&it->first);
+         return unIdx;
+      }
+
+      /*
+       * Appends a node to the tree and returns the number of nodes written,
+       * zero for the nodes that are dropped.
+       */
+      UInt32 WriteNode(ticpp::Node& t_node) {
+         if(t_node.Type() == TiXmlNode::TEXT) {
+            m_vecTree.push_back(COMPILED_TEXT);
+            m_vecTree.push_back(AddString(t_node.Value()));
+            return 1;
+         }
+         if(t_node.Type() != TiXmlNode::ELEMENT) {
+            return 0;
+         }
+         m_vecTree.push_back(COMPILED_ELEMENT);
+         m_vecTree.push_back(AddString(t_node.Value()));
+         /* Attributes */
+         size_t unCountPos = m_vecTree.size();
+         m_vecTree.push_back(0);
+         TConfigurationAttributeIterator itAttr;
+         for(itAttr = itAttr.begin(t_node.ToElement());
+             itAttr != itAttr.end();
+             ++itAttr) {
+            m_vecTree.push_back(AddString(itAttr->Name()));
+            m_vecTree.push_back(AddString(itAttr->Value()));
+            ++m_vecTree[unCountPos];
+         }
+         /* Children */
+         unCountPos = m_vecTree.size();
+         m_vecTree.push_back(0);
+         ticpp::Iterator<ticpp::Node> itChild;
+         for(itChild = itChild.begin(&t_node);
+             itChild != itChild.end();
+             ++itChild) {
+            UInt32 unWritten = WriteNode(*itChild);
+            m_vecTree[unCountPos] += unWritten;
+         }
+         return 1;
+      }
+
+   private:
+
+      std::unordered_map<std::string, UInt32> m_mapStrings;
+      std::vector<const std::string*> m_vecStrings;
+      std::vector<UInt32> m_vecTree;
+   };
+
+   /****************************************/
+   /****************************************/
+
+   class CCompiledConfigurationReader {
+
+   public:
+
+      CCompiledConfigurationReader(const std::string& str_file_name) :
+         m_strFileName(str_file_name),
+         m_pchData(nullptr),
+         m_unSize(0),
+         m_unPos(0),
+         m_punTree(nullptr),
+         m_unTreeSize(0),
+         m_unTreePos(0) {
+         int nFD = ::open(str_file_name.c_str(), O_RDONLY);
+         if(nFD < 0) {
+            THROW_ARGOSEXCEPTION("Error opening file \"" << str_file_name << "\": " << ::strerror(errno));
+         }
+         struct stat sStat;
+         if(::fstat(nFD, &sStat) < 0) {
+            ::close(nFD);
+            THROW_ARGOSEXCEPTION("Error reading file \"" << str_file_name << "\": " << ::strerror(errno));
+         }
+         m_unSize = sStat.st_size;
+         if(m_unSize > 0) {
+            void* pMap = ::mmap(nullptr, m_unSize, PROT_READ, MAP_PRIVATE, nFD, 0);
+            if(pMap == MAP_FAILED) {
+               ::close(nFD);
+               THROW_ARGOSEXCEPTION("Error mapping file \"" << str_file_name << "\": " << ::strerror(errno));
+            }
+            m_pchData = static_cast<const char*>(pMap);
+         }
+         ::close(nFD);
+      }
+
+      ~CCompiledConfigurationReader() {
+         if(m_pchData != nullptr) {
+            ::munmap(const_cast<char*>(m_pchData), m_unSize);
+         }
+      }
+
+      void Read(ticpp::Document& t_document) {
+         /* Header */
+         if(m_unSize < sizeof(COMPILED_MAGIC) ||
+            ::memcmp(m_pchData, COMPILED_MAGIC, sizeof(COMPILED_MAGIC)) != 0) {
+            THROW_ARGOSEXCEPTION("File \"" << m_strFileName << "\" is not a compiled configuration");
+         }
+         m_unPos = sizeof(COMPILED_MAGIC);
+         UInt16 unVersion = ReadRaw<UInt16>();
+         if(unVersion != COMPILED_VERSION) {
+            THROW_ARGOSEXCEPTION("File \"" << m_strFileName << "\" has version " << unVersion <<
+                                 " of the compiled configuration format, but version " <<
+                                 COMPILED_VERSION << " is supported; compile it again");
+         }
+         if(ReadRaw<UInt32>() != COMPILED_BYTE_ORDER) {
+            THROW_ARGOSEXCEPTION("File \"" << m_strFileName << "\" was compiled on a machine with a different byte order; compile it again");
+         }
+         /* String table, pointing into the mapped file */
+         UInt32 unStrings = ReadRaw<UInt32>();
+         m_vecStrings.reserve(unStrings);
+         for(UInt32 i = 0; i < unStrings; ++i) {
+            UInt32 unLength = ReadRaw<UInt32>();
+            Check(unLength);
+            m_vecStrings.emplace_back(m_pchData + m_unPos, unLength);
+            m_unPos += unLength;
+         }
+         /* The tree starts at the next multiple of four bytes, the mapping is page aligned */
+         UInt32 unRoots = ReadRaw<UInt32>();
+         m_unPos = (m_unPos + sizeof(UInt32) - 1) / sizeof(UInt32) * sizeof(UInt32);
+         if(m_unPos < m_unSize) {
+            m_punTree = reinterpret_cast<const UInt32*>(m_pchData + m_unPos);
+            m_unTreeSize = (m_unSize - m_unPos) / sizeof(UInt32);
+         }
+         m_unTreePos = 0;
+         t_document.Clear();
+         for(UInt32 i = 0; i < unRoots; ++i) {
+            ReadNode(t_document);
+         }
+      }
+
+   private:
+
+      void Check(size_t un_bytes) {
+         if(m_unPos + un_bytes > m_unSize) {
+            THROW_ARGOSEXCEPTION("File \"" << m_strFileName << "\" is truncated");
+         }
+      }
+
+      template <typename T>
+      T ReadRaw() {
+         Check(sizeof(T));
+         T tValue;
+         ::memcpy(&tValue, m_pchData + m_unPos, sizeof(T));
+         m_unPos += sizeof(T);
+         return tValue;
+      }
+
+      UInt32 NextWord() {
+         if(m_unTreePos >= m_unTreeSize) {
+            THROW_ARGOSEXCEPTION("File \"" << m_strFileName << "\" is truncated");
+         }
+         return m_punTree[m_unTreePos++];
+      }
+
+      const std::string& NextString() {
+         UInt32 unIdx = NextWord();
+         if(unIdx >= m_vecStrings.size()) {
+            THROW_ARGOSEXCEPTION("File \"" << m_strFileName << "\" is corrupted");
+         }
+         return m_vecStrings[unIdx];
+      }
+
+      void ReadNode(ticpp::Node& t_parent) {
+         UInt32 unKind = NextWord();
+         if(unKind == COMPILED_TEXT) {
+            ticpp::Text cText(NextString());
+            t_parent.LinkEndChild(&cText);
+         }
+         else if(unKind == COMPILED_ELEMENT) {
+            ticpp::Element cElement(NextString());
+            UInt32 unAttributes = NextWord();
+            for(UInt32 i = 0; i < unAttributes; ++i) {
+               const std::string& strName = NextString();
+               cElement.SetAttribute(strName, NextString());
+            }
+            t_parent.LinkEndChild(&cElement);
+            UInt32 unChildren = NextWord();
+            for(UInt32 i = 0; i < unChildren; ++i) {
+               ReadNode(cElement);
+            }
+         }
+         else {
+            THROW_ARGOSEXCEPTION("File \"" << m_strFileName << "\" is corrupted");
+         }
+      }
+
+   private:
+
+      std::string m_strFileName;
+      const char* m_pchData;
+      size_t m_unSize;
+      size_t m_unPos;
+      std::vector<std::string> m_vecStrings;
+      const UInt32* m_punTree;
+      size_t m_unTreeSize;
+      size_t m_unTreePos;
+   };
+
+   /****************************************/
+   /****************************************/
+
+   bool IsCompiledConfiguration(const std::string& str_file_name) {
+      std::ifstream cIn(str_file_name.c_str(), std::ios::in | std::ios::binary);
+      char pchMagic[sizeof(COMPILED_MAGIC)];
+      return
+         cIn.read(pchMagic, sizeof(COMPILED_MAGIC)) &&
+         ::memcmp(pchMagic, COMPILED_MAGIC, sizeof(COMPILED_MAGIC)) == 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void SaveCompiledConfiguration(ticpp::Document& t_document,
+                                  const std::string& str_file_name) {
+      CCompiledConfigurationWriter().Write(t_document, str_file_name);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void LoadCompiledConfiguration(ticpp::Document& t_document,
+                                  const std::string& str_file_name) {
+      CCompiledConfigurationReader(str_file_name).Read(t_document);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void LoadConfiguration(ticpp::Document& t_document,
+                          const std::string& str_file_name) {
+      if(IsCompiledConfiguration(str_file_name)) {
+         LoadCompiledConfiguration(t_document, str_file_name);
+      }
+      else {
+         t_document.LoadFile(str_file_name);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,72 @@
+/**
+ * @file <argos3/core/utility/configuration/compiled_configuration.h>
+ *
+ * @brief This file provides functions to store an XML configuration tree in
+ * a compiled, binary form and to load it back.
+ *
+ * Parsing the XML of large experiment files, such as those generated by
+ * scripts with tens of thousands of entities, takes time. The compiled form
+ * contains the same tree, with every distinct string stored once, and it is
+ * loaded without parsing any XML. Once loaded, the tree is accessed through
+ * the usual TConfigurationNode API.
+ *
+ * The compiled form only contains elements, attributes and text. Comments
+ * and XML declarations are dropped. Compiled files are meant to be used on
+ * the machine that produced them, and they are rejected if the byte order
+ * does not match.
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef COMPILED_CONFIGURATION_H
+#define COMPILED_CONFIGURATION_H
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <string>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Returns <tt>true</tt> if the given file contains a compiled configuration tree.
+    * @param str_file_name The name of the file.
+    * @return <tt>true</tt> if the given file contains a compiled configuration tree.
+    */
+   bool IsCompiledConfiguration(const std::string& str_file_name);
+
+   /**
+    * Writes a configuration tree into a file in compiled form.
+    * @param t_document The configuration tree.
+    * @param str_file_name The name of the file.
+    * @throws CARGoSException if an error occurs.
+    */
+   void SaveCompiledConfiguration(ticpp::Document& t_document,
+                                  const std::string& str_file_name);
+
+   /**
+    * Loads a configuration tree from a file in compiled form.
+    * The file is mapped in memory and the tree is built directly from it.
+    * @param t_document The configuration tree to fill.
+    * @param str_file_name The name of the file.
+    * @throws CARGoSException if an error occurs.
+    */
+   void LoadCompiledConfiguration(ticpp::Document& t_document,
+                                  const std::string& str_file_name);
+
+   /**
+    * Loads a configuration tree from a file, either in XML or in compiled form.
+    * @param t_document The configuration tree to fill.
+    * @param str_file_name The name of the file.
+    * @throws CARGoSException if an error occurs.
+    */
+   void LoadConfiguration(ticpp::Document& t_document,
+                          const std::string& str_file_name);
+
+   /****************************************/
+   /****************************************/
+
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include <argos3/core/utility/datatypes/datatypes.h>
 #include <argos3/core/utility/configuration/argos_exception.h>
 #include <vector>
+#include <utility>
 #include <iterator>
 #include <unistd.h>
 
@@ -40,6 +41,13 @@ namespace argos {
       CByteArray(const CByteArray& c_byte_array) :
          m_vecBuffer(c_byte_array.m_vecBuffer) {}
 
+      /**
+       * Class move constructor.
+       * The given byte array is left empty.
+       */
+      CByteArray(CByteArray&& c_byte_array) noexcept :
+         m_vecBuffer(std::move(c_byte_array.m_vecBuffer)) {}
+
       /**
        * Class constructor.
        * Copies the given buffer into the byte array. The original
@@ -148,6 +156,15 @@ namespace argos {
        */
       CByteArray& operator=(const CByteArray& c_byte_array);
 
+      /**
+       * Move assignment operator.
+       * Takes over the buffer of the given byte array, which is left empty.
+       */
+      inline CByteArray& operator=(CByteArray&& c_byte_array) noexcept {
+         m_vecBuffer = std::move(c_byte_array.m_vecBuffer);
+         return *this;
+      }
+
       /**
        * Read/write index operator.
        * @param un_index the index of the wanted element.
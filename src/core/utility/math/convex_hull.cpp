@@ -6,163 +6,294 @@
 
 #include "convex_hull.h"
 
+#include <argos3/core/utility/configuration/argos_exception.h>
+
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
 
 namespace argos {
 
    /****************************************/
    /****************************************/
 
-   void Insert(std::vector<std::vector<CConvexHull::TEdge> >& vec_edges, 
-               const std::array<UInt32, 3>& arr_vertices) {
-      for(UInt32 un_idx_i = 0; un_idx_i < arr_vertices.size(); un_idx_i++) {
-         for(UInt32 un_idx_j = 0; un_idx_j < arr_vertices.size(); un_idx_j++) {
-            if(un_idx_i != un_idx_j) {
-               CConvexHull::TEdge& tEdge = 
-                  vec_edges[arr_vertices[un_idx_i]][arr_vertices[un_idx_j]];
-               for(UInt32 un_idx_k = 0; un_idx_k < arr_vertices.size(); un_idx_k++) {
-                  if(un_idx_k != un_idx_i && un_idx_k != un_idx_j) {
-                     tEdge.push_back(arr_vertices[un_idx_k]);
-                  }
-               }             
+   namespace {
+
+      /* a face of the hull under construction */
+      struct SHullFace {
+         /* the vertices, in counter-clockwise order looking from the outside */
+         std::array<UInt32, 3> Vertices;
+         /* the face across the edge from Vertices[i] to Vertices[(i + 1) % 3] */
+         std::array<UInt32, 3> Neighbors;
+         /* the unit normal and the offset of the plane of the face */
+         CVector3 Normal;
+         Real Offset;
+         /* the points in front of this face and of none of the faces before it */
+         std::vector<UInt32> Outside;
+         /* the last iteration in which the face was found visible */
+         UInt32 VisibleAt;
+         bool Deleted;
+
+         SHullFace(const std::vector<CVector3>& vec_points,
+                   UInt32 un_A,
+                   UInt32 un_B,
+                   UInt32 un_C) :
+            Vertices{un_A, un_B, un_C},
+            VisibleAt(0),
+            Deleted(false) {
+            Normal = (vec_points[un_B] - vec_points[un_A]).CrossProduct(vec_points[un_C] - vec_points[un_A]);
+            Real fLength = Normal.Length();
+            if(fLength > 0.0) {
+               Normal /= fLength;
             }
+            Offset = Normal.DotProduct(vec_points[un_A]);
          }
-      }
-   }
 
-   /****************************************/
-   /****************************************/
+         Real Distance(const CVector3& c_point) const {
+            return Normal.DotProduct(c_point) - Offset;
+         }
 
-   void Erase(std::vector<std::vector<CConvexHull::TEdge> >& vec_edges, 
-              const std::array<UInt32, 3>& arr_vertices) {
-      for(UInt32 un_idx_i = 0; un_idx_i < arr_vertices.size(); un_idx_i++) {
-         for(UInt32 un_idx_j = 0; un_idx_j < arr_vertices.size(); un_idx_j++) {
-            if(un_idx_i != un_idx_j) {
-               CConvexHull::TEdge& tEdge = 
-                  vec_edges[arr_vertices[un_idx_i]][arr_vertices[un_idx_j]];
-               for(UInt32 un_idx_k = 0; un_idx_k < arr_vertices.size(); un_idx_k++) {
-                  if(un_idx_k != un_idx_i && un_idx_k != un_idx_j) {
-                     auto itErase =
-                        std::find(std::begin(tEdge), std::end(tEdge), arr_vertices[un_idx_k]);
-                     if(itErase != std::end(tEdge)) {
-                        tEdge.erase(itErase);
-                     }
-                  }
-               }             
+         /* returns the index of the edge from un_from to un_to */
+         UInt32 Edge(UInt32 un_from, UInt32 un_to) const {
+            for(UInt32 i = 0; i < 3; ++i) {
+               if(Vertices[i] == un_from && Vertices[(i + 1) % 3] == un_to) {
+                  return i;
+               }
+            }
+            THROW_ARGOSEXCEPTION("Convex hull: edge (" << un_from << "," << un_to << ") not found in face");
+         }
+      };
+
+      /* an edge between a visible face and a face that is not visible */
+      struct SHorizonEdge {
+         UInt32 From;
+         UInt32 To;
+         UInt32 Face;
+      };
+
+      /*
+       * Adds each point to the outside set of the first face in front of it.
+       * The points behind all the faces are inside the hull, and are dropped.
+       */
+      void AssignPoints(const std::vector<CVector3>& vec_points,
+                        std::vector<SHullFace>& vec_faces,
+                        const std::vector<UInt32>& vec_candidate_faces,
+                        const std::vector<UInt32>& vec_points_to_assign,
+                        Real f_tolerance) {
+         for(UInt32 un_point : vec_points_to_assign) {
+            for(UInt32 un_face : vec_candidate_faces) {
+               if(vec_faces[un_face].Distance(vec_points[un_point]) > f_tolerance) {
+                  vec_faces[un_face].Outside.push_back(un_point);
+                  break;
+               }
             }
          }
       }
+
    }
 
    /****************************************/
    /****************************************/
 
    /*
-    * The algorithm used to building the convex hull is based on:
-    * 1. http://instructor3.algorithmdesign.net/ppt/pdf1/IncrementalHull.pdf 
-    * 2. https://gist.github.com/msg555/4963794
+    * The algorithm is the quickhull algorithm described in:
+    * C. B. Barber, D. P. Dobkin, H. Huhdanpaa, "The Quickhull Algorithm for
+    * Convex Hulls", ACM Transactions on Mathematical Software, 22(4), 1996.
     */
    CConvexHull::CConvexHull(const std::vector<CVector3>& vec_points) :
       m_vecPoints(vec_points) {
-      /* prepare the edge table */
-      std::vector<std::vector<TEdge> > m_vecEdge;
-      m_vecEdge.resize(m_vecPoints.size());
-      for(std::vector<TEdge>& vec_edge : m_vecEdge) {
-         vec_edge.resize(m_vecPoints.size());
+      if(m_vecPoints.size() < 4) {
+         THROW_ARGOSEXCEPTION("A convex hull needs at least four points, " <<
+                              m_vecPoints.size() << " given");
       }
-      /* some of the points may form a plane or a line so find four points
-         that make a solid 3D entity as a starting point */
-      std::array<UInt32, 4> arrInitialPoints;
-      bool bFoundInitialPoints = false;
-      for (UInt32 unI = 0; unI < m_vecPoints.size() && !bFoundInitialPoints; unI++) {
-         for (UInt32 unJ = unI + 1; unJ < m_vecPoints.size() && !bFoundInitialPoints; unJ++) {
-            for (UInt32 unK = unJ + 1; unK < m_vecPoints.size() && !bFoundInitialPoints; unK++) {
-               for (UInt32 unL = unK + 1; unL < m_vecPoints.size(); unL++) {
-                  /* calculate normal vector with the first 3 points */
-                  CVector3 cNormal =
-                     (m_vecPoints[unI] - m_vecPoints[unJ]).CrossProduct(m_vecPoints[unI] - m_vecPoints[unK]);
-                  /* normal is 0 means this 3 points are in a line */
-                  /* compare Real cNormal.Length() with 0 (m_fZero)
-                   * */
-                  if (cNormal.Length() < 0.000001)
-                     continue;
-                  /* whether the 4th point is in the same plane */
-                  if ((cNormal.DotProduct(m_vecPoints[unL] - m_vecPoints[unI]) <  0.000001) &&
-                      (cNormal.DotProduct(m_vecPoints[unL] - m_vecPoints[unI]) > -0.000001) )
-                     continue;
-                  arrInitialPoints = {unI, unJ, unK, unL};
-                  bFoundInitialPoints = true;
-                  break;
-               }
+      /* the tolerance on the distance of a point from a face scales with the coordinates */
+      CVector3 cMaxAbs;
+      for(const CVector3& c_point : m_vecPoints) {
+         cMaxAbs.Set(std::max(cMaxAbs.GetX(), std::abs(c_point.GetX())),
+                     std::max(cMaxAbs.GetY(), std::abs(c_point.GetY())),
+                     std::max(cMaxAbs.GetZ(), std::abs(c_point.GetZ())));
+      }
+      Real fTolerance = 3 * std::numeric_limits<Real>::epsilon() *
+         (cMaxAbs.GetX() + cMaxAbs.GetY() + cMaxAbs.GetZ());
+      /* the initial simplex: start from the two farthest extreme points along the axes */
+      std::array<UInt32, 6> arrExtremes = {0, 0, 0, 0, 0, 0};
+      for(UInt32 i = 0; i < m_vecPoints.size(); ++i) {
+         for(UInt32 j = 0; j < 3; ++j) {
+            if(m_vecPoints[i][j] < m_vecPoints[arrExtremes[2 * j]][j]) arrExtremes[2 * j] = i;
+            if(m_vecPoints[i][j] > m_vecPoints[arrExtremes[2 * j + 1]][j]) arrExtremes[2 * j + 1] = i;
+         }
+      }
+      std::array<UInt32, 4> arrSimplex = {0, 0, 0, 0};
+      Real fMaxDistance = 0;
+      for(UInt32 i = 0; i < 6; ++i) {
+         for(UInt32 j = i + 1; j < 6; ++j) {
+            Real fDistance = (m_vecPoints[arrExtremes[i]] - m_vecPoints[arrExtremes[j]]).SquareLength();
+            if(fDistance > fMaxDistance) {
+               fMaxDistance = fDistance;
+               arrSimplex[0] = arrExtremes[i];
+               arrSimplex[1] = arrExtremes[j];
             }
          }
       }
-      /* create 4 faces out of these 4 points*/
-      for (UInt32 un_idx_i = 0; un_idx_i < 4; un_idx_i++) {
-         for (UInt32 un_idx_j = un_idx_i + 1; un_idx_j < 4; un_idx_j++) {
-            for (UInt32 un_idx_k = un_idx_j + 1; un_idx_k < 4; un_idx_k++) {
-               m_vecFaces.emplace_back(m_vecPoints,
-                                       arrInitialPoints[un_idx_i], 
-                                       arrInitialPoints[un_idx_j],
-                                       arrInitialPoints[un_idx_k],
-                                       arrInitialPoints[6 - un_idx_i - un_idx_j - un_idx_k]);
-               const SFace& sFace = m_vecFaces.back();
-               Insert(m_vecEdge, sFace.VertexIndices);
+      /* the third point is the farthest from the line through the first two */
+      CVector3 cLine = (m_vecPoints[arrSimplex[1]] - m_vecPoints[arrSimplex[0]]).Normalize();
+      fMaxDistance = 0;
+      for(UInt32 i = 0; i < m_vecPoints.size(); ++i) {
+         CVector3 cOffset = m_vecPoints[i] - m_vecPoints[arrSimplex[0]];
+         Real fDistance = cOffset.CrossProduct(cLine).Length();
+         if(fDistance > fMaxDistance) {
+            fMaxDistance = fDistance;
+            arrSimplex[2] = i;
+         }
+      }
+      if(fMaxDistance <= fTolerance) {
+         THROW_ARGOSEXCEPTION("Can't compute the convex hull: all the points are on a line");
+      }
+      /* the fourth point is the farthest from the plane through the first three */
+      SHullFace sBase(m_vecPoints, arrSimplex[0], arrSimplex[1], arrSimplex[2]);
+      fMaxDistance = 0;
+      for(UInt32 i = 0; i < m_vecPoints.size(); ++i) {
+         Real fDistance = std::abs(sBase.Distance(m_vecPoints[i]));
+         if(fDistance > fMaxDistance) {
+            fMaxDistance = fDistance;
+            arrSimplex[3] = i;
+         }
+      }
+      if(fMaxDistance <= fTolerance) {
+         THROW_ARGOSEXCEPTION("Can't compute the convex hull: all the points are on a plane");
+      }
+      /* create the faces of the simplex, looking outwards */
+      std::vector<SHullFace> vecFaces;
+      for(UInt32 i = 0; i < 4; ++i) {
+         UInt32 unA = arrSimplex[(i + 1) % 4];
+         UInt32 unB = arrSimplex[(i + 2) % 4];
+         UInt32 unC = arrSimplex[(i + 3) % 4];
+         SHullFace sFace(m_vecPoints, unA, unB, unC);
+         if(sFace.Distance(m_vecPoints[arrSimplex[i]]) > 0) {
+            sFace = SHullFace(m_vecPoints, unA, unC, unB);
+         }
+         vecFaces.push_back(sFace);
+      }
+      for(UInt32 i = 0; i < 4; ++i) {
+         for(UInt32 j = 0; j < 3; ++j) {
+            UInt32 unFrom = vecFaces[i].Vertices[j];
+            UInt32 unTo = vecFaces[i].Vertices[(j + 1) % 3];
+            for(UInt32 k = 0; k < 4; ++k) {
+               /* the faces of a tetrahedron share an edge with all the others */
+               if(k != i &&
+                  std::find(vecFaces[k].Vertices.begin(), vecFaces[k].Vertices.end(), unFrom) != vecFaces[k].Vertices.end() &&
+                  std::find(vecFaces[k].Vertices.begin(), vecFaces[k].Vertices.end(), unTo) != vecFaces[k].Vertices.end()) {
+                  vecFaces[i].Neighbors[j] = k;
+               }
             }
          }
       }
-      /* create faces with the remaining points */
-      for (UInt32 un_idx_point = 0; un_idx_point < m_vecPoints.size(); un_idx_point++) {
-         const CVector3& cPoint = m_vecPoints[un_idx_point];
-
-         /* check if this point was already used */
-         auto itPoint =
-            std::find(std::begin(arrInitialPoints), std::end(arrInitialPoints), un_idx_point);
-         if(itPoint != std::end(arrInitialPoints)) {
+      /* distribute the other points among the faces */
+      std::vector<UInt32> vecPointsToAssign;
+      vecPointsToAssign.reserve(m_vecPoints.size());
+      for(UInt32 i = 0; i < m_vecPoints.size(); ++i) {
+         if(std::find(arrSimplex.begin(), arrSimplex.end(), i) == arrSimplex.end()) {
+            vecPointsToAssign.push_back(i);
+         }
+      }
+      std::vector<UInt32> vecNewFaces = {0, 1, 2, 3};
+      AssignPoints(m_vecPoints, vecFaces, vecNewFaces, vecPointsToAssign, fTolerance);
+      /* expand the hull with the farthest outside point of each face */
+      std::vector<UInt32> vecPending = vecNewFaces;
+      std::vector<UInt32> vecVisible;
+      std::vector<SHorizonEdge> vecHorizon;
+      std::unordered_map<UInt32, UInt32> mapFaceStartingAt;
+      std::unordered_map<UInt32, UInt32> mapFaceEndingAt;
+      UInt32 unIteration = 0;
+      while(!vecPending.empty()) {
+         UInt32 unFace = vecPending.back();
+         vecPending.pop_back();
+         if(vecFaces[unFace].Deleted || vecFaces[unFace].Outside.empty()) {
             continue;
          }
-         /* find all the faces with the focal point at its outside, and remove them */
-         for (const SFace& s_face : m_vecFaces) {
-            if (s_face.Normal.DotProduct(cPoint) > s_face.Direction + 0.000001) {
-               Erase(m_vecEdge, s_face.VertexIndices);
+         ++unIteration;
+         /* the eye point */
+         const std::vector<UInt32>& vecOutside = vecFaces[unFace].Outside;
+         UInt32 unEye = vecOutside[0];
+         Real fEyeDistance = vecFaces[unFace].Distance(m_vecPoints[unEye]);
+         for(UInt32 un_point : vecOutside) {
+            Real fDistance = vecFaces[unFace].Distance(m_vecPoints[un_point]);
+            if(fDistance > fEyeDistance) {
+               fEyeDistance = fDistance;
+               unEye = un_point;
+            }
+         }
+         const CVector3& cEye = m_vecPoints[unEye];
+         /* the faces visible from the eye point are connected: find them and their horizon */
+         vecVisible.clear();
+         vecHorizon.clear();
+         vecVisible.push_back(unFace);
+         vecFaces[unFace].VisibleAt = unIteration;
+         for(size_t i = 0; i < vecVisible.size(); ++i) {
+            const SHullFace& sVisible = vecFaces[vecVisible[i]];
+            for(UInt32 j = 0; j < 3; ++j) {
+               UInt32 unNeighbor = sVisible.Neighbors[j];
+               SHullFace& sNeighbor = vecFaces[unNeighbor];
+               if(sNeighbor.VisibleAt == unIteration) {
+                  continue;
+               }
+               if(sNeighbor.Distance(cEye) > fTolerance) {
+                  sNeighbor.VisibleAt = unIteration;
+                  vecVisible.push_back(unNeighbor);
+               }
+               else {
+                  vecHorizon.push_back({sVisible.Vertices[j],
+                                        sVisible.Vertices[(j + 1) % 3],
+                                        unNeighbor});
+               }
             }
-         }       
-         auto itEraseFrom = 
-            std::remove_if(std::begin(m_vecFaces), std::end(m_vecFaces), [cPoint] (const SFace& s_face) {
-               return (s_face.Normal.DotProduct(cPoint) > s_face.Direction + 0.000001);
-            });
-         m_vecFaces.erase(itEraseFrom, std::end(m_vecFaces));
-         /* add new faces */
-         std::vector<SFace> vecFacesToAdd;
-         for (const SFace& s_face : m_vecFaces) {
-            for (UInt32 unIdxA = 0; unIdxA < 3; unIdxA++) {
-               for (UInt32 unIdxB = unIdxA + 1; unIdxB < 3; unIdxB++) {
-                  if (m_vecEdge[s_face.VertexIndices[unIdxA]][s_face.VertexIndices[unIdxB]].size() == 2)
-                     continue;
-                  UInt32 unIdxC = 3 - unIdxA - unIdxB;
-                  vecFacesToAdd.emplace_back(m_vecPoints,
-                                             s_face.VertexIndices[unIdxA],
-                                             s_face.VertexIndices[unIdxB],
-                                             un_idx_point,
-                                             s_face.VertexIndices[unIdxC]);
-                  SFace& sFace = vecFacesToAdd.back();
-                  /* verify direction, the direction should be consistent with the focal face (s_face)
-                   * the right direction is told by the order of unIdxA and unIdxB
-                   * for example, if unIdxA and unIdxB are 0 and 1, then in the new face, the
-                   * order of point s_face.VertexIndices[unIdxA] and s_face.VertexIndices[unIdxB] should be reversed
-                   * */
-                  if ((((unIdxB - unIdxA + 3) % 3 == 1) && (sFace.VertexIndices[2] != s_face.VertexIndices[unIdxB])) ||
-                      (((unIdxA - unIdxB + 3) % 3 == 1) && (sFace.VertexIndices[1] != s_face.VertexIndices[unIdxB]))) {
-                     sFace.Flip();
-                  }
-                  Insert(m_vecEdge, sFace.VertexIndices);
+         }
+         /* replace the visible faces with a cone from the horizon to the eye point */
+         vecNewFaces.clear();
+         mapFaceStartingAt.clear();
+         mapFaceEndingAt.clear();
+         for(const SHorizonEdge& s_edge : vecHorizon) {
+            UInt32 unNewFace = vecFaces.size();
+            vecFaces.emplace_back(m_vecPoints, s_edge.From, s_edge.To, unEye);
+            vecFaces[unNewFace].Neighbors[0] = s_edge.Face;
+            SHullFace& sOther = vecFaces[s_edge.Face];
+            sOther.Neighbors[sOther.Edge(s_edge.To, s_edge.From)] = unNewFace;
+            mapFaceStartingAt[s_edge.From] = unNewFace;
+            mapFaceEndingAt[s_edge.To] = unNewFace;
+            vecNewFaces.push_back(unNewFace);
+         }
+         for(UInt32 un_new_face : vecNewFaces) {
+            SHullFace& sNewFace = vecFaces[un_new_face];
+            /* across the edge from To to the eye is the face starting at To */
+            sNewFace.Neighbors[1] = mapFaceStartingAt[sNewFace.Vertices[1]];
+            /* across the edge from the eye to From is the face ending at From */
+            sNewFace.Neighbors[2] = mapFaceEndingAt[sNewFace.Vertices[0]];
+         }
+         /* the outside points of the visible faces go to the new faces */
+         vecPointsToAssign.clear();
+         for(UInt32 un_visible : vecVisible) {
+            SHullFace& sVisible = vecFaces[un_visible];
+            for(UInt32 un_point : sVisible.Outside) {
+               if(un_point != unEye) {
+                  vecPointsToAssign.push_back(un_point);
                }
             }
+            sVisible.Outside.clear();
+            sVisible.Outside.shrink_to_fit();
+            sVisible.Deleted = true;
+         }
+         AssignPoints(m_vecPoints, vecFaces, vecNewFaces, vecPointsToAssign, fTolerance);
+         vecPending.insert(vecPending.end(), vecNewFaces.begin(), vecNewFaces.end());
+      }
+      /* store the faces of the hull */
+      for(const SHullFace& s_face : vecFaces) {
+         if(!s_face.Deleted) {
+            m_vecFaces.emplace_back(m_vecPoints,
+                                    s_face.Vertices[0],
+                                    s_face.Vertices[1],
+                                    s_face.Vertices[2]);
          }
-         std::move(std::begin(vecFacesToAdd), 
-                   std::end(vecFacesToAdd),
-                   std::back_inserter(m_vecFaces));
-         vecFacesToAdd.clear();
       }
    }
 
@@ -173,10 +304,8 @@ namespace argos {
                              UInt32 un_A,
                              UInt32 un_B,
                              UInt32 un_C,
-                             UInt32 un_inside_point) {
-      VertexIndices = {un_A, un_B, un_C};
-      Normal = (vec_points[un_B] - vec_points[un_A]).CrossProduct(vec_points[un_C] - vec_points[un_A]);
-      Direction = Normal.DotProduct(vec_points[un_A]);
+                             UInt32 un_inside_point) :
+      SFace(vec_points, un_A, un_B, un_C) {
       /* flip face outwards if required */
       if (Normal.DotProduct(vec_points[un_inside_point]) > Direction) {
          Flip();
@@ -186,6 +315,18 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CConvexHull::SFace::SFace(const std::vector<CVector3>& vec_points,
+                             UInt32 un_A,
+                             UInt32 un_B,
+                             UInt32 un_C) {
+      VertexIndices = {un_A, un_B, un_C};
+      Normal = (vec_points[un_B] - vec_points[un_A]).CrossProduct(vec_points[un_C] - vec_points[un_A]);
+      Direction = Normal.DotProduct(vec_points[un_A]);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CConvexHull::SFace::Flip() {
       Normal = -Normal;
       Direction = -Direction;
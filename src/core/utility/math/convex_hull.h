@@ -13,24 +13,35 @@ namespace argos {
 
 #include <argos3/core/utility/math/vector3.h>
 #include <array>
-#include <algorithm> // REMOVE
+#include <vector>
 
 namespace argos {
 
+   /**
+    * The convex hull of a set of 3D points.
+    * The hull is computed with the quickhull algorithm, in O(n log n)
+    * expected time. The points must not all lie on a plane; an exception is
+    * thrown otherwise.
+    */
    class CConvexHull {
 
    public:
-      typedef std::vector<UInt32> TEdge;
 
-      /* each face has three points, specified in counter-clockwise 
+      /* each face has three points, specified in counter-clockwise
          order looking from the outside */
       struct SFace {
          SFace(const std::vector<CVector3>& vec_points,
-               UInt32 un_A, 
-               UInt32 un_B, 
-               UInt32 un_C, 
+               UInt32 un_A,
+               UInt32 un_B,
+               UInt32 un_C,
                UInt32 un_inside_point);
 
+         /* the points are already in counter-clockwise order */
+         SFace(const std::vector<CVector3>& vec_points,
+               UInt32 un_A,
+               UInt32 un_B,
+               UInt32 un_C);
+
          void Flip();
 
          CVector3 Normal;
@@ -0,0 +1,113 @@
+/**
+ * @file <argos3/core/utility/math/quaternion_array.h>
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef QUATERNION_ARRAY_H
+#define QUATERNION_ARRAY_H
+
+namespace argos {
+   class CQuaternionArray;
+}
+
+#include <argos3/core/utility/math/quaternion.h>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * An array of quaternions, stored as structure of arrays.
+    * The components of the quaternions are stored in four separate arrays,
+    * so that the batch transforms in transforms.h can process several
+    * quaternions per instruction.
+    * @see CQuaternion
+    * @see CVector3Array
+    */
+   class CQuaternionArray {
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param un_size The number of quaternions, all set to the identity.
+       */
+      CQuaternionArray(size_t un_size = 0) :
+         m_vecW(un_size, 1.0),
+         m_vecX(un_size, 0.0),
+         m_vecY(un_size, 0.0),
+         m_vecZ(un_size, 0.0) {}
+
+      /**
+       * Returns the number of quaternions.
+       * @return The number of quaternions.
+       */
+      inline size_t Size() const {
+         return m_vecW.size();
+      }
+
+      /**
+       * Changes the number of quaternions.
+       * The new quaternions are set to the identity.
+       * @param un_size The number of quaternions.
+       */
+      inline void Resize(size_t un_size) {
+         m_vecW.resize(un_size, 1.0);
+         m_vecX.resize(un_size, 0.0);
+         m_vecY.resize(un_size, 0.0);
+         m_vecZ.resize(un_size, 0.0);
+      }
+
+      /**
+       * Returns the quaternion at the given index.
+       * @param un_index The index of the quaternion.
+       * @return The quaternion at the given index.
+       */
+      inline CQuaternion Get(size_t un_index) const {
+         return CQuaternion(m_vecW[un_index],
+                            m_vecX[un_index],
+                            m_vecY[un_index],
+                            m_vecZ[un_index]);
+      }
+
+      /**
+       * Sets the quaternion at the given index.
+       * @param un_index The index of the quaternion.
+       * @param c_quaternion The new value of the quaternion.
+       */
+      inline void Set(size_t un_index,
+                      const CQuaternion& c_quaternion) {
+         m_vecW[un_index] = c_quaternion.GetW();
+         m_vecX[un_index] = c_quaternion.GetX();
+         m_vecY[un_index] = c_quaternion.GetY();
+         m_vecZ[un_index] = c_quaternion.GetZ();
+      }
+
+      inline const Real* GetW() const {
+         return m_vecW.data();
+      }
+
+      inline const Real* GetX() const {
+         return m_vecX.data();
+      }
+
+      inline const Real* GetY() const {
+         return m_vecY.data();
+      }
+
+      inline const Real* GetZ() const {
+         return m_vecZ.data();
+      }
+
+   private:
+
+      std::vector<Real> m_vecW;
+      std::vector<Real> m_vecX;
+      std::vector<Real> m_vecY;
+      std::vector<Real> m_vecZ;
+
+   };
+
+}
+
+#endif
@@ -1,5 +1,21 @@
 #include "transforms.h"
 
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+/*
+ * The instruction set of the batch transforms is selected at build time
+ */
+#if defined(__AVX__)
+#  include <immintrin.h>
+#  define ARGOS_BATCH_AVX
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#  define ARGOS_BATCH_SSE2
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || !defined(ARGOS_USE_DOUBLE))
+#  include <arm_neon.h>
+#  define ARGOS_BATCH_NEON
+#endif
+
 namespace argos {
 
    /****************************************/
@@ -27,4 +43,309 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   namespace {
+
+      /*
+       * The operations on packs of Reals used by the kernels. The kernels
+       * process the vectors a pack at a time, and the remaining ones with
+       * the scalar pack.
+       */
+      struct SScalarPack {
+         typedef Real TPack;
+         static const size_t WIDTH = 1;
+         static inline TPack Load(const Real* pf_data) { return *pf_data; }
+         static inline void Store(Real* pf_data, TPack t_value) { *pf_data = t_value; }
+         static inline TPack Broadcast(Real f_value) { return f_value; }
+         static inline TPack Add(TPack t_a, TPack t_b) { return t_a + t_b; }
+         static inline TPack Sub(TPack t_a, TPack t_b) { return t_a - t_b; }
+         static inline TPack Mul(TPack t_a, TPack t_b) { return t_a * t_b; }
+      };
+
+#if defined(ARGOS_BATCH_AVX)
+      static const char* BATCH_INSTRUCTION_SET = "AVX";
+      struct SSIMDPack {
+#  ifdef ARGOS_USE_DOUBLE
+         typedef __m256d TPack;
+         static const size_t WIDTH = 4;
+         static inline TPack Load(const Real* pf_data) { return _mm256_loadu_pd(pf_data); }
+         static inline void Store(Real* pf_data, TPack t_value) { _mm256_storeu_pd(pf_data, t_value); }
+         static inline TPack Broadcast(Real f_value) { return _mm256_set1_pd(f_value); }
+         static inline TPack Add(TPack t_a, TPack t_b) { return _mm256_add_pd(t_a, t_b); }
+         static inline TPack Sub(TPack t_a, TPack t_b) { return _mm256_sub_pd(t_a, t_b); }
+         static inline TPack Mul(TPack t_a, TPack t_b) { return _mm256_mul_pd(t_a, t_b); }
+#  else
+         typedef __m256 TPack;
+         static const size_t WIDTH = 8;
+         static inline TPack Load(const Real* pf_data) { return _mm256_loadu_ps(pf_data); }
+         static inline void Store(Real* pf_data, TPack t_value) { _mm256_storeu_ps(pf_data, t_value); }
+         static inline TPack Broadcast(Real f_value) { return _mm256_set1_ps(f_value); }
+         static inline TPack Add(TPack t_a, TPack t_b) { return _mm256_add_ps(t_a, t_b); }
+         static inline TPack Sub(TPack t_a, TPack t_b) { return _mm256_sub_ps(t_a, t_b); }
+         static inline TPack Mul(TPack t_a, TPack t_b) { return _mm256_mul_ps(t_a, t_b); }
+#  endif
+      };
+#elif defined(ARGOS_BATCH_SSE2)
+      static const char* BATCH_INSTRUCTION_SET = "SSE2";
+      struct SSIMDPack {
+#  ifdef ARGOS_USE_DOUBLE
+         typedef __m128d TPack;
+         static const size_t WIDTH = 2;
+         static inline TPack Load(const Real* pf_data) { return _mm_loadu_pd(pf_data); }
+         static inline void Store(Real* pf_data, TPack t_value) { _mm_storeu_pd(pf_data, t_value); }
+         static inline TPack Broadcast(Real f_value) { return _mm_set1_pd(f_value); }
+         static inline TPack Add(TPack t_a, TPack t_b) { return _mm_add_pd(t_a, t_b); }
+         static inline TPack Sub(TPack t_a, TPack t_b) { return _mm_sub_pd(t_a, t_b); }
+         static inline TPack Mul(TPack t_a, TPack t_b) { return _mm_mul_pd(t_a, t_b); }
+#  else
+         typedef __m128 TPack;
+         static const size_t WIDTH = 4;
+         static inline TPack Load(const Real* pf_data) { return _mm_loadu_ps(pf_data); }
+         static inline void Store(Real* pf_data, TPack t_value) { _mm_storeu_ps(pf_data, t_value); }
+         static inline TPack Broadcast(Real f_value) { return _mm_set1_ps(f_value); }
+         static inline TPack Add(TPack t_a, TPack t_b) { return _mm_add_ps(t_a, t_b); }
+         static inline TPack Sub(TPack t_a, TPack t_b) { return _mm_sub_ps(t_a, t_b); }
+         static inline TPack Mul(TPack t_a, TPack t_b) { return _mm_mul_ps(t_a, t_b); }
+#  endif
+      };
+#elif defined(ARGOS_BATCH_NEON)
+      static const char* BATCH_INSTRUCTION_SET = "NEON";
+      struct SSIMDPack {
+#  ifdef ARGOS_USE_DOUBLE
+         typedef float64x2_t TPack;
+         static const size_t WIDTH = 2;
+         static inline TPack Load(const Real* pf_data) { return vld1q_f64(pf_data); }
+         static inline void Store(Real* pf_data, TPack t_value) { vst1q_f64(pf_data, t_value); }
+         static inline TPack Broadcast(Real f_value) { return vdupq_n_f64(f_value); }
+         static inline TPack Add(TPack t_a, TPack t_b) { return vaddq_f64(t_a, t_b); }
+         static inline TPack Sub(TPack t_a, TPack t_b) { return vsubq_f64(t_a, t_b); }
+         static inline TPack Mul(TPack t_a, TPack t_b) { return vmulq_f64(t_a, t_b); }
+#  else
+         typedef float32x4_t TPack;
+         static const size_t WIDTH = 4;
+         static inline TPack Load(const Real* pf_data) { return vld1q_f32(pf_data); }
+         static inline void Store(Real* pf_data, TPack t_value) { vst1q_f32(pf_data, t_value); }
+         static inline TPack Broadcast(Real f_value) { return vdupq_n_f32(f_value); }
+         static inline TPack Add(TPack t_a, TPack t_b) { return vaddq_f32(t_a, t_b); }
+         static inline TPack Sub(TPack t_a, TPack t_b) { return vsubq_f32(t_a, t_b); }
+         static inline TPack Mul(TPack t_a, TPack t_b) { return vmulq_f32(t_a, t_b); }
+#  endif
+      };
+#else
+      static const char* BATCH_INSTRUCTION_SET = "none";
+      typedef SScalarPack SSIMDPack;
+#endif
+
+      /****************************************/
+      /****************************************/
+
+      /*
+       * The matrix of the rotation q v q^-1, as computed by CVector3::Rotate().
+       * The quaternion is not normalized, to give the same results.
+       */
+      void RotationMatrix(Real* pf_matrix,
+                          const CQuaternion& c_quaternion) {
+         Real fW = c_quaternion.GetW();
+         Real fX = c_quaternion.GetX();
+         Real fY = c_quaternion.GetY();
+         Real fZ = c_quaternion.GetZ();
+         Real fS = fW * fW - fX * fX - fY * fY - fZ * fZ;
+         pf_matrix[0] = fS + 2 * fX * fX;
+         pf_matrix[1] = 2 * (fX * fY - fW * fZ);
+         pf_matrix[2] = 2 * (fX * fZ + fW * fY);
+         pf_matrix[3] = 2 * (fX * fY + fW * fZ);
+         pf_matrix[4] = fS + 2 * fY * fY;
+         pf_matrix[5] = 2 * (fY * fZ - fW * fX);
+         pf_matrix[6] = 2 * (fX * fZ - fW * fY);
+         pf_matrix[7] = 2 * (fY * fZ + fW * fX);
+         pf_matrix[8] = fS + 2 * fZ * fZ;
+      }
+
+      /*
+       * v <- M v + t, for the vectors from un_begin to un_end, a pack at a time.
+       * Returns the index of the first vector left out.
+       */
+      template<class PACK>
+      size_t AffineKernel(const Real* pf_matrix,
+                          const Real* pf_translation,
+                          Real* pf_x,
+                          Real* pf_y,
+                          Real* pf_z,
+                          size_t un_begin,
+                          size_t un_end) {
+         typedef typename PACK::TPack TPack;
+         TPack tM[9];
+         for(size_t i = 0; i < 9; ++i) {
+            tM[i] = PACK::Broadcast(pf_matrix[i]);
+         }
+         TPack tTX = PACK::Broadcast(pf_translation[0]);
+         TPack tTY = PACK::Broadcast(pf_translation[1]);
+         TPack tTZ = PACK::Broadcast(pf_translation[2]);
+         size_t i = un_begin;
+         for(; i + PACK::WIDTH <= un_end; i += PACK::WIDTH) {
+            TPack tX = PACK::Load(pf_x + i);
+            TPack tY = PACK::Load(pf_y + i);
+            TPack tZ = PACK::Load(pf_z + i);
+            PACK::Store(pf_x + i,
+                        PACK::Add(PACK::Add(PACK::Add(PACK::Mul(tM[0], tX),
+                                                      PACK::Mul(tM[1], tY)),
+                                            PACK::Mul(tM[2], tZ)),
+                                  tTX));
+            PACK::Store(pf_y + i,
+                        PACK::Add(PACK::Add(PACK::Add(PACK::Mul(tM[3], tX),
+                                                      PACK::Mul(tM[4], tY)),
+                                            PACK::Mul(tM[5], tZ)),
+                                  tTY));
+            PACK::Store(pf_z + i,
+                        PACK::Add(PACK::Add(PACK::Add(PACK::Mul(tM[6], tX),
+                                                      PACK::Mul(tM[7], tY)),
+                                            PACK::Mul(tM[8], tZ)),
+                                  tTZ));
+         }
+         return i;
+      }
+
+      void Affine(CVector3Array& c_vectors,
+                  const Real* pf_matrix,
+                  const Real* pf_translation) {
+         size_t unDone = AffineKernel<SSIMDPack>(pf_matrix, pf_translation,
+                                                 c_vectors.GetX(), c_vectors.GetY(), c_vectors.GetZ(),
+                                                 0, c_vectors.Size());
+         AffineKernel<SScalarPack>(pf_matrix, pf_translation,
+                                   c_vectors.GetX(), c_vectors.GetY(), c_vectors.GetZ(),
+                                   unDone, c_vectors.Size());
+      }
+
+      /*
+       * g_i <- q_i o q_i^-1 + t_i, for the frames from un_begin to un_end, a
+       * pack at a time. The rotation is
+       * q o q^-1 = (w^2 - u.u) o + 2 (u.o) u + 2 w (u x o), with q = (w, u).
+       * Returns the index of the first frame left out.
+       */
+      template<class PACK>
+      size_t OffsetKernel(const CVector3& c_local,
+                          const CVector3Array& c_translations,
+                          const CQuaternionArray& c_orientations,
+                          CVector3Array& c_globals,
+                          size_t un_begin,
+                          size_t un_end) {
+         typedef typename PACK::TPack TPack;
+         TPack tOX = PACK::Broadcast(c_local.GetX());
+         TPack tOY = PACK::Broadcast(c_local.GetY());
+         TPack tOZ = PACK::Broadcast(c_local.GetZ());
+         TPack tTwo = PACK::Broadcast(2);
+         size_t i = un_begin;
+         for(; i + PACK::WIDTH <= un_end; i += PACK::WIDTH) {
+            TPack tW = PACK::Load(c_orientations.GetW() + i);
+            TPack tX = PACK::Load(c_orientations.GetX() + i);
+            TPack tY = PACK::Load(c_orientations.GetY() + i);
+            TPack tZ = PACK::Load(c_orientations.GetZ() + i);
+            /* w^2 - u.u */
+            TPack tS = PACK::Sub(PACK::Mul(tW, tW),
+                                 PACK::Add(PACK::Add(PACK::Mul(tX, tX),
+                                                     PACK::Mul(tY, tY)),
+                                           PACK::Mul(tZ, tZ)));
+            /* 2 (u.o) */
+            TPack tD = PACK::Mul(tTwo,
+                                 PACK::Add(PACK::Add(PACK::Mul(tX, tOX),
+                                                     PACK::Mul(tY, tOY)),
+                                           PACK::Mul(tZ, tOZ)));
+            /* 2 w */
+            TPack tW2 = PACK::Mul(tTwo, tW);
+            /* u x o */
+            TPack tCX = PACK::Sub(PACK::Mul(tY, tOZ), PACK::Mul(tZ, tOY));
+            TPack tCY = PACK::Sub(PACK::Mul(tZ, tOX), PACK::Mul(tX, tOZ));
+            TPack tCZ = PACK::Sub(PACK::Mul(tX, tOY), PACK::Mul(tY, tOX));
+            PACK::Store(c_globals.GetX() + i,
+                        PACK::Add(PACK::Add(PACK::Add(PACK::Mul(tS, tOX),
+                                                      PACK::Mul(tD, tX)),
+                                            PACK::Mul(tW2, tCX)),
+                                  PACK::Load(c_translations.GetX() + i)));
+            PACK::Store(c_globals.GetY() + i,
+                        PACK::Add(PACK::Add(PACK::Add(PACK::Mul(tS, tOY),
+                                                      PACK::Mul(tD, tY)),
+                                            PACK::Mul(tW2, tCY)),
+                                  PACK::Load(c_translations.GetY() + i)));
+            PACK::Store(c_globals.GetZ() + i,
+                        PACK::Add(PACK::Add(PACK::Add(PACK::Mul(tS, tOZ),
+                                                      PACK::Mul(tD, tZ)),
+                                            PACK::Mul(tW2, tCZ)),
+                                  PACK::Load(c_translations.GetZ() + i)));
+         }
+         return i;
+      }
+
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void Rotate(CVector3Array& c_vectors,
+               const CQuaternion& c_orientation) {
+      Real pfMatrix[9];
+      Real pfTranslation[3] = {0, 0, 0};
+      RotationMatrix(pfMatrix, c_orientation);
+      Affine(c_vectors, pfMatrix, pfTranslation);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void LocalToGlobal(CVector3Array& c_vectors,
+                      const CVector3& c_translation,
+                      const CQuaternion& c_orientation) {
+      Real pfMatrix[9];
+      Real pfTranslation[3] = {
+         c_translation.GetX(), c_translation.GetY(), c_translation.GetZ()
+      };
+      RotationMatrix(pfMatrix, c_orientation);
+      Affine(c_vectors, pfMatrix, pfTranslation);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void GlobalToLocal(CVector3Array& c_vectors,
+                      const CVector3& c_translation,
+                      const CQuaternion& c_orientation) {
+      /* R^-1 (v - t) = R^-1 v - R^-1 t */
+      Real pfMatrix[9];
+      RotationMatrix(pfMatrix, c_orientation.Inverse());
+      Real pfTranslation[3];
+      for(size_t i = 0; i < 3; ++i) {
+         pfTranslation[i] = -(pfMatrix[3 * i]     * c_translation.GetX() +
+                              pfMatrix[3 * i + 1] * c_translation.GetY() +
+                              pfMatrix[3 * i + 2] * c_translation.GetZ());
+      }
+      Affine(c_vectors, pfMatrix, pfTranslation);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void LocalToGlobal(CVector3Array& c_globals,
+                      const CVector3& c_local,
+                      const CVector3Array& c_translations,
+                      const CQuaternionArray& c_orientations) {
+      if(c_translations.Size() != c_orientations.Size()) {
+         THROW_ARGOSEXCEPTION("LocalToGlobal(): " <<
+                              c_translations.Size() << " translations and " <<
+                              c_orientations.Size() << " orientations given");
+      }
+      c_globals.Resize(c_translations.Size());
+      size_t unDone = OffsetKernel<SSIMDPack>(c_local, c_translations, c_orientations, c_globals,
+                                              0, c_translations.Size());
+      OffsetKernel<SScalarPack>(c_local, c_translations, c_orientations, c_globals,
+                                unDone, c_translations.Size());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const char* GetBatchTransformsInstructionSet() {
+      return BATCH_INSTRUCTION_SET;
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
@@ -2,7 +2,9 @@
 #define TRANSFORMS_H
 
 #include <argos3/core/utility/math/vector3.h>
+#include <argos3/core/utility/math/vector3_array.h>
 #include <argos3/core/utility/math/quaternion.h>
+#include <argos3/core/utility/math/quaternion_array.h>
 
 namespace argos {
 
@@ -14,6 +16,67 @@ namespace argos {
                           CVector3 c_translation,
                           CQuaternion c_orientation);
 
+   /*
+    * Batch transforms.
+    *
+    * These functions give the same results as CVector3::Rotate(), up to
+    * rounding, for many vectors at once. They use SIMD instructions
+    * when the compiler targets AVX, SSE2 or NEON; build with
+    * ARGOS_BUILD_NATIVE=ON to use the widest ones of the current
+    * processor.
+    */
+
+   /**
+    * Rotates all the vectors by the given quaternion.
+    * @param c_vectors The vectors to rotate.
+    * @param c_orientation The rotation.
+    * @see CVector3::Rotate()
+    */
+   void Rotate(CVector3Array& c_vectors,
+               const CQuaternion& c_orientation);
+
+   /**
+    * Transforms all the vectors from the given local frame to the global frame.
+    * @param c_vectors The vectors, in the local frame before the call and in
+    * the global frame after it.
+    * @param c_translation The position of the local frame.
+    * @param c_orientation The orientation of the local frame.
+    */
+   void LocalToGlobal(CVector3Array& c_vectors,
+                      const CVector3& c_translation,
+                      const CQuaternion& c_orientation);
+
+   /**
+    * Transforms all the vectors from the global frame to the given local frame.
+    * @param c_vectors The vectors, in the global frame before the call and in
+    * the local frame after it.
+    * @param c_translation The position of the local frame.
+    * @param c_orientation The orientation of the local frame.
+    */
+   void GlobalToLocal(CVector3Array& c_vectors,
+                      const CVector3& c_translation,
+                      const CQuaternion& c_orientation);
+
+   /**
+    * Transforms one vector from many local frames to the global frame.
+    * This is the position of an offset, such as an anchor or a sensor, on
+    * many bodies.
+    * @param c_globals The result, resized to the number of frames.
+    * @param c_local The vector in the local frames.
+    * @param c_translations The positions of the local frames.
+    * @param c_orientations The orientations of the local frames.
+    */
+   void LocalToGlobal(CVector3Array& c_globals,
+                      const CVector3& c_local,
+                      const CVector3Array& c_translations,
+                      const CQuaternionArray& c_orientations);
+
+   /**
+    * Returns the name of the instruction set used by the batch transforms.
+    * @return The name of the instruction set, e.g., <tt>"AVX"</tt>.
+    */
+   const char* GetBatchTransformsInstructionSet();
+
 }
 
 #endif // TRANSFORMS_H
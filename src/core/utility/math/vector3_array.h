@@ -0,0 +1,138 @@
+/**
+ * @file <argos3/core/utility/math/vector3_array.h>
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef VECTOR3_ARRAY_H
+#define VECTOR3_ARRAY_H
+
+namespace argos {
+   class CVector3Array;
+}
+
+#include <argos3/core/utility/math/vector3.h>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * An array of 3D vectors, stored as structure of arrays.
+    * The components of the vectors are stored in three separate arrays, one
+    * per axis, so that the batch transforms in transforms.h can process
+    * several vectors per instruction.
+    * @see CVector3
+    * @see CQuaternionArray
+    */
+   class CVector3Array {
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param un_size The number of vectors, all set to zero.
+       */
+      CVector3Array(size_t un_size = 0) :
+         m_vecX(un_size, 0.0),
+         m_vecY(un_size, 0.0),
+         m_vecZ(un_size, 0.0) {}
+
+      /**
+       * Returns the number of vectors.
+       * @return The number of vectors.
+       */
+      inline size_t Size() const {
+         return m_vecX.size();
+      }
+
+      /**
+       * Changes the number of vectors.
+       * The new vectors are set to zero.
+       * @param un_size The number of vectors.
+       */
+      inline void Resize(size_t un_size) {
+         m_vecX.resize(un_size, 0.0);
+         m_vecY.resize(un_size, 0.0);
+         m_vecZ.resize(un_size, 0.0);
+      }
+
+      /**
+       * Returns the vector at the given index.
+       * @param un_index The index of the vector.
+       * @return The vector at the given index.
+       */
+      inline CVector3 Get(size_t un_index) const {
+         return CVector3(m_vecX[un_index], m_vecY[un_index], m_vecZ[un_index]);
+      }
+
+      /**
+       * Sets the vector at the given index.
+       * @param un_index The index of the vector.
+       * @param c_vector The new value of the vector.
+       */
+      inline void Set(size_t un_index,
+                      const CVector3& c_vector) {
+         m_vecX[un_index] = c_vector.GetX();
+         m_vecY[un_index] = c_vector.GetY();
+         m_vecZ[un_index] = c_vector.GetZ();
+      }
+
+      /**
+       * Returns the <em>x</em> components of the vectors.
+       * @return The <em>x</em> components of the vectors.
+       */
+      inline Real* GetX() {
+         return m_vecX.data();
+      }
+
+      /**
+       * Returns the <em>x</em> components of the vectors.
+       * @return The <em>x</em> components of the vectors.
+       */
+      inline const Real* GetX() const {
+         return m_vecX.data();
+      }
+
+      /**
+       * Returns the <em>y</em> components of the vectors.
+       * @return The <em>y</em> components of the vectors.
+       */
+      inline Real* GetY() {
+         return m_vecY.data();
+      }
+
+      /**
+       * Returns the <em>y</em> components of the vectors.
+       * @return The <em>y</em> components of the vectors.
+       */
+      inline const Real* GetY() const {
+         return m_vecY.data();
+      }
+
+      /**
+       * Returns the <em>z</em> components of the vectors.
+       * @return The <em>z</em> components of the vectors.
+       */
+      inline Real* GetZ() {
+         return m_vecZ.data();
+      }
+
+      /**
+       * Returns the <em>z</em> components of the vectors.
+       * @return The <em>z</em> components of the vectors.
+       */
+      inline const Real* GetZ() const {
+         return m_vecZ.data();
+      }
+
+   private:
+
+      std::vector<Real> m_vecX;
+      std::vector<Real> m_vecY;
+      std::vector<Real> m_vecZ;
+
+   };
+
+}
+
+#endif
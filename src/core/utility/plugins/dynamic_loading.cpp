@@ -7,7 +7,14 @@
 #include "dynamic_loading.h"
 
 #include <dirent.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <climits>
 #include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
 
 namespace argos {
 
@@ -15,7 +22,11 @@ namespace argos {
    /****************************************/
 
    CDynamicLoading::TDLHandleMap CDynamicLoading::m_tOpenLibs;
+   CDynamicLoading::TPluginIndex CDynamicLoading::m_tPluginIndex;
+   std::vector<CDynamicLoading::SRecordedSymbol> CDynamicLoading::m_vecRecordedSymbols;
+   bool CDynamicLoading::m_bRecordSymbols = false;
    const std::string CDynamicLoading::DEFAULT_PLUGIN_PATH = ARGOS_INSTALL_PREFIX "/lib/argos3/";
+   const std::string CDynamicLoading::PLUGIN_INDEX_FILE = "argos3_plugins.idx";
 
    /****************************************/
    /****************************************/
@@ -178,9 +189,8 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   void CDynamicLoading::LoadAllLibraries() {      
-      /* String to store the full path to a library */
-      std::string strLibPath;
+   std::vector<std::string> CDynamicLoading::GetPluginDirs() {
+      std::vector<std::string> vecDirs;
       /* String to store the list of paths to search */
       std::string strPluginPath = DEFAULT_PLUGIN_PATH;
       /* Get variable ARGOS_PLUGIN_PATH from the environment */
@@ -192,54 +202,270 @@ namespace argos {
       if(strPluginPath[strPluginPath.length()-1] != ':') {
          strPluginPath.append(":");
       }
-      /*
-       * Go through paths and load all the libraries
-       */
-      /* Directory info */
-      DIR* ptDir;
-      struct dirent* ptDirData;
       /* Parse the string */
       std::istringstream issPluginPath(strPluginPath);
       std::string strDir;
       while(std::getline(issPluginPath, strDir, ':')) {
+         if(strDir.empty()) continue;
          /* Add '/' to dir if missing */
          if(strDir[strDir.length()-1] != '/') {
             strDir.append("/");
          }
-         /* Try to open the directory */
-         ptDir = ::opendir(strDir.c_str());
-         if(ptDir != nullptr) {
-            /* Directory open, now go through the files in the directory */
-            while((ptDirData = ::readdir(ptDir)) != nullptr) {
-               /* We have a file, check that it is a library file */
-               if(strlen(ptDirData->d_name) > strlen(ARGOS_SHARED_LIBRARY_EXTENSION) &&
-                  std::string(ptDirData->d_name).rfind("." ARGOS_SHARED_LIBRARY_EXTENSION) +
-                  strlen(ARGOS_SHARED_LIBRARY_EXTENSION) + 1 == strlen(ptDirData->d_name)) {
-                  /* It's a library file, load it */
-                  LoadLibrary(strDir + ptDirData->d_name);
+         vecDirs.push_back(strDir);
+      }
+      return vecDirs;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Returns true if the given file name has the extension of a shared or module library.
+    */
+   static bool IsLibraryFile(const std::string& str_file) {
+      static const std::string strShared = "." ARGOS_SHARED_LIBRARY_EXTENSION;
+      static const std::string strModule = "." ARGOS_MODULE_LIBRARY_EXTENSION;
+      return
+         (str_file.length() > strShared.length() &&
+          str_file.compare(str_file.length() - strShared.length(), strShared.length(), strShared) == 0) ||
+         (str_file.length() > strModule.length() &&
+          str_file.compare(str_file.length() - strModule.length(), strModule.length(), strModule) == 0);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Fills vec_libs with the names of the library files in the given directory.
+    * Returns false if the directory could not be opened, leaving errno set.
+    */
+   static bool ListLibrariesInDir(const std::string& str_dir,
+                                  std::vector<std::string>& vec_libs) {
+      vec_libs.clear();
+      DIR* ptDir = ::opendir(str_dir.c_str());
+      if(ptDir == nullptr) {
+         return false;
+      }
+      struct dirent* ptDirData;
+      while((ptDirData = ::readdir(ptDir)) != nullptr) {
+         if(IsLibraryFile(ptDirData->d_name)) {
+            vec_libs.push_back(ptDirData->d_name);
+         }
+      }
+      ::closedir(ptDir);
+      /* Sort the names, so the loading order does not depend on the file system */
+      std::sort(vec_libs.begin(), vec_libs.end());
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::LoadAllLibrariesInDir(const std::string& str_dir) {
+      std::vector<std::string> vecLibs;
+      if(ListLibrariesInDir(str_dir, vecLibs)) {
+         for(const std::string& strLib : vecLibs) {
+            LoadLibrary(str_dir + strLib);
+         }
+      }
+      else {
+         /* Error opening directory open, inform user without bombing out */
+         LOGERR << "[WARNING] Error opening directory \""
+                << str_dir
+                << "\": "
+                << ::strerror(errno)
+                << std::endl;
+         LOGERR.Flush();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::LoadAllLibraries() {
+      std::vector<std::string> vecDirs = GetPluginDirs();
+      for(const std::string& strDir : vecDirs) {
+         LoadAllLibrariesInDir(strDir);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::LoadLibrariesOnDemand() {
+      std::vector<std::string> vecDirs = GetPluginDirs();
+      for(const std::string& strDir : vecDirs) {
+         std::ifstream cIndex(strDir + PLUGIN_INDEX_FILE);
+         if(cIndex.is_open()) {
+            /*
+             * Each line is made of kind, label and library, separated by tabs.
+             * Libraries that register no symbols are listed with empty kind and label.
+             */
+            std::set<std::string> setIndexed;
+            std::string strLine, strKind, strLabel, strLibrary;
+            while(std::getline(cIndex, strLine)) {
+               std::istringstream issLine(strLine);
+               if(std::getline(issLine, strKind, '\t') &&
+                  std::getline(issLine, strLabel, '\t') &&
+                  std::getline(issLine, strLibrary)) {
+                  setIndexed.insert(strLibrary);
+                  if(!strKind.empty()) {
+                     m_tPluginIndex.insert(
+                        std::make_pair(strKind + "\t" + strLabel, strDir + strLibrary));
+                  }
                }
-               if(strcmp(ARGOS_SHARED_LIBRARY_EXTENSION, ARGOS_MODULE_LIBRARY_EXTENSION) != 0) {
-                  if(strlen(ptDirData->d_name) > strlen(ARGOS_MODULE_LIBRARY_EXTENSION) &&
-                     std::string(ptDirData->d_name).rfind("." ARGOS_MODULE_LIBRARY_EXTENSION) +
-                     strlen(ARGOS_MODULE_LIBRARY_EXTENSION) + 1 == strlen(ptDirData->d_name)) {
-                     /* It's a library file, load it */
-                     LoadLibrary(strDir + ptDirData->d_name);
+            }
+            LOG << "[INFO] Using plugin index \"" << strDir << PLUGIN_INDEX_FILE << "\"" << std::endl;
+            LOG.Flush();
+            /*
+             * The index does not know the symbols of the libraries added or rebuilt
+             * after it was written: load those right away
+             */
+            struct stat tIndexStat, tLibStat;
+            std::vector<std::string> vecLibs;
+            if(::stat((strDir + PLUGIN_INDEX_FILE).c_str(), &tIndexStat) == 0 &&
+               ListLibrariesInDir(strDir, vecLibs)) {
+               for(const std::string& strLib : vecLibs) {
+                  std::string strReason;
+                  if(setIndexed.find(strLib) == setIndexed.end()) {
+                     strReason = "is not in the plugin index";
+                  }
+                  else if(::stat((strDir + strLib).c_str(), &tLibStat) == 0 &&
+                          tLibStat.st_mtime > tIndexStat.st_mtime) {
+                     strReason = "is newer than the plugin index";
+                  }
+                  if(!strReason.empty()) {
+                     LOGERR << "[WARNING] Library \"" << strDir << strLib << "\" " << strReason
+                            << ", loading it now. Run 'argos3 --index-plugins " << strDir
+                            << "' to update the index." << std::endl;
+                     LOGERR.Flush();
+                     LoadLibrary(strDir + strLib);
                   }
                }
             }
-            /* Close directory */
-            ::closedir(ptDir);
+            else {
+               LOGERR << "[WARNING] Error scanning directory \""
+                      << strDir
+                      << "\": "
+                      << ::strerror(errno)
+                      << std::endl;
+               LOGERR.Flush();
+            }
          }
          else {
-            /* Error opening directory open, inform user without bombing out */
-            LOGERR << "[WARNING] Error opening directory \""
-                   << strDir
-                   << "\": "
-                   << ::strerror(errno)
+            /* No index, load everything */
+            LoadAllLibrariesInDir(strDir);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CDynamicLoading::LoadLibrariesForSymbol(const std::string& str_kind,
+                                                const std::string& str_label) {
+      auto tRange = m_tPluginIndex.equal_range(str_kind + "\t" + str_label);
+      if(tRange.first == tRange.second) {
+         return false;
+      }
+      /* Remove the entries before loading, the index must not be queried again for them */
+      std::vector<std::string> vecLibs;
+      for(auto it = tRange.first; it != tRange.second; ++it) {
+         vecLibs.push_back(it->second);
+      }
+      m_tPluginIndex.erase(tRange.first, tRange.second);
+      for(const std::string& strLib : vecLibs) {
+         LoadLibrary(strLib);
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Returns the canonical directory of the given path, terminated by '/'.
+    * If the path cannot be resolved, an empty string is returned.
+    */
+   static std::string CanonicalDir(const std::string& str_path,
+                                   bool b_is_dir) {
+      std::string strDir = str_path;
+      if(!b_is_dir) {
+         size_t unSlash = strDir.rfind('/');
+         if(unSlash == std::string::npos) return "";
+         strDir = strDir.substr(0, unSlash);
+      }
+      char pchResolved[PATH_MAX];
+      if(::realpath(strDir.c_str(), pchResolved) == nullptr) return "";
+      strDir = pchResolved;
+      if(strDir[strDir.length()-1] != '/') {
+         strDir.append("/");
+      }
+      return strDir;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::WritePluginIndex(const std::string& str_dir) {
+      std::string strDir = CanonicalDir(str_dir, true);
+      if(strDir.empty()) {
+         THROW_ARGOSEXCEPTION("Can't index plugins in \"" << str_dir << "\": " << ::strerror(errno));
+      }
+      /* Load the libraries while recording the registered symbols */
+      m_vecRecordedSymbols.clear();
+      m_bRecordSymbols = true;
+      try {
+         LoadAllLibrariesInDir(strDir);
+      }
+      catch(CARGoSException& ex) {
+         m_bRecordSymbols = false;
+         THROW_ARGOSEXCEPTION_NESTED("Can't index plugins in \"" << str_dir << "\"", ex);
+      }
+      m_bRecordSymbols = false;
+      /* Write the index, keeping only the symbols defined in this directory */
+      std::ofstream cIndex(strDir + PLUGIN_INDEX_FILE, std::ios::trunc | std::ios::out);
+      if(cIndex.fail()) {
+         THROW_ARGOSEXCEPTION("Error opening file \"" << strDir << PLUGIN_INDEX_FILE << "\"");
+      }
+      UInt32 unSymbols = 0;
+      std::set<std::string> setWithSymbols;
+      for(const SRecordedSymbol& sSymbol : m_vecRecordedSymbols) {
+         if(CanonicalDir(sSymbol.Library, false) == strDir) {
+            std::string strLib = sSymbol.Library.substr(sSymbol.Library.rfind('/') + 1);
+            cIndex << sSymbol.Kind << '\t'
+                   << sSymbol.Label << '\t'
+                   << strLib
                    << std::endl;
-            LOGERR.Flush();
+            setWithSymbols.insert(strLib);
+            ++unSymbols;
          }
       }
+      /* List the other libraries too, so they are not mistaken for new ones when the index is read */
+      std::vector<std::string> vecLibs;
+      ListLibrariesInDir(strDir, vecLibs);
+      for(const std::string& strLib : vecLibs) {
+         if(setWithSymbols.find(strLib) == setWithSymbols.end()) {
+            cIndex << '\t' << '\t' << strLib << std::endl;
+         }
+      }
+      m_vecRecordedSymbols.clear();
+      LOG << "[INFO] Wrote " << unSymbols << " symbols to \"" << strDir << PLUGIN_INDEX_FILE << "\"" << std::endl;
+      LOG.Flush();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::RegisterSymbol(const std::string& str_kind,
+                                        const std::string& str_label,
+                                        void* pt_creator) {
+      if(!m_bRecordSymbols) return;
+      /* Find the library that contains the creator */
+      Dl_info tInfo;
+      if(::dladdr(pt_creator, &tInfo) != 0 && tInfo.dli_fname != nullptr) {
+         m_vecRecordedSymbols.push_back(SRecordedSymbol{str_kind, str_label, tInfo.dli_fname});
+      }
    }
 
    /****************************************/
@@ -12,6 +12,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <dlfcn.h>
 #include <cstdlib>
@@ -78,6 +79,75 @@ namespace argos {
        */
       static void UnloadAllLibraries();
 
+      /**
+       * Prepares the dynamic libraries in the current ARGOS_PLUGIN_PATH for on-demand loading.
+       * For each directory in the path that contains a plugin index (see WritePluginIndex()),
+       * the index is read and its libraries are loaded only when one of the symbols they
+       * provide is requested through CFactory. The libraries that are missing from the index,
+       * or that were modified after it was written, are loaded immediately with a warning.
+       * The libraries in directories without an index are loaded immediately, as
+       * LoadAllLibraries() does.
+       * @throws CARGoSException in case of error
+       * @see LoadLibrariesForSymbol()
+       */
+      static void LoadLibrariesOnDemand();
+
+      /**
+       * Loads the indexed libraries that provide the given symbol.
+       * Internally used by CFactory when a symbol is not found.
+       * @param str_kind The kind of symbol, i.e., the type name of the factory
+       * @param str_label The label of the symbol
+       * @return <tt>true</tt> if at least one library was loaded
+       * @throws CARGoSException in case of error
+       * @see LoadLibrariesOnDemand()
+       */
+      static bool LoadLibrariesForSymbol(const std::string& str_kind,
+                                         const std::string& str_label);
+
+      /**
+       * Loads all the dynamic libraries in the given directory and writes the plugin index.
+       * The index, stored in the given directory with the name PLUGIN_INDEX_FILE, associates
+       * each symbol registered in CFactory with the library that defines it, and also lists
+       * the libraries that register no symbols. It is meant to
+       * be generated when the libraries are installed (<tt>argos3 --index-plugins DIR</tt>).
+       * @param str_dir The directory containing the libraries
+       * @throws CARGoSException in case of error
+       */
+      static void WritePluginIndex(const std::string& str_dir);
+
+      /**
+       * Records the registration of a symbol in CFactory.
+       * Internally used by CFactory to build the plugin index. The symbol is recorded
+       * only while WritePluginIndex() is executing.
+       * @param str_kind The kind of symbol, i.e., the type name of the factory
+       * @param str_label The label of the symbol
+       * @param pt_creator The address of the function that creates the symbol
+       */
+      static void RegisterSymbol(const std::string& str_kind,
+                                 const std::string& str_label,
+                                 void* pt_creator);
+
+   public:
+
+      /**
+       * The name of the plugin index file
+       */
+      static const std::string PLUGIN_INDEX_FILE;
+
+   private:
+
+      /**
+       * Loads all the dynamic libraries in the given directory.
+       * @param str_dir The directory, terminated by '/'
+       * @throws CARGoSException in case of error
+       */
+      static void LoadAllLibrariesInDir(const std::string& str_dir);
+
+      /**
+       * Returns the list of directories in the current plugin path, each terminated by '/'.
+       */
+      static std::vector<std::string> GetPluginDirs();
+
    private:
 
       /**
@@ -90,6 +160,35 @@ namespace argos {
        */
       static TDLHandleMap m_tOpenLibs;
 
+      /**
+       * A type definition of the plugin index, from "kind label" to library path
+       */
+      typedef std::multimap<std::string, std::string> TPluginIndex;
+
+      /**
+       * The index of the libraries to load on demand
+       */
+      static TPluginIndex m_tPluginIndex;
+
+      /**
+       * A symbol registered while building the plugin index
+       */
+      struct SRecordedSymbol {
+         std::string Kind;
+         std::string Label;
+         std::string Library;
+      };
+
+      /**
+       * The symbols recorded while building the plugin index
+       */
+      static std::vector<SRecordedSymbol> m_vecRecordedSymbols;
+
+      /**
+       * <tt>true</tt> while the plugin index is being built
+       */
+      static bool m_bRecordSymbols;
+
       /**
        * Default plugin paths
        */
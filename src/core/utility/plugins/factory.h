@@ -44,10 +44,15 @@
 #ifndef FACTORY_H
 #define FACTORY_H
 
+#include <argos3/core/config.h>
 #include <argos3/core/utility/configuration/argos_exception.h>
+#ifdef ARGOS_DYNAMIC_LIBRARY_LOADING
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#endif
 #include <map>
 #include <iostream>
 #include <string>
+#include <typeinfo>
 #include <cstdlib>
 
 namespace argos {
@@ -107,6 +112,8 @@ namespace argos {
                            TCreator* pc_creator);
       /**
        * Creates a new object of type <tt>TYPE</tt>
+       * If the label is not registered, the libraries that provide it are loaded
+       * on demand through the plugin index.
        * @param str_label The label of the <tt>TYPE</tt> to create
        * @return A new object of type <tt>TYPE</tt>
        */
@@ -114,6 +121,8 @@ namespace argos {
 
       /**
        * Returns <tt>true</tt> if the given label exists in the <tt>TYPE</tt> map
+       * If the label is not registered, the libraries that provide it are loaded
+       * on demand through the plugin index.
        * @return <tt>true</tt> if the given label exists in the <tt>TYPE</tt> map
        */
       static bool Exists(const std::string& str_label);
@@ -39,6 +39,11 @@ void CFactory<TYPE>::Register(const std::string& str_label,
    psTypeInfo->Status = str_status;
    psTypeInfo->Creator = pc_creator;
    GetTypeMap()[str_label] = psTypeInfo;
+#ifdef ARGOS_DYNAMIC_LIBRARY_LOADING
+   CDynamicLoading::RegisterSymbol(typeid(TYPE).name(),
+                                   str_label,
+                                   reinterpret_cast<void*>(pc_creator));
+#endif
 }
 
 /****************************************/
@@ -47,6 +52,12 @@ void CFactory<TYPE>::Register(const std::string& str_label,
 template<typename TYPE>
 TYPE* CFactory<TYPE>::New(const std::string& str_label) {
    typename TTypeMap::iterator it = GetTypeMap().find(str_label);
+#ifdef ARGOS_DYNAMIC_LIBRARY_LOADING
+   if(it == GetTypeMap().end() &&
+      CDynamicLoading::LoadLibrariesForSymbol(typeid(TYPE).name(), str_label)) {
+      it = GetTypeMap().find(str_label);
+   }
+#endif
    if(it != GetTypeMap().end()) {
       return it->second->Creator();
    }
@@ -61,6 +72,12 @@ TYPE* CFactory<TYPE>::New(const std::string& str_label) {
 template<typename TYPE>
 bool CFactory<TYPE>::Exists(const std::string& str_label) {
    typename TTypeMap::iterator it = GetTypeMap().find(str_label);
+#ifdef ARGOS_DYNAMIC_LIBRARY_LOADING
+   if(it == GetTypeMap().end() &&
+      CDynamicLoading::LoadLibrariesForSymbol(typeid(TYPE).name(), str_label)) {
+      it = GetTypeMap().find(str_label);
+   }
+#endif
    return(it != GetTypeMap().end());
 }
 
@@ -186,6 +186,14 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CProfiler::SetStatistic(const std::string& str_name,
+                                double f_value) {
+      m_mapStatistics[str_name] = f_value;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CProfiler::FlushHumanReadable() {
       m_cOutFile << "[profiled portion overall]" << std::endl << std::endl;
       double fStartTime = TV2Sec(m_tWallClockStart);
@@ -214,6 +222,14 @@ namespace argos {
             DumpResourceUsageHumanReadable(m_cOutFile, m_vecThreadResourceUsage[i]);
          }
       }
+      if(! m_mapStatistics.empty()) {
+         m_cOutFile << std::endl << "[statistics]" << std::endl << std::endl;
+         for(std::map<std::string, double>::const_iterator it = m_mapStatistics.begin();
+             it != m_mapStatistics.end();
+             ++it) {
+            m_cOutFile << it->first << ": " << it->second << std::endl;
+         }
+      }
    }
 
    /****************************************/
@@ -246,6 +262,11 @@ namespace argos {
             DumpResourceUsageAsTableRow(m_cOutFile, m_vecThreadResourceUsage[i]);
          }
       }
+      for(std::map<std::string, double>::const_iterator it = m_mapStatistics.begin();
+          it != m_mapStatistics.end();
+          ++it) {
+         m_cOutFile << std::endl << "Statistic " << it->first << " " << it->second;
+      }
       m_cOutFile << std::endl;
    }
 
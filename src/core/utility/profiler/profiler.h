@@ -13,6 +13,7 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <map>
 #include <vector>
 
 namespace argos {
@@ -30,6 +31,15 @@ namespace argos {
       void Flush(bool b_human_readable);
       void CollectThreadResourceUsage();
 
+      /**
+       * Sets a named statistic to be written along with the resource usage.
+       * Setting a statistic again overwrites its value.
+       * @param str_name The name of the statistic. It must not contain spaces.
+       * @param f_value The value of the statistic.
+       */
+      void SetStatistic(const std::string& str_name,
+                        double f_value);
+
    private:
 
       void StartWallClock();
@@ -50,6 +60,7 @@ namespace argos {
       ::rusage m_tResourceUsageEnd;
       std::vector< ::rusage > m_vecThreadResourceUsage;
       pthread_mutex_t m_tThreadResourceUsageMutex;
+      std::map<std::string, double> m_mapStatistics;
 
    };
 
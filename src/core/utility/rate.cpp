@@ -1,26 +1,73 @@
 #include "rate.h"
 #include <argos3/core/utility/logging/argos_log.h>
+#include <cerrno>
 
 using namespace argos;
 
 /****************************************/
 /****************************************/
 
-CRate::CRate(Real f_rate) {
+/*
+ * Returns the current time on the monotonic clock in nanoseconds.
+ */
+static UInt64 NowNS() {
+  ::timespec tNow;
+  ::clock_gettime(CLOCK_MONOTONIC, &tNow);
+  return static_cast<UInt64>(tNow.tv_sec) * 1000000000 + tNow.tv_nsec;
+}
+
+/*
+ * Sleeps until the given time on the monotonic clock in nanoseconds.
+ */
+static void SleepUntilNS(UInt64 un_deadline) {
+#ifdef __APPLE__
+  /* No absolute sleep on Mac, sleep for the remaining time */
+  UInt64 unNow = NowNS();
+  while(unNow < un_deadline) {
+    ::timespec tSleepPeriod;
+    tSleepPeriod.tv_sec = (un_deadline - unNow) / 1000000000;
+    tSleepPeriod.tv_nsec = (un_deadline - unNow) % 1000000000;
+    ::nanosleep(&tSleepPeriod, nullptr);
+    unNow = NowNS();
+  }
+#else
+  ::timespec tDeadline;
+  tDeadline.tv_sec = un_deadline / 1000000000;
+  tDeadline.tv_nsec = un_deadline % 1000000000;
+  /* Sleep again if interrupted by a signal */
+  while(::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tDeadline, nullptr) == EINTR);
+#endif
+}
+
+/*
+ * Adds a value in nanoseconds to a histogram with bins of powers of ten microseconds.
+ */
+static void AddToHistogram(UInt64* pun_histogram,
+                           UInt64 un_value) {
+  UInt32 unBin = 0;
+  UInt64 unLimit = 1000;
+  while(unBin < CRate::HISTOGRAM_BINS - 1 && un_value >= unLimit) {
+    ++unBin;
+    unLimit *= 10;
+  }
+  ++pun_histogram[unBin];
+}
+
+/****************************************/
+/****************************************/
+
+CRate::CRate(Real f_rate,
+             UInt32 un_max_lag) :
+  m_unMaxLag(un_max_lag) {
   SetRate(f_rate);
+  ResetStatistics();
 }
 
 /****************************************/
 /****************************************/
 
 UInt64 CRate::ElapsedUS() const {
-  /* Get current time */
-  ::timeval tNow;
-  ::gettimeofday(&tNow, nullptr);
-  /* Calculate difference between past call and now */
-  ::timeval tDiff;
-  timersub(&tNow, &m_tPast, &tDiff);
-  return tDiff.tv_sec * 1000000 + tDiff.tv_usec;  
+  return (NowNS() - m_unPast) / 1000;
 }
 
 /****************************************/
@@ -36,24 +83,42 @@ Real CRate::ElapsedS() const {
 /****************************************/
 
 void CRate::Sleep() {
-  UInt64 unMicroSecDiff = ElapsedUS();
-  /* Sleep if necessary */
-  if(unMicroSecDiff < m_unNominalPeriod) {
-    ::timespec tSleepPeriod;
-    tSleepPeriod.tv_sec = static_cast<UInt32>((m_unNominalPeriod - unMicroSecDiff) / 1e6);
-    tSleepPeriod.tv_nsec = (m_unNominalPeriod - unMicroSecDiff) * 1000;
-    ::nanosleep(&tSleepPeriod, nullptr);
+  ++m_unTicks;
+  UInt64 unNow = NowNS();
+  if(unNow < m_unDeadline) {
+    /* Sleep until the deadline, and take note of how late we woke up */
+    SleepUntilNS(m_unDeadline);
+    m_unPast = NowNS();
+    UInt64 unJitter = (m_unPast > m_unDeadline) ? (m_unPast - m_unDeadline) : 0;
+    ++m_unSleeps;
+    m_unTotalJitter += unJitter;
+    if(unJitter > m_unMaxJitter) m_unMaxJitter = unJitter;
+    AddToHistogram(m_punJitterHistogram, unJitter);
+    /* The deadlines are absolute, so waking up late does not shift them */
+    m_unDeadline += m_unNominalPeriod;
   }
   else {
-    LOGERR << "[WARNING] Nominal rate "
-	   << m_fNominalRate
-	   << " loops per sec delayed by "
-	   << (unMicroSecDiff - m_unNominalPeriod)
-	   << " microseconds"
-	   << std::endl;
+    /* The period was exceeded */
+    UInt64 unLate = unNow - m_unDeadline;
+    ++m_unOverruns;
+    AddToHistogram(m_punOverrunHistogram, unLate);
+    m_unPast = unNow;
+    if(unLate / m_unNominalPeriod < m_unMaxLag) {
+      /* Catch up: the next period starts right away */
+      m_unDeadline += m_unNominalPeriod;
+    }
+    else {
+      /* Too late: skip the late periods and start again from now */
+      m_unSkippedPeriods += unLate / m_unNominalPeriod;
+      m_unDeadline = unNow + m_unNominalPeriod;
+      LOGERR << "[WARNING] Nominal rate "
+             << m_fNominalRate
+             << " loops per sec delayed by "
+             << (unLate / 1000)
+             << " microseconds"
+             << std::endl;
+    }
   }
-  /* Update past for next call */
-  ::gettimeofday(&m_tPast, nullptr);
 }
 
 /****************************************/
@@ -61,8 +126,33 @@ void CRate::Sleep() {
 
 void CRate::SetRate(Real f_rate) {
   m_fNominalRate = Abs(f_rate);
-  m_unNominalPeriod = 1e6 / m_fNominalRate;
-  ::gettimeofday(&m_tPast, nullptr);
+  m_unNominalPeriod = 1e9 / m_fNominalRate;
+  m_unPast = NowNS();
+  m_unDeadline = m_unPast + m_unNominalPeriod;
+}
+
+/****************************************/
+/****************************************/
+
+Real CRate::GetMeanJitterUS() const {
+  if(m_unSleeps == 0) return 0.0;
+  return static_cast<Real>(m_unTotalJitter) / m_unSleeps / 1e3;
+}
+
+/****************************************/
+/****************************************/
+
+void CRate::ResetStatistics() {
+  m_unTicks = 0;
+  m_unOverruns = 0;
+  m_unSkippedPeriods = 0;
+  m_unSleeps = 0;
+  m_unTotalJitter = 0;
+  m_unMaxJitter = 0;
+  for(UInt32 i = 0; i < HISTOGRAM_BINS; ++i) {
+    m_punJitterHistogram[i] = 0;
+    m_punOverrunHistogram[i] = 0;
+  }
 }
 
 /****************************************/
@@ -23,16 +23,39 @@ namespace argos {
    *   // don't sleep and write a warning message
    *   cRate.Sleep();
    * }
+   *
+   * The ticks follow absolute deadlines on the monotonic clock, so the time
+   * lost waking up late is recovered in the next tick and the rate does not
+   * drift. When a tick overruns its period, the next ticks start right away
+   * to catch up, as long as the loop is late by no more than the maximum lag
+   * (in periods). Beyond that, the late periods are skipped and the
+   * deadlines start again from the current time. With the default maximum
+   * lag of zero, an overrun is never made up for.
+   *
+   * The class also records how late each tick woke up (the jitter) and by
+   * how much each overrunning tick exceeded its deadline, in histograms
+   * with bins of increasing powers of ten microseconds.
    */
   class CRate {
 
+  public:
+
+    /**
+     * The number of bins of the jitter and overrun histograms.
+     * Bin <i>i</i> counts the values below 10^<i>i</i> microseconds and not
+     * counted in the previous bins; the last bin counts the rest.
+     */
+    static const UInt32 HISTOGRAM_BINS = 7;
+
   public:
 
     /**
      * Class constructor.
      * @param f_rate The number of ticks per second.
+     * @param un_max_lag The number of periods the loop can be late and still catch up.
      */
-    CRate(Real f_rate);
+    CRate(Real f_rate,
+          UInt32 un_max_lag = 0);
 
     /**
      * Class destructor.
@@ -50,9 +73,10 @@ namespace argos {
     Real ElapsedS() const;
 
     /**
-     * Sleeps for the appropriate time to complete the period.
-     * If the period was exceeded before this call, this method does not
-     * sleep and, instead, write a warning on the log.
+     * Sleeps until the deadline of the current period.
+     * If the deadline has already passed, this method does not sleep. If
+     * the loop is then late by more than the maximum lag, the late periods
+     * are skipped and a warning is written on the log.
      */
     void Sleep();
 
@@ -69,11 +93,93 @@ namespace argos {
      */
     void SetRate(Real f_rate);
 
+    /**
+     * Returns the number of periods the loop can be late and still catch up.
+     */
+    inline UInt32 GetMaxLag() const {
+      return m_unMaxLag;
+    }
+
+    /**
+     * Sets the number of periods the loop can be late and still catch up.
+     * @param un_max_lag The maximum lag, in periods.
+     */
+    inline void SetMaxLag(UInt32 un_max_lag) {
+      m_unMaxLag = un_max_lag;
+    }
+
+    /**
+     * Returns the number of calls to Sleep() since the statistics were reset.
+     */
+    inline UInt64 GetTicks() const {
+      return m_unTicks;
+    }
+
+    /**
+     * Returns the number of ticks that exceeded their deadline.
+     */
+    inline UInt64 GetOverruns() const {
+      return m_unOverruns;
+    }
+
+    /**
+     * Returns the number of periods skipped because the loop was too late.
+     */
+    inline UInt64 GetSkippedPeriods() const {
+      return m_unSkippedPeriods;
+    }
+
+    /**
+     * Returns the largest delay, in microseconds, with which a tick woke up after its deadline.
+     */
+    inline UInt64 GetMaxJitterUS() const {
+      return m_unMaxJitter / 1000;
+    }
+
+    /**
+     * Returns the mean delay, in microseconds, with which the ticks woke up after their deadline.
+     */
+    Real GetMeanJitterUS() const;
+
+    /**
+     * Returns the histogram of the delays with which the ticks woke up after their deadline.
+     * @see HISTOGRAM_BINS
+     */
+    inline const UInt64* GetJitterHistogram() const {
+      return m_punJitterHistogram;
+    }
+
+    /**
+     * Returns the histogram of the time by which the ticks exceeded their deadline.
+     * @see HISTOGRAM_BINS
+     */
+    inline const UInt64* GetOverrunHistogram() const {
+      return m_punOverrunHistogram;
+    }
+
+    /**
+     * Resets the statistics.
+     */
+    void ResetStatistics();
+
   private:
 
     Real m_fNominalRate;
+    /** The period, in nanoseconds */
     UInt64 m_unNominalPeriod;
-    ::timeval m_tPast;
+    UInt32 m_unMaxLag;
+    /** The time of the end of the last sleep, in nanoseconds */
+    UInt64 m_unPast;
+    /** The deadline of the current period, in nanoseconds */
+    UInt64 m_unDeadline;
+    UInt64 m_unTicks;
+    UInt64 m_unOverruns;
+    UInt64 m_unSkippedPeriods;
+    UInt64 m_unSleeps;
+    UInt64 m_unTotalJitter;
+    UInt64 m_unMaxJitter;
+    UInt64 m_punJitterHistogram[HISTOGRAM_BINS];
+    UInt64 m_punOverrunHistogram[HISTOGRAM_BINS];
 
   };
 
@@ -12,16 +12,89 @@
 #include <argos3/core/wrappers/lua/lua_vector2.h>
 #include <argos3/core/wrappers/lua/lua_vector3.h>
 
+#include <pthread.h>
+#include <vector>
+
 namespace argos {
 
    /****************************************/
    /****************************************/
 
+   /*
+    * A Lua state shared by several robots.
+    */
+   struct SLuaSharedState {
+      lua_State* State;
+      pthread_mutex_t Mutex;
+   };
+
+   /*
+    * The pool of shared Lua states.
+    * It is created by the first controller asking for it, and destroyed
+    * with the last one.
+    */
+   static std::vector<SLuaSharedState*> vecSharedStates;
+   static UInt32 unSharedStateUsers = 0;
+   static UInt32 unNextSharedState = 0;
+
+   /* The registry key of the globals the robot environments inherit */
+   static const char* BASE_GLOBALS_KEY = "argos3.base_globals";
+
+   /* The registry key of the package.loaded table of the shared state */
+   static const char* BASE_LOADED_KEY = "argos3.base_loaded";
+
+   /* The registry key where require() looks for the loaded modules */
+   static const char* LOADED_KEY = "_LOADED";
+
+   static SLuaSharedState* AcquireSharedState(UInt32 un_states) {
+      if(vecSharedStates.empty()) {
+         for(UInt32 i = 0; i < un_states; ++i) {
+            SLuaSharedState* psState = new SLuaSharedState;
+            psState->State = luaL_newstate();
+            luaL_openlibs(psState->State);
+            lua_pushglobaltable(psState->State);
+            lua_setfield(psState->State, LUA_REGISTRYINDEX, BASE_GLOBALS_KEY);
+            lua_getfield(psState->State, LUA_REGISTRYINDEX, LOADED_KEY);
+            lua_setfield(psState->State, LUA_REGISTRYINDEX, BASE_LOADED_KEY);
+            pthread_mutex_init(&psState->Mutex, NULL);
+            vecSharedStates.push_back(psState);
+         }
+         unNextSharedState = 0;
+      }
+      else if(vecSharedStates.size() != un_states) {
+         THROW_ARGOSEXCEPTION("All the Lua controllers must use the same number of shared states, found "
+                              << vecSharedStates.size()
+                              << " and "
+                              << un_states);
+      }
+      SLuaSharedState* psState = vecSharedStates[unNextSharedState];
+      unNextSharedState = (unNextSharedState + 1) % un_states;
+      ++unSharedStateUsers;
+      return psState;
+   }
+
+   static void ReleaseSharedState() {
+      if(--unSharedStateUsers == 0) {
+         for(size_t i = 0; i < vecSharedStates.size(); ++i) {
+            lua_close(vecSharedStates[i]->State);
+            pthread_mutex_destroy(&vecSharedStates[i]->Mutex);
+            delete vecSharedStates[i];
+         }
+         vecSharedStates.clear();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    CLuaController::CLuaController() :
       m_ptLuaState(NULL),
       m_bScriptActive(false),
       m_bIsOK(true),
-      m_pcRNG(NULL) {
+      m_pcRNG(NULL),
+      m_psSharedState(NULL),
+      m_nEnvironmentRef(LUA_NOREF),
+      m_nLoadedRef(LUA_NOREF) {
    }
 
    /****************************************/
@@ -37,6 +110,12 @@ namespace argos {
       try {
          /* Create RNG */
          m_pcRNG = CRandom::CreateRNG("argos");
+         /* Share the Lua states among the robots, if requested */
+         UInt32 unSharedStates = 0;
+         GetNodeAttributeOrDefault(t_tree, "shared_states", unSharedStates, unSharedStates);
+         if(unSharedStates > 0) {
+            m_psSharedState = AcquireSharedState(unSharedStates);
+         }
          /* Load script */
          std::string strScriptFileName;
          GetNodeAttributeOrDefault(t_tree, "script", strScriptFileName, strScriptFileName);
@@ -48,12 +127,12 @@ namespace argos {
          }
          else {
             /* Create a new Lua stack */
-            m_ptLuaState = luaL_newstate();
-            /* Load the Lua libraries */
-            luaL_openlibs(m_ptLuaState);
+            OpenLuaState();
             /* Create and set Lua state */
+            LockLuaState();
             CreateLuaState();
             SensorReadingsToLuaState();
+            UnlockLuaState();
          }
       }
       catch(CARGoSException& ex) {
@@ -66,12 +145,14 @@ namespace argos {
 
    void CLuaController::ControlStep() {
       if(m_bScriptActive && m_bIsOK) {
+         LockLuaState();
          /* Update Lua state through sensor readings */
          SensorReadingsToLuaState();
          /* Execute script step function */
          if(! CLuaUtility::CallLuaFunction(m_ptLuaState, "step")) {
             m_bIsOK = false;
          }
+         UnlockLuaState();
       }
    }
 
@@ -81,7 +162,9 @@ namespace argos {
    void CLuaController::Reset() {
       if(m_bScriptActive) {
          if(m_bIsOK) {
+            LockLuaState();
             m_bIsOK = CLuaUtility::CallLuaFunction(m_ptLuaState, "reset");
+            UnlockLuaState();
          }
          else {
             SetLuaScript(m_strScriptFileName);
@@ -95,10 +178,16 @@ namespace argos {
    void CLuaController::Destroy() {
       if(m_bScriptActive && m_bIsOK) {
          /* Execute script destroy function */
+         LockLuaState();
          CLuaUtility::CallLuaFunction(m_ptLuaState, "destroy");
+         UnlockLuaState();
       }
       /* Close Lua */
-      lua_close(m_ptLuaState);
+      CloseLuaState();
+      if(m_psSharedState != NULL) {
+         ReleaseSharedState();
+         m_psSharedState = NULL;
+      }
    }
 
    /****************************************/
@@ -107,15 +196,14 @@ namespace argos {
    void CLuaController::SetLuaScript(const std::string& str_script,
                                      TConfigurationNode& t_tree) {
       /* First, delete old script */
-      if(m_bScriptActive) {
-         lua_close(m_ptLuaState);
+      if(m_ptLuaState != NULL) {
+         CloseLuaState();
          m_bScriptActive = false;
          m_strScriptFileName = "";
       }
       /* Create a new Lua stack */
-      m_ptLuaState = luaL_newstate();
-      /* Load the Lua libraries */
-      luaL_openlibs(m_ptLuaState);
+      OpenLuaState();
+      LockLuaState();
       /* Create and set variables */
       CreateLuaState();
       SensorReadingsToLuaState();
@@ -128,24 +216,31 @@ namespace argos {
       strPackagePath += (strScriptPath + "/?/init.lua;");
       lua_getglobal(m_ptLuaState, "package");
       lua_getfield(m_ptLuaState, -1, "path");
-      strPackagePath += lua_tostring(m_ptLuaState, -1);
+      std::string strOldPackagePath = lua_tostring(m_ptLuaState, -1);
       lua_pop(m_ptLuaState, 1);
-      lua_pushstring(m_ptLuaState, strPackagePath.c_str());
-      lua_setfield(m_ptLuaState, -2, "path");
+      /* The package table is shared by the robots of a shared state */
+      if(strOldPackagePath.find(strPackagePath) != 0) {
+         strPackagePath += strOldPackagePath;
+         lua_pushstring(m_ptLuaState, strPackagePath.c_str());
+         lua_setfield(m_ptLuaState, -2, "path");
+      }
       lua_pop(m_ptLuaState, 1);
       /* Load script */
       if(!CLuaUtility::LoadScript(m_ptLuaState, str_script)) {
          m_bIsOK = false;
+         UnlockLuaState();
          return;
       }
       m_strScriptFileName = str_script;
       /* Execute script init function */
       if(!CLuaUtility::CallLuaFunction(m_ptLuaState, "init")) {
          m_bIsOK = false;
+         UnlockLuaState();
          return;
       }
       m_bIsOK = true;
       m_bScriptActive = true;
+      UnlockLuaState();
    }
 
    /****************************************/
@@ -160,6 +255,8 @@ namespace argos {
    /****************************************/
 
    void CLuaController::CreateLuaState() {
+      /* Declare the C types of the FFI views, when FFI is available */
+      CLuaUtility::DeclareFFITypes(m_ptLuaState);
       /* Register functions */
       CLuaUtility::RegisterLoggerWrapper(m_ptLuaState);
       /* Register metatables */
@@ -233,6 +330,11 @@ namespace argos {
       if(m_bIsOK) {
          return "OK";
       }
+      else if(m_psSharedState != NULL) {
+         /* The stack of a shared state is emptied after each use */
+         if(m_strErrorMessage.empty()) return "Unknown compilation error";
+         else return m_strErrorMessage;
+      }
       else {
          SInt32 i = 1;
          while(i <= lua_gettop(m_ptLuaState) && lua_type(m_ptLuaState, i) != LUA_TSTRING) {
@@ -247,6 +349,139 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLuaController::OpenLuaState() {
+      m_strErrorMessage.clear();
+      if(m_psSharedState == NULL) {
+         /* Create a new Lua stack */
+         m_ptLuaState = luaL_newstate();
+         /* Load the Lua libraries */
+         luaL_openlibs(m_ptLuaState);
+      }
+      else {
+         /*
+          * Create the environment of the robot, which inherits the libraries
+          * from the globals of the shared state
+          */
+         m_ptLuaState = m_psSharedState->State;
+         pthread_mutex_lock(&m_psSharedState->Mutex);
+         lua_newtable(m_ptLuaState);
+         lua_newtable(m_ptLuaState);
+         lua_getfield(m_ptLuaState, LUA_REGISTRYINDEX, BASE_GLOBALS_KEY);
+         lua_setfield(m_ptLuaState, -2, "__index");
+         lua_setmetatable(m_ptLuaState, -2);
+         lua_pushvalue(m_ptLuaState, -1);
+         lua_setfield(m_ptLuaState, -2, "_G");
+         /*
+          * Create the package.loaded table of the robot, which starts with
+          * the standard libraries
+          */
+         lua_newtable(m_ptLuaState);
+         lua_getfield(m_ptLuaState, LUA_REGISTRYINDEX, BASE_LOADED_KEY);
+         lua_pushnil(m_ptLuaState);
+         while(lua_next(m_ptLuaState, -2)) {
+            lua_pushvalue(m_ptLuaState, -2);
+            lua_insert(m_ptLuaState, -2);
+            lua_settable(m_ptLuaState, -5);
+         }
+         lua_pop(m_ptLuaState, 1);
+         lua_pushvalue(m_ptLuaState, -2);
+         lua_setfield(m_ptLuaState, -2, "_G");
+         /*
+          * Create the package table of the robot, which holds the
+          * package.loaded of the robot and forwards everything else to the
+          * shared package table, where require() looks for the paths
+          */
+         lua_newtable(m_ptLuaState);
+         lua_newtable(m_ptLuaState);
+         lua_getfield(m_ptLuaState, LUA_REGISTRYINDEX, BASE_GLOBALS_KEY);
+         lua_getfield(m_ptLuaState, -1, "package");
+         lua_remove(m_ptLuaState, -2);
+         lua_pushvalue(m_ptLuaState, -1);
+         lua_setfield(m_ptLuaState, -3, "__index");
+         lua_setfield(m_ptLuaState, -2, "__newindex");
+         lua_setmetatable(m_ptLuaState, -2);
+         lua_pushvalue(m_ptLuaState, -2);
+         lua_setfield(m_ptLuaState, -2, "loaded");
+         lua_pushvalue(m_ptLuaState, -1);
+         lua_setfield(m_ptLuaState, -3, "package");
+         lua_setfield(m_ptLuaState, -3, "package");
+         m_nLoadedRef = luaL_ref(m_ptLuaState, LUA_REGISTRYINDEX);
+         m_nEnvironmentRef = luaL_ref(m_ptLuaState, LUA_REGISTRYINDEX);
+         pthread_mutex_unlock(&m_psSharedState->Mutex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaController::CloseLuaState() {
+      if(m_ptLuaState == NULL) {
+         return;
+      }
+      if(m_psSharedState == NULL) {
+         lua_close(m_ptLuaState);
+      }
+      else {
+         /*
+          * Forget the environment of the robot, and go back to the shared
+          * globals and modules
+          */
+         pthread_mutex_lock(&m_psSharedState->Mutex);
+         luaL_unref(m_ptLuaState, LUA_REGISTRYINDEX, m_nEnvironmentRef);
+         luaL_unref(m_ptLuaState, LUA_REGISTRYINDEX, m_nLoadedRef);
+         lua_getfield(m_ptLuaState, LUA_REGISTRYINDEX, BASE_GLOBALS_KEY);
+         CLuaUtility::SetGlobalTable(m_ptLuaState);
+         lua_getfield(m_ptLuaState, LUA_REGISTRYINDEX, BASE_LOADED_KEY);
+         lua_setfield(m_ptLuaState, LUA_REGISTRYINDEX, LOADED_KEY);
+         pthread_mutex_unlock(&m_psSharedState->Mutex);
+         m_nEnvironmentRef = LUA_NOREF;
+         m_nLoadedRef = LUA_NOREF;
+      }
+      m_ptLuaState = NULL;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaController::LockLuaState() {
+      if(m_psSharedState != NULL) {
+         pthread_mutex_lock(&m_psSharedState->Mutex);
+         SelectLuaEnvironment();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaController::UnlockLuaState() {
+      if(m_psSharedState != NULL) {
+         /* Keep the error message, the stack is used by the other robots */
+         if(!m_bIsOK && lua_type(m_ptLuaState, -1) == LUA_TSTRING) {
+            m_strErrorMessage = lua_tostring(m_ptLuaState, -1);
+         }
+         lua_settop(m_ptLuaState, 0);
+         pthread_mutex_unlock(&m_psSharedState->Mutex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaController::SelectLuaEnvironment() {
+      /*
+       * The environment becomes the global table, so the scripts loaded now
+       * and the devices looking up the robot table both see the environment
+       */
+      lua_rawgeti(m_ptLuaState, LUA_REGISTRYINDEX, m_nEnvironmentRef);
+      CLuaUtility::SetGlobalTable(m_ptLuaState);
+      /* require() finds and stores the modules in the package.loaded of the robot */
+      lua_rawgeti(m_ptLuaState, LUA_REGISTRYINDEX, m_nLoadedRef);
+      lua_setfield(m_ptLuaState, LUA_REGISTRYINDEX, LOADED_KEY);
+   }
+
+   /****************************************/
+   /****************************************/
+
    REGISTER_CONTROLLER(CLuaController, "lua_controller");
 
 }
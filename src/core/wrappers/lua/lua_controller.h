@@ -11,8 +11,28 @@ extern "C" {
 #include <lua.h>
 }
 
+namespace argos {
+   struct SLuaSharedState;
+}
+
 namespace argos {
 
+   /**
+    * A controller that runs a Lua script.
+    * <p>
+    * By default, each robot has its own Lua state. When the attribute
+    * <tt>shared_states</tt> of the <tt>params</tt> section is set, the robots
+    * are instead distributed over the given number of Lua states, and each
+    * robot gets an environment of its own in its state. The environment
+    * contains the globals of the robot, and it inherits the standard
+    * libraries from the state. This saves memory with many robots. The
+    * robots sharing a state take turns to run, so with the multi-threaded
+    * space the number of states should not be smaller than the number of
+    * threads. Each robot has its own <tt>package.loaded</tt>, so the modules
+    * loaded with <tt>require</tt> are loaded once per robot and see the
+    * globals of the robot.
+    * </p>
+    */
    class CLuaController : public CCI_Controller {
 
    public:
@@ -29,10 +49,36 @@ namespace argos {
 
       virtual void Destroy();
 
+      /**
+       * Returns the Lua state of the robot.
+       * When the state is shared, it is used by the other robots too: call
+       * LockLuaState() before using the returned state, and UnlockLuaState()
+       * when done.
+       * @see LockLuaState()
+       * @see UnlockLuaState()
+       */
       inline lua_State* GetLuaState() {
          return m_ptLuaState;
       }
 
+      /**
+       * Gives this robot exclusive access to its Lua state.
+       * When the state is shared, this method waits until no other robot
+       * uses the state, and then selects the environment of this robot.
+       * Otherwise, it does nothing.
+       * Each call must be matched by a call to UnlockLuaState().
+       * @see UnlockLuaState()
+       */
+      void LockLuaState();
+
+      /**
+       * Releases the Lua state of the robot.
+       * When the state is shared, the stack of the state is emptied and the
+       * other robots can use the state again.
+       * @see LockLuaState()
+       */
+      void UnlockLuaState();
+
       virtual void SetLuaScript(const std::string& str_script,
                                 TConfigurationNode& t_tree);
 
@@ -50,6 +96,14 @@ namespace argos {
 
       std::string GetErrorMessage();
 
+   private:
+
+      void OpenLuaState();
+
+      void CloseLuaState();
+
+      void SelectLuaEnvironment();
+
    private:
 
       lua_State* m_ptLuaState;
@@ -57,6 +111,10 @@ namespace argos {
       bool m_bScriptActive;
       bool m_bIsOK;
       CRandom::CRNG* m_pcRNG;
+      SLuaSharedState* m_psSharedState;
+      int m_nEnvironmentRef;
+      int m_nLoadedRef;
+      std::string m_strErrorMessage;
 
    };
 
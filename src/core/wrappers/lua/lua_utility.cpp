@@ -18,6 +18,12 @@
 #include <argos3/core/wrappers/lua/lua_vector3.h>
 #include <argos3/core/wrappers/lua/lua_quaternion.h>
 
+#include <limits>
+#include <map>
+#include <tuple>
+#include <pthread.h>
+#include <sys/stat.h>
+
 namespace argos {
 
    /****************************************/
@@ -179,12 +185,79 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /*
+    * The bytecode of the compiled scripts, indexed by file name, time of
+    * last modification and size, so that a script changed on disk is
+    * compiled again, even when it is changed twice within a second.
+    */
+   typedef std::map<std::tuple<std::string, time_t, off_t>, std::string> TCompiledScripts;
+   static TCompiledScripts mapCompiledScripts;
+   static pthread_mutex_t tCompiledScriptsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+   static int LuaDumpWriter(lua_State*,
+                            const void* pt_data,
+                            size_t un_size,
+                            void* pt_buffer) {
+      reinterpret_cast<std::string*>(pt_buffer)->append(
+         reinterpret_cast<const char*>(pt_data), un_size);
+      return 0;
+   }
+
    bool CLuaUtility::LoadScript(lua_State* pt_state,
                                 const std::string& str_filename) {
-      if(luaL_loadfile(pt_state, str_filename.c_str())) {
-         LOGERR << "[FATAL] Error loading \"" << str_filename
-                << "\"" << std::endl;
-         return false;
+      /* The cache is not used for the files that can't be stat'ed,
+         luaL_loadfile() reports the error */
+      struct stat sInfo;
+      bool bCacheable = (::stat(str_filename.c_str(), &sInfo) == 0);
+      TCompiledScripts::key_type tKey(str_filename,
+                                      bCacheable ? sInfo.st_mtime : 0,
+                                      bCacheable ? sInfo.st_size : 0);
+      bool bLoaded = false;
+      if(bCacheable) {
+         pthread_mutex_lock(&tCompiledScriptsMutex);
+         TCompiledScripts::iterator it = mapCompiledScripts.find(tKey);
+         if(it != mapCompiledScripts.end()) {
+            /* Cache hit: load the bytecode, no compilation needed */
+            bLoaded = (luaL_loadbufferx(pt_state,
+                                        it->second.data(),
+                                        it->second.size(),
+                                        ("@" + str_filename).c_str(),
+                                        "b") == LUA_OK);
+            if(!bLoaded) {
+               /* Drop the error message and compile the script again */
+               lua_pop(pt_state, 1);
+               mapCompiledScripts.erase(it);
+            }
+         }
+         pthread_mutex_unlock(&tCompiledScriptsMutex);
+      }
+      if(!bLoaded) {
+         if(luaL_loadfile(pt_state, str_filename.c_str())) {
+            LOGERR << "[FATAL] Error loading \"" << str_filename
+                   << "\"" << std::endl;
+            return false;
+         }
+         if(bCacheable) {
+            /* Store the bytecode, keeping the debug information for the error messages */
+            std::string strByteCode;
+#ifdef ARGOS_WITH_LUAJIT
+            lua_dump(pt_state, LuaDumpWriter, &strByteCode);
+#else
+            lua_dump(pt_state, LuaDumpWriter, &strByteCode, 0);
+#endif
+            pthread_mutex_lock(&tCompiledScriptsMutex);
+            /* Forget the older versions of the script */
+            TCompiledScripts::iterator it =
+               mapCompiledScripts.lower_bound(
+                  TCompiledScripts::key_type(str_filename,
+                                             std::numeric_limits<time_t>::min(),
+                                             std::numeric_limits<off_t>::min()));
+            while(it != mapCompiledScripts.end() && std::get<0>(it->first) == str_filename) {
+               it = mapCompiledScripts.erase(it);
+            }
+            mapCompiledScripts[tKey].swap(strByteCode);
+            pthread_mutex_unlock(&tCompiledScriptsMutex);
+         }
       }
       if(lua_pcall(pt_state, 0, 0, 0)) {
          LOGERR << "[FATAL] Error executing \"" << str_filename
@@ -199,6 +272,26 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLuaUtility::ClearScriptCache() {
+      pthread_mutex_lock(&tCompiledScriptsMutex);
+      mapCompiledScripts.clear();
+      pthread_mutex_unlock(&tCompiledScriptsMutex);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaUtility::SetGlobalTable(lua_State* pt_state) {
+#ifdef ARGOS_WITH_LUAJIT
+      lua_replace(pt_state, LUA_GLOBALSINDEX);
+#else
+      lua_rawseti(pt_state, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+#endif
+   }
+
+   /****************************************/
+   /****************************************/
+
    bool CLuaUtility::CallLuaFunction(lua_State* pt_state,
                                      const std::string& str_function) {
       lua_getglobal(pt_state, str_function.c_str());
@@ -562,6 +655,127 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   bool CLuaUtility::AddFFIArrayToTable(lua_State* pt_state,
+                                        const std::string& str_key,
+                                        const std::string& str_ctype,
+                                        void* pt_data) {
+#ifdef ARGOS_WITH_LUAJIT
+      /* Get the FFI library */
+      lua_getglobal(pt_state, "require");
+      lua_pushstring(pt_state, "ffi");
+      if(lua_pcall(pt_state, 1, 1, 0)) {
+         lua_pop(pt_state, 1);
+         return false;
+      }
+      /* Make the view with ffi.cast(ctype, data) */
+      lua_getfield(pt_state, -1, "cast");
+      lua_pushstring(pt_state, str_ctype.c_str());
+      lua_pushlightuserdata(pt_state, pt_data);
+      if(lua_pcall(pt_state, 2, 1, 0)) {
+         LOGERR << "[WARNING] Can't make the FFI view \""
+                << str_key
+                << "\": "
+                << lua_tostring(pt_state, -1)
+                << std::endl;
+         lua_pop(pt_state, 2);
+         return false;
+      }
+      /* Stack: robot, ffi library, view */
+      lua_getfield(pt_state, -3, "ffi");
+      if(lua_isnil(pt_state, -1)) {
+         lua_pop(pt_state, 1);
+         lua_newtable(pt_state);
+         lua_pushvalue(pt_state, -1);
+         lua_setfield(pt_state, -5, "ffi");
+      }
+      /* Stack: robot, ffi library, view, robot.ffi */
+      lua_insert(pt_state, -2);
+      lua_setfield(pt_state, -2, str_key.c_str());
+      lua_pop(pt_state, 2);
+      return true;
+#else
+      return false;
+#endif
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CLuaUtility::LinkTableToFFIArray(lua_State* pt_state,
+                                         const std::string& str_key,
+                                         const std::string& str_field) {
+#ifdef ARGOS_WITH_LUAJIT
+      static const char* LINK_TO_FFI_ARRAY =
+         "local robot, key, field = ...\n"
+         "local view = robot.ffi and robot.ffi[key]\n"
+         "if not view then return false end\n"
+         "for i, reading in ipairs(robot[key]) do\n"
+         "   local element = view + (i - 1)\n"
+         "   reading[field] = nil\n"
+         "   setmetatable(reading, {\n"
+         "      __index = function(_, k)\n"
+         "         if k == field then return element[field] end\n"
+         "      end\n"
+         "   })\n"
+         "end\n"
+         "return true\n";
+      if(luaL_loadstring(pt_state, LINK_TO_FFI_ARRAY)) {
+         lua_pop(pt_state, 1);
+         return false;
+      }
+      lua_pushvalue(pt_state, -2);
+      lua_pushstring(pt_state, str_key.c_str());
+      lua_pushstring(pt_state, str_field.c_str());
+      if(lua_pcall(pt_state, 3, 1, 0)) {
+         LOGERR << "[WARNING] Can't link \""
+                << str_key
+                << "\" to its FFI view: "
+                << lua_tostring(pt_state, -1)
+                << std::endl;
+         lua_pop(pt_state, 1);
+         return false;
+      }
+      bool bLinked = lua_toboolean(pt_state, -1);
+      lua_pop(pt_state, 1);
+      return bLinked;
+#else
+      return false;
+#endif
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaUtility::DeclareFFITypes(lua_State* pt_state) {
+#ifdef ARGOS_WITH_LUAJIT
+      /* The types are per state; with shared states, they are declared once */
+      static const char* FFI_TYPES =
+         "local ffi = require(\"ffi\")\n"
+         "if not pcall(ffi.typeof, \"argos_angular_reading_t\") then\n"
+         "   ffi.cdef[[\n"
+#ifdef ARGOS_USE_DOUBLE
+         "      typedef double argos_real_t;\n"
+#else
+         "      typedef float argos_real_t;\n"
+#endif
+         "      typedef struct {\n"
+         "         argos_real_t value;\n"
+         "         argos_real_t angle;\n"
+         "      } argos_angular_reading_t;\n"
+         "   ]]\n"
+         "end\n";
+      if(luaL_dostring(pt_state, FFI_TYPES)) {
+         LOGERR << "[WARNING] Can't declare the FFI types: "
+                << lua_tostring(pt_state, -1)
+                << std::endl;
+         lua_pop(pt_state, 1);
+      }
+#endif
+   }
+
+   /****************************************/
+   /****************************************/
+
    int CLuaUtility::LOGWrapper(lua_State* pt_state) {
       return LoggerWrapper(LOG, pt_state);
    }
@@ -16,6 +16,7 @@ namespace argos {
    class CByteArray;
 }
 
+#include <argos3/core/config.h>
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/math/rng.h>
 
@@ -23,8 +24,23 @@ extern "C" {
 #include <lua.h>
 #include <lualib.h>
 #include <lauxlib.h>
+#ifdef ARGOS_WITH_LUAJIT
+#  include <luajit.h>
+#endif
 }
 
+#ifdef ARGOS_WITH_LUAJIT
+/*
+ * LuaJIT implements the Lua 5.1 API. These definitions map the few
+ * Lua 5.3 functions used by ARGoS onto their Lua 5.1 counterparts.
+ */
+#  ifndef LUA_OK
+#    define LUA_OK 0
+#  endif
+#  define lua_rawlen(L, i)         lua_objlen(L, (i))
+#  define lua_pushglobaltable(L)   lua_pushvalue(L, LUA_GLOBALSINDEX)
+#endif
+
 #include <string>
 
 namespace argos {
@@ -35,13 +51,34 @@ namespace argos {
 
       /**
        * Loads the given Lua script.
+       * The script is compiled only the first time it is loaded, and its
+       * bytecode is kept in a cache shared by all the Lua states. The
+       * following loads of the same script read the bytecode from the cache,
+       * as long as the modification time and the size of the file have not changed.
        * @param pt_state The Lua state.
        * @param str_filename The script file name.
        * @return <tt>false</tt> in case of errors, <tt>true</tt> otherwise.
+       * @see ClearScriptCache()
        */
       static bool LoadScript(lua_State* pt_state,
                              const std::string& str_filename);
+
+      /**
+       * Empties the cache of compiled scripts.
+       * @see LoadScript()
+       */
+      static void ClearScriptCache();
       
+      /**
+       * Replaces the global table of the given Lua state.
+       * The new global table is taken from the top of the stack and popped.
+       * The scripts and the functions loaded afterwards see the new table as
+       * their globals, and so do the devices that look up the
+       * <tt>robot</tt> table.
+       * @param pt_state The Lua state.
+       */
+      static void SetGlobalTable(lua_State* pt_state);
+
       /**
        * Calls a parameter-less function in the Lua script.
        * @param pt_state The Lua state.
@@ -367,6 +404,69 @@ namespace argos {
                              int n_key,
                              const CColor& c_data);
 
+      /**
+       * Adds a view on a C array to the robot state table.
+       * The robot state table must be at the top of the stack. The view is
+       * stored in its <tt>ffi</tt> table, which is created if needed, so that
+       * <tt>robot.ffi.proximity</tt> is the view of the proximity readings.
+       * With LuaJIT, the view is an FFI cdata pointer of type
+       * <tt>str_ctype</tt> to <tt>pt_data</tt>, which the scripts index from
+       * 0 and which always shows the current content of the array, without
+       * any copy. The C type must have been declared with <tt>ffi.cdef</tt>,
+       * for instance with DeclareFFITypes(). The array must not be moved
+       * while the Lua state exists.
+       * With Lua 5.3, FFI is not available and nothing is added.
+       * At the end of the execution, the stack is in the same state as it was
+       * before this function was called.
+       * @param pt_state The Lua state.
+       * @param str_key The string key for the view in the <tt>ffi</tt> table.
+       * @param str_ctype The C type of the view, e.g., <tt>"argos_reading_t*"</tt>.
+       * @param pt_data The array.
+       * @return <tt>true</tt> if the view was added, <tt>false</tt> otherwise.
+       * @see DeclareFFITypes()
+       */
+      static bool AddFFIArrayToTable(lua_State* pt_state,
+                                     const std::string& str_key,
+                                     const std::string& str_ctype,
+                                     void* pt_data);
+
+      /**
+       * Makes a table of readings read a field from an FFI view.
+       * The robot state table must be at the top of the stack, and it must
+       * contain both the table <tt>robot[str_key]</tt>, whose elements are
+       * the readings indexed from 1, and the view
+       * <tt>robot.ffi[str_key]</tt> made with AddFFIArrayToTable().
+       * The field <tt>str_field</tt> is removed from each reading, and reading
+       * it returns the current value of the field in the view. The readings
+       * then need no update at each step.
+       * At the end of the execution, the stack is in the same state as it was
+       * before this function was called.
+       * @param pt_state The Lua state.
+       * @param str_key The string key of the readings and of the view.
+       * @param str_field The field to read from the view.
+       * @return <tt>true</tt> if the readings are linked to the view, <tt>false</tt> otherwise.
+       * @see AddFFIArrayToTable()
+       */
+      static bool LinkTableToFFIArray(lua_State* pt_state,
+                                      const std::string& str_key,
+                                      const std::string& str_field);
+
+      /**
+       * Declares the C types of the FFI views of the devices.
+       * The declared types are:
+       * <ul>
+       * <li><tt>argos_real_t</tt>: the ARGoS Real type;</li>
+       * <li><tt>argos_angular_reading_t</tt>: a struct with a
+       *     <tt>value</tt> and an <tt>angle</tt> field, both
+       *     <tt>argos_real_t</tt>, with the layout of the readings of the
+       *     sensors that return a value and the angle it comes from.</li>
+       * </ul>
+       * With Lua 5.3, this function does nothing.
+       * @param pt_state The Lua state.
+       * @see AddFFIArrayToTable()
+       */
+      static void DeclareFFITypes(lua_State* pt_state);
+
       /**
        * Returns a pointer to the instance to the wanted device.
        * The Lua state is stored in a table called <tt>robot</tt>. Each
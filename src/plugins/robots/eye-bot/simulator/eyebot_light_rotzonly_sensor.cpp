@@ -10,6 +10,8 @@
 #include <argos3/plugins/simulator/entities/light_entity.h>
 #include <argos3/plugins/simulator/entities/light_sensor_equipped_entity.h>
 
+#include <argos3/plugins/simulator/media/light_visibility_medium.h>
+
 #include "eyebot_light_rotzonly_sensor.h"
 
 namespace argos {
@@ -56,6 +58,7 @@ namespace argos {
       m_bShowRays(false),
       m_pcRNG(nullptr),
       m_bAddNoise(false),
+      m_pcLightVisibilityMedium(nullptr),
       m_cSpace(CSimulator::GetInstance().GetSpace()) {}
 
    /****************************************/
@@ -95,6 +98,12 @@ namespace argos {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
          m_tReadings.resize(m_pcLightEntity->GetNumSensors());
+         /* Get the light visibility medium, if any */
+         std::string strMedium;
+         GetNodeAttributeOrDefault(t_tree, "medium", strMedium, strMedium);
+         if(!strMedium.empty()) {
+            m_pcLightVisibilityMedium = &(CSimulator::GetInstance().GetMedium<CLightVisibilityMedium>(strMedium));
+         }
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Initialization error in rot_z_only light sensor", ex);
@@ -124,8 +133,23 @@ namespace argos {
       CRadians cAngleLightWrtEyebot;
       /* Buffers to contain data about the intersection */
       SEmbodiedEntityIntersectionItem sIntersection;
-      /* List of light entities */
-      CSpace::TMapPerType& mapLights = m_cSpace.GetEntitiesByType("light");
+      /* List of light entities, from the medium if any */
+      if(m_pcLightVisibilityMedium == nullptr) {
+         m_vecLights.clear();
+         auto itLights = m_cSpace.GetEntityMapPerTypePerId().find("light");
+         if(itLights != m_cSpace.GetEntityMapPerTypePerId().end()) {
+            for(auto it = itLights->second.begin();
+                it != itLights->second.end();
+                ++it) {
+               m_vecLights.push_back(any_cast<CLightEntity*>(it->second));
+            }
+         }
+      }
+      const std::vector<CLightEntity*>& vecLights =
+         (m_pcLightVisibilityMedium != nullptr) ? m_pcLightVisibilityMedium->GetLights() : m_vecLights;
+      /* The shadow map does not give the intersection points to draw */
+      bool bUseShadowMap =
+         (m_pcLightVisibilityMedium != nullptr) && m_pcLightVisibilityMedium->HasShadowMap() && !m_bShowRays;
       /*
        * 1. go through the list of light entities in the scene
        * 2. check if a light is occluded
@@ -133,19 +157,18 @@ namespace argos {
        *    NOTE: the readings are additive
        * 4. go through the sensors and clamp their values
        */
-      for(auto it = mapLights.begin();
-          it != mapLights.end();
-          ++it) {
+      for(size_t j = 0; j < vecLights.size(); ++j) {
          /* Get a reference to the light */
-         CLightEntity& cLight = *(any_cast<CLightEntity*>(it->second));
+         CLightEntity& cLight = *vecLights[j];
          /* Consider the light only if it has non zero intensity */
          if(cLight.GetIntensity() > 0.0f) {
             /* Set the ray end */
             cOcclusionCheckRay.SetEnd(cLight.GetPosition());
             /* Check occlusion between the eye-bot and the light */
-            if(! GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
-                                                          cOcclusionCheckRay,
-                                                          *m_pcEmbodiedEntity)) {
+            bool bOccluded = bUseShadowMap ?
+               m_pcLightVisibilityMedium->IsOccluded(j, cOcclusionCheckRay, sIntersection, *m_pcEmbodiedEntity) :
+               GetClosestEmbodiedEntityIntersectedByRay(sIntersection, cOcclusionCheckRay, *m_pcEmbodiedEntity);
+            if(! bOccluded) {
                /* The light is not occluded */
                if(m_bShowRays) {
                   m_pcControllableEntity->AddCheckedRay(false, cOcclusionCheckRay);
@@ -290,6 +313,25 @@ namespace argos {
                    "    </my_controller>\n"
                    "    ...\n"
                    "  </controllers>\n\n"
+                   "The sensors can share the list of the lights through a light visibility medium,\n"
+                   "referred to by the attribute \"medium\". When the lights and the obstacles\n"
+                   "never move, the medium can also keep a shadow map that avoids most of the\n"
+                   "occlusion checks; see the documentation of the \"light_visibility\" medium.\n"
+                   "The shadow map is not used when the rays are drawn.\n\n"
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <eyebot_light implementation=\"rot_z_only\"\n"
+                   "                      medium=\"lights\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
+                   "  </controllers>\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
                    "None.\n",
                    "Usable"
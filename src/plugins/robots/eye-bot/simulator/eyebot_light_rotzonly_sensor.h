@@ -13,6 +13,8 @@
 namespace argos {
    class CEyeBotLightRotZOnlySensor;
    class CLightSensorEquippedEntity;
+   class CLightVisibilityMedium;
+   class CLightEntity;
 }
 
 #include <argos3/plugins/robots/eye-bot/control_interface/ci_eyebot_light_sensor.h>
@@ -79,6 +81,12 @@ namespace argos {
       /** Noise range */
       CRange<Real> m_cNoiseRange;
 
+      /** The light visibility medium, or nullptr */
+      CLightVisibilityMedium* m_pcLightVisibilityMedium;
+
+      /** The lights, when there is no light visibility medium */
+      std::vector<CLightEntity*> m_vecLights;
+
       /** Reference to the space */
       CSpace& m_cSpace;
    };
@@ -22,7 +22,8 @@ namespace argos {
    /****************************************/
 
    CCI_FootBotLightSensor::CCI_FootBotLightSensor() :
-      m_tReadings(24) {
+      m_tReadings(24),
+      m_bLuaFFIView(false) {
       for(size_t i = 0; i < 24; ++i) {
          m_tReadings[i].Angle = START_ANGLE + i * SPACING;
          m_tReadings[i].Angle.SignedNormalize();
@@ -41,6 +42,12 @@ namespace argos {
 
 #ifdef ARGOS_WITH_LUA
    void CCI_FootBotLightSensor::CreateLuaState(lua_State* pt_lua_state) {
+      /* With LuaJIT, robot.ffi.light is a view on the readings, indexed from 0 */
+      static_assert(sizeof(SReading) == 2 * sizeof(Real),
+                    "The readings must match argos_angular_reading_t");
+      CLuaUtility::AddFFIArrayToTable(pt_lua_state, "light",
+                                      "argos_angular_reading_t*",
+                                      m_tReadings.data());
       CLuaUtility::OpenRobotStateTable(pt_lua_state, "light");
       for(size_t i = 0; i < GetReadings().size(); ++i) {
          CLuaUtility::StartTable(pt_lua_state, i+1                           );
@@ -49,6 +56,8 @@ namespace argos {
          CLuaUtility::EndTable  (pt_lua_state                                );
       }
       CLuaUtility::CloseRobotStateTable(pt_lua_state);
+      /* With the view, the readings read their value from it when the script asks for it */
+      m_bLuaFFIView = CLuaUtility::LinkTableToFFIArray(pt_lua_state, "light", "value");
    }
 #endif
 
@@ -57,6 +66,8 @@ namespace argos {
 
 #ifdef ARGOS_WITH_LUA
    void CCI_FootBotLightSensor::ReadingsToLuaState(lua_State* pt_lua_state) {
+      /* The readings linked to the FFI view are always up to date */
+      if(m_bLuaFFIView) return;
       lua_getfield(pt_lua_state, -1, "light");
       for(size_t i = 0; i < GetReadings().size(); ++i) {
          lua_pushnumber(pt_lua_state, i+1                 );
@@ -84,6 +84,9 @@ namespace argos {
    protected:
 
       TReadings m_tReadings;
+
+      /** <tt>true</tt> when the Lua readings are read from the FFI view */
+      bool m_bLuaFFIView;
    };
 
    std::ostream& operator<<(std::ostream& c_os, const CCI_FootBotLightSensor::SReading& s_reading);
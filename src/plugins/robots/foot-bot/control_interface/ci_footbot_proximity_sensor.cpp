@@ -23,7 +23,8 @@ namespace argos {
    /****************************************/
 
    CCI_FootBotProximitySensor::CCI_FootBotProximitySensor() :
-      m_tReadings(24) {
+      m_tReadings(24),
+      m_bLuaFFIView(false) {
       for(size_t i = 0; i < 24; ++i) {
          m_tReadings[i].Angle = START_ANGLE + i * SPACING;
          m_tReadings[i].Angle.SignedNormalize();
@@ -42,6 +43,12 @@ namespace argos {
 
 #ifdef ARGOS_WITH_LUA
    void CCI_FootBotProximitySensor::CreateLuaState(lua_State* pt_lua_state) {
+      /* With LuaJIT, robot.ffi.proximity is a view on the readings, indexed from 0 */
+      static_assert(sizeof(SReading) == 2 * sizeof(Real),
+                    "The readings must match argos_angular_reading_t");
+      CLuaUtility::AddFFIArrayToTable(pt_lua_state, "proximity",
+                                      "argos_angular_reading_t*",
+                                      m_tReadings.data());
       CLuaUtility::OpenRobotStateTable(pt_lua_state, "proximity");
       for(size_t i = 0; i < GetReadings().size(); ++i) {
          CLuaUtility::StartTable(pt_lua_state, i+1                           );
@@ -50,6 +57,8 @@ namespace argos {
          CLuaUtility::EndTable  (pt_lua_state                                );
       }
       CLuaUtility::CloseRobotStateTable(pt_lua_state);
+      /* With the view, the readings read their value from it when the script asks for it */
+      m_bLuaFFIView = CLuaUtility::LinkTableToFFIArray(pt_lua_state, "proximity", "value");
    }
 #endif
 
@@ -58,6 +67,8 @@ namespace argos {
 
 #ifdef ARGOS_WITH_LUA
    void CCI_FootBotProximitySensor::ReadingsToLuaState(lua_State* pt_lua_state) {
+      /* The readings linked to the FFI view are always up to date */
+      if(m_bLuaFFIView) return;
       lua_getfield(pt_lua_state, -1, "proximity");
       for(size_t i = 0; i < GetReadings().size(); ++i) {
          lua_pushnumber(pt_lua_state, i+1                 );
@@ -88,6 +88,9 @@ namespace argos {
 
       TReadings m_tReadings;
 
+      /** <tt>true</tt> when the Lua readings are read from the FFI view */
+      bool m_bLuaFFIView;
+
    };
 
    std::ostream& operator<<(std::ostream& c_os, const CCI_FootBotProximitySensor::SReading& s_reading);
@@ -222,6 +222,11 @@ namespace argos {
          /* No, we don't want to move - zero all speeds */
          m_cDiffSteering.Reset();
       }
+      /* Wake the robot up if the gripper was locked or unlocked,
+         because gripping is managed through collisions */
+      if(m_pcGripper->IsGripping() != m_pcGripper->IsLocked()) {
+         cpBodyActivate(m_ptActualGripperBody);
+      }
       /* Update turret structures if the state changed state in the last step */
       if(m_cFootBotEntity.GetTurretEntity().GetMode() != m_unLastTurretMode) {
          /* Enable or disable the anchor */
@@ -0,0 +1,39 @@
+/**
+ * @file <argos3/plugins/robots/generic/control_interface/ci_camera_sensor_algorithms/ci_camera_sensor_image_algorithm.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "ci_camera_sensor_image_algorithm.h"
+
+#ifdef ARGOS_WITH_LUA
+#include <argos3/core/wrappers/lua/lua_utility.h>
+#endif
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+#ifdef ARGOS_WITH_LUA
+   void CCI_CameraSensorImageAlgorithm::CreateLuaState(lua_State* pt_lua_state) {
+      /* Only the size of the image is exported, the pixels are meant for C++ controllers */
+      CLuaUtility::AddToTable(pt_lua_state, "width", static_cast<Real>(m_unWidth));
+      CLuaUtility::AddToTable(pt_lua_state, "height", static_cast<Real>(m_unHeight));
+   }
+#endif
+
+   /****************************************/
+   /****************************************/
+
+#ifdef ARGOS_WITH_LUA
+   void CCI_CameraSensorImageAlgorithm::ReadingsToLuaState(lua_State* pt_lua_state) {
+      CLuaUtility::AddToTable(pt_lua_state, "width", static_cast<Real>(m_unWidth));
+      CLuaUtility::AddToTable(pt_lua_state, "height", static_cast<Real>(m_unHeight));
+   }
+#endif
+
+   /****************************************/
+   /****************************************/
+
+}
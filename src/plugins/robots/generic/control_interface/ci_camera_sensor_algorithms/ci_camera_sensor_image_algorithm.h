@@ -0,0 +1,103 @@
+/**
+ * @file <argos3/plugins/robots/generic/control_interface/ci_camera_sensor_algorithms/ci_camera_sensor_image_algorithm.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef CI_CAMERAS_SENSOR_IMAGE_ALGORITHM_H
+#define CI_CAMERAS_SENSOR_IMAGE_ALGORITHM_H
+
+namespace argos {
+	class CCI_CameraSensorImageAlgorithm;
+}
+
+#include <argos3/plugins/robots/generic/control_interface/ci_camera_sensor_algorithm.h>
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <vector>
+
+#ifdef ARGOS_WITH_LUA
+extern "C" {
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+#endif
+
+namespace argos {
+
+   /**
+    * An algorithm that returns the image acquired by the camera.
+    * The image is stored row by row, starting from the top-left pixel. The
+    * color buffer contains three bytes (red, green, blue) per pixel, and the
+    * depth buffer contains the distance along the optical axis of the camera,
+    * which is zero where nothing was seen. The buffers are owned by the
+    * algorithm and overwritten at each step.
+    */
+   class CCI_CameraSensorImageAlgorithm : virtual public CCI_CameraSensorAlgorithm {
+
+   public:
+
+      /**
+       * Constructor
+       */
+      CCI_CameraSensorImageAlgorithm() :
+         m_unWidth(0),
+         m_unHeight(0) {}
+
+      /**
+       * Destructor
+       */
+      virtual ~CCI_CameraSensorImageAlgorithm() {}
+
+      /**
+       * Returns the width of the image in pixels.
+       */
+      inline UInt32 GetWidth() const {
+         return m_unWidth;
+      }
+
+      /**
+       * Returns the height of the image in pixels.
+       */
+      inline UInt32 GetHeight() const {
+         return m_unHeight;
+      }
+
+      /**
+       * Returns the color buffer, with three bytes (RGB) per pixel.
+       */
+      inline const std::vector<UInt8>& GetColorBuffer() const {
+         return m_vecColorBuffer;
+      }
+
+      /**
+       * Returns the depth buffer, with one value per pixel.
+       */
+      inline const std::vector<Real>& GetDepthBuffer() const {
+         return m_vecDepthBuffer;
+      }
+
+#ifdef ARGOS_WITH_LUA
+      virtual void CreateLuaState(lua_State* pt_lua_state);
+
+      virtual void ReadingsToLuaState(lua_State* pt_lua_state);
+
+      virtual const std::string& GetId() {
+         static std::string strId("image");
+         return strId;
+      }
+#endif
+
+   protected:
+
+      UInt32 m_unWidth;
+      UInt32 m_unHeight;
+      std::vector<UInt8> m_vecColorBuffer;
+      std::vector<Real> m_vecDepthBuffer;
+
+   };
+
+}
+
+#endif
@@ -104,6 +104,8 @@ namespace argos {
                }
                /* initialize the algorithm's control interface */
                pcCIAlgorithm->Init(*itAlgorithm);
+               pcAlgorithm->SetResolution(cResolution);
+               pcAlgorithm->SetRootEntity(m_pcEmbodiedEntity->GetRootEntity());
                /* store pointers to the algorithms */
                vecSimulatedAlgorithms.push_back(pcAlgorithm);
                vecAlgorithms.push_back(pcCIAlgorithm);
@@ -325,10 +327,11 @@ namespace argos {
                    "  </controllers>\n\n"
 
                    "To run an algorithm on the camera sensor, simply add the algorithm as a node\n"
-                   "under the camera node. At the time of writing, three algorithms are available\n"
-                   "by default: led_detector, directional_led_detector, and tag_detector. Each of\n"
-                   "algorithms requires a medium attribute that specifies the medium where the\n"
-                   "target entities are indexed. By setting the show_rays attribute to true, you\n"
+                   "under the camera node. At the time of writing, four algorithms are available\n"
+                   "by default: led_detector, directional_led_detector, tag_detector, and image.\n"
+                   "The detectors require a medium attribute that specifies the medium where the\n"
+                   "target entities are indexed. The image algorithm renders the color and depth\n"
+                   "image seen by the camera without requiring an OpenGL context. By setting the show_rays attribute to true, you\n"
                    "can see whether or not a target was partially occluded by another object in\n"
                    "the simulation. For example:\n\n"
 
@@ -12,6 +12,7 @@ namespace argos {
 }
 
 #include <argos3/core/utility/plugins/factory.h>
+#include <argos3/core/utility/math/vector2.h>
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/core/utility/math/plane.h>
 #include <argos3/core/utility/math/matrix/transformationmatrix3.h>
@@ -83,6 +84,20 @@ namespace argos {
 
       virtual ~CCameraSensorSimulatedAlgorithm() {}
 
+      /**
+       * Informs the algorithm of the resolution of the camera.
+       * Called by the camera sensor after the algorithm is initialized.
+       * @param c_resolution The resolution of the camera in pixels
+       */
+      virtual void SetResolution(const CVector2& c_resolution) {}
+
+      /**
+       * Informs the algorithm of the root entity of the robot that carries the camera.
+       * Called by the camera sensor after the algorithm is initialized.
+       * @param c_root_entity The root entity of the robot
+       */
+      virtual void SetRootEntity(const CEntity& c_root_entity) {}
+
       virtual void Update(const CSquareMatrix<3>& c_projection_matrix,
                           const std::array<CPlane, 6>& arr_frustum_planes,
                           const CTransformationMatrix3& c_world_to_camera_transform,
@@ -0,0 +1,601 @@
+/**
+ * @file <argos3/plugins/robots/generic/simulator/camera_sensor_algorithms/camera_sensor_image_algorithm.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "camera_sensor_image_algorithm.h"
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/entity/floor_entity.h>
+#include <argos3/core/utility/math/matrix/squarematrix.h>
+
+#include <argos3/plugins/simulator/entities/box_entity.h>
+#include <argos3/plugins/simulator/entities/cylinder_entity.h>
+#include <argos3/plugins/simulator/media/led_medium.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /* Direction of the light used to shade the faces of the bodies */
+   static const CVector3 LIGHT_DIRECTION = CVector3(0.3, 0.4, 0.866).Normalize();
+
+   /* Colors of the boxes and of the cylinders, as in the Qt-OpenGL visualization */
+   static const CColor MOVABLE_BOX_COLOR      = CColor::RED;
+   static const CColor MOVABLE_CYLINDER_COLOR = CColor::GREEN;
+   static const CColor NONMOVABLE_COLOR       = CColor(179, 179, 179);
+
+   /* Number of sides of the prism that approximates a cylinder */
+   static const UInt32 CYLINDER_SIDES = 16;
+
+   /* Returns the color of a face with the given normal, with flat shading */
+   static inline CColor Shade(const CColor& c_color,
+                              const CVector3& c_normal) {
+      Real fShade = 0.55 + 0.45 * Max<Real>(0.0, c_normal.DotProduct(LIGHT_DIRECTION));
+      return CColor(static_cast<UInt8>(c_color.GetRed() * fShade),
+                    static_cast<UInt8>(c_color.GetGreen() * fShade),
+                    static_cast<UInt8>(c_color.GetBlue() * fShade));
+   }
+
+   /* Returns a positive value if p is on the left of the edge a->b */
+   static inline Real EdgeFunction(Real f_ax, Real f_ay,
+                                   Real f_bx, Real f_by,
+                                   Real f_px, Real f_py) {
+      return (f_bx - f_ax) * (f_py - f_ay) - (f_by - f_ay) * (f_px - f_ax);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CCameraSensorImageAlgorithm::CCameraSensorImageAlgorithm() :
+      m_pcLEDIndex(nullptr),
+      m_pcFloorEntity(nullptr),
+      m_pcRootEntity(nullptr),
+      m_bDrawFloor(true),
+      m_bFloorLookedUp(false),
+      m_fLEDRadius(0.01),
+      m_unTileSize(16),
+      m_unTilesX(0),
+      m_unTilesY(0),
+      m_cBodyColor(CColor::GRAY50),
+      m_cBackgroundColor(CColor::BLACK),
+      m_fNearDistance(0.0),
+      m_fFarDistance(0.0) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::Init(TConfigurationNode& t_tree) {
+      try {
+         /* Parent class init */
+         CCI_CameraSensorAlgorithm::Init(t_tree);
+         /* LEDs are drawn only if a medium is given */
+         if(NodeAttributeExists(t_tree, "medium")) {
+            std::string strMedium;
+            GetNodeAttribute(t_tree, "medium", strMedium);
+            m_pcLEDIndex = &(CSimulator::GetInstance().GetMedium<CLEDMedium>(strMedium).GetIndex());
+         }
+         GetNodeAttributeOrDefault(t_tree, "floor", m_bDrawFloor, m_bDrawFloor);
+         GetNodeAttributeOrDefault(t_tree, "led_radius", m_fLEDRadius, m_fLEDRadius);
+         GetNodeAttributeOrDefault(t_tree, "body_color", m_cBodyColor, m_cBodyColor);
+         GetNodeAttributeOrDefault(t_tree, "background_color", m_cBackgroundColor, m_cBackgroundColor);
+         GetNodeAttributeOrDefault(t_tree, "tile_size", m_unTileSize, m_unTileSize);
+         if(m_unTileSize == 0) {
+            THROW_ARGOSEXCEPTION("The tile size must be greater than zero");
+         }
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error initializing the image algorithm", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::SetResolution(const CVector2& c_resolution) {
+      m_unWidth = static_cast<UInt32>(c_resolution.GetX());
+      m_unHeight = static_cast<UInt32>(c_resolution.GetY());
+      m_vecColorBuffer.resize(3 * m_unWidth * m_unHeight);
+      m_vecDepthBuffer.resize(m_unWidth * m_unHeight);
+      m_vecEntityBuffer.resize(m_unWidth * m_unHeight);
+      m_unTilesX = (m_unWidth + m_unTileSize - 1) / m_unTileSize;
+      m_unTilesY = (m_unHeight + m_unTileSize - 1) / m_unTileSize;
+      m_vecTileBins.resize(m_unTilesX * m_unTilesY);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::SetRootEntity(const CEntity& c_root_entity) {
+      m_pcRootEntity = &c_root_entity;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::Update(const CSquareMatrix<3>& c_projection_matrix,
+                                            const std::array<CPlane, 6>& arr_frustum_planes,
+                                            const CTransformationMatrix3& c_camera_to_world_transform,
+                                            const CVector3& c_camera_location,
+                                            const CVector3& c_bounding_box_position,
+                                            const CVector3& c_bounding_box_half_extents) {
+      /* Store the camera parameters */
+      m_cProjectionMatrix = c_projection_matrix;
+      m_cInverseProjectionMatrix = c_projection_matrix.GetInverse();
+      /* The given transform maps world coordinates onto camera coordinates */
+      m_cWorldToCameraTransform = c_camera_to_world_transform;
+      m_cCameraToWorldTransform = c_camera_to_world_transform.GetInverse();
+      m_fNearDistance =
+         std::abs(arr_frustum_planes[4].GetNormal().DotProduct(c_camera_location - arr_frustum_planes[4].GetPosition()));
+      m_fFarDistance =
+         std::abs(arr_frustum_planes[5].GetNormal().DotProduct(c_camera_location - arr_frustum_planes[5].GetPosition()));
+      /* Clear the buffers */
+      for(UInt32 i = 0; i < m_unWidth * m_unHeight; ++i) {
+         m_vecColorBuffer[3 * i]     = m_cBackgroundColor.GetRed();
+         m_vecColorBuffer[3 * i + 1] = m_cBackgroundColor.GetGreen();
+         m_vecColorBuffer[3 * i + 2] = m_cBackgroundColor.GetBlue();
+      }
+      std::fill(std::begin(m_vecDepthBuffer), std::end(m_vecDepthBuffer), 0.0);
+      std::fill(std::begin(m_vecEntityBuffer), std::end(m_vecEntityBuffer), nullptr);
+      m_vecTriangles.clear();
+      for(std::vector<UInt32>& vec_bin : m_vecTileBins) {
+         vec_bin.clear();
+      }
+      /* Collect the triangles of the bodies that intersect the frustum */
+      SBoundingBox sFrustumBox;
+      sFrustumBox.MinCorner = c_bounding_box_position - c_bounding_box_half_extents;
+      sFrustumBox.MaxCorner = c_bounding_box_position + c_bounding_box_half_extents;
+      m_vecBodies.clear();
+      CBodyOperation cBodyOperation(m_vecBodies);
+      CSimulator::GetInstance().GetSpace().GetEmbodiedEntityIndex().ForEntitiesInBoxRange(
+         c_bounding_box_position, c_bounding_box_half_extents, cBodyOperation);
+      /* A body that spans several cells is found once per cell */
+      std::sort(std::begin(m_vecBodies), std::end(m_vecBodies),
+                [](const CEmbodiedEntity* pc_a, const CEmbodiedEntity* pc_b) {
+                   return pc_a->GetIndex() < pc_b->GetIndex();
+                });
+      m_vecBodies.erase(std::unique(std::begin(m_vecBodies), std::end(m_vecBodies)),
+                        std::end(m_vecBodies));
+      for(CEmbodiedEntity* pcBody : m_vecBodies) {
+         /* Skip the body of the robot that carries the camera */
+         if(&(pcBody->GetRootEntity()) == m_pcRootEntity ||
+            !pcBody->GetBoundingBox().Intersects(sFrustumBox)) {
+            continue;
+         }
+         AddBody(*pcBody);
+      }
+      /* Rasterize the triangles tile by tile */
+      for(UInt32 unTileY = 0; unTileY < m_unTilesY; ++unTileY) {
+         for(UInt32 unTileX = 0; unTileX < m_unTilesX; ++unTileX) {
+            RasterizeTile(unTileX, unTileY);
+         }
+      }
+      /* Fill the remaining pixels with the floor */
+      if(m_bDrawFloor) {
+         DrawFloor();
+      }
+      /* Draw the LEDs */
+      if(m_pcLEDIndex != nullptr) {
+         DrawLEDs(c_bounding_box_position, c_bounding_box_half_extents);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::AddBody(const CEmbodiedEntity& c_body) {
+      const CEntity& cRoot = c_body.GetRootEntity();
+      const SAnchor& sOrigin = c_body.GetOriginAnchor();
+      if(const CBoxEntity* pcBox = dynamic_cast<const CBoxEntity*>(&cRoot)) {
+         AddBox(sOrigin.Position,
+                sOrigin.Orientation,
+                pcBox->GetSize(),
+                c_body.IsMovable() ? MOVABLE_BOX_COLOR : NONMOVABLE_COLOR,
+                cRoot);
+      }
+      else if(const CCylinderEntity* pcCylinder = dynamic_cast<const CCylinderEntity*>(&cRoot)) {
+         AddCylinder(sOrigin.Position,
+                     sOrigin.Orientation,
+                     pcCylinder->GetRadius(),
+                     pcCylinder->GetHeight(),
+                     c_body.IsMovable() ? MOVABLE_CYLINDER_COLOR : NONMOVABLE_COLOR,
+                     cRoot);
+      }
+      else {
+         /* The shape of the other bodies is only known to the physics engines and to the visualizations */
+         const SBoundingBox& sBox = c_body.GetBoundingBox();
+         AddBox(CVector3((sBox.MinCorner.GetX() + sBox.MaxCorner.GetX()) * 0.5,
+                         (sBox.MinCorner.GetY() + sBox.MaxCorner.GetY()) * 0.5,
+                         sBox.MinCorner.GetZ()),
+                CQuaternion(),
+                sBox.MaxCorner - sBox.MinCorner,
+                m_cBodyColor,
+                cRoot);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::AddBox(const CVector3& c_position,
+                                            const CQuaternion& c_orientation,
+                                            const CVector3& c_size,
+                                            const CColor& c_color,
+                                            const CEntity& c_entity) {
+      /* Corner i has the maximum coordinate on X if bit 0 is set, on Y if bit 1 is set, on Z if bit 2 is set */
+      CVector3 arrCorners[8];
+      for(UInt32 i = 0; i < 8; ++i) {
+         arrCorners[i].Set(((i & 1) ? 0.5 : -0.5) * c_size.GetX(),
+                           ((i & 2) ? 0.5 : -0.5) * c_size.GetY(),
+                           (i & 4) ? c_size.GetZ() : 0.0);
+         arrCorners[i].Rotate(c_orientation);
+         arrCorners[i] += c_position;
+      }
+      /* The faces, with their corners in cyclic order and their normals */
+      static const UInt32 FACES[6][4] = {
+         {0, 2, 6, 4}, {1, 3, 7, 5},
+         {0, 1, 5, 4}, {2, 3, 7, 6},
+         {0, 1, 3, 2}, {4, 5, 7, 6}
+      };
+      static const CVector3 NORMALS[6] = {
+         -CVector3::X, CVector3::X,
+         -CVector3::Y, CVector3::Y,
+         -CVector3::Z, CVector3::Z
+      };
+      for(UInt32 i = 0; i < 6; ++i) {
+         CVector3 cNormal(NORMALS[i]);
+         cNormal.Rotate(c_orientation);
+         CColor cColor = Shade(c_color, cNormal);
+         AddTriangle(arrCorners[FACES[i][0]], arrCorners[FACES[i][1]], arrCorners[FACES[i][2]],
+                     cColor, c_entity);
+         AddTriangle(arrCorners[FACES[i][0]], arrCorners[FACES[i][2]], arrCorners[FACES[i][3]],
+                     cColor, c_entity);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::AddCylinder(const CVector3& c_position,
+                                                 const CQuaternion& c_orientation,
+                                                 Real f_radius,
+                                                 Real f_height,
+                                                 const CColor& c_color,
+                                                 const CEntity& c_entity) {
+      /* The vertices on the bottom and on the top rim */
+      CVector3 arrBottom[CYLINDER_SIDES];
+      CVector3 arrTop[CYLINDER_SIDES];
+      CVector3 cAxis(CVector3::Z);
+      cAxis.Rotate(c_orientation);
+      for(UInt32 i = 0; i < CYLINDER_SIDES; ++i) {
+         CRadians cAngle = CRadians::TWO_PI * i / CYLINDER_SIDES;
+         arrBottom[i].Set(f_radius * Cos(cAngle), f_radius * Sin(cAngle), 0.0);
+         arrBottom[i].Rotate(c_orientation);
+         arrBottom[i] += c_position;
+         arrTop[i] = arrBottom[i] + cAxis * f_height;
+      }
+      CVector3 cBottomCenter(c_position);
+      CVector3 cTopCenter(c_position + cAxis * f_height);
+      CColor cBottomColor = Shade(c_color, -cAxis);
+      CColor cTopColor = Shade(c_color, cAxis);
+      for(UInt32 i = 0; i < CYLINDER_SIDES; ++i) {
+         UInt32 unNext = (i + 1) % CYLINDER_SIDES;
+         /* Side, shaded with the normal in the middle of the face */
+         CVector3 cNormal((arrBottom[i] + arrBottom[unNext]) * 0.5 - c_position);
+         CColor cColor = Shade(c_color, cNormal.Normalize());
+         AddTriangle(arrBottom[i], arrBottom[unNext], arrTop[unNext], cColor, c_entity);
+         AddTriangle(arrBottom[i], arrTop[unNext], arrTop[i], cColor, c_entity);
+         /* Caps */
+         AddTriangle(cBottomCenter, arrBottom[unNext], arrBottom[i], cBottomColor, c_entity);
+         AddTriangle(cTopCenter, arrTop[i], arrTop[unNext], cTopColor, c_entity);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::AddTriangle(const CVector3& c_vertex0,
+                                                 const CVector3& c_vertex1,
+                                                 const CVector3& c_vertex2,
+                                                 const CColor& c_color,
+                                                 const CEntity& c_entity) {
+      /* Move the vertices into the camera frame */
+      CVector3 arrVertices[3] = {
+         m_cWorldToCameraTransform * c_vertex0,
+         m_cWorldToCameraTransform * c_vertex1,
+         m_cWorldToCameraTransform * c_vertex2
+      };
+      /* Count the vertices in front of the near plane */
+      UInt32 unInside = 0;
+      bool bBeyondFar = true;
+      for(const CVector3& c_vertex : arrVertices) {
+         if(c_vertex.GetZ() >= m_fNearDistance) ++unInside;
+         if(c_vertex.GetZ() <= m_fFarDistance) bBeyondFar = false;
+      }
+      if(unInside == 0 || bBeyondFar) {
+         return;
+      }
+      if(unInside == 3) {
+         AddClippedTriangle(arrVertices[0], arrVertices[1], arrVertices[2], c_color, c_entity);
+         return;
+      }
+      /* Clip the triangle against the near plane, which yields three or four vertices */
+      CVector3 arrClipped[4];
+      UInt32 unClipped = 0;
+      for(UInt32 i = 0; i < 3; ++i) {
+         const CVector3& cCurrent = arrVertices[i];
+         const CVector3& cNext = arrVertices[(i + 1) % 3];
+         bool bCurrentInside = (cCurrent.GetZ() >= m_fNearDistance);
+         bool bNextInside = (cNext.GetZ() >= m_fNearDistance);
+         if(bCurrentInside) {
+            arrClipped[unClipped++] = cCurrent;
+         }
+         if(bCurrentInside != bNextInside) {
+            Real fT = (m_fNearDistance - cCurrent.GetZ()) / (cNext.GetZ() - cCurrent.GetZ());
+            arrClipped[unClipped++] = cCurrent + (cNext - cCurrent) * fT;
+         }
+      }
+      AddClippedTriangle(arrClipped[0], arrClipped[1], arrClipped[2], c_color, c_entity);
+      if(unClipped == 4) {
+         AddClippedTriangle(arrClipped[0], arrClipped[2], arrClipped[3], c_color, c_entity);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::AddClippedTriangle(const CVector3& c_vertex0,
+                                                        const CVector3& c_vertex1,
+                                                        const CVector3& c_vertex2,
+                                                        const CColor& c_color,
+                                                        const CEntity& c_entity) {
+      STriangle sTriangle;
+      const CVector3* arrVertices[3] = { &c_vertex0, &c_vertex1, &c_vertex2 };
+      /* Project the vertices onto the image */
+      for(UInt32 i = 0; i < 3; ++i) {
+         Real fInverseDepth = 1.0 / arrVertices[i]->GetZ();
+         Real fX = arrVertices[i]->GetX() * fInverseDepth;
+         Real fY = arrVertices[i]->GetY() * fInverseDepth;
+         sTriangle.X[i] =
+            m_cProjectionMatrix(0,0) * fX + m_cProjectionMatrix(0,1) * fY + m_cProjectionMatrix(0,2);
+         sTriangle.Y[i] =
+            m_cProjectionMatrix(1,0) * fX + m_cProjectionMatrix(1,1) * fY + m_cProjectionMatrix(1,2);
+         sTriangle.InverseDepth[i] = fInverseDepth;
+      }
+      sTriangle.MinX = std::min({sTriangle.X[0], sTriangle.X[1], sTriangle.X[2]});
+      sTriangle.MaxX = std::max({sTriangle.X[0], sTriangle.X[1], sTriangle.X[2]});
+      sTriangle.MinY = std::min({sTriangle.Y[0], sTriangle.Y[1], sTriangle.Y[2]});
+      sTriangle.MaxY = std::max({sTriangle.Y[0], sTriangle.Y[1], sTriangle.Y[2]});
+      /* Discard triangles outside of the image */
+      if(sTriangle.MaxX < 0.0 || sTriangle.MinX >= m_unWidth ||
+         sTriangle.MaxY < 0.0 || sTriangle.MinY >= m_unHeight) {
+         return;
+      }
+      sTriangle.Color = c_color;
+      sTriangle.Entity = &c_entity;
+      /* Bin the triangle into the tiles it overlaps */
+      UInt32 unIndex = m_vecTriangles.size();
+      m_vecTriangles.push_back(sTriangle);
+      UInt32 unMinTileX = static_cast<UInt32>(Max<Real>(0.0, sTriangle.MinX)) / m_unTileSize;
+      UInt32 unMinTileY = static_cast<UInt32>(Max<Real>(0.0, sTriangle.MinY)) / m_unTileSize;
+      UInt32 unMaxTileX = Min<UInt32>(m_unTilesX - 1, static_cast<UInt32>(Min<Real>(m_unWidth, sTriangle.MaxX)) / m_unTileSize);
+      UInt32 unMaxTileY = Min<UInt32>(m_unTilesY - 1, static_cast<UInt32>(Min<Real>(m_unHeight, sTriangle.MaxY)) / m_unTileSize);
+      for(UInt32 unTileY = unMinTileY; unTileY <= unMaxTileY; ++unTileY) {
+         for(UInt32 unTileX = unMinTileX; unTileX <= unMaxTileX; ++unTileX) {
+            m_vecTileBins[unTileY * m_unTilesX + unTileX].push_back(unIndex);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::RasterizeTile(UInt32 un_tile_x,
+                                                   UInt32 un_tile_y) {
+      UInt32 unTileMinX = un_tile_x * m_unTileSize;
+      UInt32 unTileMinY = un_tile_y * m_unTileSize;
+      UInt32 unTileMaxX = Min<UInt32>(m_unWidth, unTileMinX + m_unTileSize);
+      UInt32 unTileMaxY = Min<UInt32>(m_unHeight, unTileMinY + m_unTileSize);
+      for(UInt32 un_triangle : m_vecTileBins[un_tile_y * m_unTilesX + un_tile_x]) {
+         const STriangle& sTriangle = m_vecTriangles[un_triangle];
+         Real fArea = EdgeFunction(sTriangle.X[0], sTriangle.Y[0],
+                                   sTriangle.X[1], sTriangle.Y[1],
+                                   sTriangle.X[2], sTriangle.Y[2]);
+         if(std::abs(fArea) < 1e-9) {
+            continue;
+         }
+         /* Make the edge functions positive inside the triangle regardless of its winding */
+         Real fSign = (fArea > 0.0) ? 1.0 : -1.0;
+         Real fInverseArea = fSign / fArea;
+         /* Pixel range covered by the triangle within the tile */
+         UInt32 unMinX = Max<UInt32>(unTileMinX, static_cast<UInt32>(Max<Real>(0.0, std::floor(sTriangle.MinX))));
+         UInt32 unMinY = Max<UInt32>(unTileMinY, static_cast<UInt32>(Max<Real>(0.0, std::floor(sTriangle.MinY))));
+         UInt32 unMaxX = Min<UInt32>(unTileMaxX, static_cast<UInt32>(Max<Real>(0.0, std::ceil(sTriangle.MaxX))));
+         UInt32 unMaxY = Min<UInt32>(unTileMaxY, static_cast<UInt32>(Max<Real>(0.0, std::ceil(sTriangle.MaxY))));
+         /* Increments of the edge functions along X */
+         Real arrStepX[3] = {
+            -fSign * (sTriangle.Y[2] - sTriangle.Y[1]),
+            -fSign * (sTriangle.Y[0] - sTriangle.Y[2]),
+            -fSign * (sTriangle.Y[1] - sTriangle.Y[0])
+         };
+         for(UInt32 unY = unMinY; unY < unMaxY; ++unY) {
+            Real fPX = unMinX + 0.5;
+            Real fPY = unY + 0.5;
+            Real arrEdges[3] = {
+               fSign * EdgeFunction(sTriangle.X[1], sTriangle.Y[1], sTriangle.X[2], sTriangle.Y[2], fPX, fPY),
+               fSign * EdgeFunction(sTriangle.X[2], sTriangle.Y[2], sTriangle.X[0], sTriangle.Y[0], fPX, fPY),
+               fSign * EdgeFunction(sTriangle.X[0], sTriangle.Y[0], sTriangle.X[1], sTriangle.Y[1], fPX, fPY)
+            };
+            for(UInt32 unX = unMinX; unX < unMaxX; ++unX) {
+               if(arrEdges[0] >= 0.0 && arrEdges[1] >= 0.0 && arrEdges[2] >= 0.0) {
+                  /* The inverse of the depth is linear in image space */
+                  Real fInverseDepth =
+                     (arrEdges[0] * sTriangle.InverseDepth[0] +
+                      arrEdges[1] * sTriangle.InverseDepth[1] +
+                      arrEdges[2] * sTriangle.InverseDepth[2]) * fInverseArea;
+                  Real fDepth = 1.0 / fInverseDepth;
+                  UInt32 unIndex = unY * m_unWidth + unX;
+                  if(fDepth <= m_fFarDistance &&
+                     (m_vecDepthBuffer[unIndex] == 0.0 || fDepth < m_vecDepthBuffer[unIndex])) {
+                     SetPixel(unIndex, sTriangle.Color, fDepth, sTriangle.Entity);
+                  }
+               }
+               arrEdges[0] += arrStepX[0];
+               arrEdges[1] += arrStepX[1];
+               arrEdges[2] += arrStepX[2];
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::DrawFloor() {
+      /* Look up the floor entity the first time, it might be added after the robots */
+      if(!m_bFloorLookedUp) {
+         try {
+            m_pcFloorEntity = &(CSimulator::GetInstance().GetSpace().GetFloorEntity());
+         }
+         catch(CARGoSException&) {
+            m_pcFloorEntity = nullptr;
+         }
+         m_bFloorLookedUp = true;
+      }
+      if(m_pcFloorEntity == nullptr) {
+         return;
+      }
+      CVector3 cOrigin = m_cCameraToWorldTransform * CVector3::ZERO;
+      for(UInt32 unY = 0; unY < m_unHeight; ++unY) {
+         for(UInt32 unX = 0; unX < m_unWidth; ++unX) {
+            UInt32 unIndex = unY * m_unWidth + unX;
+            if(m_vecDepthBuffer[unIndex] != 0.0) {
+               continue;
+            }
+            /* Point at unit depth along the ray through the pixel */
+            Real fU = unX + 0.5;
+            Real fV = unY + 0.5;
+            CVector3 cPoint(
+               m_cInverseProjectionMatrix(0,0) * fU + m_cInverseProjectionMatrix(0,1) * fV + m_cInverseProjectionMatrix(0,2),
+               m_cInverseProjectionMatrix(1,0) * fU + m_cInverseProjectionMatrix(1,1) * fV + m_cInverseProjectionMatrix(1,2),
+               1.0);
+            cPoint = m_cCameraToWorldTransform * cPoint;
+            /* Intersect the ray with the floor plane */
+            Real fDeltaZ = cPoint.GetZ() - cOrigin.GetZ();
+            if(fDeltaZ >= 0.0) {
+               continue;
+            }
+            Real fDepth = -cOrigin.GetZ() / fDeltaZ;
+            if(fDepth < m_fNearDistance || fDepth > m_fFarDistance) {
+               continue;
+            }
+            CVector3 cFloorPoint = cOrigin + (cPoint - cOrigin) * fDepth;
+            SetPixel(unIndex,
+                     m_pcFloorEntity->GetColorAtPoint(cFloorPoint.GetX(), cFloorPoint.GetY()),
+                     fDepth,
+                     m_pcFloorEntity);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::DrawLEDs(const CVector3& c_bounding_box_position,
+                                              const CVector3& c_bounding_box_half_extents) {
+      m_vecLEDs.clear();
+      CLEDOperation cOperation(m_vecLEDs);
+      m_pcLEDIndex->ForEntitiesInBoxRange(c_bounding_box_position,
+                                          c_bounding_box_half_extents,
+                                          cOperation);
+      for(CLEDEntity* pc_led : m_vecLEDs) {
+         CVector3 cPosition = m_cWorldToCameraTransform * pc_led->GetPosition();
+         Real fDepth = cPosition.GetZ();
+         if(fDepth < m_fNearDistance || fDepth > m_fFarDistance) {
+            continue;
+         }
+         Real fU =
+            m_cProjectionMatrix(0,0) * cPosition.GetX() / fDepth +
+            m_cProjectionMatrix(0,1) * cPosition.GetY() / fDepth +
+            m_cProjectionMatrix(0,2);
+         Real fV =
+            m_cProjectionMatrix(1,0) * cPosition.GetX() / fDepth +
+            m_cProjectionMatrix(1,1) * cPosition.GetY() / fDepth +
+            m_cProjectionMatrix(1,2);
+         /* Radius of the disc on the image, at least half a pixel */
+         Real fRadius = Max<Real>(0.5, m_cProjectionMatrix(0,0) * m_fLEDRadius / fDepth);
+         SInt32 nMinX = Max<SInt32>(0, static_cast<SInt32>(std::floor(fU - fRadius)));
+         SInt32 nMaxX = Min<SInt32>(m_unWidth - 1, static_cast<SInt32>(std::floor(fU + fRadius)));
+         SInt32 nMinY = Max<SInt32>(0, static_cast<SInt32>(std::floor(fV - fRadius)));
+         SInt32 nMaxY = Min<SInt32>(m_unHeight - 1, static_cast<SInt32>(std::floor(fV + fRadius)));
+         /* The LEDs lie on the bodies of their robots, which must not hide them */
+         const CEntity* pcRoot = &(pc_led->GetRootEntity());
+         for(SInt32 nY = nMinY; nY <= nMaxY; ++nY) {
+            for(SInt32 nX = nMinX; nX <= nMaxX; ++nX) {
+               Real fDX = nX + 0.5 - fU;
+               Real fDY = nY + 0.5 - fV;
+               if(fDX * fDX + fDY * fDY > fRadius * fRadius) {
+                  continue;
+               }
+               UInt32 unIndex = nY * m_unWidth + nX;
+               if(m_vecDepthBuffer[unIndex] == 0.0 ||
+                  m_vecEntityBuffer[unIndex] == pcRoot ||
+                  fDepth <= m_vecDepthBuffer[unIndex]) {
+                  SetPixel(unIndex, pc_led->GetColor(), fDepth, pcRoot);
+               }
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorImageAlgorithm::SetPixel(UInt32 un_index,
+                                              const CColor& c_color,
+                                              Real f_depth,
+                                              const CEntity* pc_entity) {
+      m_vecColorBuffer[3 * un_index]     = c_color.GetRed();
+      m_vecColorBuffer[3 * un_index + 1] = c_color.GetGreen();
+      m_vecColorBuffer[3 * un_index + 2] = c_color.GetBlue();
+      m_vecDepthBuffer[un_index] = f_depth;
+      m_vecEntityBuffer[un_index] = pc_entity;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_CAMERA_SENSOR_ALGORITHM(CCameraSensorImageAlgorithm,
+                                    "image",
+                                    "agent [agent@local]",
+                                    "1.0",
+                                    "This algorithm renders the color and depth image seen by the\n"
+                                    "camera on the CPU",
+                                    "This algorithm renders the color and depth image seen by the\n"
+                                    "camera with a tile-based software rasterizer, so that images are\n"
+                                    "available without an OpenGL context. Boxes and cylinders are drawn\n"
+                                    "with their shape and with the colors of the Qt-OpenGL visualization,\n"
+                                    "the LEDs as colored discs, and the floor with the colors of the\n"
+                                    "floor entity. All the other bodies, robots included, are drawn as\n"
+                                    "their axis-aligned bounding boxes (AABB), so a robot appears as a\n"
+                                    "box that contains it, whatever its shape and orientation. The body\n"
+                                    "of the robot that carries the camera is not drawn. The image has\n"
+                                    "the resolution of the camera. The optional\n"
+                                    "attributes are: 'medium', the LED medium whose LEDs are drawn (no\n"
+                                    "LEDs are drawn if omitted); 'floor' (default: true), whether the\n"
+                                    "floor is drawn; 'led_radius' (default: 0.01), the radius of the\n"
+                                    "LEDs in meters; 'body_color' (default: gray50), the color of the\n"
+                                    "bodies drawn as bounding boxes; 'background_color' (default:\n"
+                                    "black); and 'tile_size' (default: 16), the side of the tiles in\n"
+                                    "pixels. For example:\n\n"
+                                    "  <camera id=\"camera0\" ... resolution=\"320,240\">\n"
+                                    "    <image medium=\"leds\" floor=\"true\"/>\n"
+                                    "  </camera>\n",
+                                    "Under development");
+}
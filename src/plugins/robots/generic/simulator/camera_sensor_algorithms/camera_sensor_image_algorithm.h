@@ -0,0 +1,183 @@
+/**
+ * @file <argos3/plugins/robots/generic/simulator/camera_sensor_algorithms/camera_sensor_image_algorithm.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef CAMERA_SENSOR_IMAGE_ALGORITHM_H
+#define CAMERA_SENSOR_IMAGE_ALGORITHM_H
+
+namespace argos {
+   class CCameraSensorImageAlgorithm;
+   class CFloorEntity;
+}
+
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/space/positional_indices/positional_index.h>
+#include <argos3/core/utility/datatypes/color.h>
+#include <argos3/core/utility/math/matrix/transformationmatrix3.h>
+
+#include <argos3/plugins/simulator/entities/led_entity.h>
+#include <argos3/plugins/robots/generic/simulator/camera_sensor_algorithm.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_camera_sensor_algorithms/ci_camera_sensor_image_algorithm.h>
+
+namespace argos {
+
+   /**
+    * Renders the image seen by the camera with a software rasterizer.
+    * Boxes and cylinders are drawn with their shape and with the colors of
+    * the Qt-OpenGL visualization, the other bodies in the frustum, robots
+    * included, as their axis-aligned bounding boxes, the LEDs as colored discs
+    * and the floor with the colors of the floor entity. The body of the robot
+    * that carries the camera is not drawn. The bodies are looked up in the
+    * embodied entity index of the space with the bounding box of the frustum.
+    * The image is split into square tiles, and the triangles
+    * are binned into the tiles they overlap before being rasterized tile by
+    * tile, so that the color and depth buffers of a tile stay in the cache.
+    */
+   class CCameraSensorImageAlgorithm : public CCameraSensorSimulatedAlgorithm,
+                                       public CCI_CameraSensorImageAlgorithm {
+
+   public:
+
+      class CLEDOperation : public CPositionalIndex<CLEDEntity>::COperation {
+
+      public:
+
+         CLEDOperation(std::vector<CLEDEntity*>& vec_leds) :
+            m_vecLEDs(vec_leds) {}
+
+         virtual ~CLEDOperation() {}
+
+         virtual bool operator()(CLEDEntity& c_led) {
+            if(c_led.GetColor() != CColor::BLACK) {
+               m_vecLEDs.push_back(&c_led);
+            }
+            return true;
+         }
+
+      private:
+
+         std::vector<CLEDEntity*>& m_vecLEDs;
+      };
+
+      class CBodyOperation : public CPositionalIndex<CEmbodiedEntity>::COperation {
+
+      public:
+
+         CBodyOperation(std::vector<CEmbodiedEntity*>& vec_bodies) :
+            m_vecBodies(vec_bodies) {}
+
+         virtual ~CBodyOperation() {}
+
+         virtual bool operator()(CEmbodiedEntity& c_body) {
+            m_vecBodies.push_back(&c_body);
+            return true;
+         }
+
+      private:
+
+         std::vector<CEmbodiedEntity*>& m_vecBodies;
+      };
+
+   public:
+
+      CCameraSensorImageAlgorithm();
+
+      virtual ~CCameraSensorImageAlgorithm() {}
+
+      virtual void Init(TConfigurationNode& t_tree);
+
+      virtual void SetResolution(const CVector2& c_resolution);
+
+      virtual void SetRootEntity(const CEntity& c_root_entity);
+
+      virtual void Update(const CSquareMatrix<3>& c_projection_matrix,
+                          const std::array<CPlane, 6>& arr_frustum_planes,
+                          const CTransformationMatrix3& c_camera_to_world_transform,
+                          const CVector3& c_camera_location,
+                          const CVector3& c_bounding_box_position,
+                          const CVector3& c_bounding_box_half_extents);
+
+   private:
+
+      /* A triangle projected on the image, with the depth of its vertices */
+      struct STriangle {
+         Real X[3];
+         Real Y[3];
+         Real InverseDepth[3];
+         Real MinX, MinY, MaxX, MaxY;
+         CColor Color;
+         const CEntity* Entity;
+      };
+
+      void AddBody(const CEmbodiedEntity& c_body);
+
+      void AddBox(const CVector3& c_position,
+                  const CQuaternion& c_orientation,
+                  const CVector3& c_size,
+                  const CColor& c_color,
+                  const CEntity& c_entity);
+
+      void AddCylinder(const CVector3& c_position,
+                       const CQuaternion& c_orientation,
+                       Real f_radius,
+                       Real f_height,
+                       const CColor& c_color,
+                       const CEntity& c_entity);
+
+      void AddTriangle(const CVector3& c_vertex0,
+                       const CVector3& c_vertex1,
+                       const CVector3& c_vertex2,
+                       const CColor& c_color,
+                       const CEntity& c_entity);
+
+      void AddClippedTriangle(const CVector3& c_vertex0,
+                              const CVector3& c_vertex1,
+                              const CVector3& c_vertex2,
+                              const CColor& c_color,
+                              const CEntity& c_entity);
+
+      void RasterizeTile(UInt32 un_tile_x,
+                         UInt32 un_tile_y);
+
+      void DrawFloor();
+
+      void DrawLEDs(const CVector3& c_bounding_box_position,
+                    const CVector3& c_bounding_box_half_extents);
+
+      void SetPixel(UInt32 un_index,
+                    const CColor& c_color,
+                    Real f_depth,
+                    const CEntity* pc_entity);
+
+   private:
+
+      CPositionalIndex<CLEDEntity>* m_pcLEDIndex;
+      CFloorEntity* m_pcFloorEntity;
+      const CEntity* m_pcRootEntity;
+      bool m_bDrawFloor;
+      bool m_bFloorLookedUp;
+      Real m_fLEDRadius;
+      UInt32 m_unTileSize;
+      UInt32 m_unTilesX;
+      UInt32 m_unTilesY;
+      CColor m_cBodyColor;
+      CColor m_cBackgroundColor;
+      /* Per-update camera parameters */
+      CSquareMatrix<3> m_cProjectionMatrix;
+      CSquareMatrix<3> m_cInverseProjectionMatrix;
+      CTransformationMatrix3 m_cWorldToCameraTransform;
+      CTransformationMatrix3 m_cCameraToWorldTransform;
+      Real m_fNearDistance;
+      Real m_fFarDistance;
+      /* Buffers reused across updates */
+      std::vector<const CEntity*> m_vecEntityBuffer;
+      std::vector<STriangle> m_vecTriangles;
+      std::vector<std::vector<UInt32> > m_vecTileBins;
+      std::vector<CLEDEntity*> m_vecLEDs;
+      std::vector<CEmbodiedEntity*> m_vecBodies;
+   };
+}
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file <argos3/plugins/robots/generic/simulator/colored_blob_camera_led_batch.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "colored_blob_camera_led_batch.h"
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/core/utility/math/matrix/rotationmatrix3.h>
+#include <argos3/plugins/simulator/entities/led_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CColoredBlobCameraLEDBatch::CColoredBlobCameraLEDBatch(CEmbodiedEntity& c_embodied_entity,
+                                                          CEntity& c_sensing_root) :
+      m_cEmbodiedEntity(c_embodied_entity),
+      m_pcSensingRoot(&c_sensing_root) {}
+
+   /****************************************/
+   /****************************************/
+
+   bool CColoredBlobCameraLEDBatch::operator()(CLEDEntity& c_led) {
+      /* Process this LED only if it's lit */
+      if(c_led.GetColor() == CColor::BLACK) return true;
+      /* Filter out the LEDs belonging to the sensing entity */
+      if(&c_led.GetRootEntity() == m_pcSensingRoot) return true;
+      /* Add the LED to the batch */
+      m_vecLEDs.push_back(&c_led);
+      m_vecX.push_back(c_led.GetPosition().GetX());
+      m_vecY.push_back(c_led.GetPosition().GetY());
+      m_vecZ.push_back(c_led.GetPosition().GetZ());
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CColoredBlobCameraLEDBatch::Clear() {
+      m_vecLEDs.clear();
+      m_vecX.clear();
+      m_vecY.clear();
+      m_vecZ.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CColoredBlobCameraLEDBatch::CullGroundRange(const CVector3& c_camera_pos,
+                                                    Real f_ground_half_range) {
+      size_t unSize = m_vecLEDs.size();
+      m_vecRelX.resize(unSize);
+      m_vecRelY.resize(unSize);
+      m_vecRelZ.resize(unSize);
+      m_vecVisible.resize(unSize);
+      const Real fCamX = c_camera_pos.GetX();
+      const Real fCamY = c_camera_pos.GetY();
+      const Real fCamZ = c_camera_pos.GetZ();
+      const Real* pfX = m_vecX.data();
+      const Real* pfY = m_vecY.data();
+      const Real* pfZ = m_vecZ.data();
+      Real* pfRelX = m_vecRelX.data();
+      Real* pfRelY = m_vecRelY.data();
+      Real* pfRelZ = m_vecRelZ.data();
+      UInt8* punVisible = m_vecVisible.data();
+      /* Branchless, so it can be vectorized */
+      for(size_t i = 0; i < unSize; ++i) {
+         pfRelX[i] = pfX[i] - fCamX;
+         pfRelY[i] = pfY[i] - fCamY;
+         pfRelZ[i] = pfZ[i] - fCamZ;
+         punVisible[i] =
+            static_cast<UInt8>(Abs(pfRelX[i]) < f_ground_half_range) &
+            static_cast<UInt8>(Abs(pfRelY[i]) < f_ground_half_range) &
+            static_cast<UInt8>(pfRelZ[i] < fCamZ);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CColoredBlobCameraLEDBatch::CullViewingCone(const CVector3& c_camera_pos,
+                                                    const CQuaternion& c_camera_orient,
+                                                    Real f_range,
+                                                    const CRadians& c_aperture) {
+      size_t unSize = m_vecLEDs.size();
+      m_vecRelX.resize(unSize);
+      m_vecRelY.resize(unSize);
+      m_vecRelZ.resize(unSize);
+      m_vecVisible.resize(unSize);
+      /* Rotation from the global frame to the camera frame */
+      CRotationMatrix3 cRot = c_camera_orient.Inverse();
+      const Real fR00 = cRot(0,0), fR01 = cRot(0,1), fR02 = cRot(0,2);
+      const Real fR10 = cRot(1,0), fR11 = cRot(1,1), fR12 = cRot(1,2);
+      const Real fR20 = cRot(2,0), fR21 = cRot(2,1), fR22 = cRot(2,2);
+      const Real fCamX = c_camera_pos.GetX();
+      const Real fCamY = c_camera_pos.GetY();
+      const Real fCamZ = c_camera_pos.GetZ();
+      /*
+       * The LED is in the cone if the angle with the camera axis is below the
+       * aperture, that is, if cos(angle) = x / length > cos(aperture).
+       * Squaring both sides avoids the square root and the arc cosine.
+       */
+      const Real fCosAperture = Cos(c_aperture);
+      const Real fSquareCosAperture = fCosAperture * fCosAperture;
+      const Real* pfX = m_vecX.data();
+      const Real* pfY = m_vecY.data();
+      const Real* pfZ = m_vecZ.data();
+      Real* pfRelX = m_vecRelX.data();
+      Real* pfRelY = m_vecRelY.data();
+      Real* pfRelZ = m_vecRelZ.data();
+      UInt8* punVisible = m_vecVisible.data();
+      for(size_t i = 0; i < unSize; ++i) {
+         Real fDX = pfX[i] - fCamX;
+         Real fDY = pfY[i] - fCamY;
+         Real fDZ = pfZ[i] - fCamZ;
+         pfRelX[i] = fR00 * fDX + fR01 * fDY + fR02 * fDZ;
+         pfRelY[i] = fR10 * fDX + fR11 * fDY + fR12 * fDZ;
+         pfRelZ[i] = fR20 * fDX + fR21 * fDY + fR22 * fDZ;
+      }
+      if(fCosAperture >= 0.0f) {
+         for(size_t i = 0; i < unSize; ++i) {
+            Real fSquareLength = pfRelX[i] * pfRelX[i] + pfRelY[i] * pfRelY[i] + pfRelZ[i] * pfRelZ[i];
+            punVisible[i] =
+               static_cast<UInt8>(pfRelX[i] < f_range) &
+               static_cast<UInt8>(pfRelX[i] > 0.0f) &
+               static_cast<UInt8>(pfRelX[i] * pfRelX[i] > fSquareCosAperture * fSquareLength);
+         }
+      }
+      else {
+         for(size_t i = 0; i < unSize; ++i) {
+            Real fSquareLength = pfRelX[i] * pfRelX[i] + pfRelY[i] * pfRelY[i] + pfRelZ[i] * pfRelZ[i];
+            punVisible[i] =
+               static_cast<UInt8>(pfRelX[i] < f_range) &
+               static_cast<UInt8>(fSquareLength > 0.0f) &
+               (static_cast<UInt8>(pfRelX[i] >= 0.0f) |
+                static_cast<UInt8>(pfRelX[i] * pfRelX[i] < fSquareCosAperture * fSquareLength));
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CColoredBlobCameraLEDBatch::CullOccluded(const CVector3& c_camera_pos) {
+      /* Make a ray for each LED that is still visible */
+      m_vecRays.clear();
+      m_vecRayLEDs.clear();
+      for(size_t i = 0; i < m_vecLEDs.size(); ++i) {
+         if(m_vecVisible[i]) {
+            m_vecRays.push_back(
+               CRay3(c_camera_pos,
+                     CVector3(m_vecX[i], m_vecY[i], m_vecZ[i])));
+            m_vecRayLEDs.push_back(i);
+         }
+      }
+      /* Check all the rays at once */
+      CheckOcclusionsAlongRays(m_vecOccluded, m_vecRays, m_cEmbodiedEntity);
+      for(size_t i = 0; i < m_vecRays.size(); ++i) {
+         if(m_vecOccluded[i]) {
+            m_vecVisible[m_vecRayLEDs[i]] = 0;
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,143 @@
+/**
+ * @file <argos3/plugins/robots/generic/simulator/colored_blob_camera_led_batch.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef COLORED_BLOB_CAMERA_LED_BATCH_H
+#define COLORED_BLOB_CAMERA_LED_BATCH_H
+
+namespace argos {
+   class CColoredBlobCameraLEDBatch;
+   class CEmbodiedEntity;
+   class CEntity;
+   class CLEDEntity;
+}
+
+#include <argos3/core/simulator/space/positional_indices/positional_index.h>
+#include <argos3/core/utility/math/quaternion.h>
+#include <argos3/core/utility/math/ray3.h>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * Visibility check for the LEDs seen by a colored blob camera.
+    * <p>
+    * This class is passed to the LED positional index as an operation. Instead
+    * of checking each LED as soon as it is found, it only collects the lit LEDs
+    * that do not belong to the sensing robot, storing their positions in
+    * separate arrays. The range and angle checks are then done on the whole
+    * batch in tight loops that the compiler can vectorize. Occlusions are
+    * checked last, with a single batched ray query for the LEDs that passed the
+    * culling.
+    * </p>
+    * <p>
+    * The LEDs are kept in the order the index returned them, so the blobs are
+    * produced in the same order as with a per-LED check.
+    * </p>
+    */
+   class CColoredBlobCameraLEDBatch : public CPositionalIndex<CLEDEntity>::COperation {
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param c_embodied_entity The body of the sensing robot, ignored by the occlusion check.
+       * @param c_sensing_root The entity whose LEDs must be ignored.
+       */
+      CColoredBlobCameraLEDBatch(CEmbodiedEntity& c_embodied_entity,
+                                 CEntity& c_sensing_root);
+
+      virtual ~CColoredBlobCameraLEDBatch() {}
+
+      /**
+       * Adds the LED to the batch if it is lit and does not belong to the sensing robot.
+       */
+      virtual bool operator()(CLEDEntity& c_led);
+
+      /**
+       * Empties the batch.
+       */
+      void Clear();
+
+      /**
+       * Keeps the LEDs that are in the ground range of an omnidirectional camera.
+       * The relative positions are expressed in the global frame.
+       * @param c_camera_pos The position of the camera.
+       * @param f_ground_half_range Half the side of the area seen on the ground.
+       */
+      void CullGroundRange(const CVector3& c_camera_pos,
+                           Real f_ground_half_range);
+
+      /**
+       * Keeps the LEDs that are in the viewing cone of a perspective camera.
+       * The relative positions are expressed in the camera frame.
+       * @param c_camera_pos The position of the camera.
+       * @param c_camera_orient The orientation of the camera.
+       * @param f_range The range of the camera.
+       * @param c_aperture The aperture of the camera.
+       */
+      void CullViewingCone(const CVector3& c_camera_pos,
+                           const CQuaternion& c_camera_orient,
+                           Real f_range,
+                           const CRadians& c_aperture);
+
+      /**
+       * Discards the LEDs hidden by an embodied entity.
+       * @param c_camera_pos The position of the camera.
+       */
+      void CullOccluded(const CVector3& c_camera_pos);
+
+      /**
+       * Returns the number of LEDs in the batch, visible or not.
+       */
+      inline size_t GetSize() const {
+         return m_vecLEDs.size();
+      }
+
+      /**
+       * Returns <tt>true</tt> if the i-th LED passed all the checks so far.
+       */
+      inline bool IsVisible(size_t un_idx) const {
+         return m_vecVisible[un_idx] != 0;
+      }
+
+      inline CLEDEntity& GetLED(size_t un_idx) {
+         return *m_vecLEDs[un_idx];
+      }
+
+      /**
+       * Returns the position of the i-th LED relative to the camera.
+       * The frame depends on the culling method used.
+       */
+      inline CVector3 GetRelativePosition(size_t un_idx) const {
+         return CVector3(m_vecRelX[un_idx],
+                         m_vecRelY[un_idx],
+                         m_vecRelZ[un_idx]);
+      }
+
+   private:
+
+      CEmbodiedEntity& m_cEmbodiedEntity;
+      CEntity* m_pcSensingRoot;
+      std::vector<CLEDEntity*> m_vecLEDs;
+      /* Global LED positions */
+      std::vector<Real> m_vecX;
+      std::vector<Real> m_vecY;
+      std::vector<Real> m_vecZ;
+      /* LED positions relative to the camera */
+      std::vector<Real> m_vecRelX;
+      std::vector<Real> m_vecRelY;
+      std::vector<Real> m_vecRelZ;
+      /* Bytes instead of bools, so the culling loops can be vectorized */
+      std::vector<UInt8> m_vecVisible;
+      /* Buffers for the occlusion check */
+      std::vector<CRay3> m_vecRays;
+      std::vector<size_t> m_vecRayLEDs;
+      std::vector<UInt8> m_vecOccluded;
+   };
+
+}
+
+#endif
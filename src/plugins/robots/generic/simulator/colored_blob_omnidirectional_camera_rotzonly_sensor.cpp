@@ -1,4 +1,5 @@
 #include "colored_blob_omnidirectional_camera_rotzonly_sensor.h"
+#include "colored_blob_camera_led_batch.h"
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/space/positional_indices/positional_index.h>
 #include <argos3/core/simulator/entity/composable_entity.h>
@@ -12,7 +13,7 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   class COmnidirectionalCameraLEDCheckOperation : public CPositionalIndex<CLEDEntity>::COperation {
+   class COmnidirectionalCameraLEDCheckOperation {
 
    public:
 
@@ -28,59 +29,25 @@ namespace argos {
          m_cEmbodiedEntity(c_embodied_entity),
          m_cControllableEntity(c_controllable_entity),
          m_bShowRays(b_show_rays),
+         m_cBatch(c_embodied_entity, c_embodied_entity.GetParent()),
          m_fDistanceNoiseStdDev(f_noise_std_dev),
          m_pcRNG(nullptr) {
-         m_pcRootSensingEntity = &m_cEmbodiedEntity.GetParent();
          if(m_fDistanceNoiseStdDev > 0.0f) {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
       }
-      virtual ~COmnidirectionalCameraLEDCheckOperation() {
+      ~COmnidirectionalCameraLEDCheckOperation() {
          while(! m_tBlobs.empty()) {
             delete m_tBlobs.back();
             m_tBlobs.pop_back();
          }
       }
 
-      virtual bool operator()(CLEDEntity& c_led) {
-         /* Process this LED only if it's lit */
-         if(c_led.GetColor() != CColor::BLACK) {
-            if(c_led.HasParent()) {
-               /* Filter out the LEDs belonging to the sensing entity by checking if they share the same parent entity */
-               m_pcRootOfLEDEntity = &c_led.GetParent();
-               while(m_pcRootOfLEDEntity->HasParent()) m_pcRootOfLEDEntity = &m_pcRootOfLEDEntity->GetParent();
-               if(m_pcRootSensingEntity == m_pcRootOfLEDEntity) {
-                  return true;
-               }
-            }
-            /* If we are here, it's because the LED must be processed */
-            m_cOcclusionCheckRay.SetEnd(c_led.GetPosition());
-            m_cLEDRelativePos = c_led.GetPosition();
-            m_cLEDRelativePos -= m_cCameraPos;
-            m_cLEDRelativePosXY.Set(m_cLEDRelativePos.GetX(),
-                                    m_cLEDRelativePos.GetY());
-            if(Abs(m_cLEDRelativePos.GetX()) < m_fGroundHalfRange &&
-               Abs(m_cLEDRelativePos.GetY()) < m_fGroundHalfRange &&
-               m_cLEDRelativePos.GetZ() < m_cCameraPos.GetZ() &&
-               !GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem,
-                                                         m_cOcclusionCheckRay,
-                                                         m_cEmbodiedEntity)) {
-               /* If noise was setup, add it */
-               if(m_fDistanceNoiseStdDev > 0.0f) {
-                  m_cLEDRelativePosXY += CVector2(
-                     m_cLEDRelativePosXY.Length() * m_pcRNG->Gaussian(m_fDistanceNoiseStdDev),
-                     m_pcRNG->Uniform(CRadians::UNSIGNED_RANGE));
-               }
-               m_tBlobs.push_back(new CCI_ColoredBlobOmnidirectionalCameraSensor::SBlob(
-                                     c_led.GetColor(),
-                                     NormalizedDifference(m_cLEDRelativePosXY.Angle(), m_cCameraOrient),
-                                     m_cLEDRelativePosXY.Length() * 100.0f));
-               if(m_bShowRays) {
-                  m_cControllableEntity.AddCheckedRay(false, CRay3(m_cCameraPos, c_led.GetPosition()));
-               }
-            }
-         }
-         return true;
+      /**
+       * Returns the operation that collects the LEDs from the index.
+       */
+      inline CColoredBlobCameraLEDBatch& GetBatch() {
+         return m_cBatch;
       }
 
       void Setup(Real f_ground_half_range) {
@@ -88,11 +55,39 @@ namespace argos {
             delete m_tBlobs.back();
             m_tBlobs.pop_back();
          }
+         m_cBatch.Clear();
          m_fGroundHalfRange = f_ground_half_range;
          m_cEmbodiedEntity.GetOriginAnchor().Orientation.ToEulerAngles(m_cCameraOrient, m_cTmp1, m_cTmp2);
          m_cCameraPos = m_cEmbodiedEntity.GetOriginAnchor().Position;
          m_cCameraPos += m_cOmnicamEntity.GetOffset();
-         m_cOcclusionCheckRay.SetStart(m_cCameraPos);
+      }
+
+      /**
+       * Checks the collected LEDs and makes the blobs of the visible ones.
+       */
+      void Process() {
+         m_cBatch.CullGroundRange(m_cCameraPos, m_fGroundHalfRange);
+         m_cBatch.CullOccluded(m_cCameraPos);
+         for(size_t i = 0; i < m_cBatch.GetSize(); ++i) {
+            if(! m_cBatch.IsVisible(i)) continue;
+            CLEDEntity& cLED = m_cBatch.GetLED(i);
+            m_cLEDRelativePos = m_cBatch.GetRelativePosition(i);
+            m_cLEDRelativePosXY.Set(m_cLEDRelativePos.GetX(),
+                                    m_cLEDRelativePos.GetY());
+            /* If noise was setup, add it */
+            if(m_fDistanceNoiseStdDev > 0.0f) {
+               m_cLEDRelativePosXY += CVector2(
+                  m_cLEDRelativePosXY.Length() * m_pcRNG->Gaussian(m_fDistanceNoiseStdDev),
+                  m_pcRNG->Uniform(CRadians::UNSIGNED_RANGE));
+            }
+            m_tBlobs.push_back(new CCI_ColoredBlobOmnidirectionalCameraSensor::SBlob(
+                                  cLED.GetColor(),
+                                  NormalizedDifference(m_cLEDRelativePosXY.Angle(), m_cCameraOrient),
+                                  m_cLEDRelativePosXY.Length() * 100.0f));
+            if(m_bShowRays) {
+               m_cControllableEntity.AddCheckedRay(false, CRay3(m_cCameraPos, cLED.GetPosition()));
+            }
+         }
       }
       
    private:
@@ -103,15 +98,12 @@ namespace argos {
       CControllableEntity& m_cControllableEntity;
       Real m_fGroundHalfRange;
       bool m_bShowRays;
-      CEntity* m_pcRootSensingEntity;
-      CEntity* m_pcRootOfLEDEntity;
+      CColoredBlobCameraLEDBatch m_cBatch;
       CVector3 m_cCameraPos;
       CRadians m_cCameraOrient;
       CRadians m_cTmp1, m_cTmp2;
       CVector3 m_cLEDRelativePos;
       CVector2 m_cLEDRelativePosXY;
-      SEmbodiedEntityIntersectionItem m_sIntersectionItem;
-      CRay3 m_cOcclusionCheckRay;
       Real m_fDistanceNoiseStdDev;
       CRandom::CRNG* m_pcRNG;
    };
@@ -195,13 +187,15 @@ namespace argos {
       Real fGroundHalfRange = cCameraPos.GetZ() * Tan(m_pcOmnicamEntity->GetAperture());
       /* Prepare the operation */
       m_pcOperation->Setup(fGroundHalfRange);
-      /* Go through LED entities in box range */
+      /* Collect the LED entities in box range */
       m_pcLEDIndex->ForEntitiesInBoxRange(
          CVector3(cCameraPos.GetX(),
                   cCameraPos.GetY(),
                   cCameraPos.GetZ() * 0.5f),
          CVector3(fGroundHalfRange, fGroundHalfRange, cCameraPos.GetZ() * 0.5f),
-         *m_pcOperation);
+         m_pcOperation->GetBatch());
+      /* Check them all at once */
+      m_pcOperation->Process();
    }
 
    /****************************************/
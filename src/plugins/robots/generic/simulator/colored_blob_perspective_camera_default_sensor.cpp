@@ -1,4 +1,5 @@
 #include "colored_blob_perspective_camera_default_sensor.h"
+#include "colored_blob_camera_led_batch.h"
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/space/positional_indices/positional_index.h>
 #include <argos3/core/simulator/entity/composable_entity.h>
@@ -12,7 +13,7 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   class CPerspectiveCameraLEDCheckOperation : public CPositionalIndex<CLEDEntity>::COperation {
+   class CPerspectiveCameraLEDCheckOperation {
 
    public:
 
@@ -28,94 +29,91 @@ namespace argos {
          m_cEmbodiedEntity(c_embodied_entity),
          m_cControllableEntity(c_controllable_entity),
          m_bShowRays(b_show_rays),
+         m_cBatch(c_embodied_entity, c_embodied_entity.GetRootEntity()),
          m_fNoiseStdDev(f_noise_std_dev),
          m_pcRNG(nullptr) {
-         m_pcRootSensingEntity = &m_cEmbodiedEntity.GetRootEntity();
          if(m_fNoiseStdDev > 0.0f) {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
       }
-      virtual ~CPerspectiveCameraLEDCheckOperation() {
+      ~CPerspectiveCameraLEDCheckOperation() {
          while(! m_tBlobs.empty()) {
             delete m_tBlobs.back();
             m_tBlobs.pop_back();
          }
       }
 
-      virtual bool operator()(CLEDEntity& c_led) {
-         /* Process this LED only if it's lit */
-         if(c_led.GetColor() != CColor::BLACK) {
-            /* Filter out the LEDs belonging to the sensing entity by checking if they share the same parent entity */
-            if(m_pcRootSensingEntity == &c_led.GetRootEntity()) return true;
-            /* If we are here, it's because the LED must be processed */
-            /* Set the end of the ray for occlusion checking */
-            m_cOcclusionCheckRay.SetEnd(c_led.GetPosition());
-            /* Calculate the vector to LED in the camera-anchor frame of reference */
-            m_cLEDRelative = c_led.GetPosition();
-            m_cLEDRelative -= m_cCamEntity.GetAnchor().Position;
-            m_cLEDRelative.Rotate(m_cInvCameraOrient);
-            /* Calculate the projection of the LED vector into the camera direction */
-            Real fDotProd = m_cLEDRelative.GetX();
-            /* The blob is visible if
-             * 1. It is within the distance range AND
-             * 2. It is within the aperture range AND
-             * 3. There are no occlusions
-             */
-            if(fDotProd < m_cCamEntity.GetRange() &&
-               ACos(fDotProd / m_cLEDRelative.Length()) < m_cCamEntity.GetAperture() &&
-               !GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem,
-                                                         m_cOcclusionCheckRay,
-                                                         m_cEmbodiedEntity)) {
-               /* The LED is visibile */
-               /* Calculate the intersection point between the LED ray and the image plane */
-               m_cLEDRelative.Normalize();
-               m_cLEDRelative *= m_cCamEntity.GetFocalLength() / m_cLEDRelative.GetX();
-               /*
-                * The image plane is perpendicular to the local X axis
-                * Y points to the left, Z up, the origin is in the image center
-                * To find the pixel (i,j), we need to flip both Y and Z, and translate the origin
-                * So that the origin is up-left, the i axis goes to the right, and the j axis goes down
-                */
-               SInt32 nI =
-                  static_cast<SInt32>(- m_cCamEntity.GetImagePxWidth() /
-                  m_cCamEntity.GetImageMtWidth() *
-                  (m_cLEDRelative.GetY() -
-                   m_cCamEntity.GetImageMtWidth() * 0.5f));
-               SInt32 nJ =
-                  static_cast<SInt32>(- m_cCamEntity.GetImagePxHeight() /
-                  m_cCamEntity.GetImageMtHeight() *
-                  (m_cLEDRelative.GetZ() -
-                   m_cCamEntity.GetImageMtHeight() * 0.5f));
-               /* Make sure (i,j) is within the limits */
-               if((nI >= m_cCamEntity.GetImagePxWidth() || nI < 0) ||
-                  (nJ >= m_cCamEntity.GetImagePxHeight() || nJ < 0))
-                  return true;
-               /* Add new blob */
-               m_tBlobs.push_back(
-                  new CCI_ColoredBlobPerspectiveCameraSensor::SBlob(
-                     c_led.GetColor(), nI, nJ));
-               /* Draw ray */
-               if(m_bShowRays) {
-                  m_cControllableEntity.AddCheckedRay(
-                     false,
-                     CRay3(m_cCamEntity.GetAnchor().Position,
-                           c_led.GetPosition()));
-               }
-            }
-         }
-         return true;
+      /**
+       * Returns the operation that collects the LEDs from the index.
+       */
+      inline CColoredBlobCameraLEDBatch& GetBatch() {
+         return m_cBatch;
       }
-      
+
       void Setup() {
          /* Erase blobs */
          while(! m_tBlobs.empty()) {
             delete m_tBlobs.back();
             m_tBlobs.pop_back();
          }
-         /* Reset ray start */
-         m_cOcclusionCheckRay.SetStart(m_cCamEntity.GetAnchor().Position);
-         /* Calculate inverse of camera orientation */
-         m_cInvCameraOrient = m_cCamEntity.GetAnchor().Orientation.Inverse();
+         /* Empty the batch */
+         m_cBatch.Clear();
+      }
+
+      /**
+       * Checks the collected LEDs and makes the blobs of the visible ones.
+       */
+      void Process() {
+         /* The blob is visible if
+          * 1. It is within the distance range AND
+          * 2. It is within the aperture range AND
+          * 3. There are no occlusions
+          */
+         m_cBatch.CullViewingCone(m_cCamEntity.GetAnchor().Position,
+                                  m_cCamEntity.GetAnchor().Orientation,
+                                  m_cCamEntity.GetRange(),
+                                  m_cCamEntity.GetAperture());
+         m_cBatch.CullOccluded(m_cCamEntity.GetAnchor().Position);
+         for(size_t i = 0; i < m_cBatch.GetSize(); ++i) {
+            if(! m_cBatch.IsVisible(i)) continue;
+            /* The LED is visibile */
+            CLEDEntity& cLED = m_cBatch.GetLED(i);
+            /* Calculate the intersection point between the LED ray and the image plane */
+            m_cLEDRelative = m_cBatch.GetRelativePosition(i);
+            m_cLEDRelative.Normalize();
+            m_cLEDRelative *= m_cCamEntity.GetFocalLength() / m_cLEDRelative.GetX();
+            /*
+             * The image plane is perpendicular to the local X axis
+             * Y points to the left, Z up, the origin is in the image center
+             * To find the pixel (i,j), we need to flip both Y and Z, and translate the origin
+             * So that the origin is up-left, the i axis goes to the right, and the j axis goes down
+             */
+            SInt32 nI =
+               static_cast<SInt32>(- m_cCamEntity.GetImagePxWidth() /
+               m_cCamEntity.GetImageMtWidth() *
+               (m_cLEDRelative.GetY() -
+                m_cCamEntity.GetImageMtWidth() * 0.5f));
+            SInt32 nJ =
+               static_cast<SInt32>(- m_cCamEntity.GetImagePxHeight() /
+               m_cCamEntity.GetImageMtHeight() *
+               (m_cLEDRelative.GetZ() -
+                m_cCamEntity.GetImageMtHeight() * 0.5f));
+            /* Make sure (i,j) is within the limits */
+            if((nI >= m_cCamEntity.GetImagePxWidth() || nI < 0) ||
+               (nJ >= m_cCamEntity.GetImagePxHeight() || nJ < 0))
+               continue;
+            /* Add new blob */
+            m_tBlobs.push_back(
+               new CCI_ColoredBlobPerspectiveCameraSensor::SBlob(
+                  cLED.GetColor(), nI, nJ));
+            /* Draw ray */
+            if(m_bShowRays) {
+               m_cControllableEntity.AddCheckedRay(
+                  false,
+                  CRay3(m_cCamEntity.GetAnchor().Position,
+                        cLED.GetPosition()));
+            }
+         }
       }
       
    private:
@@ -124,13 +122,9 @@ namespace argos {
       CPerspectiveCameraEquippedEntity& m_cCamEntity;
       CEmbodiedEntity& m_cEmbodiedEntity;
       CControllableEntity& m_cControllableEntity;
-      CQuaternion m_cInvCameraOrient;
       bool m_bShowRays;
-      CEntity* m_pcRootSensingEntity;
-      CRadians m_cTmp1, m_cTmp2;
+      CColoredBlobCameraLEDBatch m_cBatch;
       CVector3 m_cLEDRelative;
-      SEmbodiedEntityIntersectionItem m_sIntersectionItem;
-      CRay3 m_cOcclusionCheckRay;
       Real m_fNoiseStdDev;
       CRandom::CRNG* m_pcRNG;
    };
@@ -223,9 +217,11 @@ namespace argos {
          Abs(cCorner.GetX()),
          Abs(cCorner.GetY()),
          Abs(cCorner.GetZ()));
-      /* Go through LED entities in box range */
+      /* Collect the LED entities in box range */
       m_pcLEDIndex->ForEntitiesInBoxRange(
-         cCenter, cHalfSize, *m_pcOperation);
+         cCenter, cHalfSize, m_pcOperation->GetBatch());
+      /* Check them all at once */
+      m_pcOperation->Process();
    }
 
    /****************************************/
@@ -10,6 +10,8 @@
 #include <argos3/plugins/simulator/entities/light_entity.h>
 #include <argos3/plugins/simulator/entities/light_sensor_equipped_entity.h>
 
+#include <argos3/plugins/simulator/media/light_visibility_medium.h>
+
 #include "light_default_sensor.h"
 
 namespace argos {
@@ -26,6 +28,7 @@ namespace argos {
       m_bShowRays(false),
       m_pcRNG(nullptr),
       m_bAddNoise(false),
+      m_pcLightVisibilityMedium(nullptr),
       m_cSpace(CSimulator::GetInstance().GetSpace()) {}
 
    /****************************************/
@@ -33,6 +36,7 @@ namespace argos {
 
    void CLightDefaultSensor::SetRobot(CComposableEntity& c_entity) {
       try {
+         m_pcEmbodiedEntity = &(c_entity.GetComponent<CEmbodiedEntity>("body"));
          m_pcControllableEntity = &(c_entity.GetComponent<CControllableEntity>("controller"));
          m_pcLightEntity = &(c_entity.GetComponent<CLightSensorEquippedEntity>("light_sensors"));
          m_pcLightEntity->Enable();
@@ -62,6 +66,12 @@ namespace argos {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
          m_tReadings.resize(m_pcLightEntity->GetNumSensors());
+         /* Get the light visibility medium, if any */
+         std::string strMedium;
+         GetNodeAttributeOrDefault(t_tree, "medium", strMedium, strMedium);
+         if(!strMedium.empty()) {
+            m_pcLightVisibilityMedium = &(CSimulator::GetInstance().GetMedium<CLightVisibilityMedium>(strMedium));
+         }
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Initialization error in default light sensor", ex);
@@ -86,10 +96,24 @@ namespace argos {
       CVector3 cSensorToLight;
       /* Buffers to contain data about the intersection */
       SEmbodiedEntityIntersectionItem sIntersection;
-      /* Get the map of light entities */
-      auto itLights = m_cSpace.GetEntityMapPerTypePerId().find("light");
-      if (itLights != m_cSpace.GetEntityMapPerTypePerId().end()) {
-         CSpace::TMapPerType& mapLights = itLights->second;
+      /* Get the light entities, from the medium if any */
+      if(m_pcLightVisibilityMedium == nullptr) {
+         m_vecLights.clear();
+         auto itLights = m_cSpace.GetEntityMapPerTypePerId().find("light");
+         if(itLights != m_cSpace.GetEntityMapPerTypePerId().end()) {
+            for(auto it = itLights->second.begin();
+                it != itLights->second.end();
+                ++it) {
+               m_vecLights.push_back(any_cast<CLightEntity*>(it->second));
+            }
+         }
+      }
+      const std::vector<CLightEntity*>& vecLights =
+         (m_pcLightVisibilityMedium != nullptr) ? m_pcLightVisibilityMedium->GetLights() : m_vecLights;
+      /* The shadow map does not give the intersection points to draw */
+      bool bUseShadowMap =
+         (m_pcLightVisibilityMedium != nullptr) && m_pcLightVisibilityMedium->HasShadowMap() && !m_bShowRays;
+      if(! vecLights.empty()) {
          /* Go through the sensors */
          for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
             /* Set ray start */
@@ -97,18 +121,18 @@ namespace argos {
             cRayStart.Rotate(m_pcLightEntity->GetSensor(i).Anchor.Orientation);
             cRayStart += m_pcLightEntity->GetSensor(i).Anchor.Position;
             /* Go through all the light entities */
-            for(auto it = mapLights.begin();
-                it != mapLights.end();
-                ++it) {
+            for(size_t j = 0; j < vecLights.size(); ++j) {
                /* Get a reference to the light */
-               CLightEntity& cLight = *any_cast<CLightEntity*>(it->second);
+               CLightEntity& cLight = *vecLights[j];
                /* Consider the light only if it has non zero intensity */
                if(cLight.GetIntensity() > 0.0f) {
                   /* Set ray end to light position */
                   cScanningRay.Set(cRayStart, cLight.GetPosition());
                   /* Check occlusions */
-                  if(! GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
-                                                                cScanningRay)) {
+                  bool bOccluded = bUseShadowMap ?
+                     m_pcLightVisibilityMedium->IsOccluded(j, cScanningRay, sIntersection, *m_pcEmbodiedEntity) :
+                     GetClosestEmbodiedEntityIntersectedByRay(sIntersection, cScanningRay);
+                  if(! bOccluded) {
                      /* No occlusion, the light is visibile */
                      if(m_bShowRays) {
                         m_pcControllableEntity->AddCheckedRay(false, cScanningRay);
@@ -249,6 +273,29 @@ namespace argos {
                    "    ...\n"
                    "  </controllers>\n\n"
 
+                   "In large swarms, the sensors can share the list of the lights through a\n"
+                   "light visibility medium, referred to by the attribute \"medium\". When the\n"
+                   "lights and the obstacles never move, the medium can also keep a shadow map\n"
+                   "that avoids most of the occlusion checks; see the documentation of the\n"
+                   "\"light_visibility\" medium. With the shadow map, the body of the robot does\n"
+                   "not occlude its own sensors. The shadow map is not used when the rays are\n"
+                   "drawn.\n\n"
+
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <light implementation=\"default\"\n"
+                   "                   medium=\"lights\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
+                   "  </controllers>\n\n"
+
                    "OPTIMIZATION HINTS\n\n"
 
                    "1. For small swarms, enabling the light sensor (and therefore causing ARGoS to\n"
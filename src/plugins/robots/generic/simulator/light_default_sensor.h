@@ -13,6 +13,8 @@
 namespace argos {
    class CLightDefaultSensor;
    class CLightSensorEquippedEntity;
+   class CLightVisibilityMedium;
+   class CLightEntity;
 }
 
 #include <argos3/plugins/robots/generic/control_interface/ci_light_sensor.h>
@@ -72,6 +74,9 @@ namespace argos {
       /** Reference to light sensor equipped entity associated to this sensor */
       CLightSensorEquippedEntity* m_pcLightEntity;
 
+      /** Reference to embodied entity associated to this sensor */
+      CEmbodiedEntity* m_pcEmbodiedEntity;
+
       /** Reference to controllable entity associated to this sensor */
       CControllableEntity* m_pcControllableEntity;
 
@@ -87,6 +92,12 @@ namespace argos {
       /** Noise range */
       CRange<Real> m_cNoiseRange;
 
+      /** The light visibility medium, or nullptr */
+      CLightVisibilityMedium* m_pcLightVisibilityMedium;
+
+      /** The lights, when there is no light visibility medium */
+      std::vector<CLightEntity*> m_vecLights;
+
       /** Reference to the space */
       CSpace& m_cSpace;
    };
@@ -7,6 +7,7 @@
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/entity/embodied_entity.h>
 #include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/utility/math/transforms.h>
 #include <argos3/plugins/simulator/entities/proximity_sensor_equipped_entity.h>
 
 #include "proximity_default_sensor.h"
@@ -81,46 +82,59 @@ namespace argos {
       }
       /* Ray used for scanning the environment for obstacles */
       CRay3 cScanningRay;
-      CVector3 cRayStart, cRayEnd;
       /* Buffers to contain data about the intersection */
       SEmbodiedEntityIntersectionItem sIntersection;
-      /* Go through the sensors */
-      for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
-         /* Compute ray for sensor i */
-         cRayStart = m_pcProximityEntity->GetSensor(i).Offset;
-         cRayStart.Rotate(m_pcProximityEntity->GetSensor(i).Anchor.Orientation);
-         cRayStart += m_pcProximityEntity->GetSensor(i).Anchor.Position;
-         cRayEnd = m_pcProximityEntity->GetSensor(i).Offset;
-         cRayEnd += m_pcProximityEntity->GetSensor(i).Direction;
-         cRayEnd.Rotate(m_pcProximityEntity->GetSensor(i).Anchor.Orientation);
-         cRayEnd += m_pcProximityEntity->GetSensor(i).Anchor.Position;
-         cScanningRay.Set(cRayStart,cRayEnd);
-         /* Compute reading */
-         /* Get the closest intersection */
-         if(GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
-                                                     cScanningRay,
-                                                     *m_pcEmbodiedEntity)) {
-            /* There is an intersection */
-            if(m_bShowRays) {
-               m_pcControllableEntity->AddIntersectionPoint(cScanningRay,
-                                                            sIntersection.TOnRay);
-               m_pcControllableEntity->AddCheckedRay(true, cScanningRay);
-            }
-            m_tReadings[i] = CalculateReading(cScanningRay.GetDistance(sIntersection.TOnRay));
+      /* Go through the sensors, a group of consecutive sensors on the same anchor at a time */
+      UInt32 unFirst = 0;
+      while(unFirst < m_tReadings.size()) {
+         const SAnchor& sAnchor = m_pcProximityEntity->GetSensor(unFirst).Anchor;
+         UInt32 unLast = unFirst + 1;
+         while(unLast < m_tReadings.size() &&
+               &m_pcProximityEntity->GetSensor(unLast).Anchor == &sAnchor) {
+            ++unLast;
          }
-         else {
-            /* No intersection */
-            m_tReadings[i] = 0.0f;
-            if(m_bShowRays) {
-               m_pcControllableEntity->AddCheckedRay(false, cScanningRay);
-            }
+         /* Compute the rays of the group with one batch transform: the
+            starts come first, then the ends */
+         UInt32 unSensors = unLast - unFirst;
+         m_cRayPoints.Resize(2 * unSensors);
+         for(UInt32 j = 0; j < unSensors; ++j) {
+            const CProximitySensorEquippedEntity::SSensor& sSensor =
+               m_pcProximityEntity->GetSensor(unFirst + j);
+            m_cRayPoints.Set(j, sSensor.Offset);
+            m_cRayPoints.Set(unSensors + j, sSensor.Offset + sSensor.Direction);
          }
-         /* Apply noise to the sensor */
-         if(m_bAddNoise) {
-            m_tReadings[i] += m_pcRNG->Uniform(m_cNoiseRange);
+         LocalToGlobal(m_cRayPoints, sAnchor.Position, sAnchor.Orientation);
+         for(UInt32 j = 0; j < unSensors; ++j) {
+            UInt32 i = unFirst + j;
+            cScanningRay.Set(m_cRayPoints.Get(j), m_cRayPoints.Get(unSensors + j));
+            /* Compute reading */
+            /* Get the closest intersection */
+            if(GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
+                                                        cScanningRay,
+                                                        *m_pcEmbodiedEntity)) {
+               /* There is an intersection */
+               if(m_bShowRays) {
+                  m_pcControllableEntity->AddIntersectionPoint(cScanningRay,
+                                                               sIntersection.TOnRay);
+                  m_pcControllableEntity->AddCheckedRay(true, cScanningRay);
+               }
+               m_tReadings[i] = CalculateReading(cScanningRay.GetDistance(sIntersection.TOnRay));
+            }
+            else {
+               /* No intersection */
+               m_tReadings[i] = 0.0f;
+               if(m_bShowRays) {
+                  m_pcControllableEntity->AddCheckedRay(false, cScanningRay);
+               }
+            }
+            /* Apply noise to the sensor */
+            if(m_bAddNoise) {
+               m_tReadings[i] += m_pcRNG->Uniform(m_cNoiseRange);
+            }
+            /* Trunc the reading between 0 and 1 */
+            UNIT.TruncValue(m_tReadings[i]);
          }
-         /* Trunc the reading between 0 and 1 */
-         UNIT.TruncValue(m_tReadings[i]);
+         unFirst = unLast;
       }
    }
 
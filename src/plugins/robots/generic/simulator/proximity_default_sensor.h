@@ -18,6 +18,7 @@ namespace argos {
 #include <argos3/plugins/robots/generic/control_interface/ci_proximity_sensor.h>
 #include <argos3/core/utility/math/range.h>
 #include <argos3/core/utility/math/rng.h>
+#include <argos3/core/utility/math/vector3_array.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/sensor.h>
 
@@ -88,6 +89,9 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** The ends of the rays of a group of sensors, for the batch transforms */
+      CVector3Array m_cRayPoints;
    };
 
 }
@@ -77,72 +77,90 @@ namespace argos {
       if (IsDisabled()) {
         return;
       }
-      /** TODO: there's a more efficient way to implement this */
-      /* Delete old readings */
-      m_tReadings.clear();
+      /*
+       * The readings of the previous step are overwritten in place, so that
+       * their payload buffers are reused and, once the number of neighbors
+       * settles, no memory is allocated
+       */
+      size_t unReadings = 0;
       /* Get list of communicating RABs */
       const CSet<CRABEquippedEntity*,SEntityComparator>& setRABs = m_pcRangeAndBearingMedium->GetRABsCommunicatingWith(*m_pcRangeAndBearingEquippedEntity);
+      /* Position and inverse orientation of the receiver, the same for all the packets */
+      const CVector3& cPosition = m_pcRangeAndBearingEquippedEntity->GetPosition();
+      CQuaternion cInvOrientation = m_pcRangeAndBearingEquippedEntity->GetOrientation().Inverse();
+      /* Which kinds of noise are applied */
+      bool bDropPackets = (m_pcRNG != nullptr && m_fPacketDropProb > 0.0f);
+      bool bDistanceNoise = (m_pcRNG != nullptr && m_fDistanceNoiseStdDev > 0.0f);
       /* Buffer for calculating the message--robot distance */
       CVector3 cVectorRobotToMessage;
-      /* Buffer for the received packet */
-      CCI_RangeAndBearingSensor::SPacket sPacket;
       /* Go through communicating RABs and create packets */
       for(CSet<CRABEquippedEntity*>::iterator it = setRABs.begin();
           it != setRABs.end(); ++it) {
          /* Should we drop this packet? */
-         if(m_pcRNG == nullptr || /* No noise to apply */
-            !(m_fPacketDropProb > 0.0f &&
-              m_pcRNG->Bernoulli(m_fPacketDropProb)) /* Packet is not dropped */
-            ) {
-            /* Create a reference to the RAB entity to process */
-            CRABEquippedEntity& cRABEntity = **it;
-            /* Add ray if requested */
-            if(m_bShowRays) {
-               m_pcControllableEntity->AddCheckedRay(false,
-                                                     CRay3(cRABEntity.GetPosition(),
-                                                           m_pcRangeAndBearingEquippedEntity->GetPosition()));
-            }
-            /* Calculate vector to entity */
-            cVectorRobotToMessage = cRABEntity.GetPosition();
-            cVectorRobotToMessage -= m_pcRangeAndBearingEquippedEntity->GetPosition();
-            /* If noise was setup, add it */
-            if(m_pcRNG && m_fDistanceNoiseStdDev > 0.0f) {
-               cVectorRobotToMessage += CVector3(
-                  m_pcRNG->Gaussian(m_fDistanceNoiseStdDev),
-                  m_pcRNG->Uniform(INCLINATION_RANGE),
-                  m_pcRNG->Uniform(CRadians::UNSIGNED_RANGE));
+         if(bDropPackets && m_pcRNG->Bernoulli(m_fPacketDropProb)) {
+            continue;
+         }
+         /* Create a reference to the RAB entity to process */
+         CRABEquippedEntity& cRABEntity = **it;
+         /* Add ray if requested */
+         if(m_bShowRays) {
+            m_pcControllableEntity->AddCheckedRay(false,
+                                                  CRay3(cRABEntity.GetPosition(),
+                                                        cPosition));
+         }
+         /* Calculate vector to entity */
+         cVectorRobotToMessage = cRABEntity.GetPosition();
+         cVectorRobotToMessage -= cPosition;
+         /* If noise was setup, add it */
+         if(bDistanceNoise) {
+            cVectorRobotToMessage += CVector3(
+               m_pcRNG->Gaussian(m_fDistanceNoiseStdDev),
+               m_pcRNG->Uniform(INCLINATION_RANGE),
+               m_pcRNG->Uniform(CRadians::UNSIGNED_RANGE));
+         }
+         /* Get the reading to fill, recycling a payload buffer if a new one is needed */
+         if(unReadings == m_tReadings.size()) {
+            m_tReadings.emplace_back();
+            if(!m_vecSparePayloads.empty()) {
+               m_tReadings.back().Data = std::move(m_vecSparePayloads.back());
+               m_vecSparePayloads.pop_back();
             }
-            /*
-             * Set range and bearing from cVectorRobotToMessage
-             * First, we must rotate the cVectorRobotToMessage so that
-             * it is local to the robot coordinate system. To do this,
-             * it enough to rotate cVectorRobotToMessage by the inverse
-             * of the robot orientation.
-             */
-            cVectorRobotToMessage.Rotate(m_pcRangeAndBearingEquippedEntity->GetOrientation().Inverse());
-            cVectorRobotToMessage.ToSphericalCoords(sPacket.Range,
-                                                    sPacket.VerticalBearing,
-                                                    sPacket.HorizontalBearing);
-            /* Convert range to cm */
-            sPacket.Range *= 100.0f;
-            /* Normalize horizontal bearing between [-pi,pi] */
-            sPacket.HorizontalBearing.SignedNormalize();
-            /*
-             * The vertical bearing is defined as the angle between the local
-             * robot XY plane and the message source position, i.e., the elevation
-             * in math jargon. However, cVectorRobotToMessage.ToSphericalCoords()
-             * sets sPacket.VerticalBearing to the inclination, which is the angle
-             * between the azimuth vector (robot local Z axis) and
-             * cVectorRobotToMessage. Elevation = 90 degrees - Inclination.
-             */
-            sPacket.VerticalBearing.Negate();
-            sPacket.VerticalBearing += CRadians::PI_OVER_TWO;
-            sPacket.VerticalBearing.SignedNormalize();
-            /* Set message data */
-            sPacket.Data = cRABEntity.GetData();
-            /* Add message to the list */
-            m_tReadings.push_back(sPacket);
          }
+         CCI_RangeAndBearingSensor::SPacket& sPacket = m_tReadings[unReadings];
+         ++unReadings;
+         /*
+          * Set range and bearing from cVectorRobotToMessage
+          * First, we must rotate the cVectorRobotToMessage so that
+          * it is local to the robot coordinate system. To do this,
+          * it enough to rotate cVectorRobotToMessage by the inverse
+          * of the robot orientation.
+          */
+         cVectorRobotToMessage.Rotate(cInvOrientation);
+         cVectorRobotToMessage.ToSphericalCoords(sPacket.Range,
+                                                 sPacket.VerticalBearing,
+                                                 sPacket.HorizontalBearing);
+         /* Convert range to cm */
+         sPacket.Range *= 100.0f;
+         /* Normalize horizontal bearing between [-pi,pi] */
+         sPacket.HorizontalBearing.SignedNormalize();
+         /*
+          * The vertical bearing is defined as the angle between the local
+          * robot XY plane and the message source position, i.e., the elevation
+          * in math jargon. However, cVectorRobotToMessage.ToSphericalCoords()
+          * sets sPacket.VerticalBearing to the inclination, which is the angle
+          * between the azimuth vector (robot local Z axis) and
+          * cVectorRobotToMessage. Elevation = 90 degrees - Inclination.
+          */
+         sPacket.VerticalBearing.Negate();
+         sPacket.VerticalBearing += CRadians::PI_OVER_TWO;
+         sPacket.VerticalBearing.SignedNormalize();
+         /* Set message data, reusing the buffer of the reading */
+         sPacket.Data = cRABEntity.GetData();
+      }
+      /* Keep the payload buffers of the readings left over from the previous step */
+      while(m_tReadings.size() > unReadings) {
+         m_vecSparePayloads.push_back(std::move(m_tReadings.back().Data));
+         m_tReadings.pop_back();
       }
    }
       
@@ -72,6 +72,8 @@ namespace argos {
       CRandom::CRNG*       m_pcRNG;
       CSpace&              m_cSpace;
       bool                 m_bShowRays;
+      /** Payload buffers of the readings dropped in past steps, reused when the readings grow again */
+      std::vector<CByteArray> m_vecSparePayloads;
    };
 }
 
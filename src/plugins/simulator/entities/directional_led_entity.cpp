@@ -155,6 +155,30 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CDirectionalLEDEntitySpatialHashUpdater::CDirectionalLEDEntitySpatialHashUpdater(CSpatialHash<CDirectionalLEDEntity>& c_hash) :
+      m_cHash(c_hash) {}
+
+   /****************************************/
+   /****************************************/
+
+   bool CDirectionalLEDEntitySpatialHashUpdater::operator()(CDirectionalLEDEntity& c_entity) {
+      try {
+         /* Calculate the position of the LED in the spatial hash */
+         m_cHash.PositionToCell(m_nI, m_nJ, m_nK, c_entity.GetPosition());
+         /* Update the corresponding cell */
+         m_cHash.UpdateCell(m_nI, m_nJ, m_nK, c_entity);
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("While updating the directional LED spatial hash for LED \"" <<
+                                     c_entity.GetContext() + c_entity.GetId() << "\"", ex);
+      }
+      /* Continue with the other entities */
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
    class CSpaceOperationAddCDirectionalLEDEntity : public CSpaceOperationAddEntity {
    public:
       void ApplyTo(CSpace& c_space, CDirectionalLEDEntity& c_entity) {
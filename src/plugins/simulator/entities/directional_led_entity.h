@@ -18,6 +18,7 @@ namespace argos {
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/core/simulator/space/positional_indices/space_hash.h>
 #include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/simulator/space/positional_indices/spatial_hash.h>
 
 namespace argos {
 
@@ -170,6 +171,23 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   class CDirectionalLEDEntitySpatialHashUpdater : public CSpatialHash<CDirectionalLEDEntity>::COperation {
+
+   public:
+
+      CDirectionalLEDEntitySpatialHashUpdater(CSpatialHash<CDirectionalLEDEntity>& c_hash);
+      virtual bool operator()(CDirectionalLEDEntity& c_entity);
+
+   private:
+
+      CSpatialHash<CDirectionalLEDEntity>& m_cHash;
+      SInt32 m_nI, m_nJ, m_nK;
+
+   };
+
+   /****************************************/
+   /****************************************/
+
 }
 
 #endif
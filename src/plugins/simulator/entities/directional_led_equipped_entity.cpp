@@ -21,7 +21,8 @@ namespace argos {
       LED(c_led),
       Anchor(s_anchor),
       PositionOffset(c_position_offset),
-      OrientationOffset(c_orientation_offset) {}
+      OrientationOffset(c_orientation_offset),
+      AnchorVersion(0) {}
 
    /****************************************/
    /****************************************/
@@ -219,13 +220,16 @@ namespace argos {
       CVector3 cLEDPosition;
       CQuaternion cLEDOrientation;
       for(SInstance& s_instance : m_vecInstances) {
-         if(s_instance.LED.IsEnabled()) {
+         /* Skip the instances whose anchor did not move */
+         if(s_instance.LED.IsEnabled() &&
+            s_instance.AnchorVersion != s_instance.Anchor.Version) {
             cLEDPosition = s_instance.PositionOffset;
             cLEDPosition.Rotate(s_instance.Anchor.Orientation);
             cLEDPosition += s_instance.Anchor.Position;
             cLEDOrientation = s_instance.Anchor.Orientation *
                s_instance.OrientationOffset;
             s_instance.LED.MoveTo(cLEDPosition, cLEDOrientation);
+            s_instance.AnchorVersion = s_instance.Anchor.Version;
          }
       }
    }
@@ -150,6 +150,32 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CLEDEntitySpatialHashUpdater::CLEDEntitySpatialHashUpdater(CSpatialHash<CLEDEntity>& c_hash) :
+      m_cHash(c_hash) {}
+
+   /****************************************/
+   /****************************************/
+
+   bool CLEDEntitySpatialHashUpdater::operator()(CLEDEntity& c_entity) {
+      /* Discard disabled and switched off LEDs */
+      if(c_entity.GetColor() != CColor::BLACK) {
+         try {
+            /* Calculate the position of the LED in the spatial hash */
+            m_cHash.PositionToCell(m_nI, m_nJ, m_nK, c_entity.GetPosition());
+            /* Update the corresponding cell */
+            m_cHash.UpdateCell(m_nI, m_nJ, m_nK, c_entity);
+         }
+         catch(CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("While updating the LED spatial hash for LED \"" << c_entity.GetContext() << c_entity.GetId() << "\"", ex);
+         }
+      }
+      /* Continue with the other entities */
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
    class CSpaceOperationAddCLEDEntity : public CSpaceOperationAddEntity {
    public:
       void ApplyTo(CSpace& c_space, CLEDEntity& c_entity) {
@@ -18,6 +18,7 @@ namespace argos {
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/core/simulator/space/positional_indices/space_hash.h>
 #include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/simulator/space/positional_indices/spatial_hash.h>
 
 namespace argos {
 
@@ -159,6 +160,23 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   class CLEDEntitySpatialHashUpdater : public CSpatialHash<CLEDEntity>::COperation {
+
+   public:
+
+      CLEDEntitySpatialHashUpdater(CSpatialHash<CLEDEntity>& c_hash);
+      virtual bool operator()(CLEDEntity& c_entity);
+
+   private:
+
+      CSpatialHash<CLEDEntity>& m_cHash;
+      SInt32 m_nI, m_nJ, m_nK;
+
+   };
+
+   /****************************************/
+   /****************************************/
+
 }
 
 #endif
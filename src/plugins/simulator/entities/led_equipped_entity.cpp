@@ -19,7 +19,8 @@ namespace argos {
                                             SAnchor& s_anchor) :
       LED(c_led),
       Offset(c_offset),
-      Anchor(s_anchor) {}
+      Anchor(s_anchor),
+      AnchorVersion(0) {}
 
    /****************************************/
    /****************************************/
@@ -191,6 +192,7 @@ namespace argos {
                    ", m_tLEDs.size() = " <<
                    m_tLEDs.size());
       m_tLEDs[un_index]->Offset = c_offset;
+      m_tLEDs[un_index]->AnchorVersion = 0;
    }
 
    /****************************************/
@@ -245,11 +247,14 @@ namespace argos {
       /* LED position wrt global reference frame */
       CVector3 cLEDPosition;
       for(UInt32 i = 0; i < m_tLEDs.size(); ++i) {
-         if(m_tLEDs[i]->LED.IsEnabled()) {
+         /* Skip the LEDs whose anchor did not move */
+         if(m_tLEDs[i]->LED.IsEnabled() &&
+            m_tLEDs[i]->AnchorVersion != m_tLEDs[i]->Anchor.Version) {
             cLEDPosition = m_tLEDs[i]->Offset;
             cLEDPosition.Rotate(m_tLEDs[i]->Anchor.Orientation);
             cLEDPosition += m_tLEDs[i]->Anchor.Position;
             m_tLEDs[i]->LED.SetPosition(cLEDPosition);
+            m_tLEDs[i]->AnchorVersion = m_tLEDs[i]->Anchor.Version;
          }
       }
    }
@@ -49,6 +49,8 @@ namespace argos {
          CLEDEntity& LED;
          CVector3 Offset;
          SAnchor& Anchor;
+         /** The anchor version the LED position was last calculated for */
+         UInt64 AnchorVersion;
 
          SActuator(CLEDEntity& c_led,
                    const CVector3& c_offset,
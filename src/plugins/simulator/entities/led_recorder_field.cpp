@@ -0,0 +1,81 @@
+/**
+ * @file <argos3/plugins/simulator/entities/led_recorder_field.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include <argos3/core/simulator/recorder/recorder_field.h>
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/plugins/simulator/entities/led_equipped_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Records the colors of the LEDs of an entity.
+    * The value is the number of LEDs followed by their colors as RGBA bytes.
+    * When an entity has more than one LED-equipped component, the LEDs of all
+    * the components are recorded in sequence.
+    */
+   class CLEDRecorderField : public CRecorderField {
+
+   public:
+
+      virtual bool Record(CComposableEntity& c_entity,
+                          CByteArray& c_buffer) {
+         auto tRange = c_entity.GetComponentMap().equal_range("leds");
+         if(tRange.first == tRange.second) {
+            return false;
+         }
+         UInt32 unNumLEDs = 0;
+         for(auto it = tRange.first; it != tRange.second; ++it) {
+            unNumLEDs += static_cast<CLEDEquippedEntity*>(it->second)->GetLEDs().size();
+         }
+         c_buffer << unNumLEDs;
+         for(auto it = tRange.first; it != tRange.second; ++it) {
+            CLEDEquippedEntity::SActuator::TList& tLEDs =
+               static_cast<CLEDEquippedEntity*>(it->second)->GetLEDs();
+            for(size_t i = 0; i < tLEDs.size(); ++i) {
+               const CColor& cColor = tLEDs[i]->LED.GetColor();
+               c_buffer << cColor.GetRed()
+                        << cColor.GetGreen()
+                        << cColor.GetBlue()
+                        << cColor.GetAlpha();
+            }
+         }
+         return true;
+      }
+
+      virtual void Replay(CComposableEntity& c_entity,
+                          CByteArray& c_value) {
+         UInt32 unNumLEDs;
+         c_value >> unNumLEDs;
+         auto tRange = c_entity.GetComponentMap().equal_range("leds");
+         for(auto it = tRange.first; it != tRange.second; ++it) {
+            CLEDEquippedEntity::SActuator::TList& tLEDs =
+               static_cast<CLEDEquippedEntity*>(it->second)->GetLEDs();
+            for(size_t i = 0; i < tLEDs.size() && unNumLEDs > 0; ++i, --unNumLEDs) {
+               UInt8 unRed, unGreen, unBlue, unAlpha;
+               c_value >> unRed >> unGreen >> unBlue >> unAlpha;
+               tLEDs[i]->LED.SetColor(CColor(unRed, unGreen, unBlue, unAlpha));
+            }
+         }
+      }
+
+   };
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_RECORDER_FIELD(CLEDRecorderField,
+                           "leds",
+                           "agent [agent@local]",
+                           "1.0",
+                           "The colors of the LEDs of an entity.",
+                           "This field records the colors of the LEDs of an entity. During a replay,\n"
+                           "the LEDs are set to the recorded colors.",
+                           "Usable");
+
+}
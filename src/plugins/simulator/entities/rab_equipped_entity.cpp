@@ -20,6 +20,7 @@ namespace argos {
    CRABEquippedEntity::CRABEquippedEntity(CComposableEntity* pc_parent) :
       CPositionalEntity(pc_parent),
       m_psAnchor(nullptr),
+      m_unAnchorVersion(0),
       m_fRange(0.0f),
       m_pcEntityBody(nullptr),
       m_pcMedium(nullptr) {
@@ -42,6 +43,7 @@ namespace argos {
       m_psAnchor(&s_anchor),
       m_cPosOffset(c_pos_offset),
       m_cRotOffset(c_rot_offset),
+      m_unAnchorVersion(0),
       m_cData(un_msg_size),
       m_fRange(f_range),
       m_pcEntityBody(&c_entity_body),
@@ -112,6 +114,9 @@ namespace argos {
    /****************************************/
 
    void CRABEquippedEntity::Update() {
+      /* Nothing to do if the anchor did not move */
+      if(m_unAnchorVersion == m_psAnchor->Version) return;
+      m_unAnchorVersion = m_psAnchor->Version;
       CVector3 cPos = m_cPosOffset;
       cPos.Rotate(m_psAnchor->Orientation);
       cPos += m_psAnchor->Position;
@@ -395,4 +400,31 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CRABEquippedEntitySpatialHashUpdater::CRABEquippedEntitySpatialHashUpdater(CSpatialHash<CRABEquippedEntity>& c_hash) :
+      m_cHash(c_hash) {}
+
+   bool CRABEquippedEntitySpatialHashUpdater::operator()(CRABEquippedEntity& c_entity) {
+      try {
+         /* Add the entity to all the cells within its range */
+         CVector3 cRange(c_entity.GetRange(), c_entity.GetRange(), c_entity.GetRange());
+         m_cHash.PositionToCell(m_nMinI, m_nMinJ, m_nMinK, c_entity.GetPosition() - cRange);
+         m_cHash.PositionToCell(m_nMaxI, m_nMaxJ, m_nMaxK, c_entity.GetPosition() + cRange);
+         for(SInt32 k = m_nMinK; k <= m_nMaxK; ++k) {
+            for(SInt32 j = m_nMinJ; j <= m_nMaxJ; ++j) {
+               for(SInt32 i = m_nMinI; i <= m_nMaxI; ++i) {
+                  m_cHash.UpdateCell(i, j, k, c_entity);
+               }
+            }
+         }
+         /* Continue with the other entities */
+         return true;
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("While updating the RAB entity spatial hash for RAB entity \"" << c_entity.GetContext() << c_entity.GetId() << "\"", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
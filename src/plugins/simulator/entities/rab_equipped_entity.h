@@ -20,6 +20,7 @@ namespace argos {
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/core/simulator/space/positional_indices/space_hash.h>
 #include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/simulator/space/positional_indices/spatial_hash.h>
 
 namespace argos {
 
@@ -100,6 +101,7 @@ namespace argos {
       SAnchor* m_psAnchor;
       CVector3 m_cPosOffset;
       CQuaternion m_cRotOffset;
+      UInt64 m_unAnchorVersion;
       CByteArray m_cData;
       Real m_fRange;
       CEmbodiedEntity* m_pcEntityBody;
@@ -161,6 +163,23 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   class CRABEquippedEntitySpatialHashUpdater : public CSpatialHash<CRABEquippedEntity>::COperation {
+
+   public:
+
+      CRABEquippedEntitySpatialHashUpdater(CSpatialHash<CRABEquippedEntity>& c_hash);
+      virtual bool operator()(CRABEquippedEntity& c_entity);
+
+   private:
+
+      CSpatialHash<CRABEquippedEntity>& m_cHash;
+      SInt32 m_nMinI, m_nMinJ, m_nMinK;
+      SInt32 m_nMaxI, m_nMaxJ, m_nMaxK;
+   };
+
+   /****************************************/
+   /****************************************/
+
 }
 
 #endif
@@ -0,0 +1,69 @@
+/**
+ * @file <argos3/plugins/simulator/entities/rab_recorder_field.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include <argos3/core/simulator/recorder/recorder_field.h>
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/plugins/simulator/entities/rab_equipped_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Records the payloads of the range-and-bearing devices of an entity.
+    * The value is the number of devices followed, for each device, by the
+    * payload size (UInt32) and the payload.
+    */
+   class CRABRecorderField : public CRecorderField {
+
+   public:
+
+      virtual bool Record(CComposableEntity& c_entity,
+                          CByteArray& c_buffer) {
+         auto tRange = c_entity.GetComponentMap().equal_range("rab");
+         if(tRange.first == tRange.second) {
+            return false;
+         }
+         c_buffer << static_cast<UInt32>(std::distance(tRange.first, tRange.second));
+         for(auto it = tRange.first; it != tRange.second; ++it) {
+            const CByteArray& cData = static_cast<CRABEquippedEntity*>(it->second)->GetData();
+            c_buffer << static_cast<UInt32>(cData.Size());
+            c_buffer.AddBuffer(cData.ToCArray(), cData.Size());
+         }
+         return true;
+      }
+
+      virtual void Replay(CComposableEntity& c_entity,
+                          CByteArray& c_value) {
+         UInt32 unNumDevices;
+         c_value >> unNumDevices;
+         auto tRange = c_entity.GetComponentMap().equal_range("rab");
+         CByteArray cData;
+         for(auto it = tRange.first; it != tRange.second && unNumDevices > 0; ++it, --unNumDevices) {
+            UInt32 unSize;
+            c_value >> unSize;
+            cData.Resize(unSize);
+            c_value.FetchBuffer(cData.ToCArray(), unSize);
+            static_cast<CRABEquippedEntity*>(it->second)->SetData(cData);
+         }
+      }
+
+   };
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_RECORDER_FIELD(CRABRecorderField,
+                           "rab",
+                           "agent [agent@local]",
+                           "1.0",
+                           "The payloads of the range-and-bearing devices of an entity.",
+                           "This field records the data broadcast by the range-and-bearing devices of\n"
+                           "an entity. During a replay, the devices broadcast the recorded data.",
+                           "Usable");
+
+}
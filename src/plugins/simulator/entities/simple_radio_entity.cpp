@@ -138,6 +138,30 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CSimpleRadioEntitySpatialHashUpdater::CSimpleRadioEntitySpatialHashUpdater(CSpatialHash<CSimpleRadioEntity>& c_hash) :
+      m_cHash(c_hash) {}
+
+   /****************************************/
+   /****************************************/
+
+   bool CSimpleRadioEntitySpatialHashUpdater::operator()(CSimpleRadioEntity& c_entity) {
+      try {
+         /* Calculate the position of the radio in the spatial hash */
+         m_cHash.PositionToCell(m_nI, m_nJ, m_nK, c_entity.GetPosition());
+         /* Update the corresponding cell */
+         m_cHash.UpdateCell(m_nI, m_nJ, m_nK, c_entity);
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("While updating the simple radio spatial hash for simple radio \"" <<
+                                     c_entity.GetContext() + c_entity.GetId() << "\"", ex);
+      }
+      /* Continue with the other entities */
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
    class CSpaceOperationAddCSimpleRadioEntity : public CSpaceOperationAddEntity {
    public:
       void ApplyTo(CSpace& c_space, CSimpleRadioEntity& c_entity) {
@@ -18,6 +18,7 @@ namespace argos {
 #include <argos3/core/utility/datatypes/byte_array.h>
 #include <argos3/core/simulator/space/positional_indices/space_hash.h>
 #include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/simulator/space/positional_indices/spatial_hash.h>
 #include <mutex>
 
 namespace argos {
@@ -180,6 +181,23 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   class CSimpleRadioEntitySpatialHashUpdater : public CSpatialHash<CSimpleRadioEntity>::COperation {
+
+   public:
+
+      CSimpleRadioEntitySpatialHashUpdater(CSpatialHash<CSimpleRadioEntity>& c_hash);
+      virtual bool operator()(CSimpleRadioEntity& c_entity);
+
+   private:
+
+      CSpatialHash<CSimpleRadioEntity>& m_cHash;
+      SInt32 m_nI, m_nJ, m_nK;
+
+   };
+
+   /****************************************/
+   /****************************************/
+
 }
 
 #endif
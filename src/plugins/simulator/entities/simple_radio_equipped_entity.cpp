@@ -19,7 +19,8 @@ namespace argos {
                                                     const CVector3& c_offset) :
       Radio(c_radio),
       Anchor(s_anchor),
-      Offset(c_offset) {}
+      Offset(c_offset),
+      AnchorVersion(0) {}
 
    /****************************************/
    /****************************************/
@@ -147,11 +148,14 @@ namespace argos {
    void CSimpleRadioEquippedEntity::UpdateComponents() {
       CVector3 cPosition;
       for(SInstance& s_instance : m_vecInstances) {
-         if(s_instance.Radio.IsEnabled()) {
+         /* Skip the radios whose anchor did not move */
+         if(s_instance.Radio.IsEnabled() &&
+            s_instance.AnchorVersion != s_instance.Anchor.Version) {
             cPosition = s_instance.Offset;
             cPosition.Rotate(s_instance.Anchor.Orientation);
             cPosition += s_instance.Anchor.Position;
             s_instance.Radio.SetPosition(cPosition);
+            s_instance.AnchorVersion = s_instance.Anchor.Version;
          }
       }
    }
@@ -39,6 +39,8 @@ namespace argos {
          CSimpleRadioEntity& Radio;
          SAnchor& Anchor;
          CVector3 Offset;
+         /** The anchor version the position was last calculated for */
+         UInt64 AnchorVersion;
          SInstance(CSimpleRadioEntity& c_radio,
                    SAnchor& s_anchor,
                    const CVector3& c_offset);
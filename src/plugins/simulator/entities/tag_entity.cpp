@@ -157,6 +157,30 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CTagEntitySpatialHashUpdater::CTagEntitySpatialHashUpdater(CSpatialHash<CTagEntity>& c_hash) :
+      m_cHash(c_hash) {}
+
+   /****************************************/
+   /****************************************/
+
+   bool CTagEntitySpatialHashUpdater::operator()(CTagEntity& c_entity) {
+      try {
+         /* Calculate the position of the tag in the spatial hash */
+         m_cHash.PositionToCell(m_nI, m_nJ, m_nK, c_entity.GetPosition());
+         /* Update the corresponding cell */
+         m_cHash.UpdateCell(m_nI, m_nJ, m_nK, c_entity);
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("While updating the tag spatial hash for tag \"" <<
+                                     c_entity.GetContext() + c_entity.GetId() << "\"", ex);
+      }
+      /* Continue with the other entities */
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
    class CSpaceOperationAddCTagEntity : public CSpaceOperationAddEntity {
    public:
       void ApplyTo(CSpace& c_space, CTagEntity& c_entity) {
@@ -17,6 +17,7 @@ namespace argos {
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/core/simulator/space/positional_indices/space_hash.h>
 #include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/simulator/space/positional_indices/spatial_hash.h>
 
 namespace argos {
 
@@ -180,6 +181,23 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   class CTagEntitySpatialHashUpdater : public CSpatialHash<CTagEntity>::COperation {
+
+   public:
+
+      CTagEntitySpatialHashUpdater(CSpatialHash<CTagEntity>& c_hash);
+      virtual bool operator()(CTagEntity& c_entity);
+
+   private:
+
+      CSpatialHash<CTagEntity>& m_cHash;
+      SInt32 m_nI, m_nJ, m_nK;
+
+   };
+
+   /****************************************/
+   /****************************************/
+
 }
 
 #endif
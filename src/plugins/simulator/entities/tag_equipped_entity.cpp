@@ -21,7 +21,8 @@ namespace argos {
       Tag(c_tag),
       Anchor(s_anchor),
       PositionOffset(c_position_offset),
-      OrientationOffset(c_orientation_offset) {}
+      OrientationOffset(c_orientation_offset),
+      AnchorVersion(0) {}
 
    /****************************************/
    /****************************************/
@@ -206,13 +207,16 @@ namespace argos {
       CVector3 cTagPosition;
       CQuaternion cTagOrientation;
       for(SInstance& s_instance : m_vecInstances) {
-         if(s_instance.Tag.IsEnabled()) {
+         /* Skip the instances whose anchor did not move */
+         if(s_instance.Tag.IsEnabled() &&
+            s_instance.AnchorVersion != s_instance.Anchor.Version) {
             cTagPosition = s_instance.PositionOffset;
             cTagPosition.Rotate(s_instance.Anchor.Orientation);
             cTagPosition += s_instance.Anchor.Position;
             cTagOrientation = s_instance.Anchor.Orientation *
                s_instance.OrientationOffset;
             s_instance.Tag.MoveTo(cTagPosition, cTagOrientation);
+            s_instance.AnchorVersion = s_instance.Anchor.Version;
          }
       }
    }
@@ -40,6 +40,8 @@ namespace argos {
          SAnchor& Anchor;
          CVector3 PositionOffset;
          CQuaternion OrientationOffset;
+         /** The anchor version the pose was last calculated for */
+         UInt64 AnchorVersion;
          SInstance(CTagEntity& c_tag,
                    SAnchor& s_anchor,
                    const CVector3& c_position_offset,
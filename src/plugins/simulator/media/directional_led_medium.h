@@ -27,7 +27,8 @@ namespace argos {
        */
       CDirectionalLEDMedium() :
          m_pcDirectionalLEDEntityIndex(nullptr),
-         m_pcDirectionalLEDEntityGridUpdateOperation(nullptr) {}
+         m_pcDirectionalLEDEntityGridUpdateOperation(nullptr),
+         m_pcDirectionalLEDEntitySpatialHashUpdateOperation(nullptr) {}
 
       /**
        * Class destructor.
@@ -68,6 +69,9 @@ namespace argos {
       /** The update operation for the grid positional index */
       CDirectionalLEDEntityGridUpdater* m_pcDirectionalLEDEntityGridUpdateOperation;
 
+      /** The update operation for the spatial hash positional index */
+      CDirectionalLEDEntitySpatialHashUpdater* m_pcDirectionalLEDEntitySpatialHashUpdateOperation;
+
    };
 
 }
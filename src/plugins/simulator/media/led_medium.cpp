@@ -2,6 +2,7 @@
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/simulator/space/positional_indices/spatial_hash.h>
 #include <argos3/core/utility/configuration/argos_exception.h>
 #include <argos3/core/utility/logging/argos_log.h>
 
@@ -10,7 +11,10 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   CLEDMedium::CLEDMedium() {
+   CLEDMedium::CLEDMedium() :
+      m_pcLEDEntityIndex(nullptr),
+      m_pcLEDEntityGridUpdateOperation(nullptr),
+      m_pcLEDEntitySpatialHashUpdateOperation(nullptr) {
    }
 
    /****************************************/
@@ -54,6 +58,14 @@ namespace argos {
             pcGrid->SetUpdateEntityOperation(m_pcLEDEntityGridUpdateOperation);
             m_pcLEDEntityIndex = pcGrid;
          }
+         else if(strPosIndexMethod == "hash") {
+            CVector3 cCellSize(1.0, 1.0, 1.0);
+            GetNodeAttributeOrDefault(t_tree, "cell_size", cCellSize, cCellSize);
+            CSpatialHash<CLEDEntity>* pcHash = new CSpatialHash<CLEDEntity>(cCellSize);
+            m_pcLEDEntitySpatialHashUpdateOperation = new CLEDEntitySpatialHashUpdater(*pcHash);
+            pcHash->SetUpdateEntityOperation(m_pcLEDEntitySpatialHashUpdateOperation);
+            m_pcLEDEntityIndex = pcHash;
+         }
          else {
             THROW_ARGOSEXCEPTION("Unknown method \"" << strPosIndexMethod << "\" for the positional index.");
          }
@@ -85,6 +97,9 @@ namespace argos {
       if(m_pcLEDEntityGridUpdateOperation != nullptr) {
          delete m_pcLEDEntityGridUpdateOperation;
       }
+      if(m_pcLEDEntitySpatialHashUpdateOperation != nullptr) {
+         delete m_pcLEDEntitySpatialHashUpdateOperation;
+      }
    }
 
    /****************************************/
@@ -125,7 +140,12 @@ namespace argos {
                    "REQUIRED XML CONFIGURATION\n\n"
                    "<led id=\"led\" />\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
-                   "None for the time being\n",
+                   "The LEDs are indexed in space with a grid by default. The grid covers the\n"
+                   "arena with cells of 1m per side, which you can change with the 'grid_size'\n"
+                   "attribute (number of cells along X, Y and Z). For large, mostly empty arenas,\n"
+                   "the 'hash' index stores only the occupied cells and does not depend on the\n"
+                   "arena size. Its cells have a fixed size, set with 'cell_size':\n\n"
+                   "<led id=\"led\" index=\"hash\" cell_size=\"1,1,1\" />\n",
                    "Under development"
       );
 
@@ -60,6 +60,9 @@ namespace argos {
       /** The update operation for the grid positional index */
       CLEDEntityGridUpdater* m_pcLEDEntityGridUpdateOperation;
 
+      /** The update operation for the spatial hash positional index */
+      CLEDEntitySpatialHashUpdater* m_pcLEDEntitySpatialHashUpdateOperation;
+
    };
 
 }
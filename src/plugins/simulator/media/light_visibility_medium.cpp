@@ -0,0 +1,379 @@
+/**
+ * @file <argos3/plugins/simulator/media/light_visibility_medium.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "light_visibility_medium.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/plugins/simulator/entities/light_entity.h>
+#include <cmath>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Returns true if the segment from c_start to c_end crosses the box.
+    */
+   static bool SegmentIntersectsBox(const CVector3& c_start,
+                                    const CVector3& c_end,
+                                    const SBoundingBox& s_box) {
+      const Real pfStart[3] = { c_start.GetX(), c_start.GetY(), c_start.GetZ() };
+      const Real pfEnd[3]   = { c_end.GetX(),   c_end.GetY(),   c_end.GetZ()   };
+      const Real pfMin[3]   = { s_box.MinCorner.GetX(), s_box.MinCorner.GetY(), s_box.MinCorner.GetZ() };
+      const Real pfMax[3]   = { s_box.MaxCorner.GetX(), s_box.MaxCorner.GetY(), s_box.MaxCorner.GetZ() };
+      Real fTMin = 0.0, fTMax = 1.0;
+      for(UInt32 i = 0; i < 3; ++i) {
+         Real fDelta = pfEnd[i] - pfStart[i];
+         if(Abs(fDelta) < 1e-12) {
+            /* Parallel to the slab, the segment must lie in it */
+            if(pfStart[i] < pfMin[i] || pfStart[i] > pfMax[i]) return false;
+         }
+         else {
+            Real fT1 = (pfMin[i] - pfStart[i]) / fDelta;
+            Real fT2 = (pfMax[i] - pfStart[i]) / fDelta;
+            if(fT1 > fT2) std::swap(fT1, fT2);
+            if(fT1 > fTMin) fTMin = fT1;
+            if(fT2 < fTMax) fTMax = fT2;
+            if(fTMin > fTMax) return false;
+         }
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLightVisibilityMedium::CLightVisibilityMedium() :
+      m_fResolution(0.0),
+      m_unShadowMapDecisions(0),
+      m_bStaticsChanged(true) {
+      pthread_mutex_init(&m_tBlockMutex, nullptr);
+      for(UInt32 i = 0; i < 3; ++i) {
+         m_nGridSize[i] = 0;
+         m_nBlockGridSize[i] = 0;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLightVisibilityMedium::~CLightVisibilityMedium() {
+      ClearShadowMaps();
+      pthread_mutex_destroy(&m_tBlockMutex);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightVisibilityMedium::Init(TConfigurationNode& t_tree) {
+      try {
+         CMedium::Init(t_tree);
+         /* Parse the resolution of the shadow map */
+         GetNodeAttributeOrDefault(t_tree, "shadow_map_resolution", m_fResolution, m_fResolution);
+         if(m_fResolution < 0.0) {
+            THROW_ARGOSEXCEPTION("The resolution of the light shadow map can't be negative");
+         }
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error in initialization of the light visibility medium", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightVisibilityMedium::Reset() {
+      /* The entities are back to their initial state, forget everything about them */
+      ClearShadowMaps();
+      m_vecLights.clear();
+      m_vecMovables.clear();
+      m_vecStatics.clear();
+      m_bStaticsChanged = true;
+      m_unShadowMapDecisions = 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightVisibilityMedium::Destroy() {
+      ClearShadowMaps();
+      m_vecLights.clear();
+      m_vecMovables.clear();
+      m_vecStatics.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightVisibilityMedium::Update() {
+      UpdateEntities();
+      if(m_fResolution > 0.0) {
+         UpdateShadowMaps();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CLightVisibilityMedium::IsOccluded(size_t un_light,
+                                           const CRay3& c_ray,
+                                           SEmbodiedEntityIntersectionItem& s_item,
+                                           CEmbodiedEntity& c_body) {
+      SInt32 pnCell[3];
+      std::atomic<UInt8>* pcCell;
+      if(un_light < m_vecShadowMaps.size() &&
+         (pcCell = GetCell(un_light, c_ray.GetStart(), pnCell)) != nullptr) {
+         UInt8 unState = pcCell->load(std::memory_order_relaxed);
+         if(unState == CELL_UNKNOWN) {
+            unState = ClassifyCell(un_light, pnCell);
+            /* Other sensors may be classifying the same cell, they get the same result */
+            pcCell->store(unState, std::memory_order_relaxed);
+         }
+         /* Shadowed by a static entity */
+         if(unState == CELL_SHADOWED) {
+            m_unShadowMapDecisions.fetch_add(1, std::memory_order_relaxed);
+            return true;
+         }
+         /* Lit, unless a movable entity is in the way */
+         if(!IsOccludedByMovable(c_ray, c_body)) {
+            m_unShadowMapDecisions.fetch_add(1, std::memory_order_relaxed);
+            return false;
+         }
+      }
+      /* The shadow map can't decide, do the actual ray query */
+      return GetClosestEmbodiedEntityIntersectedByRay(s_item, c_ray, c_body);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightVisibilityMedium::UpdateEntities() {
+      CSpace& cSpace = GetSpace();
+      /* Resolve the lights */
+      m_vecLights.clear();
+      auto itLights = cSpace.GetEntityMapPerTypePerId().find("light");
+      if(itLights != cSpace.GetEntityMapPerTypePerId().end()) {
+         for(auto it = itLights->second.begin();
+             it != itLights->second.end();
+             ++it) {
+            m_vecLights.push_back(any_cast<CLightEntity*>(it->second));
+         }
+      }
+      if(m_fResolution <= 0.0) return;
+      /*
+       * Collect the bounding boxes of the movable entities, and compare those
+       * of the static entities with the ones seen at the last update
+       */
+      m_vecMovables.clear();
+      size_t unStatics = 0;
+      auto itBodies = cSpace.GetEntityMapPerTypePerId().find("body");
+      if(itBodies != cSpace.GetEntityMapPerTypePerId().end()) {
+         for(auto it = itBodies->second.begin();
+             it != itBodies->second.end();
+             ++it) {
+            CEmbodiedEntity* pcBody = any_cast<CEmbodiedEntity*>(it->second);
+            const SBoundingBox& sBox = pcBody->GetBoundingBox();
+            if(pcBody->IsMovable()) {
+               SMovable sMovable;
+               sMovable.Entity = pcBody;
+               sMovable.BoundingBox = sBox;
+               m_vecMovables.push_back(sMovable);
+            }
+            else {
+               if(unStatics == m_vecStatics.size()) {
+                  m_vecStatics.push_back(sBox);
+                  m_bStaticsChanged = true;
+               }
+               else if(m_vecStatics[unStatics].MinCorner != sBox.MinCorner ||
+                       m_vecStatics[unStatics].MaxCorner != sBox.MaxCorner) {
+                  m_vecStatics[unStatics] = sBox;
+                  m_bStaticsChanged = true;
+               }
+               ++unStatics;
+            }
+         }
+      }
+      if(unStatics != m_vecStatics.size()) {
+         m_vecStatics.resize(unStatics);
+         m_bStaticsChanged = true;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightVisibilityMedium::UpdateShadowMaps() {
+      /* The grid covers the arena */
+      const CRange<CVector3>& cLimits = GetSpace().GetArenaLimits();
+      m_cGridOrigin = cLimits.GetMin();
+      CVector3 cSize = cLimits.GetMax() - cLimits.GetMin();
+      size_t unBlocks = 1;
+      for(UInt32 i = 0; i < 3; ++i) {
+         m_nGridSize[i] = Max<SInt32>(1, static_cast<SInt32>(Ceil(cSize[i] / m_fResolution)));
+         m_nBlockGridSize[i] = (m_nGridSize[i] + BLOCK_SIDE - 1) >> BLOCK_BITS;
+         unBlocks *= m_nBlockGridSize[i];
+      }
+      /* Forget the cells of the lights whose shadows have changed */
+      for(size_t i = m_vecLights.size(); i < m_vecShadowMaps.size(); ++i) {
+         ClearShadowMap(m_vecShadowMaps[i]);
+      }
+      m_vecShadowMaps.resize(m_vecLights.size());
+      for(size_t i = 0; i < m_vecLights.size(); ++i) {
+         SShadowMap& sMap = m_vecShadowMaps[i];
+         if(m_bStaticsChanged ||
+            sMap.Light != m_vecLights[i] ||
+            sMap.LightPosition != m_vecLights[i]->GetPosition() ||
+            sMap.Blocks.size() != unBlocks) {
+            ClearShadowMap(sMap);
+            sMap.Light = m_vecLights[i];
+            sMap.LightPosition = m_vecLights[i]->GetPosition();
+            std::vector<std::atomic<std::atomic<UInt8>*> >(unBlocks).swap(sMap.Blocks);
+         }
+      }
+      m_bStaticsChanged = false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightVisibilityMedium::ClearShadowMaps() {
+      for(size_t i = 0; i < m_vecShadowMaps.size(); ++i) {
+         ClearShadowMap(m_vecShadowMaps[i]);
+      }
+      m_vecShadowMaps.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightVisibilityMedium::ClearShadowMap(SShadowMap& s_map) {
+      for(size_t i = 0; i < s_map.Blocks.size(); ++i) {
+         delete[] s_map.Blocks[i].load();
+         s_map.Blocks[i] = nullptr;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   std::atomic<UInt8>* CLightVisibilityMedium::GetCell(size_t un_light,
+                                                       const CVector3& c_position,
+                                                       SInt32* pn_cell) {
+      /* Get the cell coordinates */
+      for(UInt32 i = 0; i < 3; ++i) {
+         pn_cell[i] = static_cast<SInt32>(Floor((c_position[i] - m_cGridOrigin[i]) / m_fResolution));
+         if(pn_cell[i] < 0 || pn_cell[i] >= m_nGridSize[i]) return nullptr;
+      }
+      /* Get the block, allocating it if needed */
+      size_t unBlock =
+         (static_cast<size_t>(pn_cell[2] >> BLOCK_BITS) * m_nBlockGridSize[1] +
+          (pn_cell[1] >> BLOCK_BITS)) * m_nBlockGridSize[0] +
+         (pn_cell[0] >> BLOCK_BITS);
+      std::atomic<std::atomic<UInt8>*>& cBlock = m_vecShadowMaps[un_light].Blocks[unBlock];
+      std::atomic<UInt8>* pcBlock = cBlock.load(std::memory_order_acquire);
+      if(pcBlock == nullptr) {
+         pthread_mutex_lock(&m_tBlockMutex);
+         pcBlock = cBlock.load(std::memory_order_relaxed);
+         if(pcBlock == nullptr) {
+            pcBlock = new std::atomic<UInt8>[BLOCK_SIDE * BLOCK_SIDE * BLOCK_SIDE]();
+            cBlock.store(pcBlock, std::memory_order_release);
+         }
+         pthread_mutex_unlock(&m_tBlockMutex);
+      }
+      /* Get the cell in the block */
+      return pcBlock +
+         ((pn_cell[2] & (BLOCK_SIDE - 1)) * BLOCK_SIDE +
+          (pn_cell[1] & (BLOCK_SIDE - 1))) * BLOCK_SIDE +
+         (pn_cell[0] & (BLOCK_SIDE - 1));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt8 CLightVisibilityMedium::ClassifyCell(size_t un_light,
+                                              const SInt32* pn_cell) {
+      /* Get the center of the cell */
+      CVector3 cCenter(m_cGridOrigin.GetX() + (pn_cell[0] + 0.5) * m_fResolution,
+                       m_cGridOrigin.GetY() + (pn_cell[1] + 0.5) * m_fResolution,
+                       m_cGridOrigin.GetZ() + (pn_cell[2] + 0.5) * m_fResolution);
+      /* The cell is shadowed if a static entity is between its center and the light */
+      TEmbodiedEntityIntersectionData tIntersections;
+      if(GetEmbodiedEntitiesIntersectedByRay(tIntersections,
+                                             CRay3(cCenter, m_vecShadowMaps[un_light].LightPosition))) {
+         for(size_t i = 0; i < tIntersections.size(); ++i) {
+            if(!tIntersections[i].IntersectedEntity->IsMovable()) {
+               return CELL_SHADOWED;
+            }
+         }
+      }
+      return CELL_LIT;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CLightVisibilityMedium::IsOccludedByMovable(const CRay3& c_ray,
+                                                    const CEmbodiedEntity& c_body) const {
+      /* Bounding box of the ray, to discard most entities with a cheap test */
+      CVector3 cRayMin(Min(c_ray.GetStart().GetX(), c_ray.GetEnd().GetX()),
+                       Min(c_ray.GetStart().GetY(), c_ray.GetEnd().GetY()),
+                       Min(c_ray.GetStart().GetZ(), c_ray.GetEnd().GetZ()));
+      CVector3 cRayMax(Max(c_ray.GetStart().GetX(), c_ray.GetEnd().GetX()),
+                       Max(c_ray.GetStart().GetY(), c_ray.GetEnd().GetY()),
+                       Max(c_ray.GetStart().GetZ(), c_ray.GetEnd().GetZ()));
+      for(size_t i = 0; i < m_vecMovables.size(); ++i) {
+         const SMovable& sMovable = m_vecMovables[i];
+         if(sMovable.Entity == &c_body) continue;
+         const SBoundingBox& sBox = sMovable.BoundingBox;
+         if(sBox.MinCorner.GetX() > cRayMax.GetX() || sBox.MaxCorner.GetX() < cRayMin.GetX() ||
+            sBox.MinCorner.GetY() > cRayMax.GetY() || sBox.MaxCorner.GetY() < cRayMin.GetY() ||
+            sBox.MinCorner.GetZ() > cRayMax.GetZ() || sBox.MaxCorner.GetZ() < cRayMin.GetZ()) {
+            continue;
+         }
+         if(SegmentIntersectsBox(c_ray.GetStart(), c_ray.GetEnd(), sBox)) {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_MEDIUM(CLightVisibilityMedium,
+                   "light_visibility",
+                   "agent [agent@local]",
+                   "1.0",
+                   "Shares the light visibility among the light sensors.",
+                   "This medium lists the lights once per step for all the light sensors that\n"
+                   "refer to it, instead of having each sensor look them up. The sensors refer to\n"
+                   "the medium with their 'medium' attribute.\n\n"
+                   "REQUIRED XML CONFIGURATION\n\n"
+                   "<light_visibility id=\"lights\" />\n\n"
+                   "OPTIONAL XML CONFIGURATION\n\n"
+                   "When the lights and the obstacles never move, it is possible to avoid most of\n"
+                   "the occlusion checks with a shadow map. The map divides the arena in cubic cells\n"
+                   "and records, for each light, which cells are in the shadow of the entities that\n"
+                   "can't move. The cells are calculated the first time they are needed, and\n"
+                   "calculated again when a light or an obstacle moves. A sensor in a shadowed cell\n"
+                   "does not see the light. A sensor in a lit cell sees the light unless another\n"
+                   "robot is in the way, which is checked with the usual occlusion check; the body\n"
+                   "of the sensing robot is never considered in the way. The map is an\n"
+                   "approximation: the sensors take the visibility of the center of their cell, so\n"
+                   "the shadows have the precision of the cell size. The attribute\n"
+                   "'shadow_map_resolution' sets the side of a cell in meters. The shadow map is not\n"
+                   "used by the sensors that draw their rays.\n\n"
+                   "<light_visibility id=\"lights\" shadow_map_resolution=\"0.05\" />\n",
+                   "Usable"
+      );
+
+   /****************************************/
+   /****************************************/
+
+}
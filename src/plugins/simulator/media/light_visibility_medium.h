@@ -0,0 +1,181 @@
+/**
+ * @file <argos3/plugins/simulator/media/light_visibility_medium.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef LIGHT_VISIBILITY_MEDIUM_H
+#define LIGHT_VISIBILITY_MEDIUM_H
+
+namespace argos {
+   class CLightVisibilityMedium;
+   class CEmbodiedEntity;
+   class CLightEntity;
+   struct SEmbodiedEntityIntersectionItem;
+}
+
+#include <argos3/core/simulator/medium/medium.h>
+#include <argos3/core/simulator/physics_engine/physics_model.h>
+#include <argos3/core/utility/math/ray3.h>
+#include <atomic>
+#include <vector>
+#include <pthread.h>
+
+namespace argos {
+
+   /**
+    * Light visibility shared by the light sensors.
+    * <p>
+    * The light sensors used to look up the light entities by type name and
+    * cast an occlusion ray for each sensor and each light at every step. This
+    * medium resolves the lights once per step into a dense vector, which all
+    * the sensors referring to the medium then go through.
+    * </p>
+    * <p>
+    * Optionally, the medium also keeps a shadow map for each light. The map is
+    * a grid over the arena whose cells are marked as either lit or shadowed by
+    * the entities that cannot move (walls, obstacles). A cell is classified the
+    * first time a sensor needs it, with a ray query from the center of the cell
+    * to the light, and it is kept until a static entity or the light moves.
+    * The cells are allocated in blocks, only where the sensors go.
+    * When a sensor lies in a shadowed cell, the light is occluded with no ray
+    * query. When it lies in a lit cell, only the movable entities can occlude
+    * the light: if no movable entity has a bounding box crossed by the ray, the
+    * light is visible, otherwise the usual ray query decides.
+    * </p>
+    * <p>
+    * The shadow map is an approximation: a sensor inherits the visibility of
+    * the center of its cell, so the shadow edges have the precision of the
+    * cell size. For this reason the map is disabled unless the resolution of
+    * the map is set in the configuration of the medium.
+    * </p>
+    * <p>
+    * The medium is brought up to date when the media are updated, once per
+    * step and before the robots sense, so the sensors only read it. For this
+    * reason, the loop functions must not remove lights in PreStep() when the
+    * sensors use the medium; lights added in PreStep() are seen from the next
+    * step.
+    * </p>
+    */
+   class CLightVisibilityMedium : public CMedium {
+
+   public:
+
+      /**
+       * Class constructor.
+       */
+      CLightVisibilityMedium();
+
+      /**
+       * Class destructor.
+       */
+      virtual ~CLightVisibilityMedium();
+
+      virtual void Init(TConfigurationNode& t_tree);
+      virtual void Reset();
+      virtual void Destroy();
+      virtual void Update();
+
+      /**
+       * Returns the lights present in the space, ordered by id.
+       */
+      inline const std::vector<CLightEntity*>& GetLights() const {
+         return m_vecLights;
+      }
+
+      /**
+       * Returns <tt>true</tt> if the medium keeps a shadow map.
+       */
+      inline bool HasShadowMap() const {
+         return m_fResolution > 0.0;
+      }
+
+      /**
+       * Checks whether a light is occluded, using the shadow map if possible.
+       * The body of the sensing robot never occludes the light. When the
+       * shadow map can't decide, this method falls back to
+       * GetClosestEmbodiedEntityIntersectedByRay(). In this case the
+       * intersection is stored in the given item, otherwise the item is left
+       * untouched.
+       * @param un_light The index of the light in GetLights().
+       * @param c_ray The ray from the sensor to the light.
+       * @param s_item The intersection found by the ray query.
+       * @param c_body The body of the sensing robot.
+       * @return <tt>true</tt> if the light is occluded.
+       */
+      bool IsOccluded(size_t un_light,
+                      const CRay3& c_ray,
+                      SEmbodiedEntityIntersectionItem& s_item,
+                      CEmbodiedEntity& c_body);
+
+      /**
+       * Returns the number of occlusion checks decided with no ray query.
+       * The count starts again when the medium is reset.
+       */
+      inline UInt64 GetNumShadowMapDecisions() const {
+         return m_unShadowMapDecisions.load(std::memory_order_relaxed);
+      }
+
+   private:
+
+      enum ECellState {
+         CELL_UNKNOWN = 0,
+         CELL_LIT,
+         CELL_SHADOWED
+      };
+
+      /** The side of a block of cells, as a power of two */
+      static const UInt32 BLOCK_BITS = 3;
+      static const UInt32 BLOCK_SIDE = 1 << BLOCK_BITS;
+
+      struct SShadowMap {
+         SShadowMap() : Light(nullptr) {}
+         CLightEntity* Light;
+         CVector3 LightPosition;
+         /** The blocks of cells, allocated when first needed */
+         std::vector<std::atomic<std::atomic<UInt8>*> > Blocks;
+      };
+
+      struct SMovable {
+         CEmbodiedEntity* Entity;
+         SBoundingBox BoundingBox;
+      };
+
+   private:
+
+      void UpdateEntities();
+
+      void UpdateShadowMaps();
+
+      void ClearShadowMaps();
+
+      void ClearShadowMap(SShadowMap& s_map);
+
+      std::atomic<UInt8>* GetCell(size_t un_light,
+                                  const CVector3& c_position,
+                                  SInt32* pn_cell);
+
+      UInt8 ClassifyCell(size_t un_light,
+                         const SInt32* pn_cell);
+
+      bool IsOccludedByMovable(const CRay3& c_ray,
+                               const CEmbodiedEntity& c_body) const;
+
+   private:
+
+      pthread_mutex_t m_tBlockMutex;
+      Real m_fResolution;
+      std::atomic<UInt64> m_unShadowMapDecisions;
+      std::vector<CLightEntity*> m_vecLights;
+      std::vector<SShadowMap> m_vecShadowMaps;
+      std::vector<SMovable> m_vecMovables;
+      std::vector<SBoundingBox> m_vecStatics;
+      bool m_bStaticsChanged;
+      CVector3 m_cGridOrigin;
+      SInt32 m_nGridSize[3];
+      SInt32 m_nBlockGridSize[3];
+   };
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/simulator/space/positional_indices/spatial_hash.h>
 #include <argos3/core/utility/configuration/argos_exception.h>
 #include <argos3/core/utility/logging/argos_log.h>
 
@@ -76,6 +77,9 @@ namespace argos {
 /****************************************/
 
    CRABMedium::CRABMedium() :
+      m_pcRABEquippedEntityIndex(nullptr),
+      m_pcRABEquippedEntityGridUpdateOperation(nullptr),
+      m_pcRABEquippedEntitySpatialHashUpdateOperation(nullptr),
       m_bCheckOcclusions(true) {
    }
 
@@ -127,6 +131,19 @@ namespace argos {
                 << punGridSize[0] << "," << punGridSize[1] << "," << punGridSize[2] << ">"
                 << std::endl;
          }
+         else if(strPosIndexMethod == "hash") {
+            CVector3 cCellSize(1.0, 1.0, 1.0);
+            GetNodeAttributeOrDefault(t_tree, "cell_size", cCellSize, cCellSize);
+            CSpatialHash<CRABEquippedEntity>* pcHash = new CSpatialHash<CRABEquippedEntity>(cCellSize);
+            m_pcRABEquippedEntitySpatialHashUpdateOperation = new CRABEquippedEntitySpatialHashUpdater(*pcHash);
+            pcHash->SetUpdateEntityOperation(m_pcRABEquippedEntitySpatialHashUpdateOperation);
+            m_pcRABEquippedEntityIndex = pcHash;
+            LOG << "[INFO] RAB medium \""
+                << GetId()
+                << "\" using the spatial hash index with cell size <"
+                << cCellSize << ">"
+                << std::endl;
+         }
          else if(strPosIndexMethod == "dummy") {
             m_pcRABEquippedEntityGridUpdateOperation = nullptr;
             m_pcRABEquippedEntityIndex = new CDummyIndex<CRABEquippedEntity>();
@@ -173,6 +190,9 @@ namespace argos {
       if(m_pcRABEquippedEntityGridUpdateOperation != nullptr) {
          delete m_pcRABEquippedEntityGridUpdateOperation;
       }
+      if(m_pcRABEquippedEntitySpatialHashUpdateOperation != nullptr) {
+         delete m_pcRABEquippedEntitySpatialHashUpdateOperation;
+      }
    }
 
 /****************************************/
@@ -285,8 +305,12 @@ namespace argos {
       m_tRoutingTable.insert(
          std::make_pair<ssize_t, CSet<CRABEquippedEntity*,SEntityComparator> >(
             c_entity.GetIndex(), CSet<CRABEquippedEntity*,SEntityComparator>()));
+      /*
+       * The index is only queried in Update(), which rebuilds it first, so
+       * there is no need to rebuild it here; doing so for every robot made
+       * adding and removing large swarms quadratic
+       */
       m_pcRABEquippedEntityIndex->AddEntity(c_entity);
-      m_pcRABEquippedEntityIndex->Update();
    }
 
 /****************************************/
@@ -294,7 +318,6 @@ namespace argos {
 
    void CRABMedium::RemoveEntity(CRABEquippedEntity& c_entity) {
       m_pcRABEquippedEntityIndex->RemoveEntity(c_entity);
-      m_pcRABEquippedEntityIndex->Update();
       TRoutingTable::iterator it = m_tRoutingTable.find(c_entity.GetIndex());
       if(it != m_tRoutingTable.end())
          m_tRoutingTable.erase(it);
@@ -348,7 +371,12 @@ namespace argos {
                    "altogether. In that case, give the \"dummy\" index a try:\n\n"
                    "<range_and_bearing id=\"rab\" index=\"dummy\" />\n\n"
                    "This index has O(N^2) complexity (where N is the number of robots), but for\n"
-                   "small experiments it's actually faster than using the grid.\n",
+                   "small experiments it's actually faster than using the grid.\n\n"
+                   "The grid allocates all of its cells, which is wasteful for large arenas that\n"
+                   "are mostly empty. The \"hash\" index stores only the cells that contain a\n"
+                   "robot, so its memory does not depend on the arena size. Its cells have a fixed\n"
+                   "size, which defaults to 1m per side and can be set with 'cell_size':\n\n"
+                   "<range_and_bearing id=\"rab\" index=\"hash\" cell_size=\"2,2,1\" />\n",
                    "Usable"
       );
 
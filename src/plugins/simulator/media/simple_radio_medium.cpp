@@ -8,6 +8,7 @@
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/simulator/space/positional_indices/spatial_hash.h>
 #include <argos3/core/utility/configuration/argos_exception.h>
 #include <argos3/core/utility/logging/argos_log.h>
 
@@ -48,6 +49,14 @@ namespace argos {
             pcGrid->SetUpdateEntityOperation(m_pcEntityGridUpdateOperation);
             m_pcEntityIndex = pcGrid;
          }
+         else if(strPosIndexMethod == "hash") {
+            CVector3 cCellSize(1.0, 1.0, 1.0);
+            GetNodeAttributeOrDefault(t_tree, "cell_size", cCellSize, cCellSize);
+            CSpatialHash<CSimpleRadioEntity>* pcHash = new CSpatialHash<CSimpleRadioEntity>(cCellSize);
+            m_pcEntitySpatialHashUpdateOperation = new CSimpleRadioEntitySpatialHashUpdater(*pcHash);
+            pcHash->SetUpdateEntityOperation(m_pcEntitySpatialHashUpdateOperation);
+            m_pcEntityIndex = pcHash;
+         }
          else {
             THROW_ARGOSEXCEPTION("Unknown method \"" << strPosIndexMethod << "\" for the positional index.");
          }
@@ -79,6 +88,9 @@ namespace argos {
       if(m_pcEntityGridUpdateOperation != nullptr) {
          delete m_pcEntityGridUpdateOperation;
       }
+      if(m_pcEntitySpatialHashUpdateOperation != nullptr) {
+         delete m_pcEntitySpatialHashUpdateOperation;
+      }
    }
 
    /****************************************/
@@ -119,7 +131,12 @@ namespace argos {
                    "REQUIRED XML CONFIGURATION\n\n"
                    "<simple_radio id=\"simple_radios\" />\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
-                   "None\n",
+                   "The radios are indexed in space with a grid by default. The grid covers the\n"
+                   "arena with cells of 1m per side, which you can change with the 'grid_size'\n"
+                   "attribute (number of cells along X, Y and Z). For large, mostly empty arenas,\n"
+                   "the 'hash' index stores only the occupied cells and does not depend on the\n"
+                   "arena size. Its cells have a fixed size, set with 'cell_size':\n\n"
+                   "<simple_radio id=\"simple_radios\" index=\"hash\" cell_size=\"1,1,1\" />\n",
                    "Under development"
       );
 
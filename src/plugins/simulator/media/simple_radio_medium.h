@@ -27,7 +27,8 @@ namespace argos {
        */
       CSimpleRadioMedium() :
          m_pcEntityIndex(nullptr),
-         m_pcEntityGridUpdateOperation(nullptr) {}
+         m_pcEntityGridUpdateOperation(nullptr),
+         m_pcEntitySpatialHashUpdateOperation(nullptr) {}
 
       /**
        * Class destructor.
@@ -69,6 +70,9 @@ namespace argos {
       /** The update operation for the grid positional index */
       CSimpleRadioEntityGridUpdater* m_pcEntityGridUpdateOperation;
 
+      /** The update operation for the spatial hash positional index */
+      CSimpleRadioEntitySpatialHashUpdater* m_pcEntitySpatialHashUpdateOperation;
+
    };
 
 }
@@ -27,7 +27,8 @@ namespace argos {
        */
       CTagMedium() :
          m_pcTagEntityIndex(nullptr),
-         m_pcTagEntityGridUpdateOperation(nullptr) {}
+         m_pcTagEntityGridUpdateOperation(nullptr),
+         m_pcTagEntitySpatialHashUpdateOperation(nullptr) {}
 
       /**
        * Class destructor.
@@ -68,6 +69,9 @@ namespace argos {
       /** The update operation for the grid positional index */
       CTagEntityGridUpdater* m_pcTagEntityGridUpdateOperation;
 
+      /** The update operation for the spatial hash positional index */
+      CTagEntitySpatialHashUpdater* m_pcTagEntitySpatialHashUpdateOperation;
+
    };
 
 }
@@ -81,6 +81,7 @@ void cpHashSetFree(cpHashSet *set);
 
 int cpHashSetCount(cpHashSet *set);
 void *cpHashSetInsert(cpHashSet *set, cpHashValue hash, void *ptr, void *data, cpHashSetTransFunc trans);
+void *cpHashSetInsertNew(cpHashSet *set, cpHashValue hash, void *ptr, void *data, cpHashSetTransFunc trans);
 void *cpHashSetRemove(cpHashSet *set, cpHashValue hash, void *ptr);
 void *cpHashSetFind(cpHashSet *set, cpHashValue hash, void *ptr);
 
@@ -585,7 +585,7 @@ cpBBTreeDestroy(cpBBTree *tree)
 static void
 cpBBTreeInsert(cpBBTree *tree, void *obj, cpHashValue hashid)
 {
-	Node *leaf = (Node *)cpHashSetInsert(tree->leaves, hashid, obj, tree, (cpHashSetTransFunc)leafSetTrans);
+	Node *leaf = (Node *)cpHashSetInsertNew(tree->leaves, hashid, obj, tree, (cpHashSetTransFunc)leafSetTrans);
 	
 	Node *root = tree->root;
 	tree->root = SubtreeInsert(root, leaf, tree);
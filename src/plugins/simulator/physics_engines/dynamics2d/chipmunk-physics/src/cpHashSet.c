@@ -152,6 +152,22 @@ cpHashSetCount(cpHashSet *set)
 	return set->entries;
 }
 
+static cpHashSetBin *
+insertBin(cpHashSet *set, int idx, cpHashValue hash, void *ptr, void *data, cpHashSetTransFunc trans)
+{
+	cpHashSetBin *bin = getUnusedBin(set);
+	bin->hash = hash;
+	bin->elt = (trans ? trans(ptr, data) : data);
+	
+	bin->next = set->table[idx];
+	set->table[idx] = bin;
+	
+	set->entries++;
+	if(setIsFull(set)) cpHashSetResize(set);
+	
+	return bin;
+}
+
 void *
 cpHashSetInsert(cpHashSet *set, cpHashValue hash, void *ptr, void *data, cpHashSetTransFunc trans)
 {
@@ -163,21 +179,20 @@ cpHashSetInsert(cpHashSet *set, cpHashValue hash, void *ptr, void *data, cpHashS
 		bin = bin->next;
 	
 	// Create it if necessary.
-	if(!bin){
-		bin = getUnusedBin(set);
-		bin->hash = hash;
-		bin->elt = (trans ? trans(ptr, data) : data);
-		
-		bin->next = set->table[idx];
-		set->table[idx] = bin;
-		
-		set->entries++;
-		if(setIsFull(set)) cpHashSetResize(set);
-	}
+	if(!bin) bin = insertBin(set, idx, hash, ptr, data, trans);
 	
 	return bin->elt;
 }
 
+void *
+cpHashSetInsertNew(cpHashSet *set, cpHashValue hash, void *ptr, void *data, cpHashSetTransFunc trans)
+{
+	// The element is known not to be in the set, so the bucket is not searched.
+	// Many elements can share the same hash, and the search would make
+	// inserting n of them O(n^2).
+	return insertBin(set, hash%set->size, hash, ptr, data, trans)->elt;
+}
+
 void *
 cpHashSetRemove(cpHashSet *set, cpHashValue hash, void *ptr)
 {
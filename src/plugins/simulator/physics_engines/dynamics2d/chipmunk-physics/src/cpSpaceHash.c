@@ -275,7 +275,7 @@ hashHandle(cpSpaceHash *hash, cpHandle *hand, cpBB bb)
 static void
 cpSpaceHashInsert(cpSpaceHash *hash, void *obj, cpHashValue hashid)
 {
-	cpHandle *hand = (cpHandle *)cpHashSetInsert(hash->handleSet, hashid, obj, hash, (cpHashSetTransFunc)handleSetTrans);
+	cpHandle *hand = (cpHandle *)cpHashSetInsertNew(hash->handleSet, hashid, obj, hash, (cpHashSetTransFunc)handleSetTrans);
 	hashHandle(hash, hand, hash->spatialIndex.bbfunc(obj));
 }
 
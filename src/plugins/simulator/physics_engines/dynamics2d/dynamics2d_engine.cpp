@@ -11,6 +11,7 @@
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/entity/embodied_entity.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace argos {
@@ -26,7 +27,14 @@ namespace argos {
       m_ptSpace(nullptr),
       m_ptGroundBody(nullptr),
       m_fGrippingRigidity(10000.0),
-      m_fElevation(0.0f) {
+      m_fElevation(0.0f),
+      m_fSleepTime(0.0f),
+      m_fIdleSpeed(0.001f),
+      m_unInternalThreads(1),
+      m_pcWorkerPool(nullptr),
+      m_bPhysicsModelsChanged(false),
+      m_bStaticReindexScheduled(false),
+      m_bCollectTransfers(false) {
    }
 
    /****************************************/
@@ -46,6 +54,25 @@ namespace argos {
             GetNodeAttributeOrDefault(tNode, "cylinder_angular_friction", m_fCylinderAngularFriction, m_fCylinderAngularFriction);
          }
          GetNodeAttributeOrDefault(t_tree, "gripping_rigidity", m_fGrippingRigidity, m_fGrippingRigidity);
+         /* Body sleeping */
+         GetNodeAttributeOrDefault(t_tree, "sleep_time", m_fSleepTime, m_fSleepTime);
+         GetNodeAttributeOrDefault(t_tree, "idle_speed", m_fIdleSpeed, m_fIdleSpeed);
+         if(m_fSleepTime < 0.0f) {
+            THROW_ARGOSEXCEPTION("The sleep time must be positive, or zero to disable sleeping");
+         }
+         if(m_fIdleSpeed <= 0.0f) {
+            THROW_ARGOSEXCEPTION("The idle speed must be positive");
+         }
+         /* Internal parallelism */
+         GetNodeAttributeOrDefault(t_tree, "internal_threads", m_unInternalThreads, m_unInternalThreads);
+         if(m_unInternalThreads == 0) {
+            m_unInternalThreads = 1;
+         }
+         if(m_unInternalThreads > 1) {
+            m_pcWorkerPool = new CDynamics2DWorkerPool(m_unInternalThreads);
+            LOG << "[INFO] Dynamics 2D engine \"" << GetId() << "\" uses "
+                << m_unInternalThreads << " internal threads" << std::endl;
+         }
          /* Override volume top and bottom with the value of m_fElevation */
          if(!GetVolume().TopFace)    GetVolume().TopFace    = new SHorizontalFace;
          if(!GetVolume().BottomFace) GetVolume().BottomFace = new SHorizontalFace;
@@ -54,14 +81,21 @@ namespace argos {
          /* Initialize physics */
          cpInitChipmunk();
          cpResetShapeIdCounter();
-         /* Used to attach static geometries so that they won't move and to simulate friction */
-         m_ptGroundBody = cpBodyNew(INFINITY, INFINITY);
+         /* Used to attach static geometries so that they won't move and to simulate friction.
+            With sleeping, the ground body must be static, otherwise the bodies attached to it
+            would be kept awake. */
+         m_ptGroundBody = IsSleepingEnabled() ? cpBodyNewStatic() : cpBodyNew(INFINITY, INFINITY);
          /* Create the space to contain the movable objects */
          m_ptSpace = cpSpaceNew();
          /* Subiterations to solve constraints.
             The more, the better for precision but the worse for speed
          */
          m_ptSpace->iterations = GetIterations();
+         /* Bodies that stay idle long enough are put to sleep */
+         if(IsSleepingEnabled()) {
+            cpSpaceSetSleepTimeThreshold(m_ptSpace, m_fSleepTime);
+            cpSpaceSetIdleSpeedThreshold(m_ptSpace, m_fIdleSpeed);
+         }
          /* Spatial hash */
          if(NodeExists(t_tree, "spatial_hash")) {
             TConfigurationNode& tNode = GetNode(t_tree, "spatial_hash");
@@ -96,29 +130,91 @@ namespace argos {
          it->second->Reset();
       }
       cpSpaceReindexStatic(m_ptSpace);
+      m_bStaticReindexScheduled = false;
    }
 
    /****************************************/
    /****************************************/
 
    void CDynamics2DEngine::Update() {
-      /* Update the physics state from the entities */
+      /* Reindex the static shapes once after removals */
+      PerformScheduledStaticReindex();
+      /* Update the physics state from the entities.
+         This stays serial because models might add or remove constraints
+         to the space, and the order of constraints affects the solver */
       for(auto it = m_tPhysicsModels.begin();
           it != m_tPhysicsModels.end(); ++it) {
          it->second->UpdateFromEntityStatus();
       }
       /* Perform the step */
       for(size_t i = 0; i < GetIterations(); ++i) {
+         RunOnPhysicsModels(&CDynamics2DModel::UpdatePhysics);
+         cpSpaceStep(m_ptSpace, GetPhysicsClockTick());
+      }
+      /* Update the simulated space */
+      m_bCollectTransfers = (m_pcWorkerPool != nullptr);
+      try {
+         RunOnPhysicsModels(&CDynamics2DModel::UpdateEntityStatus);
+      }
+      catch(...) {
+         m_bCollectTransfers = false;
+         m_vecCollectedTransfers.clear();
+         throw;
+      }
+      m_bCollectTransfers = false;
+      if(!m_vecCollectedTransfers.empty()) {
+         /* Schedule the transfers in the order a serial update would have */
+         std::sort(m_vecCollectedTransfers.begin(),
+                   m_vecCollectedTransfers.end(),
+                   [](const CEmbodiedEntity* pc_a, const CEmbodiedEntity* pc_b) {
+                      return pc_a->GetRootEntity().GetId() < pc_b->GetRootEntity().GetId();
+                   });
+         for(size_t i = 0; i < m_vecCollectedTransfers.size(); ++i) {
+            CPhysicsEngine::ScheduleEntityForTransfer(*m_vecCollectedTransfers[i]);
+         }
+         m_vecCollectedTransfers.clear();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DEngine::RunOnPhysicsModels(void (CDynamics2DModel::*pt_method)()) {
+      if(m_pcWorkerPool == nullptr) {
          for(auto it = m_tPhysicsModels.begin();
              it != m_tPhysicsModels.end(); ++it) {
-            it->second->UpdatePhysics();
+            (it->second->*pt_method)();
          }
-         cpSpaceStep(m_ptSpace, GetPhysicsClockTick());
       }
-      /* Update the simulated space */
-      for(auto it = m_tPhysicsModels.begin();
-          it != m_tPhysicsModels.end(); ++it) {
-         it->second->UpdateEntityStatus();
+      else {
+         if(m_bPhysicsModelsChanged) {
+            m_vecPhysicsModels.clear();
+            for(auto it = m_tPhysicsModels.begin();
+                it != m_tPhysicsModels.end(); ++it) {
+               m_vecPhysicsModels.push_back(it->second);
+            }
+            m_bPhysicsModelsChanged = false;
+         }
+         m_pcWorkerPool->Run(
+            m_vecPhysicsModels.size(),
+            [this, pt_method](size_t un_begin, size_t un_end) {
+               for(size_t i = un_begin; i < un_end; ++i) {
+                  (m_vecPhysicsModels[i]->*pt_method)();
+               }
+            });
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DEngine::ScheduleEntityForTransfer(CEmbodiedEntity& c_entity) {
+      if(m_bCollectTransfers) {
+         std::unique_lock<std::mutex> cLock(m_cTransferMutex);
+         m_vecCollectedTransfers.push_back(&c_entity);
+      }
+      else {
+         CPhysicsEngine::ScheduleEntityForTransfer(c_entity);
       }
    }
 
@@ -132,6 +228,10 @@ namespace argos {
          delete it->second;
       }
       m_tPhysicsModels.clear();
+      m_vecPhysicsModels.clear();
+      /* Stop the internal threads */
+      delete m_pcWorkerPool;
+      m_pcWorkerPool = nullptr;
       /* Get rid of the physics space */
       cpSpaceFree(m_ptSpace);
       cpBodyFree(m_ptGroundBody);
@@ -251,6 +351,17 @@ namespace argos {
    void CDynamics2DEngine::AddPhysicsModel(const std::string& str_id,
                                            CDynamics2DModel& c_model) {
       m_tPhysicsModels[str_id] = &c_model;
+      m_bPhysicsModelsChanged = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DEngine::PerformScheduledStaticReindex() {
+      if(m_bStaticReindexScheduled) {
+         cpSpaceReindexStatic(m_ptSpace);
+         m_bStaticReindexScheduled = false;
+      }
    }
 
    /****************************************/
@@ -261,6 +372,7 @@ namespace argos {
       if(it != m_tPhysicsModels.end()) {
          delete it->second;
          m_tPhysicsModels.erase(it);
+         m_bPhysicsModelsChanged = true;
       }
       else {
          THROW_ARGOSEXCEPTION("Dynamics2D model id \"" << str_id << "\" not found in dynamics 2D engine \"" << GetId() << "\"");
@@ -380,6 +492,40 @@ namespace argos {
                            "assigned to the area within the arena with lower-left coordinates (0,0) and\n"
                            "upper-right coordinates (4,4) and vertices are specified in counter clockwise\n"
                            "order: south-east, south-west, north-west, north-east.\n\n"
+                           "The models managed by this engine can be updated by multiple threads internal to\n"
+                           "the engine. This is useful when a single engine manages many robots, because the\n"
+                           "update of the robot components after each step is otherwise executed by a single\n"
+                           "thread. To use 4 internal threads, use this syntax:\n\n"
+                           "  <physics_engines>\n"
+                           "    ...\n"
+                           "    <dynamics2d id=\"dyn2d\"\n"
+                           "                internal_threads=\"4\" />\n"
+                           "    ...\n"
+                           "  </physics_engines>\n\n"
+                           "The default value is 1, which means that no internal threads are created. The\n"
+                           "models are split into contiguous, fixed chunks, one per thread, and each model\n"
+                           "only touches its own bodies. The resolution of the collisions and of the joints is\n"
+                           "still performed by a single thread. Thus, the results are identical to those of a\n"
+                           "run without internal threads. The internal threads are in addition to the threads\n"
+                           "set in the <system> section, so make sure enough CPU cores are available.\n\n"
+                           "Bodies that stay idle for a while can be put to sleep. A sleeping body costs\n"
+                           "nothing to the solver and its entity is not recalculated. To enable sleeping,\n"
+                           "use this syntax:\n\n"
+                           "  <physics_engines>\n"
+                           "    ...\n"
+                           "    <dynamics2d id=\"dyn2d\"\n"
+                           "                sleep_time=\"0.5\"\n"
+                           "                idle_speed=\"0.001\" />\n"
+                           "    ...\n"
+                           "  </physics_engines>\n\n"
+                           "The 'sleep_time' attribute is the time, in seconds, a body must stay idle before\n"
+                           "it is put to sleep. The default value is 0, which disables sleeping. A body is\n"
+                           "idle when its speed is below 'idle_speed', in m/s, which defaults to 0.001.\n"
+                           "A robot whose wheels are still is held in place without keeping it awake. A\n"
+                           "sleeping body wakes up when it is hit by an awake body, when its wheels start\n"
+                           "turning, when its gripper is locked or unlocked, and when it is moved. Since\n"
+                           "the solver processes the bodies in a different order, the results differ\n"
+                           "slightly from those of a run without sleeping.\n\n"
                            "OPTIMIZATION HINTS\n\n"
                            "1. A single physics engine is generally sufficient for small swarms (say <= 50\n"
                            "   robots) within a reasonably small arena to obtain faster than real-time\n"
@@ -16,7 +16,9 @@ namespace argos {
 
 #include <argos3/core/simulator/entity/controllable_entity.h>
 #include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/plugins/simulator/physics_engines/dynamics2d/dynamics2d_worker_pool.h>
 #include <argos3/plugins/simulator/physics_engines/dynamics2d/chipmunk-physics/include/chipmunk.h>
+#include <mutex>
 
 namespace argos {
 
@@ -70,6 +72,39 @@ namespace argos {
       virtual void CheckIntersectionWithRay(TEmbodiedEntityIntersectionData& t_data,
                                             const CRay3& c_ray) const;
 
+      virtual void ScheduleEntityForTransfer(CEmbodiedEntity& c_entity);
+
+      /**
+       * Returns the number of threads this engine uses internally.
+       * A value of 1 means that the engine runs entirely in the thread that updates it.
+       */
+      inline UInt32 GetNumInternalThreads() const {
+         return m_unInternalThreads;
+      }
+
+      /**
+       * Returns <tt>true</tt> if idle bodies are put to sleep.
+       * @see GetSleepTime()
+       */
+      inline bool IsSleepingEnabled() const {
+         return m_fSleepTime > 0.0f;
+      }
+
+      /**
+       * Returns the time, in seconds, a body must stay idle before it is put to sleep.
+       * A value of zero means that sleeping is disabled.
+       */
+      inline Real GetSleepTime() const {
+         return m_fSleepTime;
+      }
+
+      /**
+       * Returns the speed, in m/s, below which a body is considered idle.
+       */
+      inline Real GetIdleSpeed() const {
+         return m_fIdleSpeed;
+      }
+
       inline cpFloat GetBoxLinearFriction() const {
          return m_fBoxLinearFriction;
       }
@@ -137,6 +172,24 @@ namespace argos {
                             CDynamics2DModel& c_model);
       void RemovePhysicsModel(const std::string& str_id);
 
+      /**
+       * Schedules a reindex of the static shapes.
+       * The reindex is performed once, before the next step or before new
+       * shapes are added, so removing many static shapes costs one reindex.
+       */
+      inline void ScheduleStaticReindex() {
+         m_bStaticReindexScheduled = true;
+      }
+
+      /**
+       * Reindexes the static shapes, if a reindex was scheduled.
+       */
+      void PerformScheduledStaticReindex();
+
+   private:
+
+      void RunOnPhysicsModels(void (CDynamics2DModel::*pt_method)());
+
    private:
 
       cpFloat m_fBoxLinearFriction;
@@ -147,10 +200,25 @@ namespace argos {
       cpBody* m_ptGroundBody;
       Real m_fGrippingRigidity;
       Real m_fElevation;
+      Real m_fSleepTime;
+      Real m_fIdleSpeed;
 
       CControllableEntity::TMap m_tControllableEntities;
       std::map<std::string, CDynamics2DModel*> m_tPhysicsModels;
 
+      /* Internal parallelism */
+      UInt32 m_unInternalThreads;
+      CDynamics2DWorkerPool* m_pcWorkerPool;
+      /* The models of m_tPhysicsModels, in the same order, for indexed access */
+      std::vector<CDynamics2DModel*> m_vecPhysicsModels;
+      bool m_bPhysicsModelsChanged;
+      /* Whether the static shapes must be reindexed */
+      bool m_bStaticReindexScheduled;
+      /* Transfers scheduled while the models are updated in parallel */
+      bool m_bCollectTransfers;
+      std::vector<CEmbodiedEntity*> m_vecCollectedTransfers;
+      std::mutex m_cTransferMutex;
+
    };
 
    /****************************************/
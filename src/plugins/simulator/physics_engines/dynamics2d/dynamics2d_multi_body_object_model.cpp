@@ -147,6 +147,19 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   bool CDynamics2DMultiBodyObjectModel::IsAsleep() const {
+      if(m_vecBodies.empty()) return false;
+      for(size_t i = 0; i < m_vecBodies.size(); ++i) {
+         if(!cpBodyIsSleeping(m_vecBodies[i].Body)) {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DMultiBodyObjectModel::AddBody(cpBody* pt_body,
                                                  const cpVect& t_offset_pos,
                                                  cpFloat t_offset_orient,
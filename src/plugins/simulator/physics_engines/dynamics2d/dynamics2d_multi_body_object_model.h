@@ -120,6 +120,8 @@ namespace argos {
 
       virtual bool IsCollidingWithSomething() const;
 
+      virtual bool IsAsleep() const;
+
       /**
        * Adds a body.
        * <p>
@@ -10,7 +10,10 @@ namespace argos {
                                                                       CComposableEntity& c_entity) :
       CDynamics2DModel(c_engine, c_entity.GetComponent<CEmbodiedEntity>("body")),
       m_cEntity(c_entity),
-      m_ptBody(nullptr) {}
+      m_ptBody(nullptr) {
+      /* The shapes added by the derived class must find the static index up to date */
+      c_engine.PerformScheduledStaticReindex();
+   }
 
    /****************************************/
    /****************************************/
@@ -31,7 +34,7 @@ namespace argos {
          cpSpaceRemoveBody(GetDynamics2DEngine().GetPhysicsSpace(), m_ptBody);
       cpBodyFree(m_ptBody);
       /* Reindex space */
-      if(bIsStatic) cpSpaceReindexStatic(GetDynamics2DEngine().GetPhysicsSpace());
+      if(bIsStatic) GetDynamics2DEngine().ScheduleStaticReindex();
    }
 
    /****************************************/
@@ -112,6 +115,13 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   bool CDynamics2DSingleBodyObjectModel::IsAsleep() const {
+      return !cpBodyIsStatic(m_ptBody) && cpBodyIsSleeping(m_ptBody);
+   }
+
+   /****************************************/
+   /****************************************/
+
    bool CDynamics2DSingleBodyObjectModel::IsCollidingWithSomething() const {
       for(cpShape* pt_shape = m_ptBody->shapeList;
           pt_shape != nullptr;
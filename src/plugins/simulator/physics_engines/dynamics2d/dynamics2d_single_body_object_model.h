@@ -102,6 +102,12 @@ namespace argos {
 
       virtual void CalculateBoundingBox();
 
+      virtual bool HasRigidBoundingBox() const {
+         return true;
+      }
+
+      virtual bool IsAsleep() const;
+
       virtual void UpdateEntityStatus();
 
       virtual void UpdateFromEntityStatus()  = 0;
@@ -22,7 +22,8 @@ namespace argos {
       m_ptLinearConstraint(nullptr),
       m_ptAngularConstraint(nullptr),
       m_fMaxForce(f_max_force),
-      m_fMaxTorque(f_max_torque) {
+      m_fMaxTorque(f_max_torque),
+      m_bIdle(false) {
       m_ptControlBody = cpBodyNew(INFINITY, INFINITY);
       if(t_node &&
          NodeExists(*t_node, "dynamics2d")) {
@@ -70,6 +71,8 @@ namespace argos {
                                              1.0f));
       m_ptAngularConstraint->maxBias = 0.0f; /* disable joint correction */
       m_ptAngularConstraint->maxForce = m_fMaxTorque; /* limit the torque */
+      m_bIdle = false;
+      UpdateIdleState();
    }
 
    /****************************************/
@@ -85,6 +88,7 @@ namespace argos {
          cpConstraintFree(m_ptAngularConstraint);
          /* Erase pointer to controlled body */
          m_ptControlledBody = nullptr;
+         m_bIdle = false;
       }
    }
 
@@ -95,6 +99,7 @@ namespace argos {
       m_ptControlBody->v.x = 0;
       m_ptControlBody->v.y = 0;
       m_ptControlBody->w = 0;
+      UpdateIdleState();
    }
 
    /****************************************/
@@ -111,6 +116,7 @@ namespace argos {
    void CDynamics2DVelocityControl::SetLinearVelocity(const CVector2& c_velocity) {
       m_ptControlBody->v.x = c_velocity.GetX();
       m_ptControlBody->v.y = c_velocity.GetY();
+      UpdateIdleState();
    }
 
    /****************************************/
@@ -125,6 +131,39 @@ namespace argos {
 
    void CDynamics2DVelocityControl::SetAngularVelocity(Real f_velocity) {
       m_ptControlBody->w = f_velocity;
+      UpdateIdleState();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DVelocityControl::UpdateIdleState() {
+      if(m_ptControlledBody == nullptr ||
+         !m_cDyn2DEngine.IsSleepingEnabled()) return;
+      bool bIdle =
+         m_ptControlBody->v.x == 0.0f &&
+         m_ptControlBody->v.y == 0.0f &&
+         m_ptControlBody->w == 0.0f;
+      if(bIdle != m_bIdle) {
+         /* Constraints to the ground body, which is static, don't keep the body awake */
+         BindConstraintsTo(bIdle ?
+                           m_cDyn2DEngine.GetGroundBody() :
+                           m_ptControlBody);
+         m_bIdle = bIdle;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DVelocityControl::BindConstraintsTo(cpBody* pt_body) {
+      /* Removing and adding the constraints also wakes the controlled body up */
+      cpSpaceRemoveConstraint(m_cDyn2DEngine.GetPhysicsSpace(), m_ptLinearConstraint);
+      cpSpaceRemoveConstraint(m_cDyn2DEngine.GetPhysicsSpace(), m_ptAngularConstraint);
+      m_ptLinearConstraint->b = pt_body;
+      m_ptAngularConstraint->b = pt_body;
+      cpSpaceAddConstraint(m_cDyn2DEngine.GetPhysicsSpace(), m_ptLinearConstraint);
+      cpSpaceAddConstraint(m_cDyn2DEngine.GetPhysicsSpace(), m_ptAngularConstraint);
    }
 
    /****************************************/
@@ -66,6 +66,23 @@ namespace argos {
          return m_ptAngularConstraint;
       }
 
+      /**
+       * Returns <tt>true</tt> if the controlled body is held still by the ground body.
+       * When sleeping is enabled in the engine and the wanted velocities are zero,
+       * the constraints are moved from the control body to the ground body. The
+       * effect on the controlled body is the same, but it can be put to sleep.
+       * @see CDynamics2DEngine::IsSleepingEnabled()
+       */
+      inline bool IsIdle() const {
+         return m_bIdle;
+      }
+
+   private:
+
+      void UpdateIdleState();
+
+      void BindConstraintsTo(cpBody* pt_body);
+
    protected:
 
       CDynamics2DEngine& m_cDyn2DEngine;
@@ -81,6 +98,8 @@ namespace argos {
       Real m_fMaxForce;
 
       Real m_fMaxTorque;
+
+      bool m_bIdle;
    };
 
 }
@@ -0,0 +1,129 @@
+/**
+ * @file <argos3/plugins/simulator/physics_engines/dynamics2d/dynamics2d_worker_pool.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "dynamics2d_worker_pool.h"
+#include <argos3/core/utility/logging/argos_log.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CDynamics2DWorkerPool::CDynamics2DWorkerPool(UInt32 un_num_threads) :
+      m_vecErrors(un_num_threads > 0 ? un_num_threads : 1),
+      m_ptTask(nullptr),
+      m_unSize(0),
+      m_unGeneration(0),
+      m_unPending(0),
+      m_bQuit(false) {
+      for(UInt32 i = 1; i < un_num_threads; ++i) {
+         m_vecWorkers.emplace_back(&CDynamics2DWorkerPool::Work, this, i);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CDynamics2DWorkerPool::~CDynamics2DWorkerPool() {
+      {
+         std::unique_lock<std::mutex> cLock(m_cMutex);
+         m_bQuit = true;
+      }
+      m_cStartCondition.notify_all();
+      for(size_t i = 0; i < m_vecWorkers.size(); ++i) {
+         m_vecWorkers[i].join();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DWorkerPool::Run(size_t un_size,
+                                   const TTask& t_task) {
+      /* Nothing to share: execute the task in the caller thread */
+      if(m_vecWorkers.empty() || un_size <= 1) {
+         t_task(0, un_size);
+         return;
+      }
+      /* Wake up the workers */
+      {
+         std::unique_lock<std::mutex> cLock(m_cMutex);
+         m_ptTask = &t_task;
+         m_unSize = un_size;
+         m_unPending = m_vecWorkers.size();
+         ++m_unGeneration;
+      }
+      m_cStartCondition.notify_all();
+      /* Process the first chunk */
+      RunChunk(0);
+      /* Wait for the workers to be done */
+      {
+         std::unique_lock<std::mutex> cLock(m_cMutex);
+         m_cDoneCondition.wait(cLock, [this] { return m_unPending == 0; });
+         m_ptTask = nullptr;
+      }
+      /* Re-throw the first error, if any */
+      for(size_t i = 0; i < m_vecErrors.size(); ++i) {
+         if(m_vecErrors[i]) {
+            std::exception_ptr ptError = m_vecErrors[i];
+            for(size_t j = i; j < m_vecErrors.size(); ++j) {
+               m_vecErrors[j] = nullptr;
+            }
+            std::rethrow_exception(ptError);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DWorkerPool::Work(UInt32 un_index) {
+      /* Give the worker its own log buffers, as the space threads do */
+      LOG.AddThreadSafeBuffer();
+      LOGERR.AddThreadSafeBuffer();
+      UInt64 unSeenGeneration = 0;
+      while(true) {
+         {
+            std::unique_lock<std::mutex> cLock(m_cMutex);
+            m_cStartCondition.wait(cLock, [this, unSeenGeneration] {
+                  return m_bQuit || m_unGeneration != unSeenGeneration;
+               });
+            if(m_bQuit) return;
+            unSeenGeneration = m_unGeneration;
+         }
+         RunChunk(un_index);
+         {
+            std::unique_lock<std::mutex> cLock(m_cMutex);
+            if(--m_unPending == 0) {
+               m_cDoneCondition.notify_one();
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DWorkerPool::RunChunk(UInt32 un_index) {
+      /* Contiguous, balanced chunks: the first (size % threads) get one more index */
+      size_t unThreads = GetNumThreads();
+      size_t unBase = m_unSize / unThreads;
+      size_t unExtra = m_unSize % unThreads;
+      size_t unBegin = un_index * unBase + (un_index < unExtra ? un_index : unExtra);
+      size_t unEnd = unBegin + unBase + (un_index < unExtra ? 1 : 0);
+      if(unBegin >= unEnd) return;
+      try {
+         (*m_ptTask)(unBegin, unEnd);
+      }
+      catch(...) {
+         m_vecErrors[un_index] = std::current_exception();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
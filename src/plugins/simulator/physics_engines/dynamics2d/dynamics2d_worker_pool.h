@@ -0,0 +1,93 @@
+/**
+ * @file <argos3/plugins/simulator/physics_engines/dynamics2d/dynamics2d_worker_pool.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef DYNAMICS2D_WORKER_POOL_H
+#define DYNAMICS2D_WORKER_POOL_H
+
+namespace argos {
+   class CDynamics2DWorkerPool;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * A small pool of threads internal to a dynamics 2D engine.
+    * <p>
+    * The pool executes a task over a range of indices. The range is split into
+    * one contiguous chunk per thread, and the calling thread processes the first
+    * chunk itself. The partition depends only on the size of the range and on
+    * the number of threads, so the same index is always processed by the same
+    * thread. Exceptions raised by a task are re-thrown by Run() in the caller
+    * thread; when several chunks fail, the exception of the lowest chunk wins.
+    * </p>
+    */
+   class CDynamics2DWorkerPool {
+
+   public:
+
+      /**
+       * The task executed on a chunk of indices.
+       * The arguments are the first and one-past-the-last index of the chunk.
+       */
+      typedef std::function<void(size_t, size_t)> TTask;
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param un_num_threads The total number of threads, including the caller.
+       */
+      CDynamics2DWorkerPool(UInt32 un_num_threads);
+
+      ~CDynamics2DWorkerPool();
+
+      /**
+       * Runs the given task over the range [0,un_size) and waits for it to finish.
+       * @param un_size The size of the range.
+       * @param t_task The task to execute.
+       */
+      void Run(size_t un_size,
+               const TTask& t_task);
+
+      /**
+       * Returns the total number of threads, including the caller.
+       */
+      inline UInt32 GetNumThreads() const {
+         return m_vecWorkers.size() + 1;
+      }
+
+   private:
+
+      void Work(UInt32 un_index);
+
+      void RunChunk(UInt32 un_index);
+
+   private:
+
+      std::vector<std::thread> m_vecWorkers;
+      std::vector<std::exception_ptr> m_vecErrors;
+      std::mutex m_cMutex;
+      std::condition_variable m_cStartCondition;
+      std::condition_variable m_cDoneCondition;
+      const TTask* m_ptTask;
+      size_t m_unSize;
+      UInt64 m_unGeneration;
+      UInt32 m_unPending;
+      bool m_bQuit;
+   };
+
+}
+
+#endif
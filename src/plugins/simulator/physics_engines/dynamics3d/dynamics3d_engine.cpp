@@ -372,14 +372,18 @@ namespace argos {
                            "torques to bodies in the simulation that contains magnetic dipoles. The\n"
                            "'max_distance' attribute is an optional optimization that sets the maximum\n"
                            "distance at which two magnetic dipoles will interact with each other. In\n"
-                           "the example below, this distance has been set to 4 cm.\n\n"
+                           "the example below, this distance has been set to 4 cm. By default, all the\n"
+                           "pairs of dipoles are considered. When 'max_distance' is set, the 'method'\n"
+                           "attribute can be set to 'cell_list' to bin the dipoles into cells as large\n"
+                           "as 'max_distance', so that only the dipoles in neighboring cells are\n"
+                           "considered. This is much faster with many dipoles spread over the arena.\n\n"
 
                            "  <physics_engines>\n"
                            "    ...\n"
                            "    <dynamics3d id=\"dyn3d\" default_friction=\"2.0\">\n"
                            "      <floor height=\"0.01\" friction=\"0.05\"/>\n"
                            "      <gravity g=\"10\" />\n"
-                           "      <magnetism max_distance=\"0.04\" />\n"
+                           "      <magnetism max_distance=\"0.04\" method=\"cell_list\" />\n"
                            "    </dynamics3d>\n"
                            "    ...\n"
                            "  </physics_engines>\n\n",
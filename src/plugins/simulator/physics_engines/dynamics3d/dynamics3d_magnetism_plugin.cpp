@@ -11,6 +11,7 @@
 #include <argos3/plugins/simulator/physics_engines/dynamics3d/dynamics3d_model.h>
 
 #include <algorithm>
+#include <cmath>
 
 namespace argos {
 
@@ -20,6 +21,25 @@ namespace argos {
    void CDynamics3DMagnetismPlugin::Init(TConfigurationNode& t_tree) {
       GetNodeAttributeOrDefault(t_tree, "force_constant", m_fForceConstant, m_fForceConstant);
       GetNodeAttributeOrDefault(t_tree, "max_distance", m_fMaxDistance, m_fMaxDistance);
+      if(!(m_fMaxDistance > 0)) {
+         THROW_ARGOSEXCEPTION("The magnetism plugin requires \"max_distance\" to be positive");
+      }
+      std::string strMethod = "pairwise";
+      GetNodeAttributeOrDefault(t_tree, "method", strMethod, strMethod);
+      if(strMethod == "cell_list") {
+         if(!(m_fMaxDistance < std::numeric_limits<btScalar>::infinity())) {
+            THROW_ARGOSEXCEPTION("The magnetism plugin requires \"max_distance\" to be set " <<
+                                 "when using the \"cell_list\" method");
+         }
+         m_bUseCellList = true;
+      }
+      else if(strMethod == "pairwise") {
+         m_bUseCellList = false;
+      }
+      else {
+         THROW_ARGOSEXCEPTION("Unknown method \"" << strMethod <<
+                              "\" for the magnetism plugin, use \"pairwise\" or \"cell_list\"");
+      }
    }
 
    /****************************************/
@@ -57,66 +77,74 @@ namespace argos {
          /* Nothing to do */
          return;
       }
-      for(auto itDipole0 = std::begin(m_vecDipoles);
-          itDipole0 != (std::end(m_vecDipoles) - 1);
-          ++itDipole0) {
-         for(auto itDipole1 = std::next(itDipole0, 1);
-             itDipole1 != std::end(m_vecDipoles);
-             ++itDipole1) {
-            const btTransform& cTransformDipole0 = itDipole0->Offset * itDipole0->Body->GetTransform();
-            const btTransform& cTransformDipole1 = itDipole1->Offset * itDipole1->Body->GetTransform();
-            const btVector3& cPositionDipole0 = cTransformDipole0.getOrigin();
-            const btVector3& cPositionDipole1 = cTransformDipole1.getOrigin();
-            /* calculate the distance between the two magnetic bodies */
-            btScalar fDistance = cPositionDipole0.distance(cPositionDipole1);
-            /* optimization - don't calculate magnetism for dipoles more than m_fMaxDistance apart */
-            if(fDistance > m_fMaxDistance) {
-               continue;
+      /* Cache the world position and the rotated field of every dipole for this sub-step */
+      m_vecDipoleStates.resize(m_vecDipoles.size());
+      for(UInt32 i = 0; i < m_vecDipoles.size(); ++i) {
+         SMagneticDipole& sDipole = m_vecDipoles[i];
+         const btTransform& cBodyTransform = sDipole.Body->GetTransform();
+         m_vecDipoleStates[i].Position = (sDipole.Offset * cBodyTransform).getOrigin();
+         m_vecDipoleStates[i].Field = cBodyTransform.getBasis() * sDipole.GetField();
+      }
+      if(m_bUseCellList) {
+         UpdateCellList();
+      }
+      else {
+         UpdatePairwise();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics3DMagnetismPlugin::UpdatePairwise() {
+      for(UInt32 i = 0; i < m_vecDipoles.size() - 1; ++i) {
+         for(UInt32 j = i + 1; j < m_vecDipoles.size(); ++j) {
+            Interact(i, j);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics3DMagnetismPlugin::UpdateCellList() {
+      /* Drop the cells if too many stale ones have accumulated */
+      if(m_mapCells.size() > 4 * m_vecDipoles.size()) {
+         m_mapCells.clear();
+      }
+      else {
+         for(auto& c_cell : m_mapCells) {
+            c_cell.second.clear();
+         }
+      }
+      /* Bin the dipoles into cells whose side is the maximum interaction distance */
+      m_vecDipoleCells.resize(m_vecDipoles.size());
+      for(UInt32 i = 0; i < m_vecDipoles.size(); ++i) {
+         const btVector3& cPosition = m_vecDipoleStates[i].Position;
+         SCell& sCell = m_vecDipoleCells[i];
+         sCell.X = static_cast<SInt32>(std::floor(cPosition.getX() / m_fMaxDistance));
+         sCell.Y = static_cast<SInt32>(std::floor(cPosition.getY() / m_fMaxDistance));
+         sCell.Z = static_cast<SInt32>(std::floor(cPosition.getZ() / m_fMaxDistance));
+         m_mapCells[sCell].push_back(i);
+      }
+      /* Only visit the dipoles in the same and in the neighboring cells */
+      for(UInt32 i = 0; i < m_vecDipoles.size(); ++i) {
+         const SCell& sCell = m_vecDipoleCells[i];
+         for(SInt32 nX = sCell.X - 1; nX <= sCell.X + 1; ++nX) {
+            for(SInt32 nY = sCell.Y - 1; nY <= sCell.Y + 1; ++nY) {
+               for(SInt32 nZ = sCell.Z - 1; nZ <= sCell.Z + 1; ++nZ) {
+                  auto itCell = m_mapCells.find(SCell{nX, nY, nZ});
+                  if(itCell == std::end(m_mapCells)) {
+                     continue;
+                  }
+                  for(UInt32 j : itCell->second) {
+                     /* Each pair is considered once */
+                     if(j > i) {
+                        Interact(i, j);
+                     }
+                  }
+               }
             }
-            /* perform Barnes-hut algorithm */
-            /* calculate the normalized seperation between the two dipoles, pointing from Dipole1 to Dipole0*/
-            const btVector3& cNormalizedSeparation =
-               btVector3(cPositionDipole0 - cPositionDipole1) / fDistance;
-            /* calculate the rotated field of dipole 0 */
-            const btVector3& cRotatedFieldDipole0 =
-               itDipole0->Body->GetTransform().getBasis() * itDipole0->GetField();
-            /* calculate the rotated field of dipole 1 */
-            const btVector3& cRotatedFieldDipole1 =
-               itDipole1->Body->GetTransform().getBasis() * itDipole1->GetField();
-            /* We now have cRotatedFieldDipole0 and cRotatedFieldDipole1 as the magnetic moments
-               (i.e., m0, m1), cNormalizedSeparation as the direction unit vector from Dipole 1
-               to Dipole 0 (i.e., n), fDistance is the scalar distance between the dipoles (i.e.,
-               d), and B0 is the magnetic flux density at Dipole 0.
-                  B0 = u0/4pi * [3n(n.m1) - m1] / d^3
-                  T0 = m0 * B0
-                     = u0.4pi/d^3 * [3 (m1.n)(m0 * n) - m0 * m1]
-
-                  F0 = grad(m0.B0)
-                     = u0.4pi/d^4 * [-15n(m0.n)(m1.n) + 3n(m0.m1) + 3(m0(m1.n)+m1(m0.n))]
-            */
-            /* calculate the intermediate cross and dot products */
-            const btVector3& cCrossProduct01 = cRotatedFieldDipole0.cross(cRotatedFieldDipole1);
-            const btVector3& cCrossProduct0 = cRotatedFieldDipole0.cross(cNormalizedSeparation);
-            const btVector3& cCrossProduct1 = cRotatedFieldDipole1.cross(cNormalizedSeparation);
-            btScalar fDotProduct01 = cRotatedFieldDipole0.dot(cRotatedFieldDipole1);
-            btScalar fDotProduct0 = cRotatedFieldDipole0.dot(cNormalizedSeparation);
-            btScalar fDotProduct1 = cRotatedFieldDipole1.dot(cNormalizedSeparation);
-            /* calculate the magnetic force and torque */
-            const btVector3& cTorque0 =
-               ((3 * fDotProduct1 * cCrossProduct0) - cCrossProduct01) *
-               m_fForceConstant / btPow(fDistance, 3);
-            const btVector3& cTorque1 =
-               ((3 * fDotProduct0 * cCrossProduct1) + cCrossProduct01) *
-               m_fForceConstant / btPow(fDistance, 3);
-            const btVector3& cForce = (m_fForceConstant / btPow(fDistance, 4)) *
-               ((-15 * cNormalizedSeparation * fDotProduct1 * fDotProduct0) +
-                (3 * cNormalizedSeparation * fDotProduct01) +
-                (3 * (fDotProduct1 * cRotatedFieldDipole0 + fDotProduct0 * cRotatedFieldDipole1)));
-            /* apply torques and forces to the bodies */
-            itDipole0->Body->ApplyForce(cForce, (itDipole0->Offset).getOrigin());
-            itDipole0->Body->ApplyTorque(cTorque0);
-            itDipole1->Body->ApplyForce(-cForce, (itDipole1->Offset).getOrigin());
-            itDipole1->Body->ApplyTorque(cTorque1);
          }
       }
    }
@@ -124,6 +152,62 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics3DMagnetismPlugin::Interact(UInt32 un_dipole0, UInt32 un_dipole1) {
+      const btVector3& cPositionDipole0 = m_vecDipoleStates[un_dipole0].Position;
+      const btVector3& cPositionDipole1 = m_vecDipoleStates[un_dipole1].Position;
+      /* calculate the distance between the two magnetic bodies */
+      btScalar fDistance = cPositionDipole0.distance(cPositionDipole1);
+      /* optimization - don't calculate magnetism for dipoles more than m_fMaxDistance apart */
+      if(fDistance > m_fMaxDistance) {
+         return;
+      }
+      /* calculate the normalized seperation between the two dipoles, pointing from Dipole1 to Dipole0*/
+      const btVector3& cNormalizedSeparation =
+         btVector3(cPositionDipole0 - cPositionDipole1) / fDistance;
+      /* get the rotated fields of dipole 0 and dipole 1 */
+      const btVector3& cRotatedFieldDipole0 = m_vecDipoleStates[un_dipole0].Field;
+      const btVector3& cRotatedFieldDipole1 = m_vecDipoleStates[un_dipole1].Field;
+      /* We now have cRotatedFieldDipole0 and cRotatedFieldDipole1 as the magnetic moments
+         (i.e., m0, m1), cNormalizedSeparation as the direction unit vector from Dipole 1
+         to Dipole 0 (i.e., n), fDistance is the scalar distance between the dipoles (i.e.,
+         d), and B0 is the magnetic flux density at Dipole 0.
+            B0 = u0/4pi * [3n(n.m1) - m1] / d^3
+            T0 = m0 * B0
+               = u0.4pi/d^3 * [3 (m1.n)(m0 * n) - m0 * m1]
+
+            F0 = grad(m0.B0)
+               = u0.4pi/d^4 * [-15n(m0.n)(m1.n) + 3n(m0.m1) + 3(m0(m1.n)+m1(m0.n))]
+      */
+      /* calculate the intermediate cross and dot products */
+      const btVector3& cCrossProduct01 = cRotatedFieldDipole0.cross(cRotatedFieldDipole1);
+      const btVector3& cCrossProduct0 = cRotatedFieldDipole0.cross(cNormalizedSeparation);
+      const btVector3& cCrossProduct1 = cRotatedFieldDipole1.cross(cNormalizedSeparation);
+      btScalar fDotProduct01 = cRotatedFieldDipole0.dot(cRotatedFieldDipole1);
+      btScalar fDotProduct0 = cRotatedFieldDipole0.dot(cNormalizedSeparation);
+      btScalar fDotProduct1 = cRotatedFieldDipole1.dot(cNormalizedSeparation);
+      /* calculate the magnetic force and torque */
+      const btVector3& cTorque0 =
+         ((3 * fDotProduct1 * cCrossProduct0) - cCrossProduct01) *
+         m_fForceConstant / btPow(fDistance, 3);
+      const btVector3& cTorque1 =
+         ((3 * fDotProduct0 * cCrossProduct1) + cCrossProduct01) *
+         m_fForceConstant / btPow(fDistance, 3);
+      const btVector3& cForce = (m_fForceConstant / btPow(fDistance, 4)) *
+         ((-15 * cNormalizedSeparation * fDotProduct1 * fDotProduct0) +
+          (3 * cNormalizedSeparation * fDotProduct01) +
+          (3 * (fDotProduct1 * cRotatedFieldDipole0 + fDotProduct0 * cRotatedFieldDipole1)));
+      /* apply torques and forces to the bodies */
+      SMagneticDipole& sDipole0 = m_vecDipoles[un_dipole0];
+      SMagneticDipole& sDipole1 = m_vecDipoles[un_dipole1];
+      sDipole0.Body->ApplyForce(cForce, sDipole0.Offset.getOrigin());
+      sDipole0.Body->ApplyTorque(cTorque0);
+      sDipole1.Body->ApplyForce(-cForce, sDipole1.Offset.getOrigin());
+      sDipole1.Body->ApplyTorque(cTorque1);
+   }
+
+   /****************************************/
+   /****************************************/
+
    REGISTER_DYNAMICS3D_PLUGIN(CDynamics3DMagnetismPlugin,
                               "magnetism",
                               "Michael Allwright [allsey87@gmail.com]",
@@ -15,6 +15,7 @@
 #include <argos3/core/utility/datatypes/datatypes.h>
 #include <functional>
 #include <limits>
+#include <unordered_map>
 #include <vector>
 
 namespace argos {
@@ -26,7 +27,8 @@ namespace argos {
    public:
       CDynamics3DMagnetismPlugin() :
          m_fForceConstant(7.0500949e-13),
-         m_fMaxDistance(std::numeric_limits<Real>::infinity()) {}
+         m_fMaxDistance(std::numeric_limits<Real>::infinity()),
+         m_bUseCellList(false) {}
       
       ~CDynamics3DMagnetismPlugin() {}
       
@@ -42,10 +44,19 @@ namespace argos {
       
       virtual void Update();
 
+   private:
+
+      void UpdatePairwise();
+
+      void UpdateCellList();
+
+      void Interact(UInt32 un_dipole0, UInt32 un_dipole1);
+
    private:
       
       btScalar m_fForceConstant;
       btScalar m_fMaxDistance;
+      bool m_bUseCellList;
 
       struct SMagneticDipole {
          /* Constructor */
@@ -62,6 +73,35 @@ namespace argos {
       };    
 
       std::vector<SMagneticDipole> m_vecDipoles;
+
+      /* World position and rotated field of a dipole, cached once per sub-step */
+      struct SDipoleState {
+         btVector3 Position;
+         btVector3 Field;
+      };
+
+      std::vector<SDipoleState> m_vecDipoleStates;
+
+      /* Integer coordinates of a cell in the cell list */
+      struct SCell {
+         SInt32 X, Y, Z;
+         bool operator==(const SCell& s_other) const {
+            return X == s_other.X && Y == s_other.Y && Z == s_other.Z;
+         }
+      };
+
+      struct SCellHash {
+         size_t operator()(const SCell& s_cell) const {
+            return
+               (static_cast<size_t>(s_cell.X) * 73856093u) ^
+               (static_cast<size_t>(s_cell.Y) * 19349663u) ^
+               (static_cast<size_t>(s_cell.Z) * 83492791u);
+         }
+      };
+
+      /* Cells are kept between sub-steps so that their storage is reused */
+      std::unordered_map<SCell, std::vector<UInt32>, SCellHash> m_mapCells;
+      std::vector<SCell> m_vecDipoleCells;
    };
    
    /****************************************/
@@ -8,6 +8,8 @@
 #include "dynamics3d_shape_manager.h"
 #include <argos3/core/utility/configuration/argos_exception.h>
 
+#include <functional>
+
 namespace argos {
 
    /****************************************/
@@ -106,25 +108,40 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   std::vector<CDynamics3DShapeManager::SConvexHullResource>
-      CDynamics3DShapeManager::m_vecConvexHullResources;
+   std::unordered_multimap<size_t, CDynamics3DShapeManager::SConvexHullResource>
+      CDynamics3DShapeManager::m_mapConvexHullResources;
 
    /****************************************/
    /****************************************/
 
    std::shared_ptr<btCollisionShape> CDynamics3DShapeManager::RequestConvexHull(const std::vector<btVector3>& vec_points) {
-      std::vector<SConvexHullResource>::iterator itConvexHullResource;
-      for(itConvexHullResource = std::begin(m_vecConvexHullResources);
-          itConvexHullResource != std::end(m_vecConvexHullResources);
-          ++itConvexHullResource) {
-         if(itConvexHullResource->Points == vec_points) break;
+      size_t unFingerprint = GetFingerprint(vec_points);
+      /* Only the resources with the same fingerprint can have the same points */
+      auto itRange = m_mapConvexHullResources.equal_range(unFingerprint);
+      auto itConvexHullResource = itRange.first;
+      for(; itConvexHullResource != itRange.second; ++itConvexHullResource) {
+         if(itConvexHullResource->second.Points == vec_points) break;
       }
       /* If the resource doesn't exist, create a new one */
-      if(itConvexHullResource == std::end(m_vecConvexHullResources)) {
+      if(itConvexHullResource == itRange.second) {
          itConvexHullResource =
-            m_vecConvexHullResources.emplace(itConvexHullResource, vec_points);
+            m_mapConvexHullResources.emplace(unFingerprint, vec_points);
+      }
+      return std::static_pointer_cast<btCollisionShape>(itConvexHullResource->second.Shape);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   size_t CDynamics3DShapeManager::GetFingerprint(const std::vector<btVector3>& vec_points) {
+      std::hash<btScalar> tHash;
+      size_t unFingerprint = vec_points.size();
+      for(const btVector3& c_point : vec_points) {
+         for(btScalar f_coordinate : {c_point.getX(), c_point.getY(), c_point.getZ()}) {
+            unFingerprint ^= tHash(f_coordinate) + 0x9e3779b9 + (unFingerprint << 6) + (unFingerprint >> 2);
+         }
       }
-      return std::static_pointer_cast<btCollisionShape>(itConvexHullResource->Shape);
+      return unFingerprint;
    }
 
    /****************************************/
@@ -134,9 +151,13 @@ namespace argos {
       Points(vec_points),
       Shape(new btConvexHullShape) {
       Shape->setMargin(0);
+      /* Compute the bounding box once, after adding all the points */
       for(const btVector3& c_point : vec_points) {
-         Shape->addPoint(c_point);
+         Shape->addPoint(c_point, false);
       }
+      /* Keep only the vertices of the hull, the other points are never in contact */
+      Shape->optimizeConvexHull();
+      Shape->recalcLocalAabb();
    }
 
    /****************************************/
@@ -33,6 +33,7 @@ namespace argos {
 
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 namespace argos {
 
@@ -78,13 +79,14 @@ namespace argos {
       };
       static std::vector<SSphereResource> m_vecSphereResources;
 
-      /* convex hulls */
+      /* convex hulls, indexed by the fingerprint of their points */
       struct SConvexHullResource {
          SConvexHullResource(const std::vector<btVector3>& vec_points);
          std::vector<btVector3> Points;
          std::shared_ptr<btConvexHullShape> Shape;
       };
-      static std::vector<SConvexHullResource> m_vecConvexHullResources;
+      static size_t GetFingerprint(const std::vector<btVector3>& vec_points);
+      static std::unordered_multimap<size_t, SConvexHullResource> m_mapConvexHullResources;
    };
 
 }
@@ -81,6 +81,10 @@ namespace argos {
 
       virtual void CalculateBoundingBox();
 
+      virtual bool HasRigidBoundingBox() const {
+         return true;
+      }
+
       virtual void AddToWorld(btMultiBodyDynamicsWorld& c_world);
 
       virtual void RemoveFromWorld(btMultiBodyDynamicsWorld& c_world);
@@ -41,6 +41,10 @@ namespace argos {
 
       virtual bool IsCollidingWithSomething() const;
 
+      virtual bool HasRigidBoundingBox() const {
+         return true;
+      }
+
       virtual bool CheckIntersectionWithRay(Real& f_t_on_ray,
                                             const CRay3& c_ray) const = 0;
 
@@ -204,6 +204,8 @@ namespace argos {
       /* Clear the message table */
       m_pcLuaMessageTable->clearContents();
       m_pcLuaMessageTable->setRowCount(1);
+      /* Forget the bytecode of the previous versions of the script */
+      CLuaUtility::ClearScriptCache();
       /* Create temporary file to contain the bytecode */
       QTemporaryFile cByteCode;
       if(! cByteCode.open()) {
@@ -243,12 +245,12 @@ namespace argos {
       }
       /* Update Lua state if visible */
       if(m_pcLuaVariableDock->isVisible()) {
-         static_cast<CQTOpenGLLuaStateTreeModel*>(m_pcLuaVariableTree->model())->SetLuaState(
-            m_vecControllers[m_unSelectedRobot]->GetLuaState());
+         static_cast<CQTOpenGLLuaStateTreeModel*>(m_pcLuaVariableTree->model())->SetLuaController(
+            m_vecControllers[m_unSelectedRobot]);
       }
       if(m_pcLuaFunctionDock->isVisible()) {
-         static_cast<CQTOpenGLLuaStateTreeModel*>(m_pcLuaFunctionTree->model())->SetLuaState(
-            m_vecControllers[m_unSelectedRobot]->GetLuaState());
+         static_cast<CQTOpenGLLuaStateTreeModel*>(m_pcLuaFunctionTree->model())->SetLuaController(
+            m_vecControllers[m_unSelectedRobot]);
       }
       /* Resume simulation */
       m_pcMainWindow->ResumeExperiment();
@@ -707,7 +709,7 @@ namespace argos {
          if(bFound &&
             m_vecControllers[m_unSelectedRobot]->GetLuaState() != NULL) {
             CQTOpenGLLuaStateTreeVariableModel* pcVarModel =
-               new CQTOpenGLLuaStateTreeVariableModel(m_vecControllers[m_unSelectedRobot]->GetLuaState(),
+               new CQTOpenGLLuaStateTreeVariableModel(m_vecControllers[m_unSelectedRobot],
                                                       false,
                                                       m_pcLuaVariableTree);
             pcVarModel->Refresh();
@@ -720,10 +722,10 @@ namespace argos {
                     Qt::QueuedConnection);
             m_pcLuaVariableTree->setModel(pcVarModel);
             m_pcLuaVariableTree->setRootIndex(pcVarModel->index(0, 0));
-            m_pcLuaVariableTree->expandAll();
+            m_pcLuaVariableTree->expandToDepth(0);
             m_pcLuaVariableDock->show();
             CQTOpenGLLuaStateTreeFunctionModel* pcFunModel =
-               new CQTOpenGLLuaStateTreeFunctionModel(m_vecControllers[m_unSelectedRobot]->GetLuaState(),
+               new CQTOpenGLLuaStateTreeFunctionModel(m_vecControllers[m_unSelectedRobot],
                                                       true,
                                                       m_pcLuaFunctionTree);
             pcFunModel->Refresh();
@@ -736,7 +738,7 @@ namespace argos {
                     Qt::QueuedConnection);
             m_pcLuaFunctionTree->setModel(pcFunModel);
             m_pcLuaFunctionTree->setRootIndex(pcFunModel->index(0, 0));
-            m_pcLuaFunctionTree->expandAll();
+            m_pcLuaFunctionTree->expandToDepth(0);
             m_pcLuaFunctionDock->show();
          }
       }
@@ -771,7 +773,7 @@ namespace argos {
 
    void CQTOpenGLLuaMainWindow::VariableTreeChanged() {
       m_pcLuaVariableTree->setRootIndex(m_pcLuaVariableTree->model()->index(0, 0));
-      m_pcLuaVariableTree->expandAll();
+      m_pcLuaVariableTree->expandToDepth(0);
    }
 
    /****************************************/
@@ -779,7 +781,7 @@ namespace argos {
 
    void CQTOpenGLLuaMainWindow::FunctionTreeChanged() {
       m_pcLuaFunctionTree->setRootIndex(m_pcLuaFunctionTree->model()->index(0, 0));
-      m_pcLuaFunctionTree->expandAll();
+      m_pcLuaFunctionTree->expandToDepth(0);
    }
 
    /****************************************/
@@ -13,7 +13,10 @@ namespace argos {
    /****************************************/
 
    CQTOpenGLLuaStateTreeItem::CQTOpenGLLuaStateTreeItem(CQTOpenGLLuaStateTreeItem* pc_parent) :
-      m_pcParent(pc_parent) {}
+      m_pcParent(pc_parent),
+      m_ptTable(NULL),
+      m_bFetched(false),
+      m_bCycle(false) {}
 
    /****************************************/
    /****************************************/
@@ -21,7 +24,10 @@ namespace argos {
    CQTOpenGLLuaStateTreeItem::CQTOpenGLLuaStateTreeItem(QList<QVariant>& list_data,
                                                         CQTOpenGLLuaStateTreeItem* pc_parent) :
       m_listData(list_data),
-      m_pcParent(pc_parent) {}
+      m_pcParent(pc_parent),
+      m_ptTable(NULL),
+      m_bFetched(false),
+      m_bCycle(false) {}
 
    /****************************************/
    /****************************************/
@@ -54,6 +60,14 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CQTOpenGLLuaStateTreeItem::InsertChild(size_t un_idx,
+                                               CQTOpenGLLuaStateTreeItem* pc_child) {
+      m_listChildren.insert(un_idx, pc_child);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CQTOpenGLLuaStateTreeItem::RemoveChild(CQTOpenGLLuaStateTreeItem* pc_child) {
       m_listChildren.removeOne(pc_child);
    }
@@ -61,6 +75,21 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CQTOpenGLLuaStateTreeItem::DeleteChild(size_t un_idx) {
+      delete m_listChildren.takeAt(un_idx);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaStateTreeItem::DeleteChildren() {
+      qDeleteAll(m_listChildren);
+      m_listChildren.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
    size_t CQTOpenGLLuaStateTreeItem::GetNumChildren() const {
       return m_listChildren.count();
    }
@@ -68,20 +97,42 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   bool ItemLessThan(const CQTOpenGLLuaStateTreeItem* pc_i1,
-                     const CQTOpenGLLuaStateTreeItem* pc_i2) {
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-      if(pc_i1->GetData(0).typeId() == QMetaType::Double &&
-         pc_i2->GetData(0).typeId() == QMetaType::Double) {
-#else
-      if(pc_i1->GetData(0).type() == QVariant::Double &&
-         pc_i2->GetData(0).type() == QVariant::Double) {
-#endif
-         return pc_i1->GetData(0).toDouble() < pc_i2->GetData(0).toDouble();
+   static int KeyRank(const QVariant& c_key) {
+      switch(c_key.userType()) {
+         case QMetaType::Bool:   return 0;
+         case QMetaType::Double: return 1;
+         default:                return 2;
       }
-      else {
-         return pc_i1->GetData(0).toString().toLower() < pc_i2->GetData(0).toString().toLower();
+   }
+
+   bool CQTOpenGLLuaStateTreeItem::KeyLessThan(const QVariant& c_key1,
+                                               const QVariant& c_key2) {
+      int nRank1 = KeyRank(c_key1);
+      int nRank2 = KeyRank(c_key2);
+      if(nRank1 != nRank2) {
+         return nRank1 < nRank2;
+      }
+      if(nRank1 == 0) {
+         return c_key1.toBool() < c_key2.toBool();
+      }
+      if(nRank1 == 1) {
+         return c_key1.toDouble() < c_key2.toDouble();
+      }
+      /* The exact string breaks the ties, so that different keys never compare equal */
+      QString strLower1 = c_key1.toString().toLower();
+      QString strLower2 = c_key2.toString().toLower();
+      if(strLower1 != strLower2) {
+         return strLower1 < strLower2;
       }
+      return c_key1.toString() < c_key2.toString();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool ItemLessThan(const CQTOpenGLLuaStateTreeItem* pc_i1,
+                     const CQTOpenGLLuaStateTreeItem* pc_i2) {
+      return CQTOpenGLLuaStateTreeItem::KeyLessThan(pc_i1->GetData(0), pc_i2->GetData(0));
    }
 
    void CQTOpenGLLuaStateTreeItem::SortChildren() {
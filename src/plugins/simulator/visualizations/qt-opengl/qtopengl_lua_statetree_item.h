@@ -30,21 +30,88 @@ namespace argos {
 
       void AddChild(CQTOpenGLLuaStateTreeItem* pc_child);
 
+      void InsertChild(size_t un_idx,
+                       CQTOpenGLLuaStateTreeItem* pc_child);
+
       void RemoveChild(CQTOpenGLLuaStateTreeItem* pc_child);
 
+      /**
+       * Removes the child at the given position and deletes it.
+       */
+      void DeleteChild(size_t un_idx);
+
+      /**
+       * Removes all the children and deletes them.
+       */
+      void DeleteChildren();
+
       size_t GetNumChildren() const;
 
       void SortChildren();
 
       QVariant GetData(int n_col) const;
 
+      inline const QList<QVariant>& GetData() const {
+         return m_listData;
+      }
+
+      inline void SetData(const QList<QVariant>& list_data) {
+         m_listData = list_data;
+      }
+
+      /**
+       * Returns the Lua table this item stands for.
+       * For the items that are not tables, this is <tt>NULL</tt>.
+       */
+      inline const void* GetTable() const {
+         return m_ptTable;
+      }
+
+      inline void SetTable(const void* pt_table) {
+         m_ptTable = pt_table;
+      }
+
+      /**
+       * Returns <tt>true</tt> if the children of this item have been read.
+       */
+      inline bool IsFetched() const {
+         return m_bFetched;
+      }
+
+      inline void SetFetched(bool b_fetched) {
+         m_bFetched = b_fetched;
+      }
+
+      /**
+       * Returns <tt>true</tt> if this item is a table that contains itself.
+       * The children of such an item are never read.
+       */
+      inline bool IsCycle() const {
+         return m_bCycle;
+      }
+
+      inline void SetCycle(bool b_cycle) {
+         m_bCycle = b_cycle;
+      }
+
       int GetRow();
 
+      /**
+       * Compares two keys of a Lua table.
+       * Booleans come first, then numbers, then strings in case-insensitive
+       * order.
+       */
+      static bool KeyLessThan(const QVariant& c_key1,
+                              const QVariant& c_key2);
+
    private:
 
       QList<QVariant> m_listData;
       CQTOpenGLLuaStateTreeItem* m_pcParent;
       QList<CQTOpenGLLuaStateTreeItem*> m_listChildren;
+      const void* m_ptTable;
+      bool m_bFetched;
+      bool m_bCycle;
 
    };
 
@@ -12,7 +12,10 @@
 #include <argos3/core/wrappers/lua/lua_vector2.h>
 #include <argos3/core/wrappers/lua/lua_vector3.h>
 #include <argos3/core/wrappers/lua/lua_quaternion.h>
+#include <argos3/core/wrappers/lua/lua_controller.h>
 
+#include <algorithm>
+#include <iomanip>
 #include <sstream>
 
 namespace argos {
@@ -20,13 +23,19 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   CQTOpenGLLuaStateTreeModel::CQTOpenGLLuaStateTreeModel(lua_State* pt_state,
+   CQTOpenGLLuaStateTreeModel::CQTOpenGLLuaStateTreeModel(CLuaController* pc_controller,
                                                           bool b_remove_empty_tables,
                                                           QObject* pc_parent) :
       QAbstractItemModel(pc_parent),
-      m_ptState(pt_state),
+      m_pcController(pc_controller),
+      m_ptState(NULL),
+      m_unLuaStateLocks(0),
       m_bRemoveEmptyTables(b_remove_empty_tables) {
       m_pcDataRoot = new CQTOpenGLLuaStateTreeItem();
+      m_cRefreshTimer.setSingleShot(true);
+      m_cRefreshTimer.setInterval(REFRESH_PERIOD);
+      connect(&m_cRefreshTimer, SIGNAL(timeout()),
+              this, SLOT(Refresh()));
    }
 
    /****************************************/
@@ -125,108 +134,308 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLLuaStateTreeModel::SetLuaState(lua_State* pt_state) {
-      m_ptState = pt_state;
-      Refresh();
+   bool CQTOpenGLLuaStateTreeModel::hasChildren(const QModelIndex& c_parent) const {
+      if(c_parent.column() > 0) {
+         return false;
+      }
+      CQTOpenGLLuaStateTreeItem* pcItem;
+      if(!c_parent.isValid()) {
+         pcItem = m_pcDataRoot;
+      }
+      else {
+         pcItem = static_cast<CQTOpenGLLuaStateTreeItem*>(c_parent.internalPointer());
+      }
+      /* A table that has not been read yet may have children */
+      if(pcItem->GetTable() != NULL && !pcItem->IsCycle() && !pcItem->IsFetched()) {
+         return true;
+      }
+      return pcItem->GetNumChildren() > 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CQTOpenGLLuaStateTreeModel::canFetchMore(const QModelIndex& c_parent) const {
+      if(!c_parent.isValid()) {
+         return false;
+      }
+      CQTOpenGLLuaStateTreeItem* pcItem = static_cast<CQTOpenGLLuaStateTreeItem*>(c_parent.internalPointer());
+      return pcItem->GetTable() != NULL && !pcItem->IsCycle() && !pcItem->IsFetched();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaStateTreeModel::fetchMore(const QModelIndex& c_parent) {
+      if(!canFetchMore(c_parent)) {
+         return;
+      }
+      CQTOpenGLLuaStateTreeItem* pcItem = static_cast<CQTOpenGLLuaStateTreeItem*>(c_parent.internalPointer());
+      LockLuaState();
+      if(PushTable(pcItem)) {
+         FetchChildren(pcItem);
+         lua_pop(m_ptState, 1);
+      }
+      else {
+         /* The table is gone, the next refresh removes the item */
+         pcItem->SetFetched(true);
+      }
+      UnlockLuaState();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaStateTreeModel::SetLuaController(CLuaController* pc_controller) {
+      m_pcController = pc_controller;
+      Reset();
    }
 
    /****************************************/
    /****************************************/
 
    void CQTOpenGLLuaStateTreeModel::Refresh() {
-      beginResetModel();
-      delete m_pcDataRoot;
-      m_pcDataRoot = new CQTOpenGLLuaStateTreeItem();
-      lua_pushnil(m_ptState);
+      m_cRefreshTimer.stop();
+      LockLuaState();
       lua_getglobal(m_ptState, "_G");
-      ProcessLuaState(m_ptState, m_pcDataRoot);
-      m_pcDataRoot->SortChildren();
-      lua_pop(m_ptState, 2);
-      endResetModel();
+      if(m_pcDataRoot->GetNumChildren() == 0 ||
+         m_pcDataRoot->GetChild(0)->GetTable() != lua_topointer(m_ptState, -1)) {
+         /* A different state, start over */
+         lua_pop(m_ptState, 1);
+         Reset();
+      }
+      else {
+         UpdateChildren(m_pcDataRoot->GetChild(0));
+         lua_pop(m_ptState, 1);
+      }
+      UnlockLuaState();
    }
 
    /****************************************/
    /****************************************/
 
    void CQTOpenGLLuaStateTreeModel::Refresh(int) {
-      Refresh();
+      if(!m_cRefreshTimer.isActive()) {
+         m_cRefreshTimer.start();
+      }
    }
 
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLLuaStateTreeModel::ProcessLuaState(lua_State* pt_state,
-                                                    CQTOpenGLLuaStateTreeItem* pc_item) {
+   void CQTOpenGLLuaStateTreeModel::Reset() {
+      m_cRefreshTimer.stop();
+      beginResetModel();
+      m_pcDataRoot->DeleteChildren();
+      LockLuaState();
+      /* The item of the global table, with its first level of children */
       QList<QVariant> cData;
-      switch(lua_type(pt_state, -2)) {
-         case LUA_TBOOLEAN:
-            cData << lua_toboolean(pt_state, -2);
+      CQTOpenGLLuaStateTreeItem* pcGlobals = new CQTOpenGLLuaStateTreeItem(cData, m_pcDataRoot);
+      m_pcDataRoot->AddChild(pcGlobals);
+      lua_getglobal(m_ptState, "_G");
+      pcGlobals->SetTable(lua_topointer(m_ptState, -1));
+      std::vector<SEntry> vecEntries;
+      ReadTable(pcGlobals, vecEntries);
+      for(size_t i = 0; i < vecEntries.size(); ++i) {
+         pcGlobals->AddChild(MakeItem(vecEntries[i], pcGlobals));
+      }
+      pcGlobals->SetFetched(true);
+      lua_pop(m_ptState, 1);
+      UnlockLuaState();
+      endResetModel();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaStateTreeModel::LockLuaState() {
+      /*
+       * The state of the robot can be shared with other robots, which the
+       * simulation threads may be running. The views can call back into the
+       * model while it reads the state, so only the outermost call locks.
+       */
+      if(m_unLuaStateLocks == 0) {
+         m_pcController->LockLuaState();
+         m_ptState = m_pcController->GetLuaState();
+      }
+      ++m_unLuaStateLocks;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaStateTreeModel::UnlockLuaState() {
+      if(--m_unLuaStateLocks == 0) {
+         m_pcController->UnlockLuaState();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   QModelIndex CQTOpenGLLuaStateTreeModel::GetIndex(CQTOpenGLLuaStateTreeItem* pc_item) {
+      if(pc_item == m_pcDataRoot) {
+         return QModelIndex();
+      }
+      return createIndex(pc_item->GetRow(), 0, pc_item);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static void PushKey(lua_State* pt_state,
+                       const QVariant& c_key) {
+      switch(c_key.userType()) {
+         case QMetaType::Bool:
+            lua_pushboolean(pt_state, c_key.toBool());
             break;
-         case LUA_TNUMBER:
-            cData << lua_tonumber(pt_state, -2);
+         case QMetaType::Double:
+            lua_pushnumber(pt_state, c_key.toDouble());
             break;
-         case LUA_TSTRING:
-            cData << lua_tostring(pt_state, -2);
+         default:
+            lua_pushstring(pt_state, c_key.toString().toUtf8().constData());
             break;
-         default: break;
-      }
-      if(lua_istable(pt_state, -1)) {
-         CQTOpenGLLuaStateTreeItem* pcChild = new CQTOpenGLLuaStateTreeItem(cData, pc_item);
-         pc_item->AddChild(pcChild);
-         lua_pushnil(pt_state);
-         while(lua_next(pt_state, -2)) {
-            if(IsTypeVisitable(pt_state)) {
-               ProcessLuaState(pt_state, pcChild);
-            }
-            lua_pop(pt_state, 1);
+      }
+   }
+
+   bool CQTOpenGLLuaStateTreeModel::PushTable(CQTOpenGLLuaStateTreeItem* pc_item) {
+      if(pc_item->GetParent() == m_pcDataRoot) {
+         /* The global table */
+         lua_getglobal(m_ptState, "_G");
+      }
+      else {
+         /* Look up the item in the table of its parent */
+         if(!PushTable(pc_item->GetParent())) {
+            return false;
          }
-         if(m_bRemoveEmptyTables) {
-            if(pcChild->GetNumChildren() == 0) {
-               pc_item->RemoveChild(pcChild);
+         PushKey(m_ptState, pc_item->GetData(0));
+         lua_rawget(m_ptState, -2);
+         lua_remove(m_ptState, -2);
+      }
+      if(!lua_istable(m_ptState, -1) ||
+         lua_topointer(m_ptState, -1) != pc_item->GetTable()) {
+         lua_pop(m_ptState, 1);
+         return false;
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaStateTreeModel::ReadTable(CQTOpenGLLuaStateTreeItem* pc_item,
+                                              std::vector<SEntry>& vec_entries) {
+      /* The table is at the top of the stack */
+      lua_pushnil(m_ptState);
+      while(lua_next(m_ptState, -2)) {
+         if(IsTypeVisitable(m_ptState)) {
+            SEntry sEntry;
+            if(ReadEntry(sEntry)) {
+               if(sEntry.Table != NULL) {
+                  /* A table is a cycle if it is one of the tables containing it */
+                  for(CQTOpenGLLuaStateTreeItem* pcAncestor = pc_item;
+                      pcAncestor != m_pcDataRoot;
+                      pcAncestor = pcAncestor->GetParent()) {
+                     if(pcAncestor->GetTable() == sEntry.Table) {
+                        sEntry.Cycle = true;
+                        sEntry.Data << tr("<cycle>");
+                        break;
+                     }
+                  }
+               }
+               if(sEntry.Table == NULL ||
+                  sEntry.Cycle ||
+                  !m_bRemoveEmptyTables ||
+                  HasVisitableEntries()) {
+                  vec_entries.push_back(sEntry);
+               }
             }
          }
+         lua_pop(m_ptState, 1);
       }
-      else if(lua_isuserdata(pt_state, -1)) {
+      /* Sort the entries, as the children are kept sorted */
+      std::sort(vec_entries.begin(), vec_entries.end(),
+                [](const SEntry& s_a, const SEntry& s_b) {
+                   return CQTOpenGLLuaStateTreeItem::KeyLessThan(s_a.Data.value(0),
+                                                                 s_b.Data.value(0));
+                });
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CQTOpenGLLuaStateTreeModel::HasVisitableEntries() {
+      /* The table is at the top of the stack */
+      bool bFound = false;
+      lua_pushnil(m_ptState);
+      while(!bFound && lua_next(m_ptState, -2)) {
+         bFound = IsTypeVisitable(m_ptState);
+         lua_pop(m_ptState, 1);
+      }
+      if(bFound) {
+         /* Pop the key left by the interrupted traversal */
+         lua_pop(m_ptState, 1);
+      }
+      return bFound;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CQTOpenGLLuaStateTreeModel::ReadEntry(SEntry& s_entry) {
+      /* The key is at -2, the value at -1 */
+      s_entry.Table = NULL;
+      s_entry.Cycle = false;
+      QList<QVariant>& cData = s_entry.Data;
+      switch(lua_type(m_ptState, -2)) {
+         case LUA_TBOOLEAN:
+            cData << static_cast<bool>(lua_toboolean(m_ptState, -2));
+            break;
+         case LUA_TNUMBER:
+            cData << lua_tonumber(m_ptState, -2);
+            break;
+         case LUA_TSTRING:
+            cData << lua_tostring(m_ptState, -2);
+            break;
+         default:
+            /* The keys of the other types can't be looked up again */
+            return false;
+      }
+      if(lua_istable(m_ptState, -1)) {
+         s_entry.Table = lua_topointer(m_ptState, -1);
+         return true;
+      }
+      else if(lua_isuserdata(m_ptState, -1)) {
          std::ostringstream cBuffer;
          cBuffer << std::fixed;
-         void *pvUserdatum = lua_touserdata(pt_state, -1);
-         if (lua_getmetatable(pt_state, -1)) {
-            lua_getfield(pt_state, LUA_REGISTRYINDEX, CLuaVector2::GetTypeId().c_str());  /* get correct metatable */
-            if (lua_rawequal(pt_state, -1, -2)) {
-               /* remove the two metatables */
-               lua_pop(pt_state, 2);
-               /* add the entry to the table */
+         void *pvUserdatum = lua_touserdata(m_ptState, -1);
+         bool bKnown = false;
+         if (lua_getmetatable(m_ptState, -1)) {
+            lua_getfield(m_ptState, LUA_REGISTRYINDEX, CLuaVector2::GetTypeId().c_str());  /* get correct metatable */
+            if (lua_rawequal(m_ptState, -1, -2)) {
                CVector2* pcVector2 = static_cast<CVector2*>(pvUserdatum);
                cBuffer << std::setprecision(3)
                        << pcVector2->GetX() << ", "
                        << pcVector2->GetY();
-               cData << cBuffer.str().c_str();
-               pc_item->AddChild(new CQTOpenGLLuaStateTreeItem(cData, pc_item));
+               bKnown = true;
             }
             else {
                /* remove the vector2 metatable */
-               lua_pop(pt_state, 1);
-               lua_getfield(pt_state, LUA_REGISTRYINDEX, CLuaVector3::GetTypeId().c_str());
-               if (lua_rawequal(pt_state, -1, -2)) {
-                  /* remove the two metatables */
-                  lua_pop(pt_state, 2);
-                  /* add the entry to the table */
+               lua_pop(m_ptState, 1);
+               lua_getfield(m_ptState, LUA_REGISTRYINDEX, CLuaVector3::GetTypeId().c_str());
+               if (lua_rawequal(m_ptState, -1, -2)) {
                   CVector3* pcVector3 = static_cast<CVector3*>(pvUserdatum);
                   cBuffer << std::setprecision(3)
                           << pcVector3->GetX() << ", "
                           << pcVector3->GetY() << ", "
                           << pcVector3->GetZ();
-                  cData << cBuffer.str().c_str();
-                  pc_item->AddChild(new CQTOpenGLLuaStateTreeItem(cData, pc_item));
+                  bKnown = true;
                }
                else {
                   /* remove the vector3 metatable */
-                  lua_pop(pt_state, 1);
-                  lua_getfield(pt_state, LUA_REGISTRYINDEX, CLuaQuaternion::GetTypeId().c_str());
-                  if (lua_rawequal(pt_state, -1, -2)) {
-                     /* remove the two metatables */
-                     lua_pop(pt_state, 2);
-                     /* add the entry to the table */
+                  lua_pop(m_ptState, 1);
+                  lua_getfield(m_ptState, LUA_REGISTRYINDEX, CLuaQuaternion::GetTypeId().c_str());
+                  if (lua_rawequal(m_ptState, -1, -2)) {
                      CQuaternion* pcQuaternion = static_cast<CQuaternion*>(pvUserdatum);
                      CRadians cZ, cY, cX;
                      pcQuaternion->ToEulerAngles(cZ, cY, cX);
@@ -234,44 +443,142 @@ namespace argos {
                              << ToDegrees(cZ).GetValue() << ", "
                              << ToDegrees(cY).GetValue() << ", "
                              << ToDegrees(cX).GetValue();
-                     cData << cBuffer.str().c_str();
-                     pc_item->AddChild(new CQTOpenGLLuaStateTreeItem(cData, pc_item));
+                     bKnown = true;
                   }
                }
             }
+            /* remove the two metatables */
+            lua_pop(m_ptState, 2);
+         }
+         if(bKnown) {
+            cData << cBuffer.str().c_str();
          }
+         return bKnown;
       }
       else {
-         switch(lua_type(pt_state, -1)) {
+         switch(lua_type(m_ptState, -1)) {
             case LUA_TBOOLEAN:
-               cData << lua_toboolean(pt_state, -1);
-               pc_item->AddChild(new CQTOpenGLLuaStateTreeItem(cData, pc_item));
-               break;
+               cData << static_cast<bool>(lua_toboolean(m_ptState, -1));
+               return true;
             case LUA_TNUMBER:
-               cData << lua_tonumber(pt_state, -1);
-               pc_item->AddChild(new CQTOpenGLLuaStateTreeItem(cData, pc_item));
-               break;
+               cData << lua_tonumber(m_ptState, -1);
+               return true;
             case LUA_TSTRING:
-               cData << lua_tostring(pt_state, -1);
-               pc_item->AddChild(new CQTOpenGLLuaStateTreeItem(cData, pc_item));
-               break;
+               cData << lua_tostring(m_ptState, -1);
+               return true;
             case LUA_TFUNCTION:
                cData[0] = cData[0].toString() + tr("()");
-               pc_item->AddChild(new CQTOpenGLLuaStateTreeItem(cData, pc_item));
-               break;
+               return true;
             default:
-               break;
+               return false;
          }
       }
    }
 
    /****************************************/
    /****************************************/
-   
-   CQTOpenGLLuaStateTreeVariableModel::CQTOpenGLLuaStateTreeVariableModel(lua_State* pt_state,
+
+   CQTOpenGLLuaStateTreeItem* CQTOpenGLLuaStateTreeModel::MakeItem(const SEntry& s_entry,
+                                                                    CQTOpenGLLuaStateTreeItem* pc_parent) {
+      QList<QVariant> cData = s_entry.Data;
+      CQTOpenGLLuaStateTreeItem* pcItem = new CQTOpenGLLuaStateTreeItem(cData, pc_parent);
+      pcItem->SetTable(s_entry.Table);
+      pcItem->SetCycle(s_entry.Cycle);
+      return pcItem;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaStateTreeModel::FetchChildren(CQTOpenGLLuaStateTreeItem* pc_item) {
+      /* The table is at the top of the stack */
+      std::vector<SEntry> vecEntries;
+      ReadTable(pc_item, vecEntries);
+      if(!vecEntries.empty()) {
+         beginInsertRows(GetIndex(pc_item), 0, vecEntries.size() - 1);
+         for(size_t i = 0; i < vecEntries.size(); ++i) {
+            pc_item->AddChild(MakeItem(vecEntries[i], pc_item));
+         }
+         endInsertRows();
+      }
+      pc_item->SetFetched(true);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaStateTreeModel::UpdateChildren(CQTOpenGLLuaStateTreeItem* pc_item) {
+      /* The table is at the top of the stack */
+      std::vector<SEntry> vecEntries;
+      ReadTable(pc_item, vecEntries);
+      QModelIndex cParent = GetIndex(pc_item);
+      /* Merge the sorted entries with the sorted children */
+      size_t i = 0, j = 0;
+      while(i < pc_item->GetNumChildren() || j < vecEntries.size()) {
+         CQTOpenGLLuaStateTreeItem* pcChild =
+            (i < pc_item->GetNumChildren()) ? pc_item->GetChild(i) : NULL;
+         if(pcChild != NULL &&
+            (j == vecEntries.size() ||
+             CQTOpenGLLuaStateTreeItem::KeyLessThan(pcChild->GetData(0), vecEntries[j].Data.value(0)))) {
+            /* The key is gone */
+            beginRemoveRows(cParent, i, i);
+            pc_item->DeleteChild(i);
+            endRemoveRows();
+         }
+         else if(pcChild == NULL ||
+                 CQTOpenGLLuaStateTreeItem::KeyLessThan(vecEntries[j].Data.value(0), pcChild->GetData(0))) {
+            /* The key is new */
+            beginInsertRows(cParent, i, i);
+            pc_item->InsertChild(i, MakeItem(vecEntries[j], pc_item));
+            endInsertRows();
+            ++i;
+            ++j;
+         }
+         else {
+            /* The key is still there, check the value */
+            if(pcChild->GetTable() != vecEntries[j].Table ||
+               pcChild->IsCycle() != vecEntries[j].Cycle) {
+               /* Another table or another type, forget the content read so far */
+               if(pcChild->GetNumChildren() > 0) {
+                  beginRemoveRows(GetIndex(pcChild), 0, pcChild->GetNumChildren() - 1);
+                  pcChild->DeleteChildren();
+                  endRemoveRows();
+               }
+               pcChild->SetTable(vecEntries[j].Table);
+               pcChild->SetCycle(vecEntries[j].Cycle);
+               /* A new table replacing an expanded one is read below */
+               pcChild->SetFetched(pcChild->IsFetched() &&
+                                   vecEntries[j].Table != NULL &&
+                                   !vecEntries[j].Cycle);
+            }
+            if(pcChild->GetData() != vecEntries[j].Data) {
+               pcChild->SetData(vecEntries[j].Data);
+               emit dataChanged(createIndex(i, 0, pcChild),
+                                createIndex(i, columnCount(cParent) - 1, pcChild));
+            }
+            ++i;
+            ++j;
+         }
+      }
+      /* Visit the tables whose content has been read */
+      for(size_t k = 0; k < pc_item->GetNumChildren(); ++k) {
+         CQTOpenGLLuaStateTreeItem* pcChild = pc_item->GetChild(k);
+         if(pcChild->IsFetched()) {
+            PushKey(m_ptState, pcChild->GetData(0));
+            lua_rawget(m_ptState, -2);
+            UpdateChildren(pcChild);
+            lua_pop(m_ptState, 1);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLLuaStateTreeVariableModel::CQTOpenGLLuaStateTreeVariableModel(CLuaController* pc_controller,
                                                                           bool b_remove_empty_tables,
                                                                           QObject* pc_parent) :
-      CQTOpenGLLuaStateTreeModel(pt_state, b_remove_empty_tables, pc_parent) {}
+      CQTOpenGLLuaStateTreeModel(pc_controller, b_remove_empty_tables, pc_parent) {}
 
    /****************************************/
    /****************************************/
@@ -332,10 +639,10 @@ namespace argos {
    /****************************************/
    /****************************************/
    
-   CQTOpenGLLuaStateTreeFunctionModel::CQTOpenGLLuaStateTreeFunctionModel(lua_State* pt_state,
+   CQTOpenGLLuaStateTreeFunctionModel::CQTOpenGLLuaStateTreeFunctionModel(CLuaController* pc_controller,
                                                                           bool b_remove_empty_tables,
                                                                           QObject* pc_parent) :
-      CQTOpenGLLuaStateTreeModel(pt_state, b_remove_empty_tables, pc_parent) {}
+      CQTOpenGLLuaStateTreeModel(pc_controller, b_remove_empty_tables, pc_parent) {}
 
    /****************************************/
    /****************************************/
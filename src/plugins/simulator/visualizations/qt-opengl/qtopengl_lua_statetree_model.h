@@ -12,6 +12,7 @@ namespace argos {
    class CQTOpenGLLuaStateTreeVariableModel;
    class CQTOpenGLLuaStateTreeFunctionModel;
    class CQTOpenGLLuaStateTreeItem;   
+   class CLuaController;
 }
 
 extern "C" {
@@ -20,20 +21,42 @@ extern "C" {
 
 #include <QAbstractItemModel>
 #include <QModelIndex>
+#include <QTimer>
 #include <QVariant>
+#include <vector>
 
 namespace argos {
 
    /****************************************/
    /****************************************/
 
+   /**
+    * A tree model of the global variables of a Lua controller.
+    * <p>
+    * The model is lazy: the content of a table is read only when the table
+    * is expanded in the view. When the model is refreshed, only the tables
+    * already read are visited again, and they are compared with what the
+    * model holds, so the view gets row insertions, row removals and data
+    * changes instead of a full reset. The tables that contain themselves,
+    * directly or through other tables, are shown once and never expanded.
+    * </p>
+    * <p>
+    * The refreshes requested at each simulation step are merged, so that the
+    * model is refreshed at most once every REFRESH_PERIOD milliseconds.
+    * </p>
+    */
    class CQTOpenGLLuaStateTreeModel : public QAbstractItemModel {
 
       Q_OBJECT
 
    public:
 
-      CQTOpenGLLuaStateTreeModel(lua_State* pt_state,
+      /** The minimum time between two refreshes at each step, in milliseconds */
+      static const int REFRESH_PERIOD = 100;
+
+   public:
+
+      CQTOpenGLLuaStateTreeModel(CLuaController* pc_controller,
                                  bool b_remove_empty_tables,
                                  QObject* pc_parent = 0);
 
@@ -52,25 +75,73 @@ namespace argos {
 
       virtual int rowCount(const QModelIndex& c_parent = QModelIndex()) const;
 
-      void SetLuaState(lua_State* pt_state);
+      virtual bool hasChildren(const QModelIndex& c_parent = QModelIndex()) const;
+
+      virtual bool canFetchMore(const QModelIndex& c_parent) const;
+
+      virtual void fetchMore(const QModelIndex& c_parent);
+
+      void SetLuaController(CLuaController* pc_controller);
 
    public slots:
 
+      /**
+       * Refreshes the model immediately.
+       */
       void Refresh();
+
+      /**
+       * Schedules a refresh of the model.
+       * This slot is meant to be connected to the step signal.
+       */
       void Refresh(int);
 
    protected:
 
-      void ProcessLuaState(lua_State* pt_state,
-                           CQTOpenGLLuaStateTreeItem* pc_item);
-
       virtual bool IsTypeVisitable(lua_State* pt_state) = 0;
 
    private:
 
+      struct SEntry {
+         QList<QVariant> Data;
+         const void* Table;
+         bool Cycle;
+      };
+
+   private:
+
+      void Reset();
+
+      void LockLuaState();
+
+      void UnlockLuaState();
+
+      QModelIndex GetIndex(CQTOpenGLLuaStateTreeItem* pc_item);
+
+      bool PushTable(CQTOpenGLLuaStateTreeItem* pc_item);
+
+      void ReadTable(CQTOpenGLLuaStateTreeItem* pc_item,
+                     std::vector<SEntry>& vec_entries);
+
+      bool ReadEntry(SEntry& s_entry);
+
+      bool HasVisitableEntries();
+
+      CQTOpenGLLuaStateTreeItem* MakeItem(const SEntry& s_entry,
+                                          CQTOpenGLLuaStateTreeItem* pc_parent);
+
+      void FetchChildren(CQTOpenGLLuaStateTreeItem* pc_item);
+
+      void UpdateChildren(CQTOpenGLLuaStateTreeItem* pc_item);
+
+   private:
+
+      CLuaController* m_pcController;
       lua_State* m_ptState;
+      unsigned int m_unLuaStateLocks;
       CQTOpenGLLuaStateTreeItem* m_pcDataRoot;
       bool m_bRemoveEmptyTables;
+      QTimer m_cRefreshTimer;
 
    };
 
@@ -83,7 +154,7 @@ namespace argos {
 
    public:
 
-      CQTOpenGLLuaStateTreeVariableModel(lua_State* pt_state,
+      CQTOpenGLLuaStateTreeVariableModel(CLuaController* pc_controller,
                                          bool b_remove_empty_tables,
                                          QObject* pc_parent = 0);
 
@@ -110,7 +181,7 @@ namespace argos {
 
    public:
 
-      CQTOpenGLLuaStateTreeFunctionModel(lua_State* pt_state,
+      CQTOpenGLLuaStateTreeFunctionModel(CLuaController* pc_controller,
                                          bool b_remove_empty_tables,
                                          QObject* pc_parent = 0);
 
@@ -8,7 +8,7 @@ _argos3() {
     # previous token
     prev="${COMP_WORDS[COMP_CWORD-1]}"
     # option list
-    opts="-h --help -v --version -c --config-file -q --query -n --no-color -l --log-file -e --logerr-file"
+    opts="-h --help -v --version -c --config-file -q --query -i --index-plugins -n --no-color -l --log-file -e --logerr-file"
     # Complete option arguments
     case "${prev}" in
         -h|--help|-v|--version|-n|--no-color)
@@ -19,11 +19,15 @@ _argos3() {
             return 0
             ;;
         -q|--query)
-            local plugintypes=all actuators sensors physics_engines media visualizations entities
+            local plugintypes=all actuators sensors physics_engines media visualizations entities recorder_fields
             local plugins=$(argos3 -n -q all | grep -v '^\[INFO\]' | grep '\[ ' | tr -d "[]()" | cut -c 5- | cut -d\  -f1 | sort | xargs)
             COMPREPLY=( $(compgen -W "${plugintypes} ${plugins}" -- ${cur}) )
             return 0
             ;;
+        -i|--index-plugins)
+            _filedir -d
+            return 0
+            ;;
         -l|--log-file|-e|--logerr-file)
             COMPREPLY=( $(compgen -f ${cur}) )
             return 0
@@ -0,0 +1,133 @@
+/*
+ * Measures the time to load an experiment with many explicitly placed
+ * entities, from the XML and from the compiled form, and the time to
+ * initialize its arena from the compiled form. Checks that the compiled form
+ * yields the same tree as the XML, and that all the entities are created.
+ *
+ * Usage: compiled_configuration_benchmark [number of boxes]
+ *
+ * The boxes are static and placed on a square lattice in a dynamics2d
+ * engine, as in the arenas generated by scripts.
+ */
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/configuration/compiled_configuration.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+static const char* XML_FILE_NAME = "compiled_configuration_benchmark.argos";
+static const char* COMPILED_FILE_NAME = "compiled_configuration_benchmark.argosb";
+static const Real SPACING = 0.2;
+
+/****************************************/
+/****************************************/
+
+static void WriteExperiment(UInt32 un_boxes) {
+   UInt32 unSide = static_cast<UInt32>(std::ceil(std::sqrt(static_cast<Real>(un_boxes))));
+   Real fHalfSide = unSide * SPACING * 0.5;
+   Real fArena = unSide * SPACING + 1.0;
+   std::ofstream cFile(XML_FILE_NAME);
+   cFile << "<?xml version=\"1.0\" ?>\n"
+         << "<argos-configuration>\n"
+         << "  <framework>\n"
+         << "    <system threads=\"0\" />\n"
+         << "    <experiment length=\"0\" ticks_per_second=\"10\" random_seed=\"12345\" />\n"
+         << "  </framework>\n"
+         << "  <controllers />\n"
+         << "  <arena size=\"" << fArena << "," << fArena << ",1\" center=\"0,0,0.5\">\n";
+   for(UInt32 i = 0; i < un_boxes; ++i) {
+      cFile << "    <box id=\"box" << i << "\" size=\"0.1,0.1,0.1\" movable=\"false\">\n"
+            << "      <body position=\""
+            << ((i % unSide) * SPACING - fHalfSide) << ","
+            << ((i / unSide) * SPACING - fHalfSide) << ",0\" orientation=\"0,0,0\" />\n"
+            << "    </box>\n";
+   }
+   cFile << "  </arena>\n"
+         << "  <physics_engines>\n"
+         << "    <dynamics2d id=\"dyn2d\" />\n"
+         << "  </physics_engines>\n"
+         << "  <media />\n"
+         << "</argos-configuration>\n";
+}
+
+/*
+ * Returns the time since the given instant in seconds.
+ */
+static double Elapsed(const std::chrono::steady_clock::time_point& t_start) {
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+}
+
+/*
+ * Returns the given tree as XML text, without the declaration.
+ */
+static std::string ToString(ticpp::Document& t_document) {
+   std::ostringstream cXML;
+   cXML << *t_document.FirstChildElement();
+   return cXML.str();
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unBoxes = (argc > 1) ? std::atoi(argv[1]) : 50000;
+   int nResult = EXIT_SUCCESS;
+   try {
+      CDynamicLoading::LoadLibrariesOnDemand();
+      WriteExperiment(unBoxes);
+      /* Load the XML */
+      ticpp::Document tXML;
+      auto tStart = std::chrono::steady_clock::now();
+      LoadConfiguration(tXML, XML_FILE_NAME);
+      double fXMLLoad = Elapsed(tStart);
+      /* Compile it and load the compiled form */
+      SaveCompiledConfiguration(tXML, COMPILED_FILE_NAME);
+      if(!IsCompiledConfiguration(COMPILED_FILE_NAME)) {
+         THROW_ARGOSEXCEPTION("\"" << COMPILED_FILE_NAME << "\" is not recognized as compiled");
+      }
+      ticpp::Document tCompiled;
+      tStart = std::chrono::steady_clock::now();
+      LoadConfiguration(tCompiled, COMPILED_FILE_NAME);
+      double fCompiledLoad = Elapsed(tStart);
+      if(ToString(tXML) != ToString(tCompiled)) {
+         THROW_ARGOSEXCEPTION("The compiled form differs from the XML");
+      }
+      /* Initialize the arena */
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      tStart = std::chrono::steady_clock::now();
+      cSimulator.Load(tCompiled, true);
+      double fInit = Elapsed(tStart);
+      size_t unCreated = cSimulator.GetSpace().GetEntitiesByType("box").size();
+      cSimulator.Destroy();
+      /* Report */
+      std::cout << unBoxes << " boxes, "
+                << fXMLLoad << " s to load the XML, "
+                << fCompiledLoad << " s to load the compiled form, "
+                << fInit << " s to initialize the arena"
+                << std::endl;
+      if(unCreated != unBoxes) {
+         std::cerr << "Expected " << unBoxes << " boxes, found " << unCreated << std::endl;
+         nResult = EXIT_FAILURE;
+      }
+   }
+   catch(std::exception& ex) {
+      std::cerr << ex.what() << std::endl;
+      nResult = EXIT_FAILURE;
+   }
+   std::remove(XML_FILE_NAME);
+   std::remove(COMPILED_FILE_NAME);
+   return nResult;
+}
@@ -0,0 +1,206 @@
+/*
+ * Checks the component registry of the composable entities, and compares the
+ * speed of the component lookups by string path, through the component map,
+ * and by label id.
+ *
+ * Usage: component_lookup_benchmark [number of lookups]
+ *
+ * The test robot mimics a foot-bot: a dozen components with different
+ * labels, one of which is a composable entity with 12 LEDs.
+ */
+
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/utility/string_utilities.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+/*
+ * A component with a configurable label, which records the order of the
+ * updates.
+ */
+class CTestComponentEntity : public CEntity {
+public:
+   CTestComponentEntity(CComposableEntity* pc_parent,
+                        const std::string& str_label,
+                        const std::string& str_id,
+                        std::vector<CEntity*>* pvec_updates) :
+      CEntity(pc_parent, str_id),
+      m_strLabel(str_label),
+      m_pvecUpdates(pvec_updates) {}
+   virtual std::string GetTypeDescription() const {
+      return m_strLabel;
+   }
+   virtual void Update() {
+      m_pvecUpdates->push_back(this);
+   }
+private:
+   std::string m_strLabel;
+   std::vector<CEntity*>* m_pvecUpdates;
+};
+
+/*
+ * A composable component with a configurable label.
+ */
+class CTestComposableEntity : public CComposableEntity {
+public:
+   CTestComposableEntity(CComposableEntity* pc_parent,
+                         const std::string& str_label,
+                         const std::string& str_id) :
+      CComposableEntity(pc_parent, str_id),
+      m_strLabel(str_label) {}
+   virtual std::string GetTypeDescription() const {
+      return m_strLabel;
+   }
+private:
+   std::string m_strLabel;
+};
+
+/****************************************/
+/****************************************/
+
+static double Nanoseconds(std::chrono::steady_clock::time_point t_start,
+                          UInt32 un_lookups) {
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count() * 1e9 / un_lookups;
+}
+
+#define CHECK(CONDITION)                                                \
+   if(!(CONDITION)) {                                                   \
+      std::cerr << "Check failed: " #CONDITION << std::endl;            \
+      return EXIT_FAILURE;                                              \
+   }
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unLookups = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+   try {
+      /* Build the robot, adding the components in non-alphabetical order */
+      std::vector<CEntity*> vecUpdates;
+      CComposableEntity cRobot(nullptr, "fb");
+      std::vector<std::string> vecLabels = {
+         "body", "wheels", "proximity", "light", "ground", "gripper",
+         "distance_scanner", "rab", "turret", "battery", "controller"
+      };
+      for(const std::string& str_label : vecLabels) {
+         cRobot.AddComponent(*new CTestComponentEntity(&cRobot, str_label, str_label + "_0", &vecUpdates));
+      }
+      auto* pcLEDs = new CTestComposableEntity(&cRobot, "leds", "leds_0");
+      cRobot.AddComponent(*pcLEDs);
+      for(UInt32 i = 0; i < 12; ++i) {
+         pcLEDs->AddComponent(*new CTestComponentEntity(pcLEDs, "led", "led_" + ToString(i), &vecUpdates));
+      }
+      /* A second component with the same label */
+      auto* pcSecondRAB = new CTestComponentEntity(&cRobot, "rab", "rab_1", &vecUpdates);
+      cRobot.AddComponent(*pcSecondRAB);
+      /* The string API and the label ids find the same components */
+      CComposableEntity::TLabelId tLEDs = CComposableEntity::GetLabelId("leds");
+      CComposableEntity::TLabelId tLED = CComposableEntity::GetLabelId("led");
+      CComposableEntity::TLabelId tRAB = CComposableEntity::GetLabelId("rab");
+      CHECK(CComposableEntity::FindLabelId("no_such_label") == CComposableEntity::NO_LABEL);
+      CHECK(&cRobot.GetComponent("leds") == pcLEDs);
+      CHECK(&cRobot.GetComponent(tLEDs) == pcLEDs);
+      CHECK(&cRobot.GetComponent<CComposableEntity>(tLEDs) == pcLEDs);
+      CHECK(&cRobot.GetComponent("leds.led[led_3]") == pcLEDs->GetComponents(tLED)[3]);
+      CHECK(&cRobot.GetComponent("rab") == &cRobot.GetComponent(tRAB, 0));
+      CHECK(&cRobot.GetComponent("rab[rab_1]") == pcSecondRAB);
+      CHECK(&cRobot.GetComponent(tRAB, 1) == pcSecondRAB);
+      CHECK(cRobot.FindComponent("rab[rab_1]")->second == pcSecondRAB);
+      CHECK(cRobot.HasComponent("leds.led[led_11]"));
+      CHECK(!cRobot.HasComponent("leds.led[led_12]"));
+      CHECK(!cRobot.HasComponent("rab[rab_2]"));
+      CHECK(!cRobot.HasComponent("no_such_label"));
+      CHECK(!cRobot.HasComponent(tRAB, 2));
+      CHECK(cRobot.GetComponents(CComposableEntity::NO_LABEL).empty());
+      /* The updates follow the order of the component map */
+      std::vector<CEntity*> vecExpected;
+      for(const auto& c_item : cRobot.GetComponentMap()) {
+         if(c_item.second == pcLEDs) {
+            for(const auto& c_led : pcLEDs->GetComponentMap()) vecExpected.push_back(c_led.second);
+         }
+         else {
+            vecExpected.push_back(c_item.second);
+         }
+      }
+      cRobot.UpdateComponents();
+      CHECK(vecUpdates == vecExpected);
+      /* Removals keep the registry consistent */
+      CEntity& cRemoved = cRobot.RemoveComponent("rab[rab_0]");
+      CHECK(&cRemoved != pcSecondRAB);
+      CHECK(&cRobot.GetComponent(tRAB) == pcSecondRAB);
+      CHECK(&cRobot.GetComponent("rab") == pcSecondRAB);
+      CHECK(!cRobot.HasComponent("rab[rab_0]"));
+      vecUpdates.clear();
+      cRobot.UpdateComponents();
+      CHECK(vecUpdates.size() == vecExpected.size() - 1);
+      delete &cRemoved;
+      /* Lookup speed */
+      std::vector<std::string> vecPaths = { "body", "controller", "rab[rab_1]", "leds.led[led_7]" };
+      for(const std::string& str_path : vecPaths) {
+         size_t unSeparator = str_path.find('.');
+         CEntity* pcFound = nullptr;
+         /* Through the component map, as the string API used to do */
+         auto tStart = std::chrono::steady_clock::now();
+         for(UInt32 i = 0; i < unLookups; ++i) {
+            if(unSeparator == std::string::npos) {
+               pcFound = cRobot.FindComponent(str_path)->second;
+            }
+            else {
+               CComposableEntity* pcChild = static_cast<CComposableEntity*>(
+                  cRobot.FindComponent(str_path.substr(0, unSeparator))->second);
+               pcFound = pcChild->FindComponent(str_path.substr(unSeparator + 1))->second;
+            }
+         }
+         double fMapNS = Nanoseconds(tStart, unLookups);
+         CEntity* pcMapFound = pcFound;
+         /* Through the string API */
+         tStart = std::chrono::steady_clock::now();
+         for(UInt32 i = 0; i < unLookups; ++i) {
+            pcFound = &cRobot.GetComponent(str_path);
+         }
+         double fStringNS = Nanoseconds(tStart, unLookups);
+         CHECK(pcFound == pcMapFound);
+         /* Through label ids resolved once */
+         tStart = std::chrono::steady_clock::now();
+         if(str_path == "body") {
+            CComposableEntity::TLabelId tBody = CComposableEntity::GetLabelId("body");
+            for(UInt32 i = 0; i < unLookups; ++i) pcFound = &cRobot.GetComponent(tBody);
+         }
+         else if(str_path == "controller") {
+            CComposableEntity::TLabelId tController = CComposableEntity::GetLabelId("controller");
+            for(UInt32 i = 0; i < unLookups; ++i) pcFound = &cRobot.GetComponent(tController);
+         }
+         else if(str_path == "rab[rab_1]") {
+            for(UInt32 i = 0; i < unLookups; ++i) pcFound = &cRobot.GetComponent(tRAB, 0);
+         }
+         else {
+            for(UInt32 i = 0; i < unLookups; ++i) {
+               pcFound = &cRobot.GetComponent<CComposableEntity>(tLEDs).GetComponent(tLED, 7);
+            }
+         }
+         double fIdNS = Nanoseconds(tStart, unLookups);
+         CHECK(pcFound == pcMapFound);
+         std::cout << "\"" << str_path << "\": "
+                   << fMapNS << " ns through the map, "
+                   << fStringNS << " ns by string path, "
+                   << fIdNS << " ns by label id"
+                   << std::endl;
+      }
+      /* Clean up */
+      for(CEntity* pc_led : pcLEDs->GetComponentVector()) delete pc_led;
+      for(CEntity* pc_component : cRobot.GetComponentVector()) delete pc_component;
+   }
+   catch(CARGoSException& ex) {
+      std::cerr << ex.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,340 @@
+/*
+ * Compares the memory layouts of entity trees created on the heap and in
+ * entity pools, measuring the time and, where the kernel allows it, the cache
+ * misses of the per-step component updates. Also checks the bookkeeping of
+ * the pools. Compiled only when ARGoS is compiled with ARGOS_ENTITY_POOL.
+ *
+ * Usage: entity_pool_benchmark [number of robots] [components per robot] [steps]
+ *
+ * The layouts are: the heap with the components of each robot created one
+ * after the other, the heap with the components of all the robots created in
+ * random order, as in a heap fragmented by many additions and removals, and
+ * one entity pool per robot.
+ */
+
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/entity/entity_pool.h>
+#include <argos3/core/utility/math/vector3.h>
+#include <argos3/core/utility/string_utilities.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+/*
+ * A component whose update touches its own state, like a sensor or an LED.
+ */
+class CTestComponentEntity : public CEntity {
+public:
+   CTestComponentEntity(CComposableEntity* pc_parent,
+                        const std::string& str_id) :
+      CEntity(pc_parent, str_id),
+      m_cVelocity(0.001, 0.002, 0.0) {}
+   virtual std::string GetTypeDescription() const {
+      return "test_component";
+   }
+   virtual void Update() {
+      m_cPosition += m_cVelocity;
+   }
+   const CVector3& GetPosition() const {
+      return m_cPosition;
+   }
+private:
+   CVector3 m_cPosition;
+   CVector3 m_cVelocity;
+};
+
+/****************************************/
+/****************************************/
+
+/*
+ * Counts the cache misses of this process, if the kernel allows it.
+ */
+class CCacheMissCounter {
+public:
+   CCacheMissCounter() : m_nFD(-1) {
+#ifdef __linux__
+      perf_event_attr sAttr;
+      ::memset(&sAttr, 0, sizeof(sAttr));
+      sAttr.type = PERF_TYPE_HARDWARE;
+      sAttr.size = sizeof(sAttr);
+      sAttr.config = PERF_COUNT_HW_CACHE_MISSES;
+      sAttr.disabled = 1;
+      sAttr.exclude_kernel = 1;
+      sAttr.exclude_hv = 1;
+      m_nFD = ::syscall(__NR_perf_event_open, &sAttr, 0, -1, -1, 0);
+#endif
+   }
+   ~CCacheMissCounter() {
+#ifdef __linux__
+      if(m_nFD >= 0) ::close(m_nFD);
+#endif
+   }
+   bool IsAvailable() const {
+      return m_nFD >= 0;
+   }
+   void Start() {
+#ifdef __linux__
+      if(m_nFD >= 0) {
+         ::ioctl(m_nFD, PERF_EVENT_IOC_RESET, 0);
+         ::ioctl(m_nFD, PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+   }
+   UInt64 Stop() {
+      UInt64 unCount = 0;
+#ifdef __linux__
+      if(m_nFD >= 0) {
+         ::ioctl(m_nFD, PERF_EVENT_IOC_DISABLE, 0);
+         if(::read(m_nFD, &unCount, sizeof(unCount)) != sizeof(unCount)) unCount = 0;
+      }
+#endif
+      return unCount;
+   }
+private:
+   int m_nFD;
+};
+
+/****************************************/
+/****************************************/
+
+enum ELayout {
+   LAYOUT_HEAP_IN_ORDER,
+   LAYOUT_HEAP_SCATTERED,
+   LAYOUT_POOL
+};
+
+static const char* LAYOUT_NAMES[] = {
+   "heap, in order",
+   "heap, scattered",
+   "entity pools"
+};
+
+/*
+ * Creates the robots with the given layout.
+ */
+static std::vector<CComposableEntity*> CreateRobots(ELayout e_layout,
+                                                    UInt32 un_robots,
+                                                    UInt32 un_components,
+                                                    std::mt19937& c_rng) {
+   std::vector<CComposableEntity*> vecRobots;
+   if(e_layout == LAYOUT_HEAP_SCATTERED) {
+      for(UInt32 i = 0; i < un_robots; ++i) {
+         vecRobots.push_back(new CComposableEntity(nullptr, "robot_" + ToString(i)));
+      }
+      /* Create the components of all the robots in random order */
+      std::vector<std::pair<UInt32, UInt32> > vecOrder;
+      for(UInt32 i = 0; i < un_robots; ++i) {
+         for(UInt32 j = 0; j < un_components; ++j) {
+            vecOrder.emplace_back(i, j);
+         }
+      }
+      std::shuffle(vecOrder.begin(), vecOrder.end(), c_rng);
+      std::vector<std::vector<CEntity*> > vecComponents(un_robots, std::vector<CEntity*>(un_components));
+      for(const auto& c_item : vecOrder) {
+         vecComponents[c_item.first][c_item.second] =
+            new CTestComponentEntity(vecRobots[c_item.first], "component_" + ToString(c_item.second));
+      }
+      /* Add them to their robots in order */
+      for(UInt32 i = 0; i < un_robots; ++i) {
+         for(CEntity* pc_component : vecComponents[i]) {
+            vecRobots[i]->AddComponent(*pc_component);
+         }
+      }
+   }
+   else {
+      for(UInt32 i = 0; i < un_robots; ++i) {
+         std::unique_ptr<CEntityPool::CScope> pcScope;
+         if(e_layout == LAYOUT_POOL) pcScope.reset(new CEntityPool::CScope);
+         vecRobots.push_back(new CComposableEntity(nullptr, "robot_" + ToString(i)));
+         for(UInt32 j = 0; j < un_components; ++j) {
+            vecRobots.back()->AddComponent(
+               *new CTestComponentEntity(vecRobots.back(), "component_" + ToString(j)));
+         }
+      }
+   }
+   return vecRobots;
+}
+
+/*
+ * Deletes the robots and their components.
+ */
+static void DeleteRobots(std::vector<CComposableEntity*>& vec_robots) {
+   for(CComposableEntity* pc_robot : vec_robots) {
+      for(CEntity* pc_component : pc_robot->GetComponentVector()) {
+         delete pc_component;
+      }
+      delete pc_robot;
+   }
+   vec_robots.clear();
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Checks the bookkeeping of the pools. Returns false on error.
+ */
+static bool CheckPools() {
+   if(CEntityPool::GetCurrent() != nullptr) {
+      std::cerr << "A pool is current outside of any scope" << std::endl;
+      return false;
+   }
+   CComposableEntity* pcRobot;
+   CEntity* pcHeapComponent;
+   {
+      CEntityPool::CScope cScope;
+      pcRobot = new CComposableEntity(nullptr, "robot");
+      {
+         /* A nested scope has its own pool */
+         CEntityPool::CScope cNested;
+         delete new CTestComponentEntity(nullptr, "nested");
+         if(CEntityPool::GetCurrent() != &cNested.GetPool() ||
+            cNested.GetPool().GetNumEntities() != 0) {
+            std::cerr << "Wrong nested pool" << std::endl;
+            return false;
+         }
+      }
+      if(CEntityPool::GetCurrent() != &cScope.GetPool()) {
+         std::cerr << "The outer pool was not restored" << std::endl;
+         return false;
+      }
+      for(UInt32 j = 0; j < 10; ++j) {
+         pcRobot->AddComponent(*new CTestComponentEntity(pcRobot, "component_" + ToString(j)));
+      }
+      if(cScope.GetPool().GetNumEntities() != 11 ||
+         cScope.GetPool().GetNumChunks() != 1) {
+         std::cerr << "The pool has " << cScope.GetPool().GetNumEntities() << " entities in "
+                   << cScope.GetPool().GetNumChunks() << " chunks instead of 11 in 1" << std::endl;
+         return false;
+      }
+      /* The pooled entities are found in their pool */
+      if(CEntityPool::Find(pcRobot) != &cScope.GetPool() ||
+         CEntityPool::Find(pcRobot->GetComponentVector().back()) != &cScope.GetPool()) {
+         std::cerr << "The pooled entities are not found in their pool" << std::endl;
+         return false;
+      }
+      /* The entities are consecutive and aligned */
+      const char* pchPrevious = reinterpret_cast<const char*>(pcRobot);
+      for(CEntity* pc_component : pcRobot->GetComponentVector()) {
+         const char* pchComponent = reinterpret_cast<const char*>(pc_component);
+         if(pchComponent <= pchPrevious ||
+            pchComponent - pchPrevious > 2 * static_cast<std::ptrdiff_t>(sizeof(CComposableEntity)) ||
+            reinterpret_cast<std::uintptr_t>(pchComponent) % alignof(std::max_align_t) != 0) {
+            std::cerr << "The entities in the pool are not consecutive" << std::endl;
+            return false;
+         }
+         pchPrevious = pchComponent;
+      }
+   }
+   /* Outside of scopes, the entities come from the heap */
+   pcHeapComponent = new CTestComponentEntity(nullptr, "heap");
+   if(CEntityPool::Find(pcHeapComponent) != nullptr) {
+      std::cerr << "An entity on the heap is found in a pool" << std::endl;
+      return false;
+   }
+   delete pcHeapComponent;
+   /* The pool goes away with its last entity */
+   std::vector<CComposableEntity*> vecRobots(1, pcRobot);
+   DeleteRobots(vecRobots);
+   /* The entities of a pool can be deleted in other threads */
+   std::vector<CEntity*> vecEntities;
+   {
+      CEntityPool::CScope cScope;
+      for(UInt32 j = 0; j < 1000; ++j) {
+         vecEntities.push_back(new CTestComponentEntity(nullptr, "component_" + ToString(j)));
+      }
+      std::vector<std::thread> vecThreads;
+      for(UInt32 t = 0; t < 4; ++t) {
+         vecThreads.emplace_back([&vecEntities, t]() {
+               for(size_t j = t; j < vecEntities.size(); j += 4) {
+                  delete vecEntities[j];
+               }
+            });
+      }
+      for(std::thread& c_thread : vecThreads) {
+         c_thread.join();
+      }
+      if(cScope.GetPool().GetNumEntities() != 0) {
+         std::cerr << "The pool has " << cScope.GetPool().GetNumEntities()
+                   << " entities left after deleting them in other threads" << std::endl;
+         return false;
+      }
+   }
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unRobots = (argc > 1) ? std::atoi(argv[1]) : 10000;
+   UInt32 unComponents = (argc > 2) ? std::atoi(argv[2]) : 20;
+   UInt32 unSteps = (argc > 3) ? std::atoi(argv[3]) : 50;
+   if(!CheckPools()) {
+      return EXIT_FAILURE;
+   }
+   std::mt19937 cRNG(12345);
+   CCacheMissCounter cCounter;
+   std::cout << unRobots << " robots, "
+             << unComponents << " components per robot, "
+             << unSteps << " steps"
+             << std::endl;
+   Real fReference = 0;
+   for(ELayout e_layout : { LAYOUT_HEAP_IN_ORDER, LAYOUT_HEAP_SCATTERED, LAYOUT_POOL }) {
+      std::vector<CComposableEntity*> vecRobots = CreateRobots(e_layout, unRobots, unComponents, cRNG);
+      /* Warm up */
+      for(CComposableEntity* pc_robot : vecRobots) pc_robot->UpdateComponents();
+      cCounter.Start();
+      auto tStart = std::chrono::steady_clock::now();
+      for(UInt32 s = 0; s < unSteps; ++s) {
+         for(CComposableEntity* pc_robot : vecRobots) {
+            pc_robot->UpdateComponents();
+         }
+      }
+      double fMS = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count() * 1e3;
+      UInt64 unMisses = cCounter.Stop();
+      std::cout << LAYOUT_NAMES[e_layout] << ": "
+                << fMS / unSteps << " ms per step, cache misses per step: ";
+      if(cCounter.IsAvailable()) std::cout << unMisses / unSteps;
+      else std::cout << "n/a";
+      std::cout << std::endl;
+      /* All the layouts must compute the same thing */
+      Real fSum = 0;
+      for(CComposableEntity* pc_robot : vecRobots) {
+         for(CEntity* pc_component : pc_robot->GetComponentVector()) {
+            fSum += static_cast<CTestComponentEntity*>(pc_component)->GetPosition().GetX();
+         }
+      }
+      if(e_layout == LAYOUT_HEAP_IN_ORDER) {
+         fReference = fSum;
+      }
+      else if(fSum != fReference) {
+         std::cerr << LAYOUT_NAMES[e_layout] << ": wrong update results" << std::endl;
+         return EXIT_FAILURE;
+      }
+      DeleteRobots(vecRobots);
+   }
+   return EXIT_SUCCESS;
+}
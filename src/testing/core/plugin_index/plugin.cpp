@@ -0,0 +1,8 @@
+/*
+ * An empty library, copied by plugin_index_test into its plugin directory
+ * under several names.
+ */
+
+extern "C" int plugin_index_plugin() {
+   return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * Checks that on-demand loading does not miss the libraries the plugin index
+ * does not know about.
+ *
+ * Usage: plugin_index_test <plugin library>
+ *
+ * The plugin library is copied into a fresh plugin directory as:
+ * - an indexed library, older than the index, which must not be loaded;
+ * - an indexed library with no symbols, which must not be loaded;
+ * - an indexed library rebuilt after the index was written, which must be loaded;
+ * - a library missing from the index, which must be loaded.
+ */
+
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <dlfcn.h>
+#include <unistd.h>
+#include <utime.h>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+static const std::string LIB_EXT = "." ARGOS_MODULE_LIBRARY_EXTENSION;
+static const std::string INDEXED_LIB = "libindexed" + LIB_EXT;
+static const std::string NO_SYMBOLS_LIB = "libnosymbols" + LIB_EXT;
+static const std::string REBUILT_LIB = "librebuilt" + LIB_EXT;
+static const std::string UNINDEXED_LIB = "libunindexed" + LIB_EXT;
+
+/****************************************/
+/****************************************/
+
+static bool CopyFile(const std::string& str_from,
+                     const std::string& str_to) {
+   std::ifstream cFrom(str_from, std::ios::binary);
+   std::ofstream cTo(str_to, std::ios::binary | std::ios::trunc);
+   cTo << cFrom.rdbuf();
+   return cFrom.good() && cTo.good();
+}
+
+/*
+ * Sets the modification time of the given file to now plus the given offset.
+ */
+static bool SetMTime(const std::string& str_file,
+                     time_t t_offset) {
+   struct utimbuf tTimes;
+   tTimes.actime = tTimes.modtime = ::time(nullptr) + t_offset;
+   return ::utime(str_file.c_str(), &tTimes) == 0;
+}
+
+/*
+ * Returns true if the given library has been loaded.
+ */
+static bool IsLoaded(const std::string& str_lib) {
+   void* ptHandle = ::dlopen(str_lib.c_str(), RTLD_LAZY | RTLD_NOLOAD);
+   if(ptHandle == nullptr) return false;
+   ::dlclose(ptHandle);
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+static bool Check(const std::string& str_dir,
+                  const std::string& str_lib,
+                  bool b_loaded) {
+   if(IsLoaded(str_dir + str_lib) != b_loaded) {
+      std::cerr << str_lib << " should "
+                << (b_loaded ? "" : "not ")
+                << "have been loaded"
+                << std::endl;
+      return false;
+   }
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   if(argc != 2) {
+      std::cerr << "Usage: " << argv[0] << " <plugin library>" << std::endl;
+      return EXIT_FAILURE;
+   }
+   /* Make the plugin directory */
+   char pchDir[] = "/tmp/argos3_plugin_index_XXXXXX";
+   if(::mkdtemp(pchDir) == nullptr) {
+      std::perror("mkdtemp");
+      return EXIT_FAILURE;
+   }
+   std::string strDir = std::string(pchDir) + "/";
+   /* Copy the libraries, all older than the index but the rebuilt one */
+   bool bOK =
+      CopyFile(argv[1], strDir + INDEXED_LIB) &&
+      CopyFile(argv[1], strDir + NO_SYMBOLS_LIB) &&
+      CopyFile(argv[1], strDir + REBUILT_LIB) &&
+      CopyFile(argv[1], strDir + UNINDEXED_LIB) &&
+      SetMTime(strDir + INDEXED_LIB, -100) &&
+      SetMTime(strDir + NO_SYMBOLS_LIB, -100) &&
+      SetMTime(strDir + UNINDEXED_LIB, -100) &&
+      SetMTime(strDir + REBUILT_LIB, 100);
+   /* Write an index that lists all the libraries but one */
+   {
+      std::ofstream cIndex(strDir + CDynamicLoading::PLUGIN_INDEX_FILE);
+      cIndex << "entity\tindexed\t" << INDEXED_LIB << std::endl
+             << "\t\t" << NO_SYMBOLS_LIB << std::endl
+             << "entity\trebuilt\t" << REBUILT_LIB << std::endl;
+      bOK = bOK && cIndex.good();
+   }
+   if(!bOK) {
+      std::cerr << "Can't set up the plugin directory " << strDir << std::endl;
+      return EXIT_FAILURE;
+   }
+   /* Load the libraries on demand from the plugin directory only */
+   ::setenv("ARGOS_PLUGIN_PATH", pchDir, 1);
+   int nResult = EXIT_SUCCESS;
+   try {
+      CDynamicLoading::LoadLibrariesOnDemand();
+      if(!(Check(strDir, INDEXED_LIB, false) &&
+           Check(strDir, NO_SYMBOLS_LIB, false) &&
+           Check(strDir, REBUILT_LIB, true) &&
+           Check(strDir, UNINDEXED_LIB, true))) {
+         nResult = EXIT_FAILURE;
+      }
+      /* The indexed library is loaded when one of its symbols is requested */
+      if(!CDynamicLoading::LoadLibrariesForSymbol("entity", "indexed") ||
+         !Check(strDir, INDEXED_LIB, true)) {
+         nResult = EXIT_FAILURE;
+      }
+      CDynamicLoading::UnloadAllLibraries();
+   }
+   catch(CARGoSException& ex) {
+      std::cerr << ex.what() << std::endl;
+      nResult = EXIT_FAILURE;
+   }
+   /* Clean up */
+   ::unlink((strDir + INDEXED_LIB).c_str());
+   ::unlink((strDir + NO_SYMBOLS_LIB).c_str());
+   ::unlink((strDir + REBUILT_LIB).c_str());
+   ::unlink((strDir + UNINDEXED_LIB).c_str());
+   ::unlink((strDir + CDynamicLoading::PLUGIN_INDEX_FILE).c_str());
+   ::rmdir(pchDir);
+   if(nResult == EXIT_SUCCESS) {
+      std::cout << "OK" << std::endl;
+   }
+   return nResult;
+}
@@ -0,0 +1,238 @@
+/*
+ * Checks the spatial hash positional index against brute force, and compares
+ * its memory usage and speed with the grid positional index.
+ *
+ * Usage: spatial_hash_benchmark [arena side in m] [number of entities]
+ */
+
+#include <argos3/core/simulator/entity/positional_entity.h>
+#include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/simulator/space/positional_indices/spatial_hash.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+class CGridUpdater : public CGrid<CPositionalEntity>::COperation {
+public:
+   CGridUpdater(CGrid<CPositionalEntity>& c_grid) : m_cGrid(c_grid) {}
+   virtual bool operator()(CPositionalEntity& c_entity) {
+      SInt32 nI, nJ, nK;
+      m_cGrid.PositionToCell(nI, nJ, nK, c_entity.GetPosition());
+      m_cGrid.UpdateCell(nI, nJ, nK, c_entity);
+      return true;
+   }
+private:
+   CGrid<CPositionalEntity>& m_cGrid;
+};
+
+class CHashUpdater : public CSpatialHash<CPositionalEntity>::COperation {
+public:
+   CHashUpdater(CSpatialHash<CPositionalEntity>& c_hash) : m_cHash(c_hash) {}
+   virtual bool operator()(CPositionalEntity& c_entity) {
+      SInt32 nI, nJ, nK;
+      m_cHash.PositionToCell(nI, nJ, nK, c_entity.GetPosition());
+      m_cHash.UpdateCell(nI, nJ, nK, c_entity);
+      return true;
+   }
+private:
+   CSpatialHash<CPositionalEntity>& m_cHash;
+};
+
+/*
+ * Collects the indices of the entities passed to it.
+ */
+class CCollector : public CPositionalIndex<CPositionalEntity>::COperation {
+public:
+   virtual bool operator()(CPositionalEntity& c_entity) {
+      Found.push_back(c_entity.GetIndex());
+      return true;
+   }
+   std::vector<ssize_t> Sorted() {
+      std::sort(Found.begin(), Found.end());
+      Found.erase(std::unique(Found.begin(), Found.end()), Found.end());
+      return Found;
+   }
+   std::vector<ssize_t> Found;
+};
+
+/****************************************/
+/****************************************/
+
+/*
+ * Returns true if the segment intersects the unit cell at (n_i,n_j,n_k).
+ */
+static bool SegmentHitsCell(const CRay3& c_ray, SInt32 n_i, SInt32 n_j, SInt32 n_k) {
+   Real fT0 = 0.0, fT1 = 1.0;
+   CVector3 cD = c_ray.GetEnd() - c_ray.GetStart();
+   const SInt32 pnCell[3] = { n_i, n_j, n_k };
+   for(UInt32 a = 0; a < 3; ++a) {
+      Real fS = c_ray.GetStart()[a];
+      if(cD[a] == 0.0) {
+         if(fS < pnCell[a] || fS > pnCell[a] + 1) return false;
+      }
+      else {
+         Real fTA = (pnCell[a]     - fS) / cD[a];
+         Real fTB = (pnCell[a] + 1 - fS) / cD[a];
+         if(fTA > fTB) std::swap(fTA, fTB);
+         fT0 = Max(fT0, fTA);
+         fT1 = Min(fT1, fTB);
+         if(fT0 > fT1) return false;
+      }
+   }
+   return true;
+}
+
+static double Seconds(std::chrono::steady_clock::time_point t_start) {
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   Real fSide = (argc > 1) ? std::atof(argv[1]) : 500.0;
+   UInt32 unEntities = (argc > 2) ? std::atoi(argv[2]) : 2000;
+   UInt32 unQueries = 5000;
+   std::mt19937 cRNG(12345);
+   std::uniform_real_distribution<Real> cXY(-fSide * 0.5, fSide * 0.5);
+   std::uniform_real_distribution<Real> cZ(0.01, 0.99);
+   /* Create the entities */
+   std::vector<CPositionalEntity*> vecEntities;
+   for(UInt32 i = 0; i < unEntities; ++i) {
+      vecEntities.push_back(
+         new CPositionalEntity(nullptr, "e" + ToString(i), CVector3(cXY(cRNG), cXY(cRNG), cZ(cRNG))));
+      vecEntities.back()->SetIndex(i);
+   }
+   /* Create the indices, both with 1m cells */
+   SInt32 nCells = static_cast<SInt32>(fSide);
+   CGrid<CPositionalEntity> cGrid(CVector3(-fSide * 0.5, -fSide * 0.5, 0.0),
+                                  CVector3( fSide * 0.5,  fSide * 0.5, 1.0),
+                                  nCells, nCells, 1);
+   CGridUpdater cGridUpdater(cGrid);
+   cGrid.SetUpdateEntityOperation(&cGridUpdater);
+   CSpatialHash<CPositionalEntity> cHash(CVector3(1.0, 1.0, 1.0));
+   CHashUpdater cHashUpdater(cHash);
+   cHash.SetUpdateEntityOperation(&cHashUpdater);
+   for(UInt32 i = 0; i < unEntities; ++i) {
+      cGrid.AddEntity(*vecEntities[i]);
+      cHash.AddEntity(*vecEntities[i]);
+   }
+   /* Update time */
+   auto tStart = std::chrono::steady_clock::now();
+   for(UInt32 i = 0; i < 100; ++i) cGrid.Update();
+   double fGridUpdate = Seconds(tStart);
+   tStart = std::chrono::steady_clock::now();
+   for(UInt32 i = 0; i < 100; ++i) cHash.Update();
+   double fHashUpdate = Seconds(tStart);
+   /* Random queries */
+   std::vector<CVector3> vecCenters;
+   std::vector<Real> vecRadii;
+   std::vector<CRay3> vecRays;
+   std::uniform_real_distribution<Real> cRadius(0.5, 10.0);
+   std::uniform_real_distribution<Real> cRayLength(-30.0, 30.0);
+   for(UInt32 q = 0; q < unQueries; ++q) {
+      vecCenters.push_back(CVector3(cXY(cRNG), cXY(cRNG), 0.5));
+      vecRadii.push_back(cRadius(cRNG));
+      CVector3 cEnd = vecCenters.back() + CVector3(cRayLength(cRNG), cRayLength(cRNG), 0.0);
+      cEnd.SetX(Min(Max(cEnd.GetX(), -fSide * 0.5 + 0.01), fSide * 0.5 - 0.01));
+      cEnd.SetY(Min(Max(cEnd.GetY(), -fSide * 0.5 + 0.01), fSide * 0.5 - 0.01));
+      cEnd.SetZ(cZ(cRNG));
+      vecRays.push_back(CRay3(vecCenters.back(), cEnd));
+   }
+   /* Check the hash against brute force */
+   UInt32 unErrors = 0;
+   for(UInt32 q = 0; q < unQueries; ++q) {
+      const CVector3& cC = vecCenters[q];
+      Real fR = vecRadii[q];
+      CVector3 cHalf(fR, fR * 0.5, 0.5);
+      std::vector<ssize_t> vecSphere, vecBox, vecCircle, vecRay;
+      for(UInt32 i = 0; i < unEntities; ++i) {
+         const CVector3& cP = vecEntities[i]->GetPosition();
+         if(Distance(cP, cC) <= fR) vecSphere.push_back(i);
+         if(Abs(cP.GetX() - cC.GetX()) <= cHalf.GetX() &&
+            Abs(cP.GetY() - cC.GetY()) <= cHalf.GetY() &&
+            Abs(cP.GetZ() - cC.GetZ()) <= cHalf.GetZ()) vecBox.push_back(i);
+         if(Distance(CVector2(cP.GetX(), cP.GetY()), CVector2(cC.GetX(), cC.GetY())) <= fR) vecCircle.push_back(i);
+         if(SegmentHitsCell(vecRays[q], Floor(cP.GetX()), Floor(cP.GetY()), Floor(cP.GetZ()))) vecRay.push_back(i);
+      }
+      CCollector cSphere, cBox, cCircle, cRectangle, cRay;
+      cHash.ForEntitiesInSphereRange(cC, fR, cSphere);
+      cHash.ForEntitiesInBoxRange(cC, cHalf, cBox);
+      cHash.ForEntitiesInCircleRange(cC, fR, cCircle);
+      cHash.ForEntitiesInRectangleRange(cC, CVector2(cHalf.GetX(), cHalf.GetY()), cRectangle);
+      cHash.ForEntitiesAlongRay(vecRays[q], cRay);
+      /* Range queries return candidates: keep those that are really in range */
+      std::vector<ssize_t> vecFound;
+      for(ssize_t i : cSphere.Sorted())
+         if(Distance(vecEntities[i]->GetPosition(), cC) <= fR) vecFound.push_back(i);
+      if(vecFound != vecSphere) ++unErrors;
+      vecFound.clear();
+      for(ssize_t i : cBox.Sorted()) {
+         const CVector3& cP = vecEntities[i]->GetPosition();
+         if(Abs(cP.GetX() - cC.GetX()) <= cHalf.GetX() &&
+            Abs(cP.GetY() - cC.GetY()) <= cHalf.GetY() &&
+            Abs(cP.GetZ() - cC.GetZ()) <= cHalf.GetZ()) vecFound.push_back(i);
+      }
+      if(vecFound != vecBox) ++unErrors;
+      vecFound.clear();
+      for(ssize_t i : cCircle.Sorted()) {
+         const CVector3& cP = vecEntities[i]->GetPosition();
+         if(Distance(CVector2(cP.GetX(), cP.GetY()), CVector2(cC.GetX(), cC.GetY())) <= fR) vecFound.push_back(i);
+      }
+      if(vecFound != vecCircle) ++unErrors;
+      vecFound.clear();
+      for(ssize_t i : cRectangle.Sorted()) {
+         const CVector3& cP = vecEntities[i]->GetPosition();
+         if(Abs(cP.GetX() - cC.GetX()) <= cHalf.GetX() &&
+            Abs(cP.GetY() - cC.GetY()) <= cHalf.GetY()) vecFound.push_back(i);
+      }
+      if(vecFound != vecBox) ++unErrors;
+      if(cRay.Sorted() != vecRay) ++unErrors;
+   }
+   /* Query time */
+   CCollector cSink;
+   tStart = std::chrono::steady_clock::now();
+   for(UInt32 q = 0; q < unQueries; ++q) {
+      cGrid.ForEntitiesInSphereRange(vecCenters[q], vecRadii[q], cSink);
+      cGrid.ForEntitiesInCircleRange(vecCenters[q], vecRadii[q], cSink);
+      cGrid.ForEntitiesAlongRay(vecRays[q], cSink);
+   }
+   double fGridQuery = Seconds(tStart);
+   cSink.Found.clear();
+   tStart = std::chrono::steady_clock::now();
+   for(UInt32 q = 0; q < unQueries; ++q) {
+      cHash.ForEntitiesInSphereRange(vecCenters[q], vecRadii[q], cSink);
+      cHash.ForEntitiesInCircleRange(vecCenters[q], vecRadii[q], cSink);
+      cHash.ForEntitiesAlongRay(vecRays[q], cSink);
+   }
+   double fHashQuery = Seconds(tStart);
+   /* Report */
+   size_t unGridMemory =
+      static_cast<size_t>(nCells) * nCells * sizeof(CGrid<CPositionalEntity>::SCell);
+   std::cout << "Arena " << fSide << "x" << fSide << " m, "
+             << unEntities << " entities, 1m cells" << std::endl;
+   std::cout << "grid: " << (unGridMemory / 1024) << " KiB of cells, "
+             << (fGridUpdate * 1e4) << " ms/update, "
+             << (fGridQuery * 1e3) << " ms for " << unQueries << " sphere+circle+ray queries" << std::endl;
+   std::cout << "hash: " << (cHash.GetMemoryUsage() / 1024) << " KiB for "
+             << cHash.GetNumOccupiedCells() << " occupied cells, "
+             << (fHashUpdate * 1e4) << " ms/update, "
+             << (fHashQuery * 1e3) << " ms for " << unQueries << " sphere+circle+ray queries" << std::endl;
+   for(UInt32 i = 0; i < unEntities; ++i) {
+      delete vecEntities[i];
+   }
+   if(unErrors > 0) {
+      std::cerr << unErrors << " spatial hash queries differ from brute force" << std::endl;
+      return EXIT_FAILURE;
+   }
+   return EXIT_SUCCESS;
+}
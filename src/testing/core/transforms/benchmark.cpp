@@ -0,0 +1,184 @@
+/*
+ * Compares the batch transforms with the scalar CVector3::Rotate() path, in
+ * speed and in results.
+ *
+ * Usage: transforms_benchmark [number of vectors] [repetitions]
+ *
+ * The cases are: N vectors rotated by one quaternion, N vectors moved
+ * from a local frame to the global frame and back, and one offset moved
+ * from N local frames to the global frame.
+ */
+
+#include <argos3/core/utility/math/transforms.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+static double Milliseconds(std::chrono::steady_clock::time_point t_start) {
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count() * 1e3;
+}
+
+/*
+ * Returns the largest difference between the components of the vectors.
+ */
+static Real MaxError(const std::vector<CVector3>& vec_scalar,
+                     const CVector3Array& c_batch) {
+   Real fMaxError = 0;
+   for(size_t i = 0; i < vec_scalar.size(); ++i) {
+      CVector3 cDiff = vec_scalar[i] - c_batch.Get(i);
+      fMaxError = std::max(fMaxError, std::abs(cDiff.GetX()));
+      fMaxError = std::max(fMaxError, std::abs(cDiff.GetY()));
+      fMaxError = std::max(fMaxError, std::abs(cDiff.GetZ()));
+   }
+   return fMaxError;
+}
+
+/*
+ * Prints the timings of a case, and returns whether the results match.
+ */
+static bool Report(const std::string& str_case,
+                   double f_scalar_ms,
+                   double f_batch_ms,
+                   Real f_max_error) {
+   /* The vectors have unit size, the error is a few rounding errors */
+   Real fTolerance = 64 * std::numeric_limits<Real>::epsilon();
+   std::cout << str_case << ": "
+             << f_scalar_ms << " ms scalar, "
+             << f_batch_ms << " ms batch ("
+             << f_scalar_ms / f_batch_ms << "x), "
+             << "max error " << f_max_error
+             << std::endl;
+   if(f_max_error > fTolerance) {
+      std::cerr << str_case << ": the batch results differ from the scalar ones" << std::endl;
+      return false;
+   }
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   size_t unVectors = (argc > 1) ? std::atoi(argv[1]) : 100003;
+   UInt32 unRepetitions = (argc > 2) ? std::atoi(argv[2]) : 20;
+   std::mt19937 cRNG(12345);
+   std::uniform_real_distribution<Real> cUniform(-1.0, 1.0);
+   /* Random vectors and frames */
+   std::vector<CVector3> vecVectors;
+   std::vector<CVector3> vecTranslations;
+   std::vector<CQuaternion> vecOrientations;
+   CVector3Array cVectors(unVectors);
+   CVector3Array cTranslations(unVectors);
+   CQuaternionArray cOrientations(unVectors);
+   for(size_t i = 0; i < unVectors; ++i) {
+      vecVectors.emplace_back(cUniform(cRNG), cUniform(cRNG), cUniform(cRNG));
+      vecTranslations.emplace_back(cUniform(cRNG), cUniform(cRNG), cUniform(cRNG));
+      CVector3 cAxis(cUniform(cRNG), cUniform(cRNG), cUniform(cRNG));
+      vecOrientations.emplace_back(CRadians(cUniform(cRNG) * CRadians::PI.GetValue()),
+                                   cAxis.Normalize());
+      cVectors.Set(i, vecVectors[i]);
+      cTranslations.Set(i, vecTranslations[i]);
+      cOrientations.Set(i, vecOrientations[i]);
+   }
+   const CQuaternion& cOrientation = vecOrientations[0];
+   const CVector3& cTranslation = vecTranslations[0];
+   CVector3 cOffset(0.1, -0.05, 0.02);
+   std::cout << unVectors << " vectors, "
+             << unRepetitions << " repetitions, "
+             << sizeof(Real) * 8 << "-bit Real, "
+             << "instruction set: " << GetBatchTransformsInstructionSet()
+             << std::endl;
+   bool bOK = true;
+   /* N vectors rotated by one quaternion */
+   {
+      std::vector<CVector3> vecScalar;
+      auto tStart = std::chrono::steady_clock::now();
+      for(UInt32 r = 0; r < unRepetitions; ++r) {
+         vecScalar = vecVectors;
+         for(CVector3& c_vector : vecScalar) {
+            c_vector.Rotate(cOrientation);
+         }
+      }
+      double fScalarMS = Milliseconds(tStart);
+      CVector3Array cBatch;
+      tStart = std::chrono::steady_clock::now();
+      for(UInt32 r = 0; r < unRepetitions; ++r) {
+         cBatch = cVectors;
+         Rotate(cBatch, cOrientation);
+      }
+      double fBatchMS = Milliseconds(tStart);
+      bOK &= Report("rotate N vectors", fScalarMS, fBatchMS, MaxError(vecScalar, cBatch));
+   }
+   /* N vectors from one local frame to the global frame and back */
+   {
+      std::vector<CVector3> vecScalar;
+      auto tStart = std::chrono::steady_clock::now();
+      for(UInt32 r = 0; r < unRepetitions; ++r) {
+         vecScalar = vecVectors;
+         for(CVector3& c_vector : vecScalar) {
+            c_vector = LocalToGlobal(c_vector, cTranslation, cOrientation);
+         }
+      }
+      double fScalarMS = Milliseconds(tStart);
+      CVector3Array cBatch;
+      tStart = std::chrono::steady_clock::now();
+      for(UInt32 r = 0; r < unRepetitions; ++r) {
+         cBatch = cVectors;
+         LocalToGlobal(cBatch, cTranslation, cOrientation);
+      }
+      double fBatchMS = Milliseconds(tStart);
+      bOK &= Report("local to global, N vectors", fScalarMS, fBatchMS, MaxError(vecScalar, cBatch));
+      /* And back */
+      CVector3Array cGlobals(cBatch);
+      std::vector<CVector3> vecGlobals(vecScalar);
+      tStart = std::chrono::steady_clock::now();
+      for(UInt32 r = 0; r < unRepetitions; ++r) {
+         vecScalar = vecGlobals;
+         for(CVector3& c_vector : vecScalar) {
+            c_vector = GlobalToLocal(c_vector, cTranslation, cOrientation);
+         }
+      }
+      fScalarMS = Milliseconds(tStart);
+      tStart = std::chrono::steady_clock::now();
+      for(UInt32 r = 0; r < unRepetitions; ++r) {
+         cBatch = cGlobals;
+         GlobalToLocal(cBatch, cTranslation, cOrientation);
+      }
+      fBatchMS = Milliseconds(tStart);
+      bOK &= Report("global to local, N vectors", fScalarMS, fBatchMS, MaxError(vecScalar, cBatch));
+      Real fRoundTripError = MaxError(vecVectors, cBatch);
+      std::cout << "round trip: max error " << fRoundTripError << std::endl;
+      if(fRoundTripError > 64 * std::numeric_limits<Real>::epsilon()) {
+         std::cerr << "round trip: the batch results differ from the original vectors" << std::endl;
+         bOK = false;
+      }
+   }
+   /* One offset from N local frames to the global frame */
+   {
+      std::vector<CVector3> vecScalar(unVectors);
+      auto tStart = std::chrono::steady_clock::now();
+      for(UInt32 r = 0; r < unRepetitions; ++r) {
+         for(size_t i = 0; i < unVectors; ++i) {
+            vecScalar[i] = LocalToGlobal(cOffset, vecTranslations[i], vecOrientations[i]);
+         }
+      }
+      double fScalarMS = Milliseconds(tStart);
+      CVector3Array cBatch;
+      tStart = std::chrono::steady_clock::now();
+      for(UInt32 r = 0; r < unRepetitions; ++r) {
+         LocalToGlobal(cBatch, cOffset, cTranslations, cOrientations);
+      }
+      double fBatchMS = Milliseconds(tStart);
+      bOK &= Report("local to global, N frames", fScalarMS, fBatchMS, MaxError(vecScalar, cBatch));
+   }
+   return bOK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
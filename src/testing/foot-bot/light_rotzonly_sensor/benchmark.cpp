@@ -0,0 +1,223 @@
+/*
+ * Measures the update of the rot-z-only light sensor in an arena with lights
+ * and pillars, with and without the shadow map, and checks that the shadow
+ * map gives the same readings as the ray queries for almost all the robots.
+ *
+ * Usage: footbot_light_rotzonly_sensor_benchmark [number of robots] [steps]
+ *
+ * The robots stand on a square lattice with 0.5m spacing. Static pillars,
+ * lower than the lights, stand between the robots every 1.5m. Four lights
+ * are placed above the arena.
+ */
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/sensor.h>
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_light_sensor.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_light_rotzonly_sensor.h>
+#include <argos3/plugins/simulator/media/light_visibility_medium.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+/*
+ * A controller that only holds the sensor.
+ */
+class CBenchmarkController : public CCI_Controller {
+public:
+   virtual void Init(TConfigurationNode&) {
+      m_pcLightSensor = GetSensor<CCI_FootBotLightSensor>("footbot_light");
+   }
+   virtual void ControlStep() {}
+   CCI_FootBotLightSensor* GetLightSensor() {
+      return m_pcLightSensor;
+   }
+private:
+   CCI_FootBotLightSensor* m_pcLightSensor;
+};
+
+REGISTER_CONTROLLER(CBenchmarkController, "light_benchmark_controller");
+
+/****************************************/
+/****************************************/
+
+static std::string MakeExperiment(UInt32 un_robots) {
+   UInt32 unSide = static_cast<UInt32>(std::ceil(std::sqrt(static_cast<Real>(un_robots))));
+   Real fSpacing = 0.5;
+   Real fHalfSide = unSide * fSpacing * 0.5;
+   Real fArena = unSide * fSpacing + 2.0;
+   std::ostringstream cXML;
+   cXML << "<argos-configuration>"
+        << "<framework>"
+        << "<system threads=\"0\" />"
+        << "<experiment length=\"0\" ticks_per_second=\"10\" random_seed=\"12345\" />"
+        << "</framework>"
+        << "<controllers>"
+        << "<light_benchmark_controller id=\"ctrl\">"
+        << "<actuators />"
+        << "<sensors>"
+        << "<footbot_light implementation=\"rot_z_only\" medium=\"lights\" />"
+        << "</sensors>"
+        << "<params />"
+        << "</light_benchmark_controller>"
+        << "</controllers>"
+        << "<arena size=\"" << fArena << "," << fArena << ",2\" center=\"0,0,1\">";
+   /* The robots */
+   for(UInt32 i = 0; i < un_robots; ++i) {
+      cXML << "<foot-bot id=\"fb" << i << "\">"
+           << "<body position=\""
+           << ((i % unSide) * fSpacing - fHalfSide) << ","
+           << ((i / unSide) * fSpacing - fHalfSide) << ",0\" orientation=\"0,0,0\" />"
+           << "<controller config=\"ctrl\" />"
+           << "</foot-bot>";
+   }
+   /* The pillars, between the robots */
+   UInt32 unPillars = 0;
+   for(UInt32 i = 1; i < unSide; i += 3) {
+      for(UInt32 j = 1; j < unSide; j += 3) {
+         cXML << "<box id=\"pillar" << unPillars++ << "\" size=\"0.2,0.2,0.6\" movable=\"false\">"
+              << "<body position=\""
+              << ((i + 0.5) * fSpacing - fHalfSide) << ","
+              << ((j + 0.5) * fSpacing - fHalfSide) << ",0\" orientation=\"0,0,0\" />"
+              << "</box>";
+      }
+   }
+   /* The lights */
+   for(UInt32 i = 0; i < 4; ++i) {
+      cXML << "<light id=\"light" << i << "\" position=\""
+           << ((i % 2) ? 0.5 : -0.5) * fHalfSide << ","
+           << ((i / 2) ? 0.5 : -0.5) * fHalfSide << ",1.5\" orientation=\"0,0,0\""
+           << " color=\"yellow\" intensity=\"3\" medium=\"leds\" />";
+   }
+   cXML << "</arena>"
+        << "<physics_engines><dynamics2d id=\"dyn2d\" /></physics_engines>"
+        << "<media>"
+        << "<led id=\"leds\" />"
+        << "<light_visibility id=\"lights\" shadow_map_resolution=\"0.02\" />"
+        << "</media>"
+        << "</argos-configuration>";
+   return cXML.str();
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Updates all the sensors for the given number of steps, and returns the time
+ * per step in milliseconds.
+ */
+static double UpdateSensors(CLightVisibilityMedium& c_medium,
+                            std::vector<CFootBotLightRotZOnlySensor*>& vec_sensors,
+                            std::vector<CControllableEntity*>& vec_controllables,
+                            UInt32 un_steps) {
+   auto tStart = std::chrono::steady_clock::now();
+   for(UInt32 s = 0; s < un_steps; ++s) {
+      /* A new step, as in CSpace::Update() */
+      c_medium.Update();
+      for(size_t i = 0; i < vec_sensors.size(); ++i) {
+         vec_sensors[i]->Update();
+         /* Forget the rays, when they are recorded */
+         vec_controllables[i]->GetCheckedRays().clear();
+         vec_controllables[i]->GetIntersectionPoints().clear();
+      }
+   }
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count() * 1e3 / un_steps;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unRobots = (argc > 1) ? std::atoi(argv[1]) : 2000;
+   UInt32 unSteps = (argc > 2) ? std::atoi(argv[2]) : 10;
+   try {
+      CDynamicLoading::LoadLibrariesOnDemand();
+      /* Create the experiment */
+      ticpp::Document tConfiguration;
+      tConfiguration.Parse(MakeExperiment(unRobots));
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      cSimulator.Load(tConfiguration, true);
+      CLightVisibilityMedium& cMedium = cSimulator.GetMedium<CLightVisibilityMedium>("lights");
+      /* Collect the sensors */
+      std::vector<CFootBotLightRotZOnlySensor*> vecSensors;
+      std::vector<CCI_FootBotLightSensor*> vecControlInterfaces;
+      std::vector<CControllableEntity*> vecControllables;
+      CSpace::TMapPerType& tFootBots = cSimulator.GetSpace().GetEntitiesByType("foot-bot");
+      for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+          it != tFootBots.end();
+          ++it) {
+         CFootBotEntity& cFootBot = *any_cast<CFootBotEntity*>(it->second);
+         CBenchmarkController& cController =
+            dynamic_cast<CBenchmarkController&>(cFootBot.GetControllableEntity().GetController());
+         vecControlInterfaces.push_back(cController.GetLightSensor());
+         vecSensors.push_back(dynamic_cast<CFootBotLightRotZOnlySensor*>(cController.GetLightSensor()));
+         vecControllables.push_back(&cFootBot.GetControllableEntity());
+      }
+      /* With the rays shown, the sensors do all the ray queries */
+      for(size_t i = 0; i < vecSensors.size(); ++i) {
+         vecSensors[i]->SetShowRays(true);
+      }
+      double fExactMS = UpdateSensors(cMedium, vecSensors, vecControllables, unSteps);
+      std::vector<Real> vecExact;
+      for(size_t i = 0; i < vecControlInterfaces.size(); ++i) {
+         for(size_t j = 0; j < vecControlInterfaces[i]->GetReadings().size(); ++j) {
+            vecExact.push_back(vecControlInterfaces[i]->GetReadings()[j].Value);
+         }
+      }
+      /* Now with the shadow map; the first step fills it */
+      for(size_t i = 0; i < vecSensors.size(); ++i) {
+         vecSensors[i]->SetShowRays(false);
+      }
+      double fFirstMS = UpdateSensors(cMedium, vecSensors, vecControllables, 1);
+      double fMapMS = UpdateSensors(cMedium, vecSensors, vecControllables, unSteps);
+      /* Compare the readings */
+      size_t unMismatches = 0;
+      size_t unLit = 0;
+      size_t k = 0;
+      for(size_t i = 0; i < vecControlInterfaces.size(); ++i) {
+         bool bMismatch = false;
+         bool bLit = false;
+         for(size_t j = 0; j < vecControlInterfaces[i]->GetReadings().size(); ++j, ++k) {
+            if(std::abs(vecControlInterfaces[i]->GetReadings()[j].Value - vecExact[k]) > 1e-6) {
+               bMismatch = true;
+            }
+            if(vecExact[k] > 0.0) {
+               bLit = true;
+            }
+         }
+         if(bMismatch) ++unMismatches;
+         if(bLit) ++unLit;
+      }
+      /* Report */
+      std::cout << vecSensors.size() << " robots, "
+                << unLit << " lit, "
+                << fExactMS << " ms per update with ray queries, "
+                << fMapMS << " ms per update with the shadow map ("
+                << fFirstMS << " ms to fill it), "
+                << unMismatches << " robots with different readings"
+                << std::endl;
+      cSimulator.Destroy();
+      /* The robots near the shadow edges may differ, by construction */
+      if(unLit == 0 || unMismatches * 20 > vecSensors.size()) {
+         std::cerr << "The shadow map readings differ from the ray queries for too many robots" << std::endl;
+         return EXIT_FAILURE;
+      }
+   }
+   catch(std::exception& ex) {
+      std::cerr << ex.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,23 @@
+/**
+ * @file <argos3/testing/foot-bot/light_rotzonly_sensor/controller.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include <argos3/core/control_interface/ci_controller.h>
+
+namespace argos {
+
+   /*
+    * Holds the light sensors, whose readings are checked by the loop functions.
+    */
+   class CTestController : public CCI_Controller {
+
+   public:
+
+      CTestController() {}
+
+      virtual ~CTestController() {}
+
+   };
+}
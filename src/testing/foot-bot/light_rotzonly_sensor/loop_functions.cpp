@@ -0,0 +1,97 @@
+/**
+ * @file <argos3/testing/foot-bot/light_rotzonly_sensor/loop_functions.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "loop_functions.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_light_sensor.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_light_sensor.h>
+#include <argos3/plugins/simulator/entities/box_entity.h>
+#include <argos3/plugins/simulator/media/light_visibility_medium.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const UInt32 CTestLoopFunctions::MOVE_STEP = 10;
+   const UInt32 CTestLoopFunctions::STEPS = 20;
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostStep() {
+      UInt32 unClock = GetSpace().GetSimulationClock();
+      /* The rays expected to be decided by the shadow map in this step */
+      UInt64 unExpectedDecisions = 0;
+      for(const auto& c_item : GetSpace().GetEntitiesByType("foot-bot")) {
+         CFootBotEntity* pcFootBot = any_cast<CFootBotEntity*>(c_item.second);
+         const CVector3& cPosition = pcFootBot->GetEmbodiedEntity().GetOriginAnchor().Position;
+         /* The wall shadows the east side first, then the west side */
+         bool bBehindBox = cPosition.GetY() > 0.5;
+         bool bEast = cPosition.GetX() > 0.0;
+         bool bLit = !bBehindBox && (bEast == (unClock > MOVE_STEP));
+         /* Look at the readings of the sensor of the robot */
+         CCI_Controller& cController = pcFootBot->GetControllableEntity().GetController();
+         bool bSeesLight = false;
+         size_t unRays = 0;
+         if(cController.HasSensor("footbot_light")) {
+            for(const auto& s_reading :
+                   cController.GetSensor<CCI_FootBotLightSensor>("footbot_light")->GetReadings()) {
+               bSeesLight |= (s_reading.Value > 0.0);
+            }
+            unRays = 1;
+         }
+         else {
+            for(Real f_reading :
+                   cController.GetSensor<CCI_LightSensor>("light")->GetReadings()) {
+               bSeesLight |= (f_reading > 0.0);
+            }
+            unRays = cController.GetSensor<CCI_LightSensor>("light")->GetReadings().size();
+         }
+         if(bSeesLight != bLit) {
+            THROW_ARGOSEXCEPTION("Robot \"" << pcFootBot->GetId() << "\" " <<
+                                 (bSeesLight ? "sees" : "does not see") <<
+                                 " the light at step " << unClock);
+         }
+         /* Only the rays crossing the movable box need a ray query */
+         if(!bBehindBox) {
+            unExpectedDecisions += unRays;
+         }
+      }
+      /* Check that the shadow map was actually used */
+      UInt64 unDecisions =
+         CSimulator::GetInstance().GetMedium<CLightVisibilityMedium>("lights").GetNumShadowMapDecisions();
+      if(unDecisions - m_unShadowMapDecisions != unExpectedDecisions) {
+         THROW_ARGOSEXCEPTION("The shadow map decided " << (unDecisions - m_unShadowMapDecisions) <<
+                              " occlusions instead of " << unExpectedDecisions <<
+                              " at step " << unClock);
+      }
+      m_unShadowMapDecisions = unDecisions;
+      /* Move the wall to the other side of the light */
+      if(unClock == MOVE_STEP) {
+         CBoxEntity& cWall = *any_cast<CBoxEntity*>(GetSpace().GetEntitiesByType("box")["wall"]);
+         if(!cWall.GetEmbodiedEntity().MoveTo(CVector3(-0.5, 0.0, 0.0), CQuaternion())) {
+            THROW_ARGOSEXCEPTION("Can't move the wall");
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      return GetSpace().GetSimulationClock() >= STEPS;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
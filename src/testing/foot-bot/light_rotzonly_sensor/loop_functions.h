@@ -0,0 +1,46 @@
+/**
+ * @file <argos3/testing/foot-bot/light_rotzonly_sensor/loop_functions.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+
+namespace argos {
+
+   /*
+    * Checks the light sensors that use the shadow map of a light visibility
+    * medium. Each pair of foot-bots has a rot-z-only and a default light
+    * sensor. One pair is in the shadow of a static wall, one pair is lit, and
+    * one pair is behind a movable box. After a while, the wall is moved to
+    * the other side of the light, so the first two pairs swap.
+    * The rays of the robots in the shadow of the wall and of the lit robots
+    * must be decided by the shadow map, with no ray query.
+    */
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() :
+         m_unShadowMapDecisions(0) {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void PostStep() override;
+
+      virtual bool IsExperimentFinished() override;
+
+   private:
+
+      const static UInt32 MOVE_STEP;
+      const static UInt32 STEPS;
+
+      UInt64 m_unShadowMapDecisions;
+
+   };
+}
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * @file <argos3/testing/foot-bot/loop_functions_map_reduce/controller.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "controller.h"
+
+#include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_actuator.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   void CTestController::Init(TConfigurationNode& t_tree) {
+      CCI_DifferentialSteeringActuator* pcActuator =
+         GetActuator<CCI_DifferentialSteeringActuator>("differential_steering");
+      pcActuator->SetLinearVelocity(10.0, 7.0); // drive in circles
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_CONTROLLER(CTestController, "test_controller");
+
+}
@@ -0,0 +1,198 @@
+/**
+ * @file <argos3/testing/foot-bot/loop_functions_map_reduce/loop_functions.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "loop_functions.h"
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/simulator/entity/floor_entity.h>
+
+#include <atomic>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const size_t CTestLoopFunctions::STEPS = 50;
+
+   /****************************************/
+   /****************************************/
+
+   static const CVector3& GetPosition(CFootBotEntity& c_foot_bot) {
+      return c_foot_bot.GetEmbodiedEntity().GetOriginAnchor().Position;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PreStep() {
+      /* Change the floor, to have the raster calculated again */
+      if(GetSpace().GetSimulationClock() % 10 == 0) {
+         ++m_unPattern;
+         GetSpace().GetFloorEntity().SetChanged();
+      }
+      /* The controllable entities can be visited several times */
+      for(UInt32 i = 0; i < 3; ++i) {
+         std::atomic<size_t> unVisits(0);
+         IterateOverControllableEntities([this, &unVisits](CControllableEntity*) {
+            RecordThread();
+            ++unVisits;
+         });
+         if(unVisits != GetSpace().GetEntitiesByType("foot-bot").size()) {
+            THROW_ARGOSEXCEPTION("IterateOverControllableEntities() visited " << unVisits <<
+                                 " robots instead of " << GetSpace().GetEntitiesByType("foot-bot").size());
+         }
+      }
+      /* The exceptions thrown by the callbacks reach the loop functions */
+      bool bThrown = false;
+      try {
+         MapReduce(
+            GetSpace().GetEntitiesByType("foot-bot").size(), size_t(0),
+            [](size_t&, size_t i) {
+               if(i == 7) THROW_ARGOSEXCEPTION("robot 7");
+            },
+            [](size_t&, size_t) {});
+      }
+      catch(CARGoSException& ex) {
+         bThrown = (std::string(ex.what()).find("robot 7") != std::string::npos);
+      }
+      if(!bThrown) {
+         THROW_ARGOSEXCEPTION("The exception thrown by MapReduce() was lost");
+      }
+      /* A MapReduce() nested in a callback runs in place */
+      std::atomic<size_t> unNestedErrors(0);
+      IterateOverEntities<CFootBotEntity>(
+         "foot-bot",
+         [this, &unNestedErrors](CFootBotEntity& c_foot_bot) {
+            size_t unCount = MapReduce(
+               100, size_t(0),
+               [](size_t& un_count, size_t) { ++un_count; },
+               [](size_t& un_total, size_t un_count) { un_total += un_count; });
+            if(unCount != 100) ++unNestedErrors;
+         });
+      if(unNestedErrors > 0) {
+         THROW_ARGOSEXCEPTION("Nested MapReduce() gave wrong results");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostStep() {
+      m_sParallelResults = Compute();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      /* Nothing to compare before the first step */
+      if(GetSpace().GetSimulationClock() == 0) {
+         return false;
+      }
+      /* Here the callbacks run in the main thread */
+      SResults sSerialResults = Compute();
+      if(sSerialResults.Robots != m_sParallelResults.Robots ||
+         sSerialResults.RobotsInNest != m_sParallelResults.RobotsInNest ||
+         sSerialResults.PositionSum != m_sParallelResults.PositionSum ||
+         sSerialResults.SquareDistanceSum != m_sParallelResults.SquareDistanceSum) {
+         THROW_ARGOSEXCEPTION("MapReduce() gave different results in the ARGoS threads: " <<
+                              m_sParallelResults.Robots << " robots, " <<
+                              m_sParallelResults.RobotsInNest << " in the nest, " <<
+                              m_sParallelResults.PositionSum << ", " <<
+                              m_sParallelResults.SquareDistanceSum << " instead of " <<
+                              sSerialResults.Robots << " robots, " <<
+                              sSerialResults.RobotsInNest << " in the nest, " <<
+                              sSerialResults.PositionSum << ", " <<
+                              sSerialResults.SquareDistanceSum);
+      }
+      /* The raster calculated by the threads matches the loop functions */
+      CFloorEntity& cFloor = GetSpace().GetFloorEntity();
+      Real fPixelSize = 1.0 / cFloor.GetRasterPixelsPerMeter();
+      const CVector3& cArenaSize = GetSpace().GetArenaSize();
+      for(Real fY = -cArenaSize.GetY() * 0.5 + fPixelSize * 0.5; fY < cArenaSize.GetY() * 0.5; fY += fPixelSize) {
+         for(Real fX = -cArenaSize.GetX() * 0.5 + fPixelSize * 0.5; fX < cArenaSize.GetX() * 0.5; fX += fPixelSize) {
+            if(cFloor.GetColorAtPoint(fX, fY) != GetFloorColor(CVector2(fX, fY))) {
+               THROW_ARGOSEXCEPTION("The floor raster differs from the loop functions at " <<
+                                    CVector2(fX, fY));
+            }
+         }
+      }
+      if(GetSpace().GetSimulationClock() < STEPS) {
+         return false;
+      }
+      /* With threads, the main thread runs no callback of PreStep() */
+      if(GetSimulator().GetNumThreads() > 0) {
+         if(m_setThreads.count(std::this_thread::get_id()) > 0) {
+            THROW_ARGOSEXCEPTION("The main thread ran the callbacks");
+         }
+      }
+      else if(m_setThreads.size() != 1) {
+         THROW_ARGOSEXCEPTION("The callbacks ran in " << m_setThreads.size() << " threads with no ARGoS threads");
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CColor CTestLoopFunctions::GetFloorColor(const CVector2& c_pos_on_floor) {
+      /* Stripes that move with the pattern */
+      SInt32 nStripe = static_cast<SInt32>(Floor(c_pos_on_floor.GetX() * 4)) + m_unPattern;
+      return (nStripe % 2 == 0) ? CColor::WHITE : CColor::BLACK;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CTestLoopFunctions::SResults CTestLoopFunctions::Compute() {
+      SResults sResults;
+      /* Several MapReduce() calls in a row */
+      sResults.Robots = MapReduceOverEntities<CFootBotEntity>(
+         "foot-bot", size_t(0),
+         [](size_t& un_count, CFootBotEntity&) { ++un_count; },
+         [](size_t& un_total, size_t un_count) { un_total += un_count; });
+      sResults.RobotsInNest = MapReduceOverEntities<CFootBotEntity>(
+         "foot-bot", size_t(0),
+         [](size_t& un_count, CFootBotEntity& c_foot_bot) {
+            if(GetPosition(c_foot_bot).GetX() < 0) ++un_count;
+         },
+         [](size_t& un_total, size_t un_count) { un_total += un_count; });
+      sResults.PositionSum = MapReduceOverEntities<CFootBotEntity>(
+         "foot-bot", CVector3(),
+         [](CVector3& c_sum, CFootBotEntity& c_foot_bot) {
+            c_sum += GetPosition(c_foot_bot);
+         },
+         [](CVector3& c_total, const CVector3& c_sum) { c_total += c_sum; });
+      /* Over indices, summing values of very different magnitudes */
+      std::vector<CFootBotEntity*> vecFootBots;
+      for(const auto& c_item : GetSpace().GetEntitiesByType("foot-bot")) {
+         vecFootBots.push_back(any_cast<CFootBotEntity*>(c_item.second));
+      }
+      sResults.SquareDistanceSum = MapReduce(
+         vecFootBots.size(), Real(0),
+         [&vecFootBots](Real& f_sum, size_t i) {
+            f_sum += GetPosition(*vecFootBots[i]).SquareLength() * (i % 2 == 0 ? 1e-6 : 1e6);
+         },
+         [](Real& f_total, Real f_sum) { f_total += f_sum; });
+      return sResults;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::RecordThread() {
+      std::lock_guard<std::mutex> cLock(m_cThreadsMutex);
+      m_setThreads.insert(std::this_thread::get_id());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
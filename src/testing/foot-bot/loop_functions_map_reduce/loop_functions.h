@@ -0,0 +1,76 @@
+/**
+ * @file <argos3/testing/foot-bot/loop_functions_map_reduce/loop_functions.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace argos {
+
+   /*
+    * Checks the parallel hooks of the loop functions: MapReduce() over
+    * controllable entities and over entities of a given type, called several
+    * times per step, IterateOverControllableEntities(), the propagation of
+    * the exceptions thrown by the callbacks, and the floor raster calculated
+    * by the ARGoS threads. The results computed in PostStep() are compared,
+    * bit for bit, with those computed again in IsExperimentFinished(), where
+    * the callbacks run in the main thread.
+    */
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() :
+         m_unPattern(0) {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void PreStep() override;
+
+      virtual void PostStep() override;
+
+      virtual bool IsExperimentFinished() override;
+
+      virtual CColor GetFloorColor(const CVector2& c_pos_on_floor) override;
+
+   private:
+
+      /** The results compared between the parallel and serial runs */
+      struct SResults {
+         size_t Robots;
+         size_t RobotsInNest;
+         CVector3 PositionSum;
+         Real SquareDistanceSum;
+      };
+
+      SResults Compute();
+
+      /** Records the thread running a callback */
+      void RecordThread();
+
+   private:
+
+      const static size_t STEPS;
+
+      /** Changes the floor color every few steps */
+      UInt32 m_unPattern;
+
+      /** The results of the last PostStep() */
+      SResults m_sParallelResults;
+
+      /** The threads that ran the callbacks */
+      std::set<std::thread::id> m_setThreads;
+      std::mutex m_cThreadsMutex;
+
+   };
+}
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ * Measures the control step of foot-bots running a Lua controller. With
+ * LuaJIT, the step is measured with the interpreter, with the JIT compiler,
+ * and with the JIT compiler reading the proximity readings through the FFI
+ * view; the three runs must compute the same wheel speeds. With Lua 5.3,
+ * only the interpreter is measured.
+ *
+ * Usage: footbot_lua_controller_benchmark [number of robots] [steps] [iterations]
+ *
+ * The robots stand on a square lattice with 0.2m spacing, so that they see
+ * each other with the proximity sensors. The iterations are the number of
+ * times the script computes the direction of the obstacles in each step.
+ */
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/core/wrappers/lua/lua_controller.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+static std::string MakeExperiment(UInt32 un_robots,
+                                  UInt32 un_iterations) {
+   UInt32 unSide = static_cast<UInt32>(std::ceil(std::sqrt(static_cast<Real>(un_robots))));
+   Real fSpacing = 0.2;
+   Real fHalfSide = unSide * fSpacing * 0.5;
+   Real fArena = unSide * fSpacing + 2.0;
+   std::ostringstream cXML;
+   cXML << "<argos-configuration>"
+        << "<framework>"
+        << "<system threads=\"0\" />"
+        << "<experiment length=\"0\" ticks_per_second=\"10\" random_seed=\"12345\" />"
+        << "</framework>"
+        << "<controllers>"
+        << "<lua_controller id=\"lua\">"
+        << "<actuators>"
+        << "<differential_steering implementation=\"default\" />"
+        << "</actuators>"
+        << "<sensors>"
+        << "<footbot_proximity implementation=\"default\" show_rays=\"false\" />"
+        << "</sensors>"
+        << "<params script=\"controller.lua\" iterations=\"" << un_iterations << "\" />"
+        << "</lua_controller>"
+        << "</controllers>"
+        << "<arena size=\"" << fArena << "," << fArena << ",1\" center=\"0,0,0.5\">";
+   for(UInt32 i = 0; i < un_robots; ++i) {
+      cXML << "<foot-bot id=\"fb" << i << "\">"
+           << "<body position=\""
+           << ((i % unSide) * fSpacing - fHalfSide) << ","
+           << ((i / unSide) * fSpacing - fHalfSide) << ",0\" orientation=\""
+           << (i * 37 % 360) << ",0,0\" />"
+           << "<controller config=\"lua\" />"
+           << "</foot-bot>";
+   }
+   cXML << "</arena>"
+        << "<physics_engines><dynamics2d id=\"dyn2d\" /></physics_engines>"
+        << "<media />"
+        << "</argos-configuration>";
+   return cXML.str();
+}
+
+/****************************************/
+/****************************************/
+
+#ifdef ARGOS_WITH_LUAJIT
+/*
+ * Runs the given code in the Lua state of each controller.
+ */
+static bool RunInControllers(std::vector<CLuaController*>& vec_controllers,
+                             const std::string& str_code) {
+   for(size_t i = 0; i < vec_controllers.size(); ++i) {
+      vec_controllers[i]->LockLuaState();
+      lua_State* ptState = vec_controllers[i]->GetLuaState();
+      if(luaL_dostring(ptState, str_code.c_str())) {
+         std::cerr << "Error running \"" << str_code << "\": "
+                   << lua_tostring(ptState, -1) << std::endl;
+         lua_pop(ptState, 1);
+         vec_controllers[i]->UnlockLuaState();
+         return false;
+      }
+      vec_controllers[i]->UnlockLuaState();
+   }
+   return true;
+}
+#endif
+
+/*
+ * Executes the control step of all the robots for the given number of steps,
+ * and returns the time per step in milliseconds.
+ */
+static double ControlStep(std::vector<CControllableEntity*>& vec_controllables,
+                          UInt32 un_steps) {
+   auto tStart = std::chrono::steady_clock::now();
+   for(UInt32 s = 0; s < un_steps; ++s) {
+      for(size_t i = 0; i < vec_controllables.size(); ++i) {
+         vec_controllables[i]->ControlStep();
+      }
+   }
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count() * 1e3 / un_steps;
+}
+
+#ifdef ARGOS_WITH_LUAJIT
+/*
+ * Returns the wheel speeds last computed by the scripts.
+ */
+static std::vector<Real> GetWheelSpeeds(std::vector<CLuaController*>& vec_controllers) {
+   std::vector<Real> vecSpeeds;
+   for(size_t i = 0; i < vec_controllers.size(); ++i) {
+      vec_controllers[i]->LockLuaState();
+      lua_State* ptState = vec_controllers[i]->GetLuaState();
+      lua_getglobal(ptState, "last_left");
+      lua_getglobal(ptState, "last_right");
+      vecSpeeds.push_back(lua_tonumber(ptState, -2));
+      vecSpeeds.push_back(lua_tonumber(ptState, -1));
+      lua_pop(ptState, 2);
+      vec_controllers[i]->UnlockLuaState();
+   }
+   return vecSpeeds;
+}
+
+/*
+ * Returns the number of wheel speeds that differ.
+ */
+static size_t CountMismatches(const std::vector<Real>& vec_a,
+                              const std::vector<Real>& vec_b) {
+   size_t unMismatches = 0;
+   for(size_t i = 0; i < vec_a.size(); ++i) {
+      if(std::abs(vec_a[i] - vec_b[i]) > 1e-6) {
+         ++unMismatches;
+      }
+   }
+   return unMismatches;
+}
+#endif
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unRobots = (argc > 1) ? std::atoi(argv[1]) : 400;
+   UInt32 unSteps = (argc > 2) ? std::atoi(argv[2]) : 20;
+   UInt32 unIterations = (argc > 3) ? std::atoi(argv[3]) : 20;
+   int nResult = EXIT_SUCCESS;
+   try {
+      CDynamicLoading::LoadLibrariesOnDemand();
+      /* Create the experiment */
+      ticpp::Document tConfiguration;
+      tConfiguration.Parse(MakeExperiment(unRobots, unIterations));
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      cSimulator.Load(tConfiguration, true);
+      /* Collect the controllers */
+      std::vector<CControllableEntity*> vecControllables;
+      std::vector<CLuaController*> vecControllers;
+      CSpace::TMapPerType& tFootBots = cSimulator.GetSpace().GetEntitiesByType("foot-bot");
+      for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+          it != tFootBots.end();
+          ++it) {
+         CFootBotEntity& cFootBot = *any_cast<CFootBotEntity*>(it->second);
+         vecControllables.push_back(&cFootBot.GetControllableEntity());
+         vecControllers.push_back(
+            &dynamic_cast<CLuaController&>(cFootBot.GetControllableEntity().GetController()));
+         if(! vecControllers.back()->IsOK()) {
+            THROW_ARGOSEXCEPTION("Error in the Lua controller of " << cFootBot.GetId() << ": " <<
+                                 vecControllers.back()->GetErrorMessage());
+         }
+      }
+      /* Sense once, the readings stay the same in all the runs */
+      for(size_t i = 0; i < vecControllables.size(); ++i) {
+         vecControllables[i]->Sense();
+      }
+      std::ostringstream cReport;
+      cReport << vecControllables.size() << " robots, "
+              << unIterations << " iterations per step, ";
+#ifdef ARGOS_WITH_LUAJIT
+      /* The interpreter: no trace is compiled */
+      if(! RunInControllers(vecControllers, "jit.off() jit.flush()")) {
+         THROW_ARGOSEXCEPTION("Can't turn the JIT compiler off");
+      }
+      double fInterpreterMS = ControlStep(vecControllables, unSteps);
+      std::vector<Real> vecInterpreter = GetWheelSpeeds(vecControllers);
+      /* The JIT compiler, reading the tables */
+      RunInControllers(vecControllers, "jit.on()");
+      double fJITMS = ControlStep(vecControllables, unSteps);
+      size_t unJITMismatches = CountMismatches(vecInterpreter, GetWheelSpeeds(vecControllers));
+      /* The JIT compiler, reading the FFI views */
+      RunInControllers(vecControllers, "use_ffi = true");
+      double fFFIMS = ControlStep(vecControllables, unSteps);
+      size_t unFFIMismatches = CountMismatches(vecInterpreter, GetWheelSpeeds(vecControllers));
+      cReport << fInterpreterMS << " ms per step with the interpreter, "
+              << fJITMS << " ms per step with the JIT compiler, "
+              << fFFIMS << " ms per step with the JIT compiler and the FFI views, "
+              << unJITMismatches + unFFIMismatches << " different wheel speeds";
+      if(unJITMismatches > 0 || unFFIMismatches > 0) {
+         std::cerr << "The JIT compiler and the FFI views change the wheel speeds" << std::endl;
+         nResult = EXIT_FAILURE;
+      }
+#else
+      double fInterpreterMS = ControlStep(vecControllables, unSteps);
+      cReport << fInterpreterMS << " ms per step with the interpreter";
+#endif
+      std::cout << cReport.str() << std::endl;
+      cSimulator.Destroy();
+   }
+   catch(std::exception& ex) {
+      std::cerr << ex.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+   return nResult;
+}
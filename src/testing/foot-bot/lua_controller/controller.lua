@@ -0,0 +1,69 @@
+-- Obstacle avoidance on the proximity readings. The direction of the
+-- obstacles is computed several times per step, so the cost of the script
+-- dominates the cost of a step.
+--
+-- The readings are read from the robot.proximity tables, or, when use_ffi is
+-- set and the Lua runtime is LuaJIT, from the robot.ffi.proximity view. The
+-- parameter use_ffi sets it at initialization.
+--
+-- The steps are counted in the step_counter module, which checks that each
+-- robot loads its own copy of the modules.
+
+use_ffi = false
+
+local iterations = 1
+
+-- Lua 5.3 has a two-argument math.atan, LuaJIT has math.atan2
+local atan2 = math.atan2 or math.atan
+
+-- Direction of the obstacles from the proximity tables
+local function obstacle_from_tables()
+   local x, y = 0, 0
+   for i = 1, #robot.proximity do
+      local reading = robot.proximity[i]
+      x = x + reading.value * math.cos(reading.angle)
+      y = y + reading.value * math.sin(reading.angle)
+   end
+   return x, y
+end
+
+-- Direction of the obstacles from the FFI view, indexed from 0
+local function obstacle_from_ffi()
+   local readings = robot.ffi.proximity
+   local x, y = 0, 0
+   for i = 0, #robot.proximity - 1 do
+      x = x + readings[i].value * math.cos(readings[i].angle)
+      y = y + readings[i].value * math.sin(readings[i].angle)
+   end
+   return x, y
+end
+
+function init()
+   iterations = tonumber(robot.params.iterations) or iterations
+   use_ffi = (robot.params.use_ffi == "true")
+   last_left, last_right = 0, 0
+   counter = require("step_counter")
+end
+
+function step()
+   local obstacle = obstacle_from_tables
+   if use_ffi and robot.ffi then
+      obstacle = obstacle_from_ffi
+   end
+   local turn = 0
+   for k = 1, iterations do
+      local x, y = obstacle()
+      turn = turn + atan2(y, x) / iterations
+   end
+   last_left, last_right = 10 + turn, 10 - turn
+   robot.wheels.set_velocity(last_left, last_right)
+   counter.steps = counter.steps + 1
+end
+
+function reset()
+   last_left, last_right = 0, 0
+   counter.steps = 0
+end
+
+function destroy()
+end
@@ -0,0 +1,84 @@
+/**
+ * @file <argos3/testing/foot-bot/lua_controller/loop_functions.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "loop_functions.h"
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/wrappers/lua/lua_controller.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_proximity_sensor.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const UInt32 CTestLoopFunctions::STEPS = 20;
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostStep() {
+      for(const auto& c_item : GetSpace().GetEntitiesByType("foot-bot")) {
+         CFootBotEntity* pcFootBot = any_cast<CFootBotEntity*>(c_item.second);
+         CLuaController& cController =
+            dynamic_cast<CLuaController&>(pcFootBot->GetControllableEntity().GetController());
+         if(!cController.IsOK()) {
+            THROW_ARGOSEXCEPTION("Error in the Lua controller of \"" << pcFootBot->GetId() <<
+                                 "\": " << cController.GetErrorMessage());
+         }
+         /* The direction of the obstacles, as computed by the script */
+         Real fX = 0.0, fY = 0.0;
+         for(const auto& s_reading :
+                cController.GetSensor<CCI_FootBotProximitySensor>("footbot_proximity")->GetReadings()) {
+            fX += s_reading.Value * Cos(s_reading.Angle);
+            fY += s_reading.Value * Sin(s_reading.Angle);
+         }
+         Real fTurn = ATan2(fY, fX).GetValue();
+         /* The wheel speeds set by the script */
+         cController.LockLuaState();
+         lua_State* ptState = cController.GetLuaState();
+         lua_getglobal(ptState, "last_left");
+         lua_getglobal(ptState, "last_right");
+         Real fLeft = lua_tonumber(ptState, -2);
+         Real fRight = lua_tonumber(ptState, -1);
+         lua_pop(ptState, 2);
+         /* The step counter module of the robot */
+         lua_getglobal(ptState, "counter");
+         lua_getfield(ptState, -1, "id");
+         lua_getfield(ptState, -2, "steps");
+         std::string strCounterId = lua_tostring(ptState, -2);
+         UInt32 unCounterSteps = lua_tonumber(ptState, -1);
+         lua_pop(ptState, 3);
+         cController.UnlockLuaState();
+         if(strCounterId != pcFootBot->GetId() ||
+            unCounterSteps != GetSpace().GetSimulationClock()) {
+            THROW_ARGOSEXCEPTION("Robot \"" << pcFootBot->GetId() << "\" uses the step counter module of \"" <<
+                                 strCounterId << "\", which counted " << unCounterSteps <<
+                                 " steps at step " << GetSpace().GetSimulationClock());
+         }
+         if(Abs(fLeft - (10.0 + fTurn)) > 1e-6 ||
+            Abs(fRight - (10.0 - fTurn)) > 1e-6) {
+            THROW_ARGOSEXCEPTION("Robot \"" << pcFootBot->GetId() << "\" set the wheel speeds (" <<
+                                 fLeft << ", " << fRight << ") instead of (" <<
+                                 (10.0 + fTurn) << ", " << (10.0 - fTurn) <<
+                                 ") at step " << GetSpace().GetSimulationClock());
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      return GetSpace().GetSimulationClock() >= STEPS;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
@@ -0,0 +1,41 @@
+/**
+ * @file <argos3/testing/foot-bot/lua_controller/loop_functions.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+
+namespace argos {
+
+   /*
+    * Checks the wheel speeds computed by the Lua controller of a row of
+    * foot-bots, which see each other with the proximity sensors. The speeds
+    * must match the ones computed here from the same proximity readings,
+    * both for the robots that read the robot.proximity tables and for the
+    * robots that read the FFI views. Without LuaJIT, all the robots read the
+    * tables.
+    */
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void PostStep() override;
+
+      virtual bool IsExperimentFinished() override;
+
+   private:
+
+      const static UInt32 STEPS;
+
+   };
+}
+
+#endif
@@ -0,0 +1,6 @@
+-- Counts the control steps of the robot that requires it. Each robot must get
+-- its own copy of the module, also when the robots share a Lua state.
+
+local counter = { id = robot.id, steps = 0 }
+
+return counter
@@ -0,0 +1,261 @@
+/*
+ * Measures the update of the rot-z-only motor ground sensor on a floor
+ * colored by the loop functions, with and without the floor raster, and
+ * checks that the raster gives the same readings as the loop functions
+ * for almost all the robots, also after a part of the floor changed.
+ *
+ * Usage: footbot_motor_ground_rotzonly_sensor_benchmark [number of robots] [steps]
+ *
+ * The robots stand on a square lattice with 0.3m spacing. The floor is
+ * white, with 256 black circular nests.
+ */
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/sensor.h>
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/simulator/entity/floor_entity.h>
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_motor_ground_sensor.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+/*
+ * A controller that only holds the sensor.
+ */
+class CBenchmarkController : public CCI_Controller {
+public:
+   virtual void Init(TConfigurationNode&) {
+      m_pcGroundSensor = GetSensor<CCI_FootBotMotorGroundSensor>("footbot_motor_ground");
+   }
+   virtual void ControlStep() {}
+   CCI_FootBotMotorGroundSensor* GetGroundSensor() {
+      return m_pcGroundSensor;
+   }
+private:
+   CCI_FootBotMotorGroundSensor* m_pcGroundSensor;
+};
+
+REGISTER_CONTROLLER(CBenchmarkController, "ground_benchmark_controller");
+
+/****************************************/
+/****************************************/
+
+/*
+ * Loop functions that color the floor by searching the closest nest.
+ */
+class CBenchmarkLoopFunctions : public CLoopFunctions {
+public:
+   CBenchmarkLoopFunctions() :
+      m_unCalls(0) {}
+   virtual CColor GetFloorColor(const CVector2& c_pos_on_floor) {
+      ++m_unCalls;
+      for(size_t i = 0; i < Nests.size(); ++i) {
+         if((c_pos_on_floor - Nests[i]).SquareLength() < NestRadius * NestRadius) {
+            return CColor::BLACK;
+         }
+      }
+      return CColor::WHITE;
+   }
+   size_t GetCalls() const {
+      return m_unCalls;
+   }
+   std::vector<CVector2> Nests;
+   Real NestRadius;
+private:
+   size_t m_unCalls;
+};
+
+REGISTER_LOOP_FUNCTIONS(CBenchmarkLoopFunctions, "ground_benchmark_loop_functions");
+
+/****************************************/
+/****************************************/
+
+static std::string MakeExperiment(UInt32 un_robots) {
+   UInt32 unSide = static_cast<UInt32>(std::ceil(std::sqrt(static_cast<Real>(un_robots))));
+   Real fSpacing = 0.3;
+   Real fHalfSide = unSide * fSpacing * 0.5;
+   Real fArena = unSide * fSpacing + 2.0;
+   std::ostringstream cXML;
+   cXML << "<argos-configuration>"
+        << "<framework>"
+        << "<system threads=\"0\" />"
+        << "<experiment length=\"0\" ticks_per_second=\"10\" random_seed=\"12345\" />"
+        << "</framework>"
+        << "<controllers>"
+        << "<ground_benchmark_controller id=\"ctrl\">"
+        << "<actuators />"
+        << "<sensors>"
+        << "<footbot_motor_ground implementation=\"rot_z_only\" />"
+        << "</sensors>"
+        << "<params />"
+        << "</ground_benchmark_controller>"
+        << "</controllers>"
+        << "<loop_functions label=\"ground_benchmark_loop_functions\" />"
+        << "<arena size=\"" << fArena << "," << fArena << ",1\" center=\"0,0,0.5\">"
+        << "<floor id=\"floor\" source=\"loop_functions\" pixels_per_meter=\"10\" />";
+   for(UInt32 i = 0; i < un_robots; ++i) {
+      cXML << "<foot-bot id=\"fb" << i << "\">"
+           << "<body position=\""
+           << ((i % unSide) * fSpacing - fHalfSide) << ","
+           << ((i / unSide) * fSpacing - fHalfSide) << ",0\" orientation=\""
+           << (i * 37 % 360) << ",0,0\" />"
+           << "<controller config=\"ctrl\" />"
+           << "</foot-bot>";
+   }
+   cXML << "</arena>"
+        << "<physics_engines><dynamics2d id=\"dyn2d\" /></physics_engines>"
+        << "<media />"
+        << "</argos-configuration>";
+   return cXML.str();
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Updates all the sensors for the given number of steps, and returns the time
+ * per step in milliseconds.
+ */
+static double UpdateSensors(std::vector<CSimulatedSensor*>& vec_sensors,
+                            UInt32 un_steps) {
+   CFloorEntity& cFloor = CSimulator::GetInstance().GetSpace().GetFloorEntity();
+   auto tStart = std::chrono::steady_clock::now();
+   for(UInt32 s = 0; s < un_steps; ++s) {
+      cFloor.Update();
+      for(size_t i = 0; i < vec_sensors.size(); ++i) {
+         vec_sensors[i]->Update();
+      }
+   }
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count() * 1e3 / un_steps;
+}
+
+/*
+ * Returns the readings of all the sensors.
+ */
+static std::vector<Real> GetReadings(std::vector<CCI_FootBotMotorGroundSensor*>& vec_sensors) {
+   std::vector<Real> vecReadings;
+   for(size_t i = 0; i < vec_sensors.size(); ++i) {
+      for(size_t j = 0; j < vec_sensors[i]->GetReadings().size(); ++j) {
+         vecReadings.push_back(vec_sensors[i]->GetReadings()[j].Value);
+      }
+   }
+   return vecReadings;
+}
+
+/*
+ * Returns the number of robots whose readings differ.
+ */
+static size_t CountMismatches(const std::vector<Real>& vec_a,
+                              const std::vector<Real>& vec_b) {
+   size_t unMismatches = 0;
+   for(size_t i = 0; i < vec_a.size(); i += 4) {
+      for(size_t j = i; j < i + 4; ++j) {
+         if(vec_a[j] != vec_b[j]) {
+            ++unMismatches;
+            break;
+         }
+      }
+   }
+   return unMismatches;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unRobots = (argc > 1) ? std::atoi(argv[1]) : 5000;
+   UInt32 unSteps = (argc > 2) ? std::atoi(argv[2]) : 10;
+   int nResult = EXIT_SUCCESS;
+   try {
+      CDynamicLoading::LoadLibrariesOnDemand();
+      /* Create the experiment */
+      ticpp::Document tConfiguration;
+      tConfiguration.Parse(MakeExperiment(unRobots));
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      cSimulator.Load(tConfiguration, true);
+      CFloorEntity& cFloor = cSimulator.GetSpace().GetFloorEntity();
+      /* Place the nests */
+      CBenchmarkLoopFunctions& cLoopFunctions =
+         dynamic_cast<CBenchmarkLoopFunctions&>(cSimulator.GetLoopFunctions());
+      Real fHalfArena = cSimulator.GetSpace().GetArenaSize().GetX() * 0.5 - 1.0;
+      for(UInt32 i = 0; i < 16; ++i) {
+         for(UInt32 j = 0; j < 16; ++j) {
+            cLoopFunctions.Nests.push_back(CVector2((i + 0.5) / 8.0 * fHalfArena - fHalfArena,
+                                                    (j + 0.5) / 8.0 * fHalfArena - fHalfArena));
+         }
+      }
+      cLoopFunctions.NestRadius = fHalfArena / 20.0;
+      /* Collect the sensors */
+      std::vector<CSimulatedSensor*> vecSensors;
+      std::vector<CCI_FootBotMotorGroundSensor*> vecControlInterfaces;
+      CSpace::TMapPerType& tFootBots = cSimulator.GetSpace().GetEntitiesByType("foot-bot");
+      for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+          it != tFootBots.end();
+          ++it) {
+         CFootBotEntity& cFootBot = *any_cast<CFootBotEntity*>(it->second);
+         CBenchmarkController& cController =
+            dynamic_cast<CBenchmarkController&>(cFootBot.GetControllableEntity().GetController());
+         vecControlInterfaces.push_back(cController.GetGroundSensor());
+         vecSensors.push_back(dynamic_cast<CSimulatedSensor*>(cController.GetGroundSensor()));
+      }
+      /* Without raster, the sensors call the loop functions */
+      double fSourceMS = UpdateSensors(vecSensors, unSteps);
+      std::vector<Real> vecSource = GetReadings(vecControlInterfaces);
+      /* With the raster; the first step fills it */
+      cFloor.SetRaster(100);
+      double fFirstMS = UpdateSensors(vecSensors, 1);
+      size_t unCalls = cLoopFunctions.GetCalls();
+      double fRasterMS = UpdateSensors(vecSensors, unSteps);
+      size_t unSensingCalls = cLoopFunctions.GetCalls() - unCalls;
+      size_t unMismatches = CountMismatches(vecSource, GetReadings(vecControlInterfaces));
+      /* Move a nest, and compare again */
+      CVector2 cOldNest = cLoopFunctions.Nests[119];
+      cLoopFunctions.Nests[119] += CVector2(cLoopFunctions.NestRadius, cLoopFunctions.NestRadius);
+      CVector2 cRadius(cLoopFunctions.NestRadius, cLoopFunctions.NestRadius);
+      cFloor.SetChanged(cOldNest - cRadius, cOldNest + cRadius);
+      cFloor.SetChanged(cLoopFunctions.Nests[119] - cRadius, cLoopFunctions.Nests[119] + cRadius);
+      unCalls = cLoopFunctions.GetCalls();
+      UpdateSensors(vecSensors, 1);
+      size_t unChangeCalls = cLoopFunctions.GetCalls() - unCalls;
+      std::vector<Real> vecRaster = GetReadings(vecControlInterfaces);
+      cFloor.SetRaster(0);
+      UpdateSensors(vecSensors, 1);
+      size_t unChangeMismatches = CountMismatches(GetReadings(vecControlInterfaces), vecRaster);
+      /* Report */
+      std::cout << vecSensors.size() << " robots, "
+                << fSourceMS << " ms per update with the loop functions, "
+                << fRasterMS << " ms per update with the raster ("
+                << fFirstMS << " ms to fill it), "
+                << unSensingCalls << " calls to the loop functions while sensing, "
+                << unMismatches << " robots with different readings, "
+                << unChangeCalls << " pixels sampled again after a change, "
+                << unChangeMismatches << " robots with different readings after it"
+                << std::endl;
+      cSimulator.Destroy();
+      /* The robots on the nest borders may differ, by construction */
+      if(unSensingCalls > 0 ||
+         unMismatches * 20 > vecSensors.size() ||
+         unChangeMismatches * 20 > vecSensors.size()) {
+         std::cerr << "The raster does not match the loop functions" << std::endl;
+         nResult = EXIT_FAILURE;
+      }
+   }
+   catch(std::exception& ex) {
+      std::cerr << ex.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+   return nResult;
+}
@@ -0,0 +1,16 @@
+/**
+ * @file <argos3/testing/foot-bot/motor_ground_rotzonly_sensor/controller.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "controller.h"
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_CONTROLLER(CTestController, "test_controller");
+
+}
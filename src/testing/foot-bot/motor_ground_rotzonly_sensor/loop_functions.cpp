@@ -0,0 +1,104 @@
+/**
+ * @file <argos3/testing/foot-bot/motor_ground_rotzonly_sensor/loop_functions.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "loop_functions.h"
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/simulator/entity/floor_entity.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_motor_ground_sensor.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const UInt32 CTestLoopFunctions::MOVE_STEP = 10;
+   const UInt32 CTestLoopFunctions::STEPS = 20;
+   const Real CTestLoopFunctions::NEST_RADIUS = 0.2;
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::Init(TConfigurationNode& t_tree) {
+      m_cNest.Set(0.5, 0.0);
+      if(GetSpace().GetFloorEntity().GetRasterPixelsPerMeter() == 0) {
+         THROW_ARGOSEXCEPTION("The floor is not rasterized");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CColor CTestLoopFunctions::GetFloorColor(const CVector2& c_pos_on_floor) {
+      ++m_unCalls;
+      return ((c_pos_on_floor - m_cNest).Length() < NEST_RADIUS) ? CColor::BLACK : CColor::WHITE;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostStep() {
+      UInt32 unClock = GetSpace().GetSimulationClock();
+      CFloorEntity& cFloor = GetSpace().GetFloorEntity();
+      /* The floor is sampled at the first step, and then only where it changed */
+      if(unClock == 1) {
+         if(m_unCalls == 0) {
+            THROW_ARGOSEXCEPTION("The raster was not filled at the first step");
+         }
+      }
+      else if(unClock == MOVE_STEP + 1) {
+         /* The rectangle around the old and the new nest, plus a border pixel */
+         Real fWidth = (1.0 + 2.0 * NEST_RADIUS) * cFloor.GetRasterPixelsPerMeter() + 3.0;
+         Real fHeight = 2.0 * NEST_RADIUS * cFloor.GetRasterPixelsPerMeter() + 3.0;
+         if(m_unCalls == 0 || m_unCalls > fWidth * fHeight) {
+            THROW_ARGOSEXCEPTION("The floor color was asked " << m_unCalls <<
+                                 " times after the nest moved");
+         }
+      }
+      else if(m_unCalls > 0) {
+         THROW_ARGOSEXCEPTION("The floor color was asked " << m_unCalls <<
+                              " times at step " << unClock);
+      }
+      m_unCalls = 0;
+      /* Check the readings of each robot */
+      for(const auto& c_item : GetSpace().GetEntitiesByType("foot-bot")) {
+         CFootBotEntity* pcFootBot = any_cast<CFootBotEntity*>(c_item.second);
+         const CVector3& cPosition = pcFootBot->GetEmbodiedEntity().GetOriginAnchor().Position;
+         Real fExpected =
+            ((CVector2(cPosition.GetX(), cPosition.GetY()) - m_cNest).Length() < NEST_RADIUS) ? 0.0 : 1.0;
+         for(const auto& s_reading :
+                pcFootBot->GetControllableEntity().GetController().
+                GetSensor<CCI_FootBotMotorGroundSensor>("footbot_motor_ground")->GetReadings()) {
+            if(s_reading.Value != fExpected) {
+               THROW_ARGOSEXCEPTION("Robot \"" << pcFootBot->GetId() << "\" reads " <<
+                                    s_reading.Value << " instead of " << fExpected <<
+                                    " at step " << unClock);
+            }
+         }
+      }
+      /* Move the nest under the other robot */
+      if(unClock == MOVE_STEP) {
+         CVector2 cRadius(NEST_RADIUS, NEST_RADIUS);
+         cFloor.SetChanged(m_cNest - cRadius, m_cNest + cRadius);
+         m_cNest.Set(-0.5, 0.0);
+         cFloor.SetChanged(m_cNest - cRadius, m_cNest + cRadius);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      return GetSpace().GetSimulationClock() >= STEPS;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
@@ -0,0 +1,53 @@
+/**
+ * @file <argos3/testing/foot-bot/motor_ground_rotzonly_sensor/loop_functions.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+
+namespace argos {
+
+   /*
+    * Checks the rot-z-only motor ground sensor on a rasterized floor, whose
+    * color comes from these loop functions: white, with a black nest. One
+    * foot-bot stands on the nest, the other on the white floor. After a
+    * while, the nest is moved under the other robot, and only the changed
+    * part of the floor is marked.
+    * The raster is filled at the first step, and later only where the floor
+    * changed: in the other steps, the loop functions are never asked for the
+    * color of the floor.
+    */
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() :
+         m_unCalls(0) {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void Init(TConfigurationNode& t_tree) override;
+
+      virtual CColor GetFloorColor(const CVector2& c_pos_on_floor) override;
+
+      virtual void PostStep() override;
+
+      virtual bool IsExperimentFinished() override;
+
+   private:
+
+      const static UInt32 MOVE_STEP;
+      const static UInt32 STEPS;
+      const static Real NEST_RADIUS;
+
+      CVector2 m_cNest;
+      UInt32 m_unCalls;
+
+   };
+}
+
+#endif
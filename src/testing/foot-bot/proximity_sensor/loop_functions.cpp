@@ -0,0 +1,78 @@
+/**
+ * @file <argos3/testing/foot-bot/proximity_sensor/loop_functions.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "loop_functions.h"
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_proximity_sensor.h>
+#include <argos3/plugins/simulator/entities/proximity_sensor_equipped_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const UInt32 CTestLoopFunctions::STEPS = 5;
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostStep() {
+      UInt32 unClock = GetSpace().GetSimulationClock();
+      UInt32 unObstructed = 0;
+      for(const auto& c_item : GetSpace().GetEntitiesByType("foot-bot")) {
+         CFootBotEntity* pcFootBot = any_cast<CFootBotEntity*>(c_item.second);
+         CProximitySensorEquippedEntity& cSensors = pcFootBot->GetProximitySensorEquippedEntity();
+         const std::vector<Real>& vecReadings =
+            pcFootBot->GetControllableEntity().GetController().
+            GetSensor<CCI_ProximitySensor>("proximity")->GetReadings();
+         SEmbodiedEntityIntersectionItem sIntersection;
+         for(UInt32 i = 0; i < vecReadings.size(); ++i) {
+            /* Cast the ray of the sensor one vector at a time */
+            const CProximitySensorEquippedEntity::SSensor& sSensor = cSensors.GetSensor(i);
+            CVector3 cRayStart = sSensor.Offset;
+            cRayStart.Rotate(sSensor.Anchor.Orientation);
+            cRayStart += sSensor.Anchor.Position;
+            CVector3 cRayEnd = sSensor.Offset;
+            cRayEnd += sSensor.Direction;
+            cRayEnd.Rotate(sSensor.Anchor.Orientation);
+            cRayEnd += sSensor.Anchor.Position;
+            CRay3 cRay(cRayStart, cRayEnd);
+            Real fExpected = 0.0;
+            if(GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
+                                                        cRay,
+                                                        pcFootBot->GetEmbodiedEntity())) {
+               fExpected = Exp(-cRay.GetDistance(sIntersection.TOnRay));
+               ++unObstructed;
+            }
+            if(Abs(vecReadings[i] - fExpected) > 1e-9) {
+               THROW_ARGOSEXCEPTION("Sensor " << i << " of \"" << pcFootBot->GetId() <<
+                                    "\" reads " << vecReadings[i] <<
+                                    " instead of " << fExpected <<
+                                    " at step " << unClock);
+            }
+         }
+      }
+      /* The boxes must be seen */
+      if(unObstructed == 0) {
+         THROW_ARGOSEXCEPTION("No proximity sensor sees the boxes at step " << unClock);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      return GetSpace().GetSimulationClock() >= STEPS;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
@@ -0,0 +1,39 @@
+/**
+ * @file <argos3/testing/foot-bot/proximity_sensor/loop_functions.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+
+namespace argos {
+
+   /*
+    * Checks the default proximity sensor, which computes its rays with the
+    * batch transforms. Foot-bots with different orientations stand next to
+    * boxes, and the readings of their sensors are compared with those of
+    * rays computed one at a time with CVector3::Rotate().
+    */
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void PostStep() override;
+
+      virtual bool IsExperimentFinished() override;
+
+   private:
+
+      const static UInt32 STEPS;
+
+   };
+}
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ * Measures the update of the range-and-bearing medium sensor in a dense
+ * swarm, and checks that it does not allocate memory once the readings of
+ * all the robots have been filled a first time.
+ *
+ * Usage: footbot_range_and_bearing_medium_sensor_benchmark [number of robots] [steps]
+ *
+ * The robots stand on a square lattice with 0.3m spacing, and their range
+ * is such that each of them receives about 50 messages of 10 bytes.
+ */
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/sensor.h>
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_sensor.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <vector>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+/*
+ * Counts the allocations made while the flag is set.
+ */
+static std::atomic<bool> g_bCountAllocations(false);
+static std::atomic<size_t> g_unAllocations(0);
+
+void* operator new(size_t un_size) {
+   if(g_bCountAllocations) ++g_unAllocations;
+   void* pvData = std::malloc(un_size > 0 ? un_size : 1);
+   if(pvData == nullptr) throw std::bad_alloc();
+   return pvData;
+}
+
+void operator delete(void* pv_data) noexcept {
+   std::free(pv_data);
+}
+
+void operator delete(void* pv_data, size_t) noexcept {
+   std::free(pv_data);
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * A controller that only holds the sensor.
+ */
+class CBenchmarkController : public CCI_Controller {
+public:
+   virtual void Init(TConfigurationNode&) {
+      m_pcRABSensor = GetSensor<CCI_RangeAndBearingSensor>("range_and_bearing");
+   }
+   virtual void ControlStep() {}
+   CCI_RangeAndBearingSensor* GetRABSensor() {
+      return m_pcRABSensor;
+   }
+private:
+   CCI_RangeAndBearingSensor* m_pcRABSensor;
+};
+
+REGISTER_CONTROLLER(CBenchmarkController, "rab_benchmark_controller");
+
+/****************************************/
+/****************************************/
+
+static std::string MakeExperiment(UInt32 un_robots) {
+   UInt32 unSide = static_cast<UInt32>(std::ceil(std::sqrt(static_cast<Real>(un_robots))));
+   Real fSpacing = 0.3;
+   /* About 50 lattice points in range */
+   Real fRange = fSpacing * std::sqrt(51.0 / ARGOS_PI);
+   Real fArena = unSide * fSpacing + 2.0;
+   std::ostringstream cXML;
+   cXML << "<argos-configuration>"
+        << "<framework>"
+        << "<system threads=\"0\" />"
+        << "<experiment length=\"0\" ticks_per_second=\"10\" random_seed=\"12345\" />"
+        << "</framework>"
+        << "<controllers>"
+        << "<rab_benchmark_controller id=\"ctrl\">"
+        << "<actuators />"
+        << "<sensors>"
+        << "<range_and_bearing implementation=\"medium\" medium=\"rab\" noise_std_dev=\"0.01\" />"
+        << "</sensors>"
+        << "<params />"
+        << "</rab_benchmark_controller>"
+        << "</controllers>"
+        << "<arena size=\"" << fArena << "," << fArena << ",1\">";
+   for(UInt32 i = 0; i < un_robots; ++i) {
+      cXML << "<foot-bot id=\"fb" << i << "\" rab_range=\"" << fRange << "\" rab_data_size=\"10\">"
+           << "<body position=\""
+           << ((i % unSide) * fSpacing - unSide * fSpacing * 0.5) << ","
+           << ((i / unSide) * fSpacing - unSide * fSpacing * 0.5) << ",0\" orientation=\"0,0,0\" />"
+           << "<controller config=\"ctrl\" />"
+           << "</foot-bot>";
+   }
+   cXML << "</arena>"
+        << "<physics_engines><dynamics2d id=\"dyn2d\" /></physics_engines>"
+        << "<media><range_and_bearing id=\"rab\" check_occlusions=\"false\" /></media>"
+        << "</argos-configuration>";
+   return cXML.str();
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unRobots = (argc > 1) ? std::atoi(argv[1]) : 5000;
+   UInt32 unSteps = (argc > 2) ? std::atoi(argv[2]) : 20;
+   try {
+      CDynamicLoading::LoadLibrariesOnDemand();
+      /* Create the experiment */
+      ticpp::Document tConfiguration;
+      tConfiguration.Parse(MakeExperiment(unRobots));
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      cSimulator.Load(tConfiguration, true);
+      /* Collect the sensors */
+      std::vector<CSimulatedSensor*> vecSensors;
+      std::vector<CCI_RangeAndBearingSensor*> vecControlInterfaces;
+      CSpace::TMapPerType& tFootBots = cSimulator.GetSpace().GetEntitiesByType("foot-bot");
+      for(CSpace::TMapPerType::iterator it = tFootBots.begin();
+          it != tFootBots.end();
+          ++it) {
+         CFootBotEntity& cFootBot = *any_cast<CFootBotEntity*>(it->second);
+         CBenchmarkController& cController =
+            dynamic_cast<CBenchmarkController&>(cFootBot.GetControllableEntity().GetController());
+         vecControlInterfaces.push_back(cController.GetRABSensor());
+         vecSensors.push_back(dynamic_cast<CSimulatedSensor*>(cController.GetRABSensor()));
+      }
+      /* The first update fills the readings */
+      for(size_t i = 0; i < vecSensors.size(); ++i) {
+         vecSensors[i]->Update();
+      }
+      /* Measure the following updates */
+      g_unAllocations = 0;
+      g_bCountAllocations = true;
+      auto tStart = std::chrono::steady_clock::now();
+      for(UInt32 s = 0; s < unSteps; ++s) {
+         for(size_t i = 0; i < vecSensors.size(); ++i) {
+            vecSensors[i]->Update();
+         }
+      }
+      double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+      g_bCountAllocations = false;
+      size_t unAllocations = g_unAllocations;
+      /* Report */
+      size_t unReadings = 0;
+      for(size_t i = 0; i < vecControlInterfaces.size(); ++i) {
+         unReadings += vecControlInterfaces[i]->GetReadings().size();
+      }
+      std::cout << vecSensors.size() << " robots, "
+                << (static_cast<Real>(unReadings) / vecSensors.size()) << " readings per robot, "
+                << (fSeconds * 1e3 / unSteps) << " ms per update of all the sensors, "
+                << unAllocations << " allocations in " << unSteps << " updates"
+                << std::endl;
+      cSimulator.Destroy();
+      if(unAllocations > 0) {
+         std::cerr << "The sensor allocated memory after the first update" << std::endl;
+         return EXIT_FAILURE;
+      }
+   }
+   catch(std::exception& ex) {
+      std::cerr << ex.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,30 @@
+/**
+ * @file <argos3/testing/foot-bot/range_and_bearing_medium_sensor/controller.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "controller.h"
+
+#include <argos3/core/utility/string_utilities.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_actuator.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   void CTestController::Init(TConfigurationNode& t_tree) {
+      /* Send the index in the robot id, "fb<index>" */
+      UInt8 unIndex = FromString<UInt32>(GetId().substr(2));
+      CCI_RangeAndBearingActuator* pcActuator =
+         GetActuator<CCI_RangeAndBearingActuator>("range_and_bearing");
+      pcActuator->SetData(0, unIndex);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_CONTROLLER(CTestController, "test_controller");
+
+}
@@ -0,0 +1,22 @@
+/**
+ * @file <argos3/testing/foot-bot/range_and_bearing_medium_sensor/controller.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include <argos3/core/control_interface/ci_controller.h>
+
+namespace argos {
+
+   class CTestController : public CCI_Controller {
+
+   public:
+
+      CTestController() {}
+
+      virtual ~CTestController() {}
+
+      virtual void Init(TConfigurationNode& t_tree);
+
+   };
+}
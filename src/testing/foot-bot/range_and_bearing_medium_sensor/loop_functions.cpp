@@ -0,0 +1,114 @@
+/**
+ * @file <argos3/testing/foot-bot/range_and_bearing_medium_sensor/loop_functions.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "loop_functions.h"
+#include <argos3/core/utility/string_utilities.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/plugins/simulator/entities/rab_equipped_entity.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_sensor.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+
+#include <map>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const UInt32 CTestLoopFunctions::ADD_STEP = 10;
+   const UInt32 CTestLoopFunctions::SHRINK_STEP = 20;
+   const UInt32 CTestLoopFunctions::STEPS = 30;
+   const Real CTestLoopFunctions::RAB_RANGE = 0.35;
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostStep() {
+      /* The robots, by the index in their id */
+      std::map<UInt32, CFootBotEntity*> mapFootBots;
+      for(const auto& c_item : GetSpace().GetEntitiesByType("foot-bot")) {
+         CFootBotEntity* pcFootBot = any_cast<CFootBotEntity*>(c_item.second);
+         mapFootBots[FromString<UInt32>(pcFootBot->GetId().substr(2))] = pcFootBot;
+      }
+      /* Check the readings of each robot */
+      for(const auto& c_receiver : mapFootBots) {
+         const CVector3& cReceiverPosition =
+            c_receiver.second->GetEmbodiedEntity().GetOriginAnchor().Position;
+         const CCI_RangeAndBearingSensor::TReadings& tReadings =
+            c_receiver.second->GetControllableEntity().GetController().
+            GetSensor<CCI_RangeAndBearingSensor>("range_and_bearing")->GetReadings();
+         /* The robots in range */
+         std::map<UInt32, CVector3> mapExpected;
+         for(const auto& c_sender : mapFootBots) {
+            CVector3 cOffset =
+               c_sender.second->GetEmbodiedEntity().GetOriginAnchor().Position - cReceiverPosition;
+            if(c_sender.first != c_receiver.first &&
+               cOffset.Length() < c_sender.second->GetRABEquippedEntity().GetRange()) {
+               mapExpected[c_sender.first] = cOffset;
+            }
+         }
+         if(tReadings.size() != mapExpected.size()) {
+            THROW_ARGOSEXCEPTION("Robot \"" << c_receiver.second->GetId() << "\" received " <<
+                                 tReadings.size() << " messages instead of " <<
+                                 mapExpected.size() << " at step " << GetSpace().GetSimulationClock());
+         }
+         for(const CCI_RangeAndBearingSensor::SPacket& s_packet : tReadings) {
+            if(s_packet.Data.Size() != 4) {
+               THROW_ARGOSEXCEPTION("Robot \"" << c_receiver.second->GetId() << "\" received " <<
+                                    s_packet.Data.Size() << " bytes instead of 4");
+            }
+            auto itSender = mapExpected.find(s_packet.Data[0]);
+            if(itSender == mapExpected.end()) {
+               THROW_ARGOSEXCEPTION("Robot \"" << c_receiver.second->GetId() <<
+                                    "\" received an unexpected message from fb" <<
+                                    static_cast<UInt32>(s_packet.Data[0]) << " at step " <<
+                                    GetSpace().GetSimulationClock());
+            }
+            /* The range is in cm, the robots all face the X axis */
+            if(Abs(s_packet.Range - itSender->second.Length() * 100.0) > 1e-6 ||
+               Abs((s_packet.HorizontalBearing -
+                    ATan2(itSender->second.GetY(), itSender->second.GetX())).
+                   SignedNormalize().GetValue()) > 1e-6) {
+               THROW_ARGOSEXCEPTION("Robot \"" << c_receiver.second->GetId() <<
+                                    "\" received the message of fb" << itSender->first <<
+                                    " with the wrong range or bearing");
+            }
+            /* Each robot is received once */
+            mapExpected.erase(itSender);
+         }
+      }
+      /* Add the center robot, then make its messages reach nobody */
+      if(GetSpace().GetSimulationClock() == ADD_STEP) {
+         CFootBotEntity* pcFootBot =
+            new CFootBotEntity("fb4", "test_controller", CVector3(), CQuaternion(), RAB_RANGE, 4);
+         AddEntity(*pcFootBot);
+      }
+      else if(GetSpace().GetSimulationClock() == SHRINK_STEP) {
+         any_cast<CFootBotEntity*>(GetSpace().GetEntitiesByType("foot-bot")["fb4"])->
+            GetRABEquippedEntity().SetRange(0.2);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      if(GetSpace().GetSimulationClock() < STEPS) {
+         return false;
+      }
+      if(GetSpace().GetEntitiesByType("foot-bot").size() != 9) {
+         THROW_ARGOSEXCEPTION("The center robot was not added");
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
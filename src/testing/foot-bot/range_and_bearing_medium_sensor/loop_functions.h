@@ -0,0 +1,45 @@
+/**
+ * @file <argos3/testing/foot-bot/range_and_bearing_medium_sensor/loop_functions.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+
+namespace argos {
+
+   /*
+    * Checks the readings of the range-and-bearing medium sensor on a 3x3
+    * lattice of foot-bots, where only the orthogonal neighbors are in range.
+    * The center robot is added later, and later still its range is reduced so
+    * that its messages reach nobody: the readings, which are reused across
+    * steps, must grow and shrink again.
+    * Every reading must come from a robot in range, exactly once, with the
+    * payload, range and bearing of that robot.
+    */
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void PostStep() override;
+
+      virtual bool IsExperimentFinished() override;
+
+   private:
+
+      const static UInt32 ADD_STEP;
+      const static UInt32 SHRINK_STEP;
+      const static UInt32 STEPS;
+      const static Real RAB_RANGE;
+
+   };
+}
+
+#endif
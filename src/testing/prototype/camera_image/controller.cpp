@@ -0,0 +1,24 @@
+/**
+ * @file <argos3/testing/prototype/camera_image/controller.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "controller.h"
+#include <argos3/plugins/robots/generic/control_interface/ci_camera_sensor.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   void CTestController::Init(TConfigurationNode& t_tree) {
+      GetSensor<CCI_CameraSensor>("cameras")->Enable();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_CONTROLLER(CTestController, "test_controller");
+
+}
@@ -0,0 +1,25 @@
+/**
+ * @file <argos3/testing/prototype/camera_image/controller.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include <argos3/core/control_interface/ci_controller.h>
+
+namespace argos {
+
+   /*
+    * Enables the camera, whose image is checked by the loop functions.
+    */
+   class CTestController : public CCI_Controller {
+
+   public:
+
+      CTestController() {}
+
+      virtual ~CTestController() {}
+
+      virtual void Init(TConfigurationNode& t_tree) override;
+
+   };
+}
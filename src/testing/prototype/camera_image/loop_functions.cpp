@@ -0,0 +1,80 @@
+/**
+ * @file <argos3/testing/prototype/camera_image/loop_functions.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "loop_functions.h"
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_camera_sensor.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_camera_sensor_algorithms/ci_camera_sensor_image_algorithm.h>
+#include <argos3/plugins/robots/prototype/simulator/prototype_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const UInt32 CTestLoopFunctions::STEPS = 3;
+
+   /****************************************/
+   /****************************************/
+
+   void CTestLoopFunctions::PostStep() {
+      CPrototypeEntity& cRobot = dynamic_cast<CPrototypeEntity&>(GetSpace().GetEntity("robot"));
+      const CCI_CameraSensor::SInterface& sCamera =
+         cRobot.GetControllableEntity().GetController().GetSensor<CCI_CameraSensor>("cameras")->GetInterfaces()[0];
+      const CCI_CameraSensorImageAlgorithm* pcImage =
+         dynamic_cast<const CCI_CameraSensorImageAlgorithm*>(sCamera.Algorithms[0]);
+      if(pcImage == nullptr) {
+         THROW_ARGOSEXCEPTION("The camera has no image algorithm");
+      }
+      /* Count the pixels of each color */
+      UInt32 unRed = 0, unGray = 0, unBlue = 0, unOther = 0;
+      const std::vector<UInt8>& vecColors = pcImage->GetColorBuffer();
+      for(size_t i = 0; i < vecColors.size(); i += 3) {
+         UInt8 unR = vecColors[i], unG = vecColors[i + 1], unB = vecColors[i + 2];
+         if(unR == 0 && unG == 0 && unB == 0) {
+            /* Background */
+         }
+         else if(unR > 0 && unG == 0 && unB == 0) {
+            ++unRed;
+         }
+         else if(unR == unG && unG == unB) {
+            ++unGray;
+         }
+         else if(unR == 0 && unG == 0 && unB > 0) {
+            ++unBlue;
+         }
+         else {
+            ++unOther;
+         }
+      }
+      UInt32 unClock = GetSpace().GetSimulationClock();
+      if(unBlue > 0) {
+         THROW_ARGOSEXCEPTION("The camera sees the body of its robot at step " << unClock);
+      }
+      if(unRed == 0) {
+         THROW_ARGOSEXCEPTION("The camera does not see the box at step " << unClock);
+      }
+      if(unGray == 0) {
+         THROW_ARGOSEXCEPTION("The camera does not see the cylinder at step " << unClock);
+      }
+      if(unOther > 0) {
+         THROW_ARGOSEXCEPTION("The image has " << unOther << " pixels of unexpected colors at step " << unClock);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTestLoopFunctions::IsExperimentFinished() {
+      return GetSpace().GetSimulationClock() >= STEPS;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_LOOP_FUNCTIONS(CTestLoopFunctions, "test_loop_functions");
+
+}
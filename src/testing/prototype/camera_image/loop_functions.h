@@ -0,0 +1,41 @@
+/**
+ * @file <argos3/testing/prototype/camera_image/loop_functions.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef TEST_LOOP_FUNCTIONS_H
+#define TEST_LOOP_FUNCTIONS_H
+
+#include <argos3/core/simulator/loop_functions.h>
+
+namespace argos {
+
+   /*
+    * Checks the image rendered by the image algorithm of the camera sensor.
+    * The camera sits behind the body of the robot that carries it and looks
+    * through it at a movable box and at a non-movable cylinder. The image
+    * must show the box in red and the cylinder in gray, as in the Qt-OpenGL
+    * visualization, and must not show the body of the robot, which would be
+    * drawn in the blue body color.
+    */
+   class CTestLoopFunctions : public CLoopFunctions {
+
+   public:
+
+      CTestLoopFunctions() {}
+
+      virtual ~CTestLoopFunctions() {}
+
+      virtual void PostStep() override;
+
+      virtual bool IsExperimentFinished() override;
+
+   private:
+
+      const static UInt32 STEPS;
+
+   };
+}
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * Measures the construction of convex hulls of point clouds of 1k, 10k and
+ * 100k points, checks that the hulls are closed and contain all the points,
+ * and measures the convex hull shape cache of the dynamics3d engine.
+ *
+ * Usage: prototype_convex_hull_benchmark [number of cached shapes]
+ *
+ * The clouds are points in a ball, whose hull has few vertices, and points
+ * on a sphere, which are all vertices of the hull, as in scanned meshes.
+ */
+
+#include <argos3/core/utility/math/convex_hull.h>
+#include <argos3/plugins/simulator/physics_engines/dynamics3d/dynamics3d_shape_manager.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+/*
+ * Returns points uniformly distributed in the unit ball, or on the unit sphere.
+ */
+static std::vector<CVector3> MakeCloud(std::mt19937& c_rng,
+                                       UInt32 un_points,
+                                       bool b_on_sphere) {
+   std::normal_distribution<Real> cGaussian(0.0, 1.0);
+   std::uniform_real_distribution<Real> cUniform(0.0, 1.0);
+   std::vector<CVector3> vecPoints;
+   vecPoints.reserve(un_points);
+   while(vecPoints.size() < un_points) {
+      CVector3 cPoint(cGaussian(c_rng), cGaussian(c_rng), cGaussian(c_rng));
+      if(cPoint.SquareLength() < 1e-12) continue;
+      cPoint.Normalize();
+      if(!b_on_sphere) {
+         cPoint *= std::cbrt(cUniform(c_rng));
+      }
+      vecPoints.push_back(cPoint);
+   }
+   return vecPoints;
+}
+
+/*
+ * Checks that the hull is a closed surface, whose faces have all the points
+ * behind them. Returns the number of vertices of the hull, or -1 on error.
+ */
+static SInt32 CheckHull(const std::vector<CVector3>& vec_points,
+                        const std::vector<CConvexHull::SFace>& vec_faces,
+                        UInt32 un_point_stride) {
+   /* Each edge is used once in each direction */
+   std::map<std::pair<UInt32, UInt32>, UInt32> mapEdges;
+   std::set<UInt32> setVertices;
+   for(const CConvexHull::SFace& s_face : vec_faces) {
+      for(UInt32 i = 0; i < 3; ++i) {
+         setVertices.insert(s_face.VertexIndices[i]);
+         ++mapEdges[std::make_pair(s_face.VertexIndices[i], s_face.VertexIndices[(i + 1) % 3])];
+      }
+   }
+   for(const auto& c_edge : mapEdges) {
+      auto itReverse = mapEdges.find(std::make_pair(c_edge.first.second, c_edge.first.first));
+      if(c_edge.second != 1 || itReverse == mapEdges.end() || itReverse->second != 1) {
+         std::cerr << "Edge (" << c_edge.first.first << "," << c_edge.first.second
+                   << ") is not shared by exactly two faces" << std::endl;
+         return -1;
+      }
+   }
+   /* Euler's formula for a closed surface of genus 0 */
+   if(setVertices.size() + vec_faces.size() != mapEdges.size() / 2 + 2) {
+      std::cerr << "The hull is not a closed surface" << std::endl;
+      return -1;
+   }
+   /* All the points are behind all the faces */
+   for(UInt32 i = 0; i < vec_points.size(); i += un_point_stride) {
+      for(const CConvexHull::SFace& s_face : vec_faces) {
+         Real fLength = s_face.Normal.Length();
+         if(s_face.Normal.DotProduct(vec_points[i]) - s_face.Direction > 1e-9 * fLength) {
+            std::cerr << "Point " << i << " is outside the hull" << std::endl;
+            return -1;
+         }
+      }
+   }
+   return setVertices.size();
+}
+
+/****************************************/
+/****************************************/
+
+static double Seconds(std::chrono::steady_clock::time_point t_start) {
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unShapes = (argc > 1) ? std::atoi(argv[1]) : 50;
+   std::mt19937 cRNG(12345);
+   try {
+      /* The convex hulls */
+      for(UInt32 un_points : {1000, 10000, 100000}) {
+         for(bool b_on_sphere : {false, true}) {
+            std::vector<CVector3> vecPoints = MakeCloud(cRNG, un_points, b_on_sphere);
+            auto tStart = std::chrono::steady_clock::now();
+            CConvexHull cHull(vecPoints);
+            double fHullMS = Seconds(tStart) * 1e3;
+            /* Check a sample of the points against all the faces */
+            SInt32 nVertices = CheckHull(vecPoints, cHull.GetFaces(), un_points / 1000);
+            std::cout << un_points << " points " << (b_on_sphere ? "on a sphere" : "in a ball") << ", "
+                      << fHullMS << " ms to build the hull, "
+                      << nVertices << " vertices, "
+                      << cHull.GetFaces().size() << " faces"
+                      << std::endl;
+            if(nVertices < 0 ||
+               (b_on_sphere && static_cast<UInt32>(nVertices) != un_points)) {
+               std::cerr << "Wrong convex hull" << std::endl;
+               return EXIT_FAILURE;
+            }
+         }
+      }
+      /* The shape cache */
+      std::vector<std::vector<btVector3> > vecClouds;
+      for(UInt32 i = 0; i < unShapes; ++i) {
+         vecClouds.emplace_back();
+         for(const CVector3& c_point : MakeCloud(cRNG, 10000, false)) {
+            vecClouds.back().emplace_back(c_point.GetX(), c_point.GetY(), c_point.GetZ());
+         }
+      }
+      std::vector<std::shared_ptr<btCollisionShape> > vecShapes;
+      auto tStart = std::chrono::steady_clock::now();
+      for(const std::vector<btVector3>& vec_cloud : vecClouds) {
+         vecShapes.push_back(CDynamics3DShapeManager::RequestConvexHull(vec_cloud));
+      }
+      double fCreateMS = Seconds(tStart) * 1e3 / unShapes;
+      /* Request copies of the clouds, which must give the cached shapes */
+      std::vector<std::vector<btVector3> > vecCopies(vecClouds);
+      bool bCached = true;
+      tStart = std::chrono::steady_clock::now();
+      for(UInt32 i = 0; i < unShapes; ++i) {
+         bCached &= (CDynamics3DShapeManager::RequestConvexHull(vecCopies[i]) == vecShapes[i]);
+      }
+      double fLookupMS = Seconds(tStart) * 1e3 / unShapes;
+      bool bDistinct = (std::set<std::shared_ptr<btCollisionShape> >(vecShapes.begin(), vecShapes.end()).size() == unShapes);
+      std::cout << unShapes << " cached shapes of 10000 points, "
+                << fCreateMS << " ms to create a shape, "
+                << fLookupMS << " ms to find a cached shape"
+                << std::endl;
+      if(!bCached || !bDistinct) {
+         std::cerr << "The shape cache returned the wrong shapes" << std::endl;
+         return EXIT_FAILURE;
+      }
+   }
+   catch(std::exception& ex) {
+      std::cerr << ex.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/*
+ * Measures the magnetism plugin of the dynamics3d engine with the pairwise
+ * loop and with the cell list, and checks that the two methods move the
+ * magnetic blocks the same way.
+ *
+ * Usage: prototype_magnetism_benchmark [number of blocks] [steps]
+ *
+ * The blocks are prototypes with a magnet on each side, resting on the floor
+ * on a square lattice, so that the magnets facing each other are closer than
+ * the maximum interaction distance, and strong enough to move the blocks.
+ */
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/plugins/simulator/physics_engines/dynamics3d/dynamics3d_engine.h>
+#include <argos3/plugins/simulator/physics_engines/dynamics3d/dynamics3d_plugin.h>
+#include <argos3/plugins/robots/prototype/simulator/prototype_entity.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+static const Real BLOCK_SIDE = 0.05;
+static const Real SPACING = 0.07;
+static const Real MAX_DISTANCE = 0.04;
+static const Real FIELD = 100.0;
+
+/****************************************/
+/****************************************/
+
+static std::string MakeExperiment(UInt32 un_blocks) {
+   UInt32 unSide = static_cast<UInt32>(std::ceil(std::sqrt(static_cast<Real>(un_blocks))));
+   Real fHalfSide = unSide * SPACING * 0.5;
+   Real fArena = unSide * SPACING + 1.0;
+   Real fHalfBlock = BLOCK_SIDE * 0.5;
+   std::ostringstream cXML;
+   cXML << "<argos-configuration>"
+        << "<framework>"
+        << "<system threads=\"0\" />"
+        << "<experiment length=\"0\" ticks_per_second=\"10\" random_seed=\"12345\" />"
+        << "</framework>"
+        << "<controllers />"
+        << "<arena size=\"" << fArena << "," << fArena << ",1\" center=\"0,0,0.5\">";
+   for(UInt32 i = 0; i < un_blocks; ++i) {
+      cXML << "<prototype id=\"block" << i << "\" movable=\"true\">"
+           << "<body position=\""
+           << ((i % unSide) * SPACING - fHalfSide) << ","
+           << ((i / unSide) * SPACING - fHalfSide) << ",0\" orientation=\"0,0,0\" />"
+           << "<links ref=\"base\">"
+           << "<link id=\"base\" geometry=\"box\" size=\""
+           << BLOCK_SIDE << "," << BLOCK_SIDE << "," << BLOCK_SIDE << "\" mass=\"0.1\""
+           << " position=\"0,0,0\" orientation=\"0,0,0\" />"
+           << "</links>"
+           << "<devices>"
+           << "<magnets>"
+           << "<magnet anchor=\"base\" offset=\"" << fHalfBlock << ",0," << fHalfBlock << "\" passive_field=\"" << FIELD << ",0,0\" />"
+           << "<magnet anchor=\"base\" offset=\"" << -fHalfBlock << ",0," << fHalfBlock << "\" passive_field=\"" << FIELD << ",0,0\" />"
+           << "<magnet anchor=\"base\" offset=\"0," << fHalfBlock << "," << fHalfBlock << "\" passive_field=\"0," << FIELD << ",0\" />"
+           << "<magnet anchor=\"base\" offset=\"0," << -fHalfBlock << "," << fHalfBlock << "\" passive_field=\"0," << FIELD << ",0\" />"
+           << "</magnets>"
+           << "</devices>"
+           << "</prototype>";
+   }
+   cXML << "</arena>"
+        << "<physics_engines>"
+        << "<dynamics3d id=\"dyn3d\">"
+        << "<floor />"
+        << "<gravity g=\"9.80665\" />"
+        << "<magnetism max_distance=\"" << MAX_DISTANCE << "\" />"
+        << "</dynamics3d>"
+        << "</physics_engines>"
+        << "<media />"
+        << "</argos-configuration>";
+   return cXML.str();
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Selects the method of the magnetism plugin.
+ */
+static void SetMethod(CDynamics3DPlugin& c_plugin,
+                      const std::string& str_method) {
+   ticpp::Element tNode("magnetism");
+   tNode.SetAttribute("max_distance", MAX_DISTANCE);
+   tNode.SetAttribute("method", str_method);
+   c_plugin.Init(tNode);
+}
+
+/*
+ * Applies the magnetic forces for the given number of times, and returns the
+ * time per update in milliseconds.
+ */
+static double UpdatePlugin(CDynamics3DPlugin& c_plugin,
+                           UInt32 un_updates) {
+   auto tStart = std::chrono::steady_clock::now();
+   for(UInt32 i = 0; i < un_updates; ++i) {
+      c_plugin.Update();
+   }
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count() * 1e3 / un_updates;
+}
+
+/*
+ * Executes the given number of steps from the initial state, and returns the
+ * positions of the blocks.
+ */
+static std::vector<CVector3> Run(UInt32 un_steps) {
+   CSimulator& cSimulator = CSimulator::GetInstance();
+   cSimulator.Reset();
+   for(UInt32 i = 0; i < un_steps; ++i) {
+      cSimulator.UpdateSpace();
+   }
+   std::vector<CVector3> vecPositions;
+   CSpace::TMapPerType& tBlocks = cSimulator.GetSpace().GetEntitiesByType("prototype");
+   for(CSpace::TMapPerType::iterator it = tBlocks.begin();
+       it != tBlocks.end();
+       ++it) {
+      CPrototypeEntity& cBlock = *any_cast<CPrototypeEntity*>(it->second);
+      vecPositions.push_back(cBlock.GetEmbodiedEntity().GetOriginAnchor().Position);
+   }
+   return vecPositions;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   UInt32 unBlocks = (argc > 1) ? std::atoi(argv[1]) : 1000;
+   UInt32 unSteps = (argc > 2) ? std::atoi(argv[2]) : 5;
+   int nResult = EXIT_SUCCESS;
+   try {
+      CDynamicLoading::LoadLibrariesOnDemand();
+      /* Create the experiment */
+      ticpp::Document tConfiguration;
+      tConfiguration.Parse(MakeExperiment(unBlocks));
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      cSimulator.Load(tConfiguration, true);
+      CDynamics3DEngine& cEngine =
+         dynamic_cast<CDynamics3DEngine&>(cSimulator.GetPhysicsEngine("dyn3d"));
+      CDynamics3DPlugin& cPlugin = *cEngine.GetPhysicsPlugins()["magnetism"];
+      /* The magnetic forces alone */
+      SetMethod(cPlugin, "pairwise");
+      double fPairwiseMS = UpdatePlugin(cPlugin, unSteps);
+      SetMethod(cPlugin, "cell_list");
+      double fCellListMS = UpdatePlugin(cPlugin, unSteps);
+      /* The whole steps, from the initial state */
+      SetMethod(cPlugin, "pairwise");
+      auto tStart = std::chrono::steady_clock::now();
+      std::vector<CVector3> vecPairwise = Run(unSteps);
+      double fPairwiseStepMS =
+         std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count() * 1e3 / unSteps;
+      SetMethod(cPlugin, "cell_list");
+      tStart = std::chrono::steady_clock::now();
+      std::vector<CVector3> vecCellList = Run(unSteps);
+      double fCellListStepMS =
+         std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count() * 1e3 / unSteps;
+      /* The forces are summed in a different order, allow for rounding */
+      std::vector<CVector3> vecInitial = Run(0);
+      size_t unMismatches = 0;
+      Real fMaxDisplacement = 0.0;
+      for(size_t i = 0; i < vecPairwise.size(); ++i) {
+         if(Distance(vecPairwise[i], vecCellList[i]) > 1e-6) {
+            ++unMismatches;
+         }
+         fMaxDisplacement = Max(fMaxDisplacement, Distance(vecPairwise[i], vecInitial[i]));
+      }
+      /* Report */
+      std::cout << unBlocks << " blocks, "
+                << fPairwiseMS << " ms per magnetism update with the pairwise loop, "
+                << fCellListMS << " ms with the cell list, "
+                << fPairwiseStepMS << " ms per step with the pairwise loop, "
+                << fCellListStepMS << " ms with the cell list, "
+                << fMaxDisplacement << " m of largest displacement, "
+                << unMismatches << " blocks in different positions"
+                << std::endl;
+      cSimulator.Destroy();
+      if(unMismatches > 0) {
+         std::cerr << "The cell list moves the blocks differently from the pairwise loop" << std::endl;
+         nResult = EXIT_FAILURE;
+      }
+   }
+   catch(std::exception& ex) {
+      std::cerr << ex.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+   return nResult;
+}